@@ -0,0 +1,702 @@
+#include "zcm/zcm.h"
+#include "zcm/zcm_msg.h"
+#include "zcm/zcm_node.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * zcm_msg codec microbenchmarks.
+ *
+ * Every case runs one operation in a loop, doubling the iteration count until
+ * the run lasts at least --min-time-ms, and reports ns/op, payload bytes/s and
+ * heap allocations/op (malloc/calloc/realloc are wrapped at link time, see
+ * CMakeLists.txt). Output is JSON (one benchmark object per line) or CSV;
+ * either can be saved and passed back with --baseline to flag regressions.
+ */
+
+/* Linked with -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc. */
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+static size_t g_allocs = 0;
+
+void *__wrap_malloc(size_t size) {
+  g_allocs++;
+  return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t n, size_t size) {
+  g_allocs++;
+  return __real_calloc(n, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+  g_allocs++;
+  return __real_realloc(ptr, size);
+}
+
+/* from zcm_msg.c */
+extern int zcm_msg__serialize(const zcm_msg_t *, const void **, size_t *, void **);
+extern int zcm_msg__from_borrowed(zcm_msg_t *, void *, size_t, void (*)(void *), void *);
+
+#define BENCH_MAX_RESULTS 256
+#define BENCH_MIXED_GROUP 6 /* items per mixed group, see build_mixed() */
+#define BENCH_ARRAY_MAX 131072u /* largest element count of any case */
+#define BENCH_BURST 32 /* frames queued per burst case */
+#define BENCH_BURST_FRAME 64
+
+typedef struct bench_state {
+  zcm_msg_t *msg;
+  zcm_msg_t *in;
+  uint32_t count;               /* scalar items or mixed groups */
+  zcm_msg_array_type_t type;
+  uint32_t elems;
+  void *src;                    /* array input, `elems` elements */
+  void *dst;                    /* array decode target */
+  const void *env;              /* serialized envelope of `msg` */
+  size_t env_len;
+  void *env_owned;
+  zcm_socket_t *push;
+  zcm_socket_t *pull;
+  long sink;
+} bench_state_t;
+
+typedef int (*bench_fn)(bench_state_t *st);
+
+typedef struct bench_result {
+  char name[96];
+  uint64_t iterations;
+  double ns_per_op;
+  double bytes_per_op;
+  double bytes_per_sec;
+  double allocs_per_op;
+  int has_baseline;
+  double baseline_ns_per_op;
+  double baseline_allocs_per_op;
+  double delta_pct;
+  int regression;
+} bench_result_t;
+
+typedef struct bench_opts {
+  int csv;
+  int quick;
+  double min_time_ms;
+  const char *filter;
+  const char *baseline;
+  double threshold_pct;
+} bench_opts_t;
+
+static bench_result_t g_results[BENCH_MAX_RESULTS];
+static size_t g_result_count = 0;
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void noop_release(void *ctx) {
+  (void)ctx;
+}
+
+static const char *array_type_name(zcm_msg_array_type_t type) {
+  switch (type) {
+    case ZCM_MSG_ARRAY_CHAR: return "char";
+    case ZCM_MSG_ARRAY_SHORT: return "short";
+    case ZCM_MSG_ARRAY_INT: return "int";
+    case ZCM_MSG_ARRAY_FLOAT: return "float";
+    case ZCM_MSG_ARRAY_DOUBLE: return "double";
+    case ZCM_MSG_ARRAY_INT64: return "int64";
+    case ZCM_MSG_ARRAY_UINT8: return "uint8";
+    case ZCM_MSG_ARRAY_UINT16: return "uint16";
+    case ZCM_MSG_ARRAY_UINT32: return "uint32";
+    case ZCM_MSG_ARRAY_UINT64: return "uint64";
+    default: return "?";
+  }
+}
+
+static size_t array_type_size(zcm_msg_array_type_t type) {
+  switch (type) {
+    case ZCM_MSG_ARRAY_CHAR:
+    case ZCM_MSG_ARRAY_UINT8: return 1;
+    case ZCM_MSG_ARRAY_SHORT:
+    case ZCM_MSG_ARRAY_UINT16: return 2;
+    case ZCM_MSG_ARRAY_INT:
+    case ZCM_MSG_ARRAY_FLOAT:
+    case ZCM_MSG_ARRAY_UINT32: return 4;
+    default: return 8;
+  }
+}
+
+/* Fill `n` elements with a slowly increasing series (delta friendly). */
+static void fill_series(void *dst, zcm_msg_array_type_t type, uint32_t n) {
+  for (uint32_t i = 0; i < n; i++) {
+    uint64_t v = 1000u + (uint64_t)i * 3u + (i % 7u);
+    switch (type) {
+      case ZCM_MSG_ARRAY_CHAR:
+      case ZCM_MSG_ARRAY_UINT8: ((uint8_t *)dst)[i] = (uint8_t)v; break;
+      case ZCM_MSG_ARRAY_SHORT:
+      case ZCM_MSG_ARRAY_UINT16: ((uint16_t *)dst)[i] = (uint16_t)v; break;
+      case ZCM_MSG_ARRAY_INT:
+      case ZCM_MSG_ARRAY_UINT32: ((uint32_t *)dst)[i] = (uint32_t)v; break;
+      case ZCM_MSG_ARRAY_FLOAT: ((float *)dst)[i] = (float)v * 0.5f; break;
+      case ZCM_MSG_ARRAY_DOUBLE: ((double *)dst)[i] = (double)v * 0.5; break;
+      default: ((uint64_t *)dst)[i] = v; break;
+    }
+  }
+}
+
+/* ---- operations ---------------------------------------------------------- */
+
+static int op_put_scalars(bench_state_t *st) {
+  zcm_msg_t *m = st->msg;
+  zcm_msg_reset(m);
+  zcm_msg_set_type(m, "Scalars");
+  for (uint32_t i = 0; i < st->count; i++) {
+    int rc = 0;
+    switch (i % 6u) {
+      case 0: rc = zcm_msg_put_char(m, (char)i); break;
+      case 1: rc = zcm_msg_put_short(m, (int16_t)i); break;
+      case 2: rc = zcm_msg_put_int(m, (int32_t)i); break;
+      case 3: rc = zcm_msg_put_long(m, (int64_t)i); break;
+      case 4: rc = zcm_msg_put_float(m, (float)i); break;
+      default: rc = zcm_msg_put_double(m, (double)i); break;
+    }
+    if (rc != 0) return -1;
+  }
+  return 0;
+}
+
+/* Same payload as op_put_scalars(), through one reservation and the inline
+ * writer cursor. */
+static int op_put_scalars_writer(bench_state_t *st) {
+  static const zcm_msg_item_type_t kinds[6] = {
+      ZCM_MSG_ITEM_CHAR, ZCM_MSG_ITEM_SHORT, ZCM_MSG_ITEM_INT,
+      ZCM_MSG_ITEM_LONG, ZCM_MSG_ITEM_FLOAT, ZCM_MSG_ITEM_DOUBLE};
+  zcm_msg_t *m = st->msg;
+  zcm_msg_reset(m);
+  zcm_msg_set_type(m, "Scalars");
+  size_t bytes = 0;
+  for (uint32_t k = 0; k < 6u; k++) {
+    uint32_t per = st->count / 6u + (k < st->count % 6u ? 1u : 0u);
+    bytes += per * zcm_msg_size_hint_scalar(kinds[k]);
+  }
+  zcm_msg_writer_t w;
+  if (zcm_msg_writer_begin(m, &w, bytes) != 0) return -1;
+  for (uint32_t i = 0; i < st->count; i++) {
+    switch (i % 6u) {
+      case 0: zcm_msg_writer_put_char(&w, (char)i); break;
+      case 1: zcm_msg_writer_put_short(&w, (int16_t)i); break;
+      case 2: zcm_msg_writer_put_int(&w, (int32_t)i); break;
+      case 3: zcm_msg_writer_put_long(&w, (int64_t)i); break;
+      case 4: zcm_msg_writer_put_float(&w, (float)i); break;
+      default: zcm_msg_writer_put_double(&w, (double)i); break;
+    }
+  }
+  return zcm_msg_writer_commit(&w) == 0 ? 0 : -1;
+}
+
+static int op_get_scalars(bench_state_t *st) {
+  zcm_msg_t *m = st->msg;
+  zcm_msg_rewind(m);
+  for (uint32_t i = 0; i < st->count; i++) {
+    int rc = 0;
+    switch (i % 6u) {
+      case 0: { char v; rc = zcm_msg_get_char(m, &v); st->sink += v; break; }
+      case 1: { int16_t v; rc = zcm_msg_get_short(m, &v); st->sink += v; break; }
+      case 2: { int32_t v; rc = zcm_msg_get_int(m, &v); st->sink += v; break; }
+      case 3: { int64_t v; rc = zcm_msg_get_long(m, &v); st->sink += (long)v; break; }
+      case 4: { float v; rc = zcm_msg_get_float(m, &v); st->sink += (long)v; break; }
+      default: { double v; rc = zcm_msg_get_double(m, &v); st->sink += (long)v; break; }
+    }
+    if (rc != 0) return -1;
+  }
+  return 0;
+}
+
+static int op_put_array(bench_state_t *st) {
+  zcm_msg_reset(st->msg);
+  zcm_msg_set_type(st->msg, "Array");
+  return zcm_msg_put_array(st->msg, st->type, st->elems, st->src);
+}
+
+static int op_get_array(bench_state_t *st) {
+  zcm_msg_array_type_t type;
+  uint32_t elems = 0;
+  const void *data = NULL;
+  zcm_msg_rewind(st->msg);
+  if (zcm_msg_get_array(st->msg, &type, &elems, &data) != 0) return -1;
+  st->sink += (long)elems + ((const uint8_t *)data)[0];
+  return 0;
+}
+
+static int op_put_array_delta(bench_state_t *st) {
+  zcm_msg_reset(st->msg);
+  zcm_msg_set_type(st->msg, "Array");
+  return zcm_msg_put_array_delta(st->msg, st->type, st->elems, st->src);
+}
+
+static int op_get_array_copy(bench_state_t *st) {
+  zcm_msg_array_type_t type;
+  uint32_t elems = 0;
+  zcm_msg_rewind(st->msg);
+  if (zcm_msg_get_array_copy(st->msg, &type, &elems, st->dst, BENCH_ARRAY_MAX * 8u) != 0)
+    return -1;
+  st->sink += (long)elems;
+  return 0;
+}
+
+static int op_serialize(bench_state_t *st) {
+  const void *data = NULL;
+  size_t len = 0;
+  void *owned = NULL;
+  if (zcm_msg__serialize(st->msg, &data, &len, &owned) != 0) return -1;
+  st->sink += (long)len;
+  free(owned);
+  return 0;
+}
+
+static int op_from_bytes(bench_state_t *st) {
+  return zcm_msg_from_bytes(st->in, st->env, st->env_len);
+}
+
+static int op_validate(bench_state_t *st) {
+  /* Re-adopting the envelope drops the cached index so every op validates. */
+  if (zcm_msg__from_borrowed(st->in, (void *)st->env, st->env_len, noop_release, NULL) != 0)
+    return -1;
+  return zcm_msg_validate(st->in);
+}
+
+static int op_validate_index(bench_state_t *st) {
+  if (zcm_msg__from_borrowed(st->in, (void *)st->env, st->env_len, noop_release, NULL) != 0)
+    return -1;
+  return zcm_msg_validate_index(st->in);
+}
+
+static int decode_mixed(bench_state_t *st, zcm_msg_t *m) {
+  for (uint32_t i = 0; i < st->count; i++) {
+    int32_t a;
+    double b;
+    const char *t;
+    uint32_t tl;
+    zcm_msg_array_type_t at;
+    uint32_t n;
+    const void *p;
+    const void *bp;
+    uint32_t bl;
+    int16_t s;
+    if (zcm_msg_get_int(m, &a) != 0 || zcm_msg_get_double(m, &b) != 0 ||
+        zcm_msg_get_text(m, &t, &tl) != 0 || zcm_msg_get_array(m, &at, &n, &p) != 0 ||
+        zcm_msg_get_bytes(m, &bp, &bl) != 0 || zcm_msg_get_short(m, &s) != 0) {
+      return -1;
+    }
+    st->sink += a + (long)tl + (long)n + (long)bl + s;
+  }
+  return 0;
+}
+
+static int op_validate_decode(bench_state_t *st) {
+  if (op_validate_index(st) != 0) return -1;
+  return decode_mixed(st, st->in);
+}
+
+static int op_from_bytes_decode(bench_state_t *st) {
+  if (zcm_msg_from_bytes(st->in, st->env, st->env_len) != 0) return -1;
+  if (zcm_msg_validate_index(st->in) != 0) return -1;
+  return decode_mixed(st, st->in);
+}
+
+static int op_send_recv_inproc(bench_state_t *st) {
+  if (zcm_socket_send_msg(st->push, st->msg) != 0) return -1;
+  if (zcm_socket_recv_msg_view(st->pull, st->in) != 0) return -1;
+  st->sink += (long)zcm_msg_remaining(st->in);
+  return 0;
+}
+
+/* Queue a burst of small frames, then take them one receive at a time. */
+static int op_burst_recv_bytes(bench_state_t *st) {
+  static const char frame[BENCH_BURST_FRAME] = "burst";
+  char buf[BENCH_BURST_FRAME];
+  for (int i = 0; i < BENCH_BURST; i++) {
+    if (zcm_socket_send_bytes(st->push, frame, sizeof(frame)) != 0) return -1;
+  }
+  for (int i = 0; i < BENCH_BURST; i++) {
+    size_t n = 0;
+    if (zcm_socket_recv_bytes(st->pull, buf, sizeof(buf), &n) != 0) return -1;
+    st->sink += (long)n;
+  }
+  return 0;
+}
+
+/* Same burst, drained by as few zcm_socket_recv_many_bytes() calls as possible. */
+static int op_burst_recv_many_bytes(bench_state_t *st) {
+  static const char frame[BENCH_BURST_FRAME] = "burst";
+  char bufs[BENCH_BURST][BENCH_BURST_FRAME];
+  size_t lens[BENCH_BURST];
+  for (int i = 0; i < BENCH_BURST; i++) {
+    if (zcm_socket_send_bytes(st->push, frame, sizeof(frame)) != 0) return -1;
+  }
+  int got = 0;
+  while (got < BENCH_BURST) {
+    int n = zcm_socket_recv_many_bytes(st->pull, bufs, sizeof(bufs[0]), lens,
+                                       (size_t)(BENCH_BURST - got), -1);
+    if (n <= 0) return -1;
+    for (int i = 0; i < n; i++) st->sink += (long)lens[i];
+    got += n;
+  }
+  return 0;
+}
+
+/* ---- fixtures ------------------------------------------------------------ */
+
+static int build_mixed(zcm_msg_t *m, uint32_t groups) {
+  double arr[64];
+  uint8_t blob[256];
+  for (int i = 0; i < 64; i++) arr[i] = i * 0.25;
+  memset(blob, 0x5A, sizeof(blob));
+  zcm_msg_reset(m);
+  zcm_msg_set_type(m, "Mixed");
+  for (uint32_t i = 0; i < groups; i++) {
+    if (zcm_msg_put_int(m, (int32_t)i) != 0 || zcm_msg_put_double(m, i * 0.5) != 0 ||
+        zcm_msg_put_text(m, "sensor-channel-name-00") != 0 ||
+        zcm_msg_put_array(m, ZCM_MSG_ARRAY_DOUBLE, 64, arr) != 0 ||
+        zcm_msg_put_bytes(m, blob, sizeof(blob)) != 0 || zcm_msg_put_short(m, 3) != 0) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+static int snapshot_envelope(bench_state_t *st) {
+  const void *data = NULL;
+  size_t len = 0;
+  void *owned = NULL;
+  if (zcm_msg__serialize(st->msg, &data, &len, &owned) != 0) return -1;
+  free(st->env_owned);
+  st->env_owned = malloc(len);
+  if (!st->env_owned) return -1;
+  memcpy(st->env_owned, data, len);
+  free(owned);
+  st->env = st->env_owned;
+  st->env_len = len;
+  return 0;
+}
+
+static size_t payload_len(zcm_msg_t *m) {
+  size_t len = 0;
+  zcm_msg_data(m, &len);
+  return len;
+}
+
+/* ---- runner -------------------------------------------------------------- */
+
+static int matches_filter(const bench_opts_t *o, const char *name) {
+  return !o->filter || strstr(name, o->filter) != NULL;
+}
+
+static int run_case(const bench_opts_t *o, const char *name, bench_fn fn, bench_state_t *st,
+                    double bytes_per_op) {
+  if (!matches_filter(o, name) || g_result_count >= BENCH_MAX_RESULTS) return 0;
+  if (fn(st) != 0) { /* warm-up, also validates the fixture */
+    fprintf(stderr, "zcm_bench_msg: %s failed\n", name);
+    return -1;
+  }
+  uint64_t iters = 1;
+  double elapsed = 0.0;
+  size_t allocs = 0;
+  for (;;) {
+    size_t a0 = g_allocs;
+    double t0 = now_ns();
+    for (uint64_t i = 0; i < iters; i++) {
+      if (fn(st) != 0) {
+        fprintf(stderr, "zcm_bench_msg: %s failed\n", name);
+        return -1;
+      }
+    }
+    elapsed = now_ns() - t0;
+    allocs = g_allocs - a0;
+    if (elapsed >= o->min_time_ms * 1e6 || iters >= ((uint64_t)1 << 40)) break;
+    iters *= 2;
+  }
+  bench_result_t *r = &g_results[g_result_count++];
+  memset(r, 0, sizeof(*r));
+  snprintf(r->name, sizeof(r->name), "%s", name);
+  r->iterations = iters;
+  r->ns_per_op = elapsed / (double)iters;
+  r->bytes_per_op = bytes_per_op;
+  r->bytes_per_sec = (elapsed > 0.0) ? bytes_per_op * (double)iters * 1e9 / elapsed : 0.0;
+  r->allocs_per_op = (double)allocs / (double)iters;
+  return 0;
+}
+
+static int bench_scalars(const bench_opts_t *o, bench_state_t *st) {
+  static const uint32_t counts[] = {16, 256, 4096};
+  size_t n = o->quick ? 2 : sizeof(counts) / sizeof(counts[0]);
+  char name[96];
+  for (size_t i = 0; i < n; i++) {
+    st->count = counts[i];
+    if (op_put_scalars(st) != 0) return -1;
+    double bytes = (double)payload_len(st->msg);
+    snprintf(name, sizeof(name), "scalars/put/n=%u", st->count);
+    if (run_case(o, name, op_put_scalars, st, bytes) != 0) return -1;
+    snprintf(name, sizeof(name), "scalars/put_writer/n=%u", st->count);
+    if (run_case(o, name, op_put_scalars_writer, st, bytes) != 0) return -1;
+    snprintf(name, sizeof(name), "scalars/get/n=%u", st->count);
+    if (run_case(o, name, op_get_scalars, st, bytes) != 0) return -1;
+  }
+  return 0;
+}
+
+static int bench_arrays(const bench_opts_t *o, bench_state_t *st) {
+  static const uint32_t sizes[] = {16, 1024, 65536};
+  size_t n = o->quick ? 2 : sizeof(sizes) / sizeof(sizes[0]);
+  char name[96];
+  for (int t = ZCM_MSG_ARRAY_CHAR; t <= ZCM_MSG_ARRAY_UINT64; t++) {
+    st->type = (zcm_msg_array_type_t)t;
+    int delta_ok = (st->type != ZCM_MSG_ARRAY_FLOAT && st->type != ZCM_MSG_ARRAY_DOUBLE);
+    for (size_t i = 0; i < n; i++) {
+      st->elems = sizes[i];
+      fill_series(st->src, st->type, st->elems);
+      double bytes = (double)st->elems * (double)array_type_size(st->type);
+      const char *tn = array_type_name(st->type);
+      if (op_put_array(st) != 0) return -1;
+      snprintf(name, sizeof(name), "array/put/%s/n=%u", tn, st->elems);
+      if (run_case(o, name, op_put_array, st, bytes) != 0) return -1;
+      snprintf(name, sizeof(name), "array/get/%s/n=%u", tn, st->elems);
+      if (run_case(o, name, op_get_array, st, bytes) != 0) return -1;
+      if (!delta_ok) continue;
+      if (op_put_array_delta(st) != 0) return -1;
+      snprintf(name, sizeof(name), "array/put_delta/%s/n=%u", tn, st->elems);
+      if (run_case(o, name, op_put_array_delta, st, bytes) != 0) return -1;
+      snprintf(name, sizeof(name), "array/get_delta/%s/n=%u", tn, st->elems);
+      if (run_case(o, name, op_get_array_copy, st, bytes) != 0) return -1;
+    }
+  }
+  return 0;
+}
+
+static int bench_envelope(const bench_opts_t *o, bench_state_t *st) {
+  static const uint32_t groups[] = {16, 256, 2000};
+  size_t n = o->quick ? 2 : sizeof(groups) / sizeof(groups[0]);
+  char name[96];
+  for (size_t i = 0; i < n; i++) {
+    st->count = groups[i];
+    if (build_mixed(st->msg, st->count) != 0 || snapshot_envelope(st) != 0) return -1;
+    double bytes = (double)payload_len(st->msg);
+    uint32_t items = st->count * BENCH_MIXED_GROUP;
+    snprintf(name, sizeof(name), "envelope/serialize/items=%u", items);
+    if (run_case(o, name, op_serialize, st, bytes) != 0) return -1;
+    snprintf(name, sizeof(name), "envelope/from_bytes/items=%u", items);
+    if (run_case(o, name, op_from_bytes, st, bytes) != 0) return -1;
+    snprintf(name, sizeof(name), "envelope/validate/items=%u", items);
+    if (run_case(o, name, op_validate, st, bytes) != 0) return -1;
+    snprintf(name, sizeof(name), "envelope/validate_index/items=%u", items);
+    if (run_case(o, name, op_validate_index, st, bytes) != 0) return -1;
+    snprintf(name, sizeof(name), "envelope/validate_decode/items=%u", items);
+    if (run_case(o, name, op_validate_decode, st, bytes) != 0) return -1;
+    snprintf(name, sizeof(name), "envelope/from_bytes_decode/items=%u", items);
+    if (run_case(o, name, op_from_bytes_decode, st, bytes) != 0) return -1;
+  }
+  return 0;
+}
+
+static int bench_transport(const bench_opts_t *o, bench_state_t *st, zcm_context_t *ctx) {
+  st->pull = zcm_socket_new(ctx, ZCM_SOCK_PULL);
+  st->push = zcm_socket_new(ctx, ZCM_SOCK_PUSH);
+  if (!st->pull || !st->push) return -1;
+  if (zcm_socket_bind(st->pull, "inproc://zcm-bench-msg") != 0) return -1;
+  if (zcm_socket_connect(st->push, "inproc://zcm-bench-msg") != 0) return -1;
+  zcm_socket_set_timeouts(st->pull, 2000);
+
+  static const uint32_t sizes[] = {1024, 131072};
+  char name[96];
+  st->type = ZCM_MSG_ARRAY_DOUBLE;
+  for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    st->elems = sizes[i];
+    fill_series(st->src, st->type, st->elems);
+    if (op_put_array(st) != 0) return -1;
+    double bytes = (double)payload_len(st->msg);
+    snprintf(name, sizeof(name), "socket/send_recv_view/double/n=%u", st->elems);
+    if (run_case(o, name, op_send_recv_inproc, st, bytes) != 0) return -1;
+  }
+  double burst_bytes = (double)BENCH_BURST * BENCH_BURST_FRAME;
+  snprintf(name, sizeof(name), "socket/burst/recv_bytes/n=%d", BENCH_BURST);
+  if (run_case(o, name, op_burst_recv_bytes, st, burst_bytes) != 0) return -1;
+  snprintf(name, sizeof(name), "socket/burst/recv_many_bytes/n=%d", BENCH_BURST);
+  if (run_case(o, name, op_burst_recv_many_bytes, st, burst_bytes) != 0) return -1;
+  return 0;
+}
+
+/* ---- output and baseline comparison -------------------------------------- */
+
+static bench_result_t *find_result(const char *name) {
+  for (size_t i = 0; i < g_result_count; i++) {
+    if (strcmp(g_results[i].name, name) == 0) return &g_results[i];
+  }
+  return NULL;
+}
+
+/* Reads either output format back: JSON lines carrying "name"/"ns_per_op"/
+ * "allocs_per_op", or CSV rows in the column order printed below. */
+static int load_baseline(const bench_opts_t *o) {
+  FILE *f = fopen(o->baseline, "r");
+  if (!f) {
+    fprintf(stderr, "zcm_bench_msg: cannot open baseline %s\n", o->baseline);
+    return -1;
+  }
+  char line[512];
+  while (fgets(line, sizeof(line), f)) {
+    char name[96] = {0};
+    double ns = 0.0, allocs = 0.0;
+    unsigned long long iters = 0;
+    double bpo = 0.0, bps = 0.0;
+    const char *p = strstr(line, "\"name\": \"");
+    if (p) {
+      if (sscanf(p, "\"name\": \"%95[^\"]\"", name) != 1) continue;
+      const char *q = strstr(line, "\"ns_per_op\": ");
+      const char *a = strstr(line, "\"allocs_per_op\": ");
+      if (!q || !a) continue;
+      ns = strtod(q + 13, NULL);
+      allocs = strtod(a + 17, NULL);
+    } else if (sscanf(line, "%95[^,],%llu,%lf,%lf,%lf,%lf", name, &iters, &ns, &bpo, &bps,
+                      &allocs) != 6) {
+      continue; /* header or unrelated line */
+    }
+    bench_result_t *r = find_result(name);
+    if (!r || ns <= 0.0) continue;
+    r->has_baseline = 1;
+    r->baseline_ns_per_op = ns;
+    r->baseline_allocs_per_op = allocs;
+    r->delta_pct = (r->ns_per_op - ns) * 100.0 / ns;
+    r->regression = r->delta_pct > o->threshold_pct || r->allocs_per_op > allocs + 0.01;
+  }
+  fclose(f);
+  return 0;
+}
+
+static void print_results(const bench_opts_t *o) {
+  if (o->csv) {
+    printf("name,iterations,ns_per_op,bytes_per_op,bytes_per_sec,allocs_per_op%s\n",
+           o->baseline ? ",baseline_ns_per_op,delta_pct,regression" : "");
+    for (size_t i = 0; i < g_result_count; i++) {
+      const bench_result_t *r = &g_results[i];
+      printf("%s,%llu,%.2f,%.0f,%.0f,%.3f", r->name, (unsigned long long)r->iterations,
+             r->ns_per_op, r->bytes_per_op, r->bytes_per_sec, r->allocs_per_op);
+      if (o->baseline) {
+        if (r->has_baseline) {
+          printf(",%.2f,%.1f,%d", r->baseline_ns_per_op, r->delta_pct, r->regression);
+        } else {
+          printf(",,,0");
+        }
+      }
+      printf("\n");
+    }
+    return;
+  }
+  printf("{\n  \"benchmarks\": [\n");
+  for (size_t i = 0; i < g_result_count; i++) {
+    const bench_result_t *r = &g_results[i];
+    printf("    {\"name\": \"%s\", \"iterations\": %llu, \"ns_per_op\": %.2f, "
+           "\"bytes_per_op\": %.0f, \"bytes_per_sec\": %.0f, \"allocs_per_op\": %.3f",
+           r->name, (unsigned long long)r->iterations, r->ns_per_op, r->bytes_per_op,
+           r->bytes_per_sec, r->allocs_per_op);
+    if (r->has_baseline) {
+      printf(", \"baseline_ns_per_op\": %.2f, \"delta_pct\": %.1f, \"regression\": %s",
+             r->baseline_ns_per_op, r->delta_pct, r->regression ? "true" : "false");
+    }
+    printf("}%s\n", (i + 1 < g_result_count) ? "," : "");
+  }
+  printf("  ]\n}\n");
+}
+
+static void usage(const char *argv0) {
+  fprintf(stderr,
+          "Usage: %s [--format json|csv] [--min-time-ms N] [--quick]\n"
+          "          [--filter SUBSTR] [--baseline FILE] [--threshold PCT]\n"
+          "\n"
+          "  --format       output format (default json)\n"
+          "  --min-time-ms  minimum measured time per case (default 200)\n"
+          "  --quick        fewer sizes and 5 ms per case (smoke run)\n"
+          "  --filter       run only cases whose name contains SUBSTR\n"
+          "  --baseline     compare against a saved json/csv run; exit 2 on regression\n"
+          "  --threshold    ns/op slowdown counted as regression, percent (default 10)\n",
+          argv0);
+}
+
+int main(int argc, char **argv) {
+  bench_opts_t o = {0, 0, 200.0, NULL, NULL, 10.0};
+  for (int i = 1; i < argc; i++) {
+    const char *a = argv[i];
+    const char *v = (i + 1 < argc) ? argv[i + 1] : NULL;
+    if (strcmp(a, "--quick") == 0) {
+      o.quick = 1;
+      o.min_time_ms = 5.0;
+    } else if (strcmp(a, "--format") == 0 && v) {
+      if (strcmp(v, "csv") == 0) {
+        o.csv = 1;
+      } else if (strcmp(v, "json") != 0) {
+        usage(argv[0]);
+        return 1;
+      }
+      i++;
+    } else if (strcmp(a, "--min-time-ms") == 0 && v) {
+      o.min_time_ms = strtod(v, NULL);
+      i++;
+    } else if (strcmp(a, "--filter") == 0 && v) {
+      o.filter = v;
+      i++;
+    } else if (strcmp(a, "--baseline") == 0 && v) {
+      o.baseline = v;
+      i++;
+    } else if (strcmp(a, "--threshold") == 0 && v) {
+      o.threshold_pct = strtod(v, NULL);
+      i++;
+    } else {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+
+  bench_state_t st;
+  memset(&st, 0, sizeof(st));
+  st.msg = zcm_msg_new();
+  st.in = zcm_msg_new();
+  st.src = malloc((size_t)BENCH_ARRAY_MAX * 8u);
+  st.dst = malloc((size_t)BENCH_ARRAY_MAX * 8u);
+  zcm_context_t *ctx = zcm_context_new();
+  if (!st.msg || !st.in || !st.src || !st.dst || !ctx) return 1;
+
+  int rc = 0;
+  if (bench_scalars(&o, &st) != 0 || bench_arrays(&o, &st) != 0 ||
+      bench_envelope(&o, &st) != 0 || bench_transport(&o, &st, ctx) != 0) {
+    rc = 1;
+  }
+  if (rc == 0 && o.baseline && load_baseline(&o) != 0) rc = 1;
+  if (rc == 0) {
+    print_results(&o);
+    for (size_t i = 0; i < g_result_count; i++) {
+      if (g_results[i].regression) {
+        fprintf(stderr, "zcm_bench_msg: regression %s: %.1f%% slower, %.3f allocs/op (was %.3f)\n",
+                g_results[i].name, g_results[i].delta_pct, g_results[i].allocs_per_op,
+                g_results[i].baseline_allocs_per_op);
+        rc = 2;
+      }
+    }
+  }
+
+  zcm_msg_free(st.in); /* drops the last received view before the sockets close */
+  zcm_socket_free(st.push);
+  zcm_socket_free(st.pull);
+  zcm_context_free(ctx);
+  zcm_msg_free(st.msg);
+  free(st.env_owned);
+  free(st.src);
+  free(st.dst);
+  if (st.sink == 42) fprintf(stderr, "\n"); /* keep decode results observable */
+  return rc;
+}
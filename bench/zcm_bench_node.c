@@ -0,0 +1,274 @@
+#include "zcm/zcm.h"
+#include "zcm/zcm_node.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+/*
+ * Broker request latency benchmark.
+ *
+ * Starts an in-process broker on a loopback TCP port and times registry
+ * requests. "warm" cases reuse one zcm_node_t and therefore its broker
+ * connection; "cold" cases create a node per request, which pays the TCP
+ * connect and ZMTP handshake on every call as every request did before nodes
+ * kept a connection. Each case reports mean, p50 and p99 latency as JSON
+ * (one object per line) or CSV.
+ */
+
+#define BENCH_MAX_SAMPLES 200000u
+#define BENCH_SVC "bench.node.svc"
+#define BENCH_TARGETS 16
+
+typedef struct bench_opts {
+  int csv;
+  double min_time_ms;
+  const char *filter;
+} bench_opts_t;
+
+typedef struct bench_state {
+  zcm_context_t *ctx;
+  char broker_ep[64];
+  zcm_node_t *node; /* warm node */
+  char target_names[BENCH_TARGETS][32];
+  const char *targets[BENCH_TARGETS];
+} bench_state_t;
+
+typedef int (*bench_fn)(bench_state_t *st);
+
+static double g_samples[BENCH_MAX_SAMPLES];
+static int g_first = 1;
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static int pick_free_tcp_port(void) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) return -1;
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(0);
+  socklen_t len = sizeof(addr);
+  if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+      getsockname(fd, (struct sockaddr *)&addr, &len) != 0) {
+    close(fd);
+    return -1;
+  }
+  close(fd);
+  return (int)ntohs(addr.sin_port);
+}
+
+static int cmp_double(const void *a, const void *b) {
+  double x = *(const double *)a;
+  double y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+/* ---- operations ---------------------------------------------------------- */
+
+static int op_lookup_warm(bench_state_t *st) {
+  char ep[256];
+  return zcm_node_lookup(st->node, BENCH_SVC, ep, sizeof(ep));
+}
+
+static int op_info_warm(bench_state_t *st) {
+  char ep[256];
+  int pid = 0;
+  return zcm_node_info(st->node, BENCH_SVC, ep, sizeof(ep), NULL, 0, NULL, 0, &pid);
+}
+
+static int op_lookup_cold(bench_state_t *st) {
+  zcm_node_t *node = zcm_node_new(st->ctx, st->broker_ep);
+  if (!node) return -1;
+  char ep[256];
+  int rc = zcm_node_lookup(node, BENCH_SVC, ep, sizeof(ep));
+  zcm_node_free(node);
+  return rc;
+}
+
+static int op_lookup_then_info_cold(bench_state_t *st) {
+  if (op_lookup_cold(st) != 0) return -1;
+  zcm_node_t *node = zcm_node_new(st->ctx, st->broker_ep);
+  if (!node) return -1;
+  char ep[256];
+  int pid = 0;
+  int rc = zcm_node_info(node, BENCH_SVC, ep, sizeof(ep), NULL, 0, NULL, 0, &pid);
+  zcm_node_free(node);
+  return rc;
+}
+
+static int op_lookup_then_info_warm(bench_state_t *st) {
+  if (op_lookup_warm(st) != 0) return -1;
+  return op_info_warm(st);
+}
+
+/* Startup of a process with BENCH_TARGETS peers: one INFO per target versus
+ * one LOOKUP_MANY. */
+static int op_info_targets_warm(bench_state_t *st) {
+  zcm_node_record_t rec;
+  for (int i = 0; i < BENCH_TARGETS; i++) {
+    if (zcm_node_resolve(st->node, st->targets[i], &rec) != 0) return -1;
+  }
+  return 0;
+}
+
+static int op_resolve_many_warm(bench_state_t *st) {
+  zcm_node_record_t recs[BENCH_TARGETS];
+  return zcm_node_resolve_many(st->node, st->targets, BENCH_TARGETS, recs) == BENCH_TARGETS ? 0 : -1;
+}
+
+/* Periodic metrics for one process with BENCH_TARGETS sockets: acknowledged
+ * METRICS requests versus one pushed report frame. */
+static int op_report_metrics_warm(bench_state_t *st) {
+  for (int i = 0; i < BENCH_TARGETS; i++) {
+    if (zcm_node_report_metrics(st->node, st->targets[i], "PUB", 7100 + i, -1, 64, -1, -1, -1) != 0)
+      return -1;
+  }
+  return 0;
+}
+
+static int op_push_metrics(bench_state_t *st) {
+  zcm_node_metrics_t reports[BENCH_TARGETS];
+  for (int i = 0; i < BENCH_TARGETS; i++) {
+    zcm_node_metrics_t r = {st->targets[i], "PUB", 7100 + i, -1, 64, -1, -1, -1};
+    reports[i] = r;
+  }
+  /* A full queue drops the frame; that is the fire-and-forget contract. */
+  (void)zcm_node_push_metrics(st->node, reports, BENCH_TARGETS);
+  return 0;
+}
+
+/* ---- harness ------------------------------------------------------------- */
+
+static int run_case(const bench_opts_t *o, const char *name, bench_fn fn, bench_state_t *st) {
+  if (o->filter && !strstr(name, o->filter)) return 0;
+  if (fn(st) != 0) { /* warm-up, and connects the warm node */
+    fprintf(stderr, "zcm_bench_node: %s failed\n", name);
+    return -1;
+  }
+  size_t n = 0;
+  double start = now_ns();
+  while (n < BENCH_MAX_SAMPLES && (n < 16 || now_ns() - start < o->min_time_ms * 1e6)) {
+    double t0 = now_ns();
+    if (fn(st) != 0) {
+      fprintf(stderr, "zcm_bench_node: %s failed\n", name);
+      return -1;
+    }
+    g_samples[n++] = now_ns() - t0;
+  }
+  double total = 0.0;
+  for (size_t i = 0; i < n; i++) total += g_samples[i];
+  qsort(g_samples, n, sizeof(g_samples[0]), cmp_double);
+  double mean = total / (double)n;
+  double p50 = g_samples[n / 2];
+  double p99 = g_samples[(n * 99) / 100];
+  if (o->csv) {
+    printf("%s,%zu,%.0f,%.0f,%.0f\n", name, n, mean, p50, p99);
+  } else {
+    printf("%s    {\"name\": \"%s\", \"iterations\": %zu, \"ns_per_op\": %.0f, "
+           "\"p50_ns\": %.0f, \"p99_ns\": %.0f}",
+           g_first ? "" : ",\n", name, n, mean, p50, p99);
+  }
+  g_first = 0;
+  return 0;
+}
+
+static void usage(const char *prog) {
+  fprintf(stderr,
+          "usage: %s [--format json|csv] [--min-time-ms MS] [--quick] [--filter TEXT]\n",
+          prog);
+}
+
+int main(int argc, char **argv) {
+  bench_opts_t o = {0, 500.0, NULL};
+  for (int i = 1; i < argc; i++) {
+    const char *a = argv[i];
+    const char *v = (i + 1 < argc) ? argv[i + 1] : NULL;
+    if (strcmp(a, "--quick") == 0) {
+      o.min_time_ms = 10.0;
+    } else if (strcmp(a, "--format") == 0 && v) {
+      if (strcmp(v, "csv") == 0) {
+        o.csv = 1;
+      } else if (strcmp(v, "json") != 0) {
+        usage(argv[0]);
+        return 1;
+      }
+      i++;
+    } else if (strcmp(a, "--min-time-ms") == 0 && v) {
+      o.min_time_ms = strtod(v, NULL);
+      i++;
+    } else if (strcmp(a, "--filter") == 0 && v) {
+      o.filter = v;
+      i++;
+    } else {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+
+  int port = pick_free_tcp_port();
+  if (port <= 0) {
+    fprintf(stderr, "zcm_bench_node: no local TCP port available\n");
+    return 1;
+  }
+  bench_state_t st;
+  memset(&st, 0, sizeof(st));
+  snprintf(st.broker_ep, sizeof(st.broker_ep), "tcp://127.0.0.1:%d", port);
+  st.ctx = zcm_context_new();
+  if (!st.ctx) return 1;
+  zcm_broker_t *broker = zcm_broker_start(st.ctx, st.broker_ep);
+  st.node = zcm_node_new(st.ctx, st.broker_ep);
+  if (!broker || !st.node) return 1;
+  int rc = -1;
+  for (int i = 0; i < 20 && rc != 0; i++) {
+    rc = zcm_node_register_ex(st.node, BENCH_SVC, "tcp://127.0.0.1:7000", "tcp://127.0.0.1:7001",
+                              "127.0.0.1", (int)getpid(), "NONE", -1, -1);
+  }
+  for (int i = 0; i < BENCH_TARGETS && rc == 0; i++) {
+    char ep[64];
+    snprintf(st.target_names[i], sizeof(st.target_names[i]), "bench.node.target%02d", i);
+    snprintf(ep, sizeof(ep), "tcp://127.0.0.1:%d", 7100 + i);
+    st.targets[i] = st.target_names[i];
+    rc = zcm_node_register_ex(st.node, st.targets[i], ep, ep, "127.0.0.1", (int)getpid(),
+                              "NONE", -1, -1);
+  }
+  if (rc != 0) {
+    fprintf(stderr, "zcm_bench_node: register failed\n");
+    return 1;
+  }
+
+  if (o.csv) {
+    printf("name,iterations,ns_per_op,p50_ns,p99_ns\n");
+  } else {
+    printf("{\n  \"benchmarks\": [\n");
+  }
+  rc = 0;
+  if (run_case(&o, "lookup/cold", op_lookup_cold, &st) != 0 ||
+      run_case(&o, "lookup/warm", op_lookup_warm, &st) != 0 ||
+      run_case(&o, "info/warm", op_info_warm, &st) != 0 ||
+      run_case(&o, "lookup+info/cold", op_lookup_then_info_cold, &st) != 0 ||
+      run_case(&o, "lookup+info/warm", op_lookup_then_info_warm, &st) != 0 ||
+      run_case(&o, "info16/warm", op_info_targets_warm, &st) != 0 ||
+      run_case(&o, "resolve_many16/warm", op_resolve_many_warm, &st) != 0 ||
+      run_case(&o, "report_metrics16/warm", op_report_metrics_warm, &st) != 0 ||
+      run_case(&o, "push_metrics16", op_push_metrics, &st) != 0) {
+    rc = 1;
+  }
+  if (!o.csv) printf("\n  ]\n}\n");
+
+  zcm_node_free(st.node);
+  zcm_broker_stop(broker);
+  zcm_context_free(st.ctx);
+  return rc;
+}
@@ -48,59 +48,50 @@ static int build_type_reply_name(const char *req_type, char *out, size_t out_siz
 
 /*
  * User hook: build typed reply payload for one validated TYPE request.
+ * `args` holds the request arguments already decoded by the handler plan.
  * Default behavior here is "echo payload" and reply type "<REQ_TYPE>_RPL".
  */
 static int app_on_type_request(const char *self_name,
                                const char *req_type,
-                               const zcm_proc_type_handler_cfg_t *handler,
-                               zcm_msg_t *req,
+                               const zcm_proc_type_args_t *args,
                                zcm_msg_t *reply,
                                void *user) {
   (void)self_name;
   (void)user;
-  if (!req_type || !handler || !req || !reply) return -1;
+  if (!req_type || !args || !reply) return -1;
 
   char reply_type[96] = {0};
   if (build_type_reply_name(req_type, reply_type, sizeof(reply_type)) != 0) return -1;
   zcm_msg_set_type(reply, reply_type);
 
-  zcm_msg_rewind(req);
-  for (size_t i = 0; i < handler->arg_count; i++) {
-    if (handler->args[i] == ZCM_PROC_TYPE_ARG_TEXT) {
-      const char *text = NULL;
-      uint32_t len = 0;
-      if (zcm_msg_get_text(req, &text, &len) != 0) return -1;
-      char *tmp = (char *)malloc((size_t)len + 1);
-      if (!tmp) return -1;
-      memcpy(tmp, text, len);
-      tmp[len] = '\0';
-      int rc = zcm_msg_put_text(reply, tmp);
-      free(tmp);
-      if (rc != 0) return -1;
-      continue;
-    }
-    if (handler->args[i] == ZCM_PROC_TYPE_ARG_DOUBLE) {
-      double v = 0.0;
-      if (zcm_msg_get_double(req, &v) != 0) return -1;
-      if (zcm_msg_put_double(reply, v) != 0) return -1;
-      continue;
-    }
-    if (handler->args[i] == ZCM_PROC_TYPE_ARG_FLOAT) {
-      float v = 0.0f;
-      if (zcm_msg_get_float(req, &v) != 0) return -1;
-      if (zcm_msg_put_float(reply, v) != 0) return -1;
-      continue;
-    }
-    if (handler->args[i] == ZCM_PROC_TYPE_ARG_INT) {
-      int32_t v = 0;
-      if (zcm_msg_get_int(req, &v) != 0) return -1;
-      if (zcm_msg_put_int(reply, v) != 0) return -1;
-      continue;
+  for (size_t i = 0; i < args->count; i++) {
+    const zcm_proc_type_arg_value_t *v = &args->values[i];
+    int rc = -1;
+    switch (v->kind) {
+      case ZCM_PROC_TYPE_ARG_TEXT: {
+        char tmp[1024];
+        if (v->text_len >= sizeof(tmp)) {
+          char *heap = (char *)malloc((size_t)v->text_len + 1);
+          if (!heap) return -1;
+          memcpy(heap, v->text, v->text_len);
+          heap[v->text_len] = '\0';
+          rc = zcm_msg_put_text(reply, heap);
+          free(heap);
+        } else {
+          memcpy(tmp, v->text, v->text_len);
+          tmp[v->text_len] = '\0';
+          rc = zcm_msg_put_text(reply, tmp);
+        }
+        break;
+      }
+      case ZCM_PROC_TYPE_ARG_DOUBLE: rc = zcm_msg_put_double(reply, v->d); break;
+      case ZCM_PROC_TYPE_ARG_FLOAT: rc = zcm_msg_put_float(reply, v->f); break;
+      case ZCM_PROC_TYPE_ARG_INT: rc = zcm_msg_put_int(reply, v->i); break;
+      default: break;
     }
-    return -1;
+    if (rc != 0) return -1;
   }
-
-  return (zcm_msg_remaining(req) == 0) ? 0 : -1;
+  return 0;
 }
 
 static int run_daemon(const char *cfg_path) {
@@ -120,14 +111,17 @@ static int run_daemon(const char *cfg_path) {
   }
   zcm_proc_runtime_start_data_workers(&cfg, proc, app_on_data_payload, NULL);
 
+  /* Request/reply messages are recycled so steady-state serving does not
+   * allocate per request. */
+  zcm_msg_pool_t *pool = zcm_msg_pool_thread();
   for (;;) {
-    zcm_msg_t *req = zcm_msg_new();
+    zcm_msg_t *req = zcm_msg_pool_acquire(pool);
     if (!req) {
       zcm_proc_free(proc);
       return 1;
     }
-    if (zcm_socket_recv_msg(rep, req) != 0) {
-      zcm_msg_free(req);
+    if (zcm_socket_recv_msg_view(rep, req) != 0) {
+      zcm_msg_pool_release(pool, req);
       continue;
     }
     app_on_req_message(cfg.name, req, NULL);
@@ -142,10 +136,11 @@ static int run_daemon(const char *cfg_path) {
     char err_text[512] = {0};
     char dynamic_reply[64] = {0};
     char parsed_summary[512] = {0};
+    zcm_proc_type_args_t parsed_args;
     const char *reply_text = zcm_proc_runtime_builtin_reply_for_command(NULL, 0);
-    zcm_msg_t *reply = zcm_msg_new();
+    zcm_msg_t *reply = zcm_msg_pool_acquire(pool);
     if (!reply) {
-      zcm_msg_free(req);
+      zcm_msg_pool_release(pool, req);
       zcm_proc_free(proc);
       return 1;
     }
@@ -157,8 +152,8 @@ static int run_daemon(const char *cfg_path) {
       int handled = zcm_node_handle_control_msg(req, reply, &should_exit);
       if (handled < 0) {
         fprintf(stderr, "control handler failed\n");
-        zcm_msg_free(reply);
-        zcm_msg_free(req);
+        zcm_msg_pool_release(pool, reply);
+        zcm_msg_pool_release(pool, req);
         zcm_proc_free(proc);
         return 1;
       }
@@ -167,16 +162,16 @@ static int run_daemon(const char *cfg_path) {
         if (!rt) rt = "";
         if (zcm_socket_send_msg(rep, reply) != 0) {
           fprintf(stderr, "reply send failed\n");
-          zcm_msg_free(reply);
-          zcm_msg_free(req);
+          zcm_msg_pool_release(pool, reply);
+          zcm_msg_pool_release(pool, req);
           zcm_proc_free(proc);
           return 1;
         }
         printf("[REP %s] sent control reply: msgType=%s exit=%d\n",
                cfg.name, rt, should_exit ? 1 : 0);
         fflush(stdout);
-        zcm_msg_free(reply);
-        zcm_msg_free(req);
+        zcm_msg_pool_release(pool, reply);
+        zcm_msg_pool_release(pool, req);
         if (should_exit) {
           zcm_proc_free(proc);
           return 0;
@@ -186,10 +181,9 @@ static int run_daemon(const char *cfg_path) {
     }
 
     const zcm_proc_type_handler_cfg_t *handler =
-        zcm_proc_runtime_find_type_handler(&cfg, req_type);
+        zcm_proc_runtime_find_type_handler_msg(&cfg, req);
     if (handler) {
-      if (zcm_proc_runtime_decode_type_payload(req, handler,
-                                               parsed_summary, sizeof(parsed_summary)) != 0) {
+      if (zcm_proc_runtime_decode_type_args(req, handler, &parsed_args) != 0) {
         malformed = 1;
         req_code = 400;
         snprintf(err_text, sizeof(err_text),
@@ -198,10 +192,14 @@ static int run_daemon(const char *cfg_path) {
         printf("[REP %s] received malformed request: msgType=%s expected=%s\n",
                cfg.name, req_type, handler->format);
       } else {
-        printf("[REP %s] received request: msgType=%s payload={%s}\n",
-               cfg.name, req_type, parsed_summary[0] ? parsed_summary : "<no-args>");
-        zcm_msg_rewind(req);
-        if (app_on_type_request(cfg.name, req_type, handler, req, reply, NULL) != 0) {
+        if (zcm_proc_runtime_log_payloads()) {
+          zcm_proc_runtime_format_type_args(&parsed_args, parsed_summary, sizeof(parsed_summary));
+          printf("[REP %s] received request: msgType=%s payload={%s}\n",
+                 cfg.name, req_type, parsed_summary[0] ? parsed_summary : "<no-args>");
+        } else {
+          printf("[REP %s] received request: msgType=%s\n", cfg.name, req_type);
+        }
+        if (app_on_type_request(cfg.name, req_type, &parsed_args, reply, NULL) != 0) {
           malformed = 1;
           req_code = 500;
           snprintf(err_text, sizeof(err_text),
@@ -354,8 +352,8 @@ static int run_daemon(const char *cfg_path) {
     }
     if (zcm_socket_send_msg(rep, reply) != 0) {
       fprintf(stderr, "reply send failed\n");
-      zcm_msg_free(reply);
-      zcm_msg_free(req);
+      zcm_msg_pool_release(pool, reply);
+      zcm_msg_pool_release(pool, req);
       zcm_proc_free(proc);
       return 1;
     }
@@ -367,8 +365,8 @@ static int run_daemon(const char *cfg_path) {
              cfg.name, malformed ? "ERROR" : "REPLY", reply_text, req_code);
     }
     fflush(stdout);
-    zcm_msg_free(reply);
-    zcm_msg_free(req);
+    zcm_msg_pool_release(pool, reply);
+    zcm_msg_pool_release(pool, req);
   }
 
   zcm_proc_free(proc);
@@ -33,8 +33,48 @@ typedef struct zcm_broker zcm_broker_t;
  */
 zcm_context_t *zcm_context_new(void);
 
+/** @brief Maximum number of CPUs in zcm_context_opts_t::cpus. */
+#define ZCM_CONTEXT_CPU_MAX 64
+
+/**
+ * @brief Context tuning for zcm_context_new_ex().
+ *
+ * A zeroed struct gives the ØMQ defaults: one I/O thread, 1023 sockets,
+ * inherited scheduling and no CPU pinning.
+ */
+typedef struct zcm_context_opts {
+  /** ØMQ I/O threads; `0` keeps one. Roughly one per GB/s of traffic. */
+  int io_threads;
+  /** Maximum number of sockets; `0` keeps the ØMQ default. */
+  int max_sockets;
+  /** I/O thread scheduling policy (`SCHED_*`); `0` inherits. */
+  int thread_sched_policy;
+  /** I/O thread priority (`1..99` for `SCHED_FIFO`/`SCHED_RR`; any other
+   *  policy takes a positive value as "raise to nice -20"); `0` inherits. */
+  int thread_priority;
+  /** CPUs the I/O threads may run on. */
+  int cpus[ZCM_CONTEXT_CPU_MAX];
+  /** Number of valid entries in `cpus`; `0` leaves the threads unpinned. */
+  size_t cpu_count;
+  /** Numeric tag in I/O thread names (`ZMQbg/<tag>/IO/<n>`); `0` for none. */
+  int thread_name_prefix;
+} zcm_context_opts_t;
+
+/**
+ * @brief Create a zCm context with tuned I/O threads and limits.
+ *
+ * Options are applied before any socket exists, as ØMQ requires. Scheduling
+ * settings are tried on a short-lived thread first: a policy or priority the
+ * process may not use makes creation fail instead of aborting an I/O thread.
+ *
+ * @param opts Context options; `NULL` behaves like zcm_context_new().
+ * @return Newly allocated context, or `NULL` when an option is out of range or
+ *         rejected by ØMQ.
+ */
+zcm_context_t *zcm_context_new_ex(const zcm_context_opts_t *opts);
+
 /**
- * @brief Destroy a context created by zcm_context_new().
+ * @brief Destroy a context created by zcm_context_new() or zcm_context_new_ex().
  *
  * @param ctx Context to free. `NULL` is allowed.
  */
@@ -12,6 +12,7 @@ extern "C" {
 
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
 /** @addtogroup zcm_low_level
  * @{
@@ -20,6 +21,19 @@ extern "C" {
 /** @brief Opaque typed message container. */
 typedef struct zcm_msg zcm_msg_t;
 
+/** @brief Opaque cache of reusable messages (see zcm_msg_pool_new()). */
+typedef struct zcm_msg_pool zcm_msg_pool_t;
+
+#ifndef ZCM_MSG_POOL_DEFAULT_MAX
+/** @brief Default number of idle messages kept by a pool. */
+#define ZCM_MSG_POOL_DEFAULT_MAX 16
+#endif
+
+#ifndef ZCM_MSG_POOL_DEFAULT_TRIM
+/** @brief Default payload capacity (bytes) a released message is trimmed to. */
+#define ZCM_MSG_POOL_DEFAULT_TRIM (64 * 1024)
+#endif
+
 /**
  * @brief Encoded item kind stored in a message payload.
  */
@@ -32,7 +46,8 @@ typedef enum {
   ZCM_MSG_ITEM_DOUBLE = 6,
   ZCM_MSG_ITEM_ARRAY = 7,
   ZCM_MSG_ITEM_TEXT = 8,
-  ZCM_MSG_ITEM_BYTES = 9
+  ZCM_MSG_ITEM_BYTES = 9,
+  ZCM_MSG_ITEM_VALUE = 10
 } zcm_msg_item_type_t;
 
 /**
@@ -43,7 +58,12 @@ typedef enum {
   ZCM_MSG_ARRAY_SHORT = 2,
   ZCM_MSG_ARRAY_INT = 3,
   ZCM_MSG_ARRAY_FLOAT = 4,
-  ZCM_MSG_ARRAY_DOUBLE = 5
+  ZCM_MSG_ARRAY_DOUBLE = 5,
+  ZCM_MSG_ARRAY_INT64 = 6,
+  ZCM_MSG_ARRAY_UINT8 = 7,
+  ZCM_MSG_ARRAY_UINT16 = 8,
+  ZCM_MSG_ARRAY_UINT32 = 9,
+  ZCM_MSG_ARRAY_UINT64 = 10
 } zcm_msg_array_type_t;
 
 /**
@@ -113,6 +133,61 @@ void zcm_msg_reset(zcm_msg_t *msg);
  */
 void zcm_msg_rewind(zcm_msg_t *msg);
 
+/**
+ * @brief Create a message pool.
+ *
+ * A pool recycles released messages together with their payload buffers, so
+ * steady-state request/reply handling does not touch the heap. Pools are not
+ * thread-safe; use one pool per thread or zcm_msg_pool_thread().
+ *
+ * @param max_cached Maximum idle messages kept (`0` selects `ZCM_MSG_POOL_DEFAULT_MAX`).
+ * @param trim_bytes Trim limit, rounded up to a power of two of at least 256
+ *        (`0` selects `ZCM_MSG_POOL_DEFAULT_TRIM`). Released payload buffers
+ *        above it are shrunk to it; index, array scratch and reference
+ *        arrays above it are freed and regrown on demand.
+ * @return New pool, or `NULL` on allocation failure.
+ */
+zcm_msg_pool_t *zcm_msg_pool_new(size_t max_cached, size_t trim_bytes);
+
+/**
+ * @brief Free a pool and every idle message it holds.
+ *
+ * @param pool Pool to free. `NULL` is allowed.
+ */
+void zcm_msg_pool_free(zcm_msg_pool_t *pool);
+
+/**
+ * @brief Take an empty message from the pool.
+ *
+ * Falls back to zcm_msg_new() when the pool is empty or `NULL`.
+ *
+ * @param pool Source pool.
+ * @return Empty message, or `NULL` on allocation failure.
+ */
+zcm_msg_t *zcm_msg_pool_acquire(zcm_msg_pool_t *pool);
+
+/**
+ * @brief Return a message to the pool.
+ *
+ * The message is reset (releasing any borrowed frame), trimmed to the pool
+ * limit and kept for reuse; it is freed instead when the pool is full or
+ * `NULL`.
+ *
+ * @param pool Destination pool.
+ * @param msg Message to recycle. `NULL` is allowed.
+ */
+void zcm_msg_pool_release(zcm_msg_pool_t *pool, zcm_msg_t *msg);
+
+/**
+ * @brief Get the calling thread's message pool (per-thread arena).
+ *
+ * The pool is created on first use with default limits and freed when the
+ * thread exits.
+ *
+ * @return Thread-local pool, or `NULL` on allocation failure.
+ */
+zcm_msg_pool_t *zcm_msg_pool_thread(void);
+
 /**
  * @brief Set application-level message type string.
  *
@@ -130,6 +205,54 @@ int zcm_msg_set_type(zcm_msg_t *msg, const char *type);
  */
 const char *zcm_msg_get_type(const zcm_msg_t *msg);
 
+/**
+ * @brief Stable 32-bit ID of a type name.
+ *
+ * FNV-1a over the name bytes (as stored, at most 63), never `0`. Peers
+ * derive the same ID independently, so no negotiation is needed.
+ *
+ * @param type Null-terminated type name.
+ * @return Type ID, or `0` if `type` is `NULL`.
+ */
+uint32_t zcm_msg_type_id(const char *type);
+
+/**
+ * @brief Get the type ID of a message.
+ *
+ * Messages received in a compact envelope carry the ID directly; otherwise it
+ * is derived from the type string on first use and cached.
+ *
+ * @param msg Message to inspect.
+ * @return Type ID, or `0` when the message has no type.
+ */
+uint32_t zcm_msg_get_type_id(const zcm_msg_t *msg);
+
+/**
+ * @brief Register a type name in the process-wide interning table.
+ *
+ * Compact envelopes received for an interned ID report the registered name
+ * from zcm_msg_get_type(); unknown IDs report a `#xxxxxxxx` placeholder.
+ * Re-interning the same name is a no-op. Interning is thread-safe, and the
+ * lookups done on receive take no lock.
+ *
+ * @param type Null-terminated type name.
+ * @param id Optional output for the type ID.
+ * @return `ZCM_MSG_OK` on success, `ZCM_MSG_ERR_TYPE` if another name already
+ * holds the same ID, otherwise an error code.
+ */
+int zcm_msg_type_intern(const char *type, uint32_t *id);
+
+/**
+ * @brief Look up an interned type name by ID.
+ *
+ * @param id Type ID.
+ * @param out Destination buffer.
+ * @param out_size Size of `out` in bytes.
+ * @return `ZCM_MSG_OK` on success, `ZCM_MSG_ERR_TYPE` if the ID is not
+ * interned, otherwise an error code.
+ */
+int zcm_msg_type_name(uint32_t id, char *out, size_t out_size);
+
 /**
  * @brief Append a `char` item.
  *
@@ -215,9 +338,88 @@ int zcm_msg_put_bytes(zcm_msg_t *msg, const void *data, uint32_t len);
 int zcm_msg_put_array(zcm_msg_t *msg, zcm_msg_array_type_t type,
                       uint32_t elements, const void *data);
 
+/**
+ * @brief Append a byte item that references caller memory instead of copying it.
+ *
+ * `data` must stay valid and unchanged until `release(ctx)` is called, which
+ * happens once the message no longer needs it (reset, free, or when reading
+ * the message forces a copy) and every frame zcm_socket_send_msg() queued from
+ * it has left ØMQ; it may run on a ØMQ I/O thread. zcm_socket_send_msg()
+ * sends such messages as multipart frames with the referenced buffers
+ * zero-copy; zcm_socket_recv_msg() reassembles them. Reading items back from
+ * this message first copies the references into the message payload.
+ *
+ * @param msg Message to append to.
+ * @param data Caller buffer. Can be `NULL` when `len == 0`.
+ * @param len Number of bytes at `data`.
+ * @param release Optional callback releasing `data`.
+ * @param ctx Argument passed to `release`.
+ * @return `ZCM_MSG_OK` on success, otherwise an error code (the caller then
+ *         keeps ownership and `release` is not called).
+ */
+int zcm_msg_put_bytes_ref(zcm_msg_t *msg, const void *data, uint32_t len,
+                          void (*release)(void *ctx), void *ctx);
+
+/**
+ * @brief Append an array item that references caller memory (see zcm_msg_put_bytes_ref()).
+ *
+ * Elements are sent as they are in memory, which is the little-endian wire
+ * order on little-endian hosts. On big-endian hosts multi-byte elements are
+ * copied instead and `release` runs before the call returns.
+ *
+ * @param msg Message to append to.
+ * @param type Array element type.
+ * @param elements Element count.
+ * @param data Caller array. Must be non-`NULL` when `elements > 0`.
+ * @param release Optional callback releasing `data`.
+ * @param ctx Argument passed to `release`.
+ * @return `ZCM_MSG_OK` on success, otherwise an error code.
+ */
+int zcm_msg_put_array_ref(zcm_msg_t *msg, zcm_msg_array_type_t type, uint32_t elements,
+                          const void *data, void (*release)(void *ctx), void *ctx);
+
+/**
+ * @brief Append an integer array item in delta + zigzag-varint encoding.
+ *
+ * Each element is stored as the varint of the zigzagged difference from the
+ * previous element, so slowly changing counters and timestamps take one or two
+ * bytes per element. Readers decode it transparently through
+ * zcm_msg_get_array() and zcm_msg_get_array_copy(), which report `type`.
+ *
+ * @param msg Message to append to.
+ * @param type Integer element type (any type except FLOAT/DOUBLE).
+ * @param elements Element count.
+ * @param data Pointer to contiguous array memory. Must be non-`NULL` when `elements > 0`.
+ * @return `ZCM_MSG_OK` on success, otherwise an error code.
+ */
+int zcm_msg_put_array_delta(zcm_msg_t *msg, zcm_msg_array_type_t type,
+                            uint32_t elements, const void *data);
+
+/**
+ * @brief Select the process-wide value property encoding.
+ *
+ * Overrides `ZCM_MSG_VALUE_COMPACT`. Affects values appended afterwards by
+ * any thread; decoding always accepts both forms.
+ *
+ * @param enable Non-zero for the compact `VALUE` item, `0` for the triplet.
+ */
+void zcm_msg_set_value_compact(int enable);
+
+/**
+ * @brief Whether value helpers currently write the compact `VALUE` item.
+ *
+ * @return `1` for compact encoding, `0` for the triplet.
+ */
+int zcm_msg_value_compact(void);
+
 /**
  * @brief Append the standardized scalar value as text.
  *
+ * Value helpers write the `__zcm_value__` marker/kind/value triplet, which
+ * every peer decodes. The compact `VALUE` item (1-byte kind tag) is opt-in
+ * with `ZCM_MSG_VALUE_COMPACT=1` or zcm_msg_set_value_compact(); enable it
+ * only once all receivers run a release that decodes it.
+ *
  * @param msg Message to append to.
  * @param value Text value.
  * @return `ZCM_MSG_OK` on success, otherwise an error code.
@@ -251,6 +453,237 @@ int zcm_msg_put_value_float(zcm_msg_t *msg, float value);
  */
 int zcm_msg_put_value_int(zcm_msg_t *msg, int32_t value);
 
+/**
+ * @brief Make room for `bytes` more payload bytes in one allocation.
+ *
+ * Appends that stay within the reservation do not reallocate. Combine with the
+ * zcm_msg_size_hint_*() helpers to size a message whose shape is known.
+ *
+ * @param msg Message to grow.
+ * @param bytes Payload bytes to reserve past the current end.
+ * @return `ZCM_MSG_OK` on success, otherwise an error code.
+ */
+int zcm_msg_reserve(zcm_msg_t *msg, size_t bytes);
+
+/**
+ * @brief Element size of an array type, or `0` for an unknown type.
+ *
+ * @param type Array element type.
+ * @return Element size in bytes.
+ */
+static inline size_t zcm_msg_array_elem_size(zcm_msg_array_type_t type) {
+  switch (type) {
+    case ZCM_MSG_ARRAY_CHAR:
+    case ZCM_MSG_ARRAY_UINT8: return 1;
+    case ZCM_MSG_ARRAY_SHORT:
+    case ZCM_MSG_ARRAY_UINT16: return 2;
+    case ZCM_MSG_ARRAY_INT:
+    case ZCM_MSG_ARRAY_FLOAT:
+    case ZCM_MSG_ARRAY_UINT32: return 4;
+    case ZCM_MSG_ARRAY_DOUBLE:
+    case ZCM_MSG_ARRAY_INT64:
+    case ZCM_MSG_ARRAY_UINT64: return 8;
+  }
+  return 0;
+}
+
+/**
+ * @brief Encoded size of a scalar item (`CHAR` to `DOUBLE`).
+ *
+ * @param type Scalar item kind.
+ * @return Encoded bytes including the tag, or `0` for a non-scalar kind.
+ */
+static inline size_t zcm_msg_size_hint_scalar(zcm_msg_item_type_t type) {
+  switch (type) {
+    case ZCM_MSG_ITEM_CHAR: return 1 + 1;
+    case ZCM_MSG_ITEM_SHORT: return 1 + 2;
+    case ZCM_MSG_ITEM_INT:
+    case ZCM_MSG_ITEM_FLOAT: return 1 + 4;
+    case ZCM_MSG_ITEM_LONG:
+    case ZCM_MSG_ITEM_DOUBLE: return 1 + 8;
+    default: return 0;
+  }
+}
+
+/**
+ * @brief Encoded size of a text item.
+ *
+ * @param len Text length in bytes (without terminator).
+ * @return Encoded bytes including the tag.
+ */
+static inline size_t zcm_msg_size_hint_text(size_t len) { return 1 + 4 + len; }
+
+/**
+ * @brief Encoded size of a bytes item.
+ *
+ * @param len Byte count.
+ * @return Encoded bytes including the tag.
+ */
+static inline size_t zcm_msg_size_hint_bytes(size_t len) { return 1 + 4 + len; }
+
+/**
+ * @brief Encoded size of a plain (not delta-coded) array item.
+ *
+ * @param type Array element type.
+ * @param elements Element count.
+ * @return Encoded bytes including the tag, or `0` for an unknown type.
+ */
+static inline size_t zcm_msg_size_hint_array(zcm_msg_array_type_t type, size_t elements) {
+  size_t elem = zcm_msg_array_elem_size(type);
+  return elem ? 1 + 1 + 4 + elem * elements : 0;
+}
+
+/**
+ * @brief Encoded size of a value property written by zcm_msg_put_value_*().
+ *
+ * Follows the current value encoding (see zcm_msg_set_value_compact()).
+ *
+ * @param kind Value kind.
+ * @param text_len Text length for `ZCM_MSG_VALUE_TEXT`, ignored otherwise.
+ * @return Encoded bytes, or `0` for an unknown kind.
+ */
+size_t zcm_msg_size_hint_value(zcm_msg_value_kind_t kind, size_t text_len);
+
+/**
+ * @brief Append cursor writing a record of items with one capacity check.
+ *
+ * zcm_msg_writer_begin() reserves the record, the zcm_msg_writer_put_*()
+ * stores are unchecked inline writes, and zcm_msg_writer_commit() appends what
+ * was written to the payload. The caller must not write more than it reserved
+ * and must not touch the message between begin and commit.
+ */
+typedef struct zcm_msg_writer {
+  /** @brief Message being written. */
+  zcm_msg_t *msg;
+  /** @brief Next byte to write. */
+  uint8_t *pos;
+  /** @brief End of the reservation. */
+  uint8_t *end;
+} zcm_msg_writer_t;
+
+/**
+ * @brief Start a record of at most `bytes` encoded bytes.
+ *
+ * @param msg Message to append to.
+ * @param w Cursor to initialize.
+ * @param bytes Exact or upper-bound record size (see zcm_msg_size_hint_*()).
+ * @return `ZCM_MSG_OK` on success, otherwise an error code (`w` is then unusable).
+ */
+int zcm_msg_writer_begin(zcm_msg_t *msg, zcm_msg_writer_t *w, size_t bytes);
+
+/**
+ * @brief Append the bytes written through `w` to the payload.
+ *
+ * @param w Cursor started by zcm_msg_writer_begin().
+ * @return `ZCM_MSG_OK` on success, `ZCM_MSG_ERR_RANGE` if the cursor ran past
+ * its reservation (nothing is appended), otherwise an error code.
+ */
+int zcm_msg_writer_commit(zcm_msg_writer_t *w);
+
+/* Unchecked little-endian stores used by the writer. */
+static inline void zcm_msg_writer__le16(uint8_t *p, uint16_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void zcm_msg_writer__le32(uint8_t *p, uint32_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  p[2] = (uint8_t)(v >> 16);
+  p[3] = (uint8_t)(v >> 24);
+}
+
+static inline void zcm_msg_writer__le64(uint8_t *p, uint64_t v) {
+  zcm_msg_writer__le32(p, (uint32_t)v);
+  zcm_msg_writer__le32(p + 4, (uint32_t)(v >> 32));
+}
+
+/** @brief Write a `char` item (see zcm_msg_put_char()). */
+static inline void zcm_msg_writer_put_char(zcm_msg_writer_t *w, char value) {
+  w->pos[0] = ZCM_MSG_ITEM_CHAR;
+  w->pos[1] = (uint8_t)value;
+  w->pos += 2;
+}
+
+/** @brief Write a 16-bit integer item (see zcm_msg_put_short()). */
+static inline void zcm_msg_writer_put_short(zcm_msg_writer_t *w, int16_t value) {
+  w->pos[0] = ZCM_MSG_ITEM_SHORT;
+  zcm_msg_writer__le16(w->pos + 1, (uint16_t)value);
+  w->pos += 3;
+}
+
+/** @brief Write a 32-bit integer item (see zcm_msg_put_int()). */
+static inline void zcm_msg_writer_put_int(zcm_msg_writer_t *w, int32_t value) {
+  w->pos[0] = ZCM_MSG_ITEM_INT;
+  zcm_msg_writer__le32(w->pos + 1, (uint32_t)value);
+  w->pos += 5;
+}
+
+/** @brief Write a 64-bit integer item (see zcm_msg_put_long()). */
+static inline void zcm_msg_writer_put_long(zcm_msg_writer_t *w, int64_t value) {
+  w->pos[0] = ZCM_MSG_ITEM_LONG;
+  zcm_msg_writer__le64(w->pos + 1, (uint64_t)value);
+  w->pos += 9;
+}
+
+/** @brief Write a `float` item (see zcm_msg_put_float()). */
+static inline void zcm_msg_writer_put_float(zcm_msg_writer_t *w, float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  w->pos[0] = ZCM_MSG_ITEM_FLOAT;
+  zcm_msg_writer__le32(w->pos + 1, bits);
+  w->pos += 5;
+}
+
+/** @brief Write a `double` item (see zcm_msg_put_double()). */
+static inline void zcm_msg_writer_put_double(zcm_msg_writer_t *w, double value) {
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  w->pos[0] = ZCM_MSG_ITEM_DOUBLE;
+  zcm_msg_writer__le64(w->pos + 1, bits);
+  w->pos += 9;
+}
+
+/** @brief Write a text item of `len` bytes (see zcm_msg_put_text()). */
+static inline void zcm_msg_writer_put_text(zcm_msg_writer_t *w, const char *value, uint32_t len) {
+  w->pos[0] = ZCM_MSG_ITEM_TEXT;
+  zcm_msg_writer__le32(w->pos + 1, len);
+  if (len) memcpy(w->pos + 5, value, len);
+  w->pos += 5 + (size_t)len;
+}
+
+/** @brief Write a bytes item (see zcm_msg_put_bytes()). */
+static inline void zcm_msg_writer_put_bytes(zcm_msg_writer_t *w, const void *data, uint32_t len) {
+  w->pos[0] = ZCM_MSG_ITEM_BYTES;
+  zcm_msg_writer__le32(w->pos + 1, len);
+  if (len) memcpy(w->pos + 5, data, len);
+  w->pos += 5 + (size_t)len;
+}
+
+/**
+ * @brief Write a plain array item (see zcm_msg_put_array()).
+ *
+ * `type` must be a valid array type.
+ */
+static inline void zcm_msg_writer_put_array(zcm_msg_writer_t *w, zcm_msg_array_type_t type,
+                                            uint32_t elements, const void *data) {
+  size_t elem = zcm_msg_array_elem_size(type);
+  uint8_t *p = w->pos + 6;
+  w->pos[0] = ZCM_MSG_ITEM_ARRAY;
+  w->pos[1] = (uint8_t)type;
+  zcm_msg_writer__le32(w->pos + 2, elements);
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && \
+    __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  const uint8_t *src = (const uint8_t *)data;
+  for (uint32_t i = 0; i < elements; i++) {
+    for (size_t b = 0; b < elem; b++) p[i * elem + b] = src[i * elem + elem - 1 - b];
+  }
+#else
+  if (elements) memcpy(p, data, elem * elements);
+#endif
+  w->pos = p + elem * elements;
+}
+
 /**
  * @brief Read the next `char` item.
  *
@@ -332,7 +765,10 @@ int zcm_msg_get_bytes(zcm_msg_t *msg, const void **data, uint32_t *len);
 /**
  * @brief Read the next array item.
  *
- * Returned pointer references internal message storage.
+ * The payload is never modified. On little-endian hosts the returned pointer
+ * references the payload directly; on big-endian hosts, and for delta-encoded
+ * arrays, it references a host-order copy owned by the message, valid until
+ * the next array read.
  *
  * @param msg Message to read from.
  * @param type Output array element type.
@@ -343,10 +779,27 @@ int zcm_msg_get_bytes(zcm_msg_t *msg, const void **data, uint32_t *len);
 int zcm_msg_get_array(zcm_msg_t *msg, zcm_msg_array_type_t *type,
                       uint32_t *elements, const void **data);
 
+/**
+ * @brief Read the next array item into a caller buffer in host byte order.
+ *
+ * When `dst_len` is too small, `type`/`elements` are still reported, the read
+ * cursor is left on the item, and `ZCM_MSG_ERR_RANGE` is returned.
+ *
+ * @param msg Message to read from.
+ * @param type Output array element type.
+ * @param elements Output element count.
+ * @param dst Destination buffer.
+ * @param dst_len Capacity of `dst` in bytes.
+ * @return `ZCM_MSG_OK` on success, otherwise an error code.
+ */
+int zcm_msg_get_array_copy(zcm_msg_t *msg, zcm_msg_array_type_t *type,
+                           uint32_t *elements, void *dst, size_t dst_len);
+
 /**
  * @brief Decode the standardized scalar value from the current read offset.
  *
- * The function consumes the marker/kind/value triplet from the message stream.
+ * The function consumes one compact `VALUE` item, or the legacy
+ * marker/kind/value triplet written by older peers, from the message stream.
  *
  * @param msg Message to read from.
  * @param out Output decoded value.
@@ -354,12 +807,138 @@ int zcm_msg_get_array(zcm_msg_t *msg, zcm_msg_array_type_t *type,
  */
 int zcm_msg_get_value(zcm_msg_t *msg, zcm_msg_value_t *out);
 
+/**
+ * @brief Count the items in the payload.
+ *
+ * The first call walks the payload once (validating it) and builds an item
+ * offset index; later calls and the indexed accessors reuse it until the
+ * payload changes.
+ *
+ * @param msg Message to inspect.
+ * @param count Output item count.
+ * @return `ZCM_MSG_OK` on success, otherwise the validation error code.
+ */
+int zcm_msg_item_count(zcm_msg_t *msg, uint32_t *count);
+
+/**
+ * @brief Move the read cursor to item `index`.
+ *
+ * Sequential getters continue from that item. `index` equal to the item count
+ * positions the cursor at the end of the payload.
+ *
+ * @param msg Message to reposition.
+ * @param index Zero-based item index.
+ * @return `ZCM_MSG_OK` on success, otherwise an error code.
+ */
+int zcm_msg_seek(zcm_msg_t *msg, uint32_t index);
+
+/**
+ * @brief Read the `char` item at `index` without moving the read cursor.
+ *
+ * @param msg Message to read from.
+ * @param index Zero-based item index.
+ * @param value Output storage for decoded value.
+ * @return `ZCM_MSG_OK` on success, otherwise an error code.
+ */
+int zcm_msg_get_char_at(zcm_msg_t *msg, uint32_t index, char *value);
+
+/**
+ * @brief Read the 16-bit signed integer item at `index` without moving the read cursor.
+ *
+ * @param msg Message to read from.
+ * @param index Zero-based item index.
+ * @param value Output storage for decoded value.
+ * @return `ZCM_MSG_OK` on success, otherwise an error code.
+ */
+int zcm_msg_get_short_at(zcm_msg_t *msg, uint32_t index, int16_t *value);
+
+/**
+ * @brief Read the 32-bit signed integer item at `index` without moving the read cursor.
+ *
+ * @param msg Message to read from.
+ * @param index Zero-based item index.
+ * @param value Output storage for decoded value.
+ * @return `ZCM_MSG_OK` on success, otherwise an error code.
+ */
+int zcm_msg_get_int_at(zcm_msg_t *msg, uint32_t index, int32_t *value);
+
+/**
+ * @brief Read the 64-bit signed integer item at `index` without moving the read cursor.
+ *
+ * @param msg Message to read from.
+ * @param index Zero-based item index.
+ * @param value Output storage for decoded value.
+ * @return `ZCM_MSG_OK` on success, otherwise an error code.
+ */
+int zcm_msg_get_long_at(zcm_msg_t *msg, uint32_t index, int64_t *value);
+
+/**
+ * @brief Read the `float` item at `index` without moving the read cursor.
+ *
+ * @param msg Message to read from.
+ * @param index Zero-based item index.
+ * @param value Output storage for decoded value.
+ * @return `ZCM_MSG_OK` on success, otherwise an error code.
+ */
+int zcm_msg_get_float_at(zcm_msg_t *msg, uint32_t index, float *value);
+
+/**
+ * @brief Read the `double` item at `index` without moving the read cursor.
+ *
+ * @param msg Message to read from.
+ * @param index Zero-based item index.
+ * @param value Output storage for decoded value.
+ * @return `ZCM_MSG_OK` on success, otherwise an error code.
+ */
+int zcm_msg_get_double_at(zcm_msg_t *msg, uint32_t index, double *value);
+
+/**
+ * @brief Read the text item at `index` without moving the read cursor.
+ *
+ * @param msg Message to read from.
+ * @param index Zero-based item index.
+ * @param value Output pointer to text bytes (not null-terminated by contract).
+ * @param len Optional output string length in bytes.
+ * @return `ZCM_MSG_OK` on success, otherwise an error code.
+ */
+int zcm_msg_get_text_at(zcm_msg_t *msg, uint32_t index, const char **value, uint32_t *len);
+
+/**
+ * @brief Read the raw byte item at `index` without moving the read cursor.
+ *
+ * @param msg Message to read from.
+ * @param index Zero-based item index.
+ * @param data Output pointer to the byte span.
+ * @param len Optional output byte count.
+ * @return `ZCM_MSG_OK` on success, otherwise an error code.
+ */
+int zcm_msg_get_bytes_at(zcm_msg_t *msg, uint32_t index, const void **data, uint32_t *len);
+
+/**
+ * @brief Read the array item at `index` without moving the read cursor.
+ *
+ * @param msg Message to read from.
+ * @param index Zero-based item index.
+ * @param type Output array element type.
+ * @param elements Output element count.
+ * @param data Output pointer to contiguous array bytes (see zcm_msg_get_array()).
+ * @return `ZCM_MSG_OK` on success, otherwise an error code.
+ */
+int zcm_msg_get_array_at(zcm_msg_t *msg, uint32_t index, zcm_msg_array_type_t *type,
+                          uint32_t *elements, const void **data);
+
 /**
  * @brief Get raw payload bytes (without transport envelope).
  *
+ * Does not modify the message. While buffers appended with
+ * zcm_msg_put_bytes_ref() or zcm_msg_put_array_ref() are pending the payload
+ * is not contiguous and `NULL` is returned; reading an item or
+ * zcm_msg_validate_index() copies them in.
+ *
  * @param msg Message to inspect.
  * @param len Optional payload byte length output.
- * @return Pointer to internal payload buffer, or `NULL` when `msg` is `NULL`.
+ * @return Pointer to internal payload buffer, or `NULL` when `msg` is `NULL`
+ *         or holds pending references.
  */
 const void *zcm_msg_data(const zcm_msg_t *msg, size_t *len);
 
@@ -384,11 +963,28 @@ int zcm_msg_from_bytes(zcm_msg_t *msg, const void *data, size_t len);
 /**
  * @brief Validate encoded payload structure.
  *
+ * Does not modify the message, so several threads may validate one shared
+ * message. Use zcm_msg_validate_index() to keep the work for later reads.
+ *
  * @param msg Message to validate.
  * @return `ZCM_MSG_OK` if the payload is structurally valid, otherwise an error code.
  */
 int zcm_msg_validate(const zcm_msg_t *msg);
 
+/**
+ * @brief Validate the payload and keep the item index it builds.
+ *
+ * On success the index used by `zcm_msg_get_*_at()` is ready and the message
+ * is marked trusted: sequential getters skip their bounds checks until the
+ * payload is modified or reset. Referenced buffers are copied into the
+ * payload first. This modifies the message; do not call it on a message
+ * other threads are reading.
+ *
+ * @param msg Message to validate.
+ * @return `ZCM_MSG_OK` if the payload is structurally valid, otherwise an error code.
+ */
+int zcm_msg_validate_index(zcm_msg_t *msg);
+
 /**
  * @brief Get the last decode/validation error text for a message.
  *
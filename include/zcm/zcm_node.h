@@ -11,6 +11,7 @@ extern "C" {
 #endif
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include "zcm_msg.h"
 
@@ -49,12 +50,37 @@ typedef struct zcm_node_entry {
   char *endpoint;
 } zcm_node_entry_t;
 
+/**
+ * @brief Full registry record of one name (see zcm_node_resolve()).
+ */
+typedef struct zcm_node_record {
+  /** @brief Data endpoint. */
+  char endpoint[512];
+  /** @brief Control endpoint (may be empty). */
+  char ctrl_endpoint[512];
+  /** @brief Host name or address (may be empty). */
+  char host[256];
+  /** @brief Process ID, or `0` when unknown. */
+  int pid;
+} zcm_node_record_t;
+
 /** @brief zcm_node_register_ex() failure code when a name is already owned by another process. */
 #define ZCM_NODE_REGISTER_EX_DUPLICATE (-2)
 
+#ifndef ZCM_NODE_TIMEOUT_MS_DEFAULT
+/** @brief Default per-request broker timeout (see zcm_node_set_timeout()). */
+#define ZCM_NODE_TIMEOUT_MS_DEFAULT 1000
+#endif
+
 /**
  * @brief Create a node helper bound to one broker endpoint.
  *
+ * The node keeps one connection to the broker, opened on the first request and
+ * reused by later ones, so a warm lookup costs a single round trip. A request
+ * that fails or times out closes the connection and the next request opens a
+ * new one. Requests from several threads are serialized. Free the node before
+ * its context.
+ *
  * @param ctx zCm context.
  * @param broker_endpoint Broker endpoint string used for registry requests.
  * @return Node handle on success, or `NULL` on failure.
@@ -68,6 +94,16 @@ zcm_node_t *zcm_node_new(struct zcm_context *ctx, const char *broker_endpoint);
  */
 void zcm_node_free(zcm_node_t *node);
 
+/**
+ * @brief Set the timeout of each broker request.
+ *
+ * @param node Node helper.
+ * @param timeout_ms Milliseconds to wait for a reply (default
+ *        `ZCM_NODE_TIMEOUT_MS_DEFAULT`).
+ * @return `0` on success, `-1` on invalid arguments.
+ */
+int zcm_node_set_timeout(zcm_node_t *node, int timeout_ms);
+
 /**
  * @brief Remove a previously registered name from the broker.
  *
@@ -130,6 +166,64 @@ int zcm_node_info(zcm_node_t *node, const char *name,
                   char *out_host, size_t out_host_size,
                   int *out_pid);
 
+/**
+ * @brief Resolve a registered name to its full record.
+ *
+ * Served from the resolution cache when enabled (zcm_node_set_cache()).
+ *
+ * @param node Node helper.
+ * @param name Name to resolve.
+ * @param out Output record.
+ * @return `0` on success, `-1` when the name is unknown or on failure.
+ */
+int zcm_node_resolve(zcm_node_t *node, const char *name, zcm_node_record_t *out);
+
+/**
+ * @brief Resolve several registered names at once.
+ *
+ * Names are sent to the broker with `LOOKUP_MANY`, up to 64 per request;
+ * larger sets are split into requests that are all sent before the first
+ * reply is read, so resolving any number of names costs about one round
+ * trip. Cached names (zcm_node_set_cache()) are not requested. Brokers that
+ * predate `LOOKUP_MANY` are queried name by name.
+ *
+ * @param node Node helper.
+ * @param names Names to resolve.
+ * @param n Number of names.
+ * @param out_records Output records, one per name; records of unknown names
+ *                    are zeroed (empty `endpoint`).
+ * @return Number of names resolved, or `-1` on failure.
+ */
+int zcm_node_resolve_many(zcm_node_t *node, const char *const *names, size_t n,
+                          zcm_node_record_t *out_records);
+
+/**
+ * @brief Enable, retune or disable the resolution cache.
+ *
+ * With a positive `ttl_ms`, zcm_node_resolve(), zcm_node_lookup() and
+ * zcm_node_info() keep resolved records for `ttl_ms` and names the broker
+ * does not know for `negative_ttl_ms` (`0` disables negative caching), so
+ * repeated resolution needs no broker traffic. Transport failures are never
+ * cached. Registering or unregistering a name through this node drops its
+ * entry; callers should call zcm_node_cache_invalidate() when they fail to
+ * reach a resolved endpoint. The cache is off by default and every call
+ * clears it.
+ *
+ * @param node Node helper.
+ * @param ttl_ms Lifetime of resolved records, `0` to disable the cache.
+ * @param negative_ttl_ms Lifetime of negative entries.
+ * @return `0` on success, `-1` on invalid arguments.
+ */
+int zcm_node_set_cache(zcm_node_t *node, int ttl_ms, int negative_ttl_ms);
+
+/**
+ * @brief Drop cached resolution entries.
+ *
+ * @param node Node helper. `NULL` is allowed.
+ * @param name Name to drop, or `NULL` to clear the whole cache.
+ */
+void zcm_node_cache_invalidate(zcm_node_t *node, const char *name);
+
 /**
  * @brief List currently registered node entries.
  *
@@ -169,6 +263,188 @@ int zcm_node_report_metrics(zcm_node_t *node, const char *name, const char *role
                             int pub_bytes, int sub_bytes,
                             int push_bytes, int pull_bytes);
 
+/** @brief Magic opening a binary metrics report frame (see zcm_node_push_metrics()). */
+#define ZCM_NODE_METRICS_MAGIC "ZCMR"
+/** @brief Binary metrics report frame version. */
+#define ZCM_NODE_METRICS_VERSION 1
+/** @brief Frame header size: magic, version, record count. */
+#define ZCM_NODE_METRICS_HEADER_SIZE 8
+/** @brief Fixed part of one report record: name/role lengths and six values. */
+#define ZCM_NODE_METRICS_RECORD_SIZE 28
+/** @brief Longest name accepted in a report record. */
+#define ZCM_NODE_METRICS_NAME_MAX 255
+/** @brief Longest role accepted in a report record. */
+#define ZCM_NODE_METRICS_ROLE_MAX 511
+/** @brief Records accepted in one zcm_node_push_metrics() call. */
+#define ZCM_NODE_METRICS_BATCH_MAX 1024
+
+/**
+ * @brief One metrics report, as passed to zcm_node_push_metrics().
+ *
+ * Fields mirror zcm_node_report_metrics(); numeric values may be `-1`.
+ */
+typedef struct zcm_node_metrics {
+  /** @brief Registered logical name. */
+  const char *name;
+  /** @brief Role string; `NULL`, empty or `-` keeps the broker's current role. */
+  const char *role;
+  /** @brief Published PUB port or `-1`. */
+  int pub_port;
+  /** @brief Published PUSH port or `-1`. */
+  int push_port;
+  /** @brief Last PUB payload byte size or `-1`. */
+  int pub_bytes;
+  /** @brief Last SUB payload byte size or `-1`. */
+  int sub_bytes;
+  /** @brief Last PUSH payload byte size or `-1`. */
+  int push_bytes;
+  /** @brief Last PULL payload byte size or `-1`. */
+  int pull_bytes;
+} zcm_node_metrics_t;
+
+/**
+ * @brief Send metrics reports to the broker without waiting for a reply.
+ *
+ * All `count` reports travel in one binary frame over a PUSH socket to the
+ * broker's metrics endpoint, which the node discovers on first use
+ * (`METRICS_ENDPOINT`). The broker applies them between registry requests,
+ * so frequent reporting does not queue behind lookups. Reports for names the
+ * broker does not know are ignored.
+ *
+ * Delivery is best effort: when the broker is unreachable the frame is queued
+ * up to a small bound, after which reports are dropped and the endpoint is
+ * rediscovered. Against brokers without a metrics endpoint each report falls
+ * back to zcm_node_report_metrics().
+ *
+ * @param node Node helper.
+ * @param reports Reports to send, typically one per socket of the process.
+ * @param count Number of reports (`1..ZCM_NODE_METRICS_BATCH_MAX`).
+ * @return `0` once queued (or acknowledged on the fallback path), `-1` on
+ *         invalid arguments or when the reports could not be sent.
+ */
+int zcm_node_push_metrics(zcm_node_t *node, const zcm_node_metrics_t *reports, size_t count);
+
+/**
+ * @brief Async completion status when no reply arrived within the node timeout.
+ *
+ * The request stays queued on the connection and may still reach a broker
+ * that comes back later.
+ */
+#define ZCM_NODE_ASYNC_TIMEOUT (-3)
+/** @brief Async completion status for requests still pending in zcm_node_free(). */
+#define ZCM_NODE_ASYNC_CANCELLED (-4)
+
+/**
+ * @brief Completion callback of an asynchronous broker request.
+ *
+ * @param node Node helper the request was issued on.
+ * @param name Name the request was about.
+ * @param status `0` on success, `-1` when the broker rejected the request or
+ *               does not know the name, ::ZCM_NODE_REGISTER_EX_DUPLICATE,
+ *               ::ZCM_NODE_ASYNC_TIMEOUT or ::ZCM_NODE_ASYNC_CANCELLED.
+ * @param rec Resolved record for successful lookups (only `endpoint` is set
+ *            by zcm_node_lookup_async()), `NULL` otherwise. Valid for the
+ *            duration of the call.
+ * @param user User pointer given with the request.
+ */
+typedef void (*zcm_node_async_cb_t)(zcm_node_t *node, const char *name, int status,
+                                    const zcm_node_record_t *rec, void *user);
+
+/**
+ * @brief Start an asynchronous lookup (see zcm_node_lookup()).
+ *
+ * Asynchronous requests use their own broker connection and never block:
+ * they are queued and complete from zcm_node_async_process(), so any number
+ * can be in flight from one thread. They always ask the broker; resolved
+ * records still feed the cache (zcm_node_set_cache()). The asynchronous API
+ * of a node must be driven from one thread at a time; the blocking API stays
+ * usable from other threads meanwhile.
+ *
+ * @param node Node helper.
+ * @param name Name to resolve.
+ * @param cb Completion callback.
+ * @param user User pointer passed to `cb`.
+ * @return `0` when queued, `-1` on invalid arguments or when the request
+ *         cannot be queued (`cb` is not called).
+ */
+int zcm_node_lookup_async(zcm_node_t *node, const char *name,
+                          zcm_node_async_cb_t cb, void *user);
+
+/**
+ * @brief Start an asynchronous full-record resolution (see zcm_node_resolve()).
+ *
+ * @param node Node helper.
+ * @param name Name to resolve.
+ * @param cb Completion callback, receiving the full record.
+ * @param user User pointer passed to `cb`.
+ * @return `0` when queued, `-1` otherwise.
+ */
+int zcm_node_resolve_async(zcm_node_t *node, const char *name,
+                           zcm_node_async_cb_t cb, void *user);
+
+/**
+ * @brief Start an asynchronous registration (see zcm_node_register_ex()).
+ *
+ * @return `0` when queued, `-1` on invalid arguments or when the request
+ *         cannot be queued.
+ */
+int zcm_node_register_async(zcm_node_t *node, const char *name, const char *endpoint,
+                            const char *ctrl_endpoint, const char *host, int pid,
+                            const char *role, int pub_port, int push_port,
+                            zcm_node_async_cb_t cb, void *user);
+
+/**
+ * @brief Start an asynchronous unregistration (see zcm_node_unregister()).
+ *
+ * @return `0` when queued, `-1` otherwise.
+ */
+int zcm_node_unregister_async(zcm_node_t *node, const char *name,
+                              zcm_node_async_cb_t cb, void *user);
+
+/**
+ * @brief Get a file descriptor to poll for async completions.
+ *
+ * The descriptor signals readability edge-style, like `ZMQ_FD`: when it
+ * polls readable, after issuing requests and when
+ * zcm_node_async_timeout_ms() elapses, call zcm_node_async_process() with a
+ * zero timeout, which drains everything that is ready.
+ *
+ * @param node Node helper.
+ * @param out_fd Output descriptor, owned by the node.
+ * @return `0` on success, `-1` on failure.
+ */
+int zcm_node_async_fd(zcm_node_t *node, int *out_fd);
+
+/**
+ * @brief Complete ready asynchronous requests.
+ *
+ * Receives available replies, expires requests older than the node timeout
+ * and invokes their callbacks, which may issue new requests.
+ *
+ * @param node Node helper.
+ * @param timeout_ms `0` to return immediately, or milliseconds to wait for
+ *                   at least one completion (`-1` waits until one happens
+ *                   while requests are pending).
+ * @return Number of completed requests, or `-1` on failure.
+ */
+int zcm_node_async_process(zcm_node_t *node, int timeout_ms);
+
+/**
+ * @brief Milliseconds until the next pending async request times out.
+ *
+ * @param node Node helper.
+ * @return Milliseconds (`0` when overdue), or `-1` when nothing is pending.
+ */
+int zcm_node_async_timeout_ms(zcm_node_t *node);
+
+/**
+ * @brief Number of asynchronous requests in flight.
+ *
+ * @param node Node helper.
+ * @return Pending request count.
+ */
+size_t zcm_node_async_pending(zcm_node_t *node);
+
 /**
  * @brief Handle a standard `ZCM_CMD` management message.
  *
@@ -236,21 +512,142 @@ int zcm_socket_set_subscribe(zcm_socket_t *sock, const char *prefix, size_t len)
 /**
  * @brief Serialize and send a typed message.
  *
+ * The envelope is written straight into the outgoing ØMQ frame, without an
+ * intermediate copy. When coalescing is enabled (zcm_socket_set_coalesce()),
+ * the message is appended to a pending batch frame instead. `msg` is only
+ * read.
+ *
  * @param sock Socket wrapper.
  * @param msg Message to send.
  * @return `0` on success, `-1` on failure.
  */
 int zcm_socket_send_msg(zcm_socket_t *sock, const zcm_msg_t *msg);
 
+/**
+ * @brief Send several typed messages in one batch frame.
+ *
+ * Any pending coalesced batch is flushed first. Receivers get the messages
+ * back one by one from zcm_socket_recv_msg() or together from
+ * zcm_socket_recv_batch().
+ *
+ * @param sock Socket wrapper.
+ * @param msgs Messages to send.
+ * @param count Number of messages (at least 1).
+ * @return `0` on success, `-1` on failure.
+ */
+int zcm_socket_send_batch(zcm_socket_t *sock, const zcm_msg_t *const *msgs, size_t count);
+
+/**
+ * @brief Enable sender-side coalescing on a PUB or PUSH socket.
+ *
+ * Subsequent zcm_socket_send_msg() calls are packed into one batch frame,
+ * which is sent once it holds at least `max_bytes`, or once the oldest pending
+ * message is `max_delay_ms` old. A send checks that age itself. When the
+ * stream goes idle, the delay is kept by a zcm_poller_t watching the socket,
+ * which flushes due batches from zcm_poller_wait(). Without a poller, bound
+ * the wait with zcm_socket_flush_timeout_ms() and call zcm_socket_flush().
+ * A negative delay or zero `max_bytes` disables coalescing and flushes what is
+ * pending.
+ *
+ * @param sock Socket wrapper.
+ * @param max_delay_ms Maximum age of a pending message, in milliseconds.
+ * @param max_bytes Batch size that triggers a send.
+ * @return `0` on success, `-1` on failure or unsupported socket type.
+ */
+int zcm_socket_set_coalesce(zcm_socket_t *sock, int max_delay_ms, size_t max_bytes);
+
+/**
+ * @brief Send messages in compact type-ID envelopes.
+ *
+ * When enabled, zcm_socket_send_msg() and batched sends replace the type
+ * string with its 32-bit zcm_msg_type_id() (16-byte header instead of
+ * 12 bytes plus the name). Receivers accept both forms on any socket and
+ * restore the name from the interning table (zcm_msg_type_intern()).
+ * Messages with referenced items are still framed with the type string.
+ *
+ * @param sock Socket wrapper.
+ * @param enable Non-zero to enable, `0` to send named envelopes.
+ * @return `0` on success, `-1` on failure.
+ */
+int zcm_socket_set_type_ids(zcm_socket_t *sock, int enable);
+
+/**
+ * @brief Send the pending coalesced batch, if any.
+ *
+ * @param sock Socket wrapper.
+ * @return `0` on success (including nothing pending), `-1` on failure.
+ */
+int zcm_socket_flush(zcm_socket_t *sock);
+
+/**
+ * @brief Milliseconds until the pending coalesced batch is due.
+ *
+ * @param sock Socket wrapper.
+ * @return Milliseconds (`0` when overdue), or `-1` when nothing is pending.
+ */
+int zcm_socket_flush_timeout_ms(zcm_socket_t *sock);
+
 /**
  * @brief Receive and decode a typed message.
  *
+ * Batch frames are unpacked transparently: each call returns the next
+ * message of the current batch before receiving a new frame.
+ *
  * @param sock Socket wrapper.
  * @param msg Destination message object.
  * @return `0` on success, `-1` on transport/decode error.
  */
 int zcm_socket_recv_msg(zcm_socket_t *sock, zcm_msg_t *msg);
 
+/**
+ * @brief Receive a typed message as a borrowed view of the ØMQ frame.
+ *
+ * Unlike zcm_socket_recv_msg(), the payload is not copied: `msg` keeps the
+ * received frame alive and zcm_msg_get_text(), zcm_msg_get_bytes() and
+ * zcm_msg_get_array() return pointers straight into it. The frame is released
+ * by zcm_msg_reset(), zcm_msg_free(), or the next receive into `msg`.
+ * Appending items to a borrowed message first copies the payload into
+ * message-owned storage. Messages unpacked from a batch frame are copied.
+ *
+ * @param sock Socket wrapper.
+ * @param msg Destination message object.
+ * @return `0` on success, `-1` on transport/decode error.
+ */
+int zcm_socket_recv_msg_view(zcm_socket_t *sock, zcm_msg_t *msg);
+
+/**
+ * @brief Receive up to `max` typed messages from one frame.
+ *
+ * Blocks for the first message like zcm_socket_recv_msg(), then returns the
+ * remaining messages of the same batch frame without waiting. A plain
+ * (non-batch) frame yields one message.
+ *
+ * @param sock Socket wrapper.
+ * @param msgs Destination message objects (at least `max`).
+ * @param max Capacity of `msgs`.
+ * @param out_count Optional number of messages decoded.
+ * @return `0` on success, `-1` on transport/decode error.
+ */
+int zcm_socket_recv_batch(zcm_socket_t *sock, zcm_msg_t **msgs, size_t max, size_t *out_count);
+
+/**
+ * @brief Receive every queued typed message, up to `max`, in one call.
+ *
+ * Waits for the first message, then keeps receiving with `ZMQ_DONTWAIT`
+ * until `max` messages are decoded or nothing more is queued, so a burst is
+ * taken in one wakeup. Entries of batch frames count as separate messages.
+ * A message that fails to decode ends the call early.
+ *
+ * @param sock Socket wrapper.
+ * @param msgs Destination message objects (at least `max`).
+ * @param max Capacity of `msgs`.
+ * @param timeout_ms Maximum wait for the first message in milliseconds, or
+ *                   `-1` to block as zcm_socket_recv_msg() does (bounded by
+ *                   zcm_socket_set_timeouts()).
+ * @return Number of messages received, `0` on timeout, `-1` on error.
+ */
+int zcm_socket_recv_many(zcm_socket_t *sock, zcm_msg_t **msgs, size_t max, int timeout_ms);
+
 /**
  * @brief Send raw bytes.
  *
@@ -264,14 +661,118 @@ int zcm_socket_send_bytes(zcm_socket_t *sock, const void *data, size_t len);
 /**
  * @brief Receive raw bytes into a caller-provided buffer.
  *
+ * Frames larger than `buf_len` are truncated and reported with a return value
+ * of `1`; use zcm_socket_recv_frame() to get the full frame and its true size.
+ *
  * @param sock Socket wrapper.
  * @param buf Destination buffer.
  * @param buf_len Capacity of `buf` in bytes.
- * @param out_len Optional output with received byte count.
- * @return `0` on success, `-1` on failure.
+ * @param out_len Optional output with the stored byte count (at most `buf_len`).
+ * @return `0` on success, `1` when the frame was truncated to `buf_len` bytes,
+ *         `-1` on failure.
  */
 int zcm_socket_recv_bytes(zcm_socket_t *sock, void *buf, size_t buf_len, size_t *out_len);
 
+/**
+ * @brief Receive every queued raw frame, up to `max`, in one call.
+ *
+ * Byte-level counterpart of zcm_socket_recv_many(): frame `i` is stored at
+ * `bufs + i * slot_len`, truncated to `slot_len` bytes, with its stored size
+ * in `lens[i]`.
+ *
+ * @param sock Socket wrapper.
+ * @param bufs Destination buffer of `max * slot_len` bytes.
+ * @param slot_len Capacity of each frame slot in bytes.
+ * @param lens Output array of stored byte counts (at least `max`).
+ * @param max Number of slots.
+ * @param timeout_ms Maximum wait for the first frame in milliseconds, or `-1`
+ *                   to block as zcm_socket_recv_bytes() does.
+ * @return Number of frames received, `0` on timeout, `-1` on error.
+ */
+int zcm_socket_recv_many_bytes(zcm_socket_t *sock, void *bufs, size_t slot_len, size_t *lens,
+                               size_t max, int timeout_ms);
+
+/** @brief zcm_socket_send_frames() flag: more frames of the message follow in a later call. */
+#define ZCM_FRAME_MORE 1
+
+/**
+ * @brief One frame of a multipart send (see zcm_socket_send_frames()).
+ *
+ * Without `release` the bytes are copied at send time. With `release` the
+ * buffer is handed to ØMQ without a copy and must stay valid and unchanged
+ * until `release(data, hint)` is called, possibly from an I/O thread.
+ */
+typedef struct zcm_iov {
+  /** @brief Frame bytes. Can be `NULL` when `len == 0`. */
+  const void *data;
+  /** @brief Frame size in bytes. */
+  size_t len;
+  /** @brief Optional release callback enabling a zero-copy send. */
+  void (*release)(void *data, void *hint);
+  /** @brief Opaque argument passed to `release`. */
+  void *hint;
+} zcm_iov_t;
+
+/**
+ * @brief A received raw frame (see zcm_socket_recv_frame()).
+ *
+ * Zero-initialize (or use ::ZCM_FRAME_INIT) before the first receive.
+ */
+typedef struct zcm_frame {
+  /** @brief Frame bytes, valid until the frame is released or reused. */
+  const void *data;
+  /** @brief True frame size in bytes. */
+  size_t size;
+  /** @brief Non-zero when more frames of the same message follow. */
+  int more;
+  /** @brief Library-owned frame storage; do not touch. */
+  void *impl;
+} zcm_frame_t;
+
+/** @brief Initializer for an empty ::zcm_frame_t. */
+#define ZCM_FRAME_INIT {NULL, 0, 0, NULL}
+
+/**
+ * @brief Send a multipart message from several buffers.
+ *
+ * Each entry goes out as one frame of the same message, so topic + payload or
+ * header + body framing needs no concatenation. Frames carrying a `release`
+ * callback are sent zero-copy; their ownership passes to the library even when
+ * the call fails. Every frame is checked before the first is sent, so a bad
+ * entry sends nothing. Any pending coalesced batch is flushed first.
+ *
+ * @param sock Socket wrapper.
+ * @param frames Frames to send, in order.
+ * @param count Number of frames (at least 1).
+ * @param flags `0`, or ::ZCM_FRAME_MORE to continue the message in a later call.
+ * @return `0` on success, `-1` on failure.
+ */
+int zcm_socket_send_frames(zcm_socket_t *sock, const zcm_iov_t *frames, size_t count, int flags);
+
+/**
+ * @brief Receive one raw frame without copying it.
+ *
+ * `frame->data` points into the ØMQ frame and `frame->size` is its full size.
+ * A frame previously received into `frame` is released first, so a receive
+ * loop reuses the same storage. Check `frame->more` to read the rest of a
+ * multipart message. Raw receives bypass batch unpacking; do not interleave
+ * them with zcm_socket_recv_msg() on a socket carrying batch frames.
+ *
+ * @param sock Socket wrapper.
+ * @param frame Frame to fill; release it with zcm_frame_release().
+ * @return `0` on success, `-1` on failure or timeout.
+ */
+int zcm_socket_recv_frame(zcm_socket_t *sock, zcm_frame_t *frame);
+
+/**
+ * @brief Release a frame from zcm_socket_recv_frame().
+ *
+ * Safe on an empty or already released frame. Leaves it empty.
+ *
+ * @param frame Frame to release.
+ */
+void zcm_frame_release(zcm_frame_t *frame);
+
 /**
  * @brief Configure receive/send socket timeouts.
  *
@@ -281,6 +782,53 @@ int zcm_socket_recv_bytes(zcm_socket_t *sock, void *buf, size_t buf_len, size_t
  */
 int zcm_socket_set_timeouts(zcm_socket_t *sock, int ms);
 
+/**
+ * @brief Tunable socket options (see zcm_socket_set_option()).
+ *
+ * Each maps to the ØMQ option of the same name. Queue limits, kernel buffers,
+ * conflation and affinity only affect connections made after they are set,
+ * so set them before zcm_socket_bind()/zcm_socket_connect().
+ */
+typedef enum {
+  /** Send high-water mark in messages (`>= 0`, `0` = unlimited). */
+  ZCM_SOCKOPT_SNDHWM = 1,
+  /** Receive high-water mark in messages (`>= 0`, `0` = unlimited). */
+  ZCM_SOCKOPT_RCVHWM = 2,
+  /** Kernel send buffer in bytes (`-1` = OS default). */
+  ZCM_SOCKOPT_SNDBUF = 3,
+  /** Kernel receive buffer in bytes (`-1` = OS default). */
+  ZCM_SOCKOPT_RCVBUF = 4,
+  /** Keep only the latest message per queue (`0` or `1`; PUB/SUB/PUSH/PULL).
+   *  inproc pipes take it from the connecting socket. */
+  ZCM_SOCKOPT_CONFLATE = 5,
+  /** Bitmask of context I/O threads serving new connections (`0` = any). */
+  ZCM_SOCKOPT_AFFINITY = 6,
+  /** TCP keepalive: `1` on, `0` off, `-1` OS default. */
+  ZCM_SOCKOPT_TCP_KEEPALIVE = 7,
+  /** Largest inbound message in bytes; bigger peers are disconnected (`-1` = no limit). */
+  ZCM_SOCKOPT_MAXMSGSIZE = 8
+} zcm_socket_option_t;
+
+/**
+ * @brief Set a tunable socket option.
+ *
+ * @param sock Socket wrapper.
+ * @param opt Option to set.
+ * @param value New value, checked against the range documented for `opt`.
+ * @return `0` on success, `-1` on invalid option, value or socket type.
+ */
+int zcm_socket_set_option(zcm_socket_t *sock, zcm_socket_option_t opt, int64_t value);
+
+/**
+ * @brief Read back a tunable socket option.
+ *
+ * @param sock Socket wrapper.
+ * @param opt Option to read.
+ * @param out_value Output value.
+ * @return `0` on success, `-1` on invalid arguments.
+ */
+int zcm_socket_get_option(zcm_socket_t *sock, zcm_socket_option_t opt, int64_t *out_value);
+
 /** @} */
 
 #ifdef __cplusplus
@@ -0,0 +1,180 @@
+#ifndef ZCM_ZCM_POLLER_H
+#define ZCM_ZCM_POLLER_H
+
+/**
+ * @file zcm_poller.h
+ * @brief Readiness multiplexing over many sockets, with timers, on one thread.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+#include "zcm_node.h"
+
+/** @addtogroup zcm_low_level
+ * @{
+ */
+
+/** @brief Opaque poller handle. */
+typedef struct zcm_poller zcm_poller_t;
+
+/** @brief Readable: a receive will not block. */
+#define ZCM_POLL_IN 1
+/** @brief Writable: a send will not block. */
+#define ZCM_POLL_OUT 2
+/** @brief Error condition (plain file descriptors only). */
+#define ZCM_POLL_ERR 4
+
+/**
+ * @brief One ready entry reported by zcm_poller_wait().
+ */
+typedef struct zcm_poll_event {
+  /** Ready socket, or `NULL` for a file descriptor entry. */
+  zcm_socket_t *sock;
+  /** Ready file descriptor, or `-1` for a socket entry. */
+  int fd;
+  /** Ready conditions (`ZCM_POLL_*`). */
+  int events;
+  /** Pointer given when the entry was added. */
+  void *user;
+} zcm_poll_event_t;
+
+/**
+ * @brief Timer callback, run from zcm_poller_wait().
+ *
+ * The callback may add or cancel timers and add or remove entries, including
+ * cancelling its own timer.
+ *
+ * @param poller Poller running the timer.
+ * @param timer_id Identifier returned by zcm_poller_add_timer().
+ * @param user Pointer given to zcm_poller_add_timer().
+ */
+typedef void (*zcm_poller_timer_fn)(zcm_poller_t *poller, int timer_id, void *user);
+
+/**
+ * @brief Create an empty poller.
+ *
+ * A poller is not thread-safe: add, remove and wait from one thread.
+ *
+ * @return Poller handle, or `NULL` on allocation failure.
+ */
+zcm_poller_t *zcm_poller_new(void);
+
+/**
+ * @brief Free a poller and its timers. Registered sockets are not closed.
+ *
+ * @param poller Poller to free. `NULL` is allowed.
+ */
+void zcm_poller_free(zcm_poller_t *poller);
+
+/**
+ * @brief Watch a socket, or change the events of a watched one.
+ *
+ * A socket holding unread messages of a received batch frame (see
+ * zcm_socket_recv_msg()) reports ::ZCM_POLL_IN even though ØMQ has nothing
+ * queued. A coalescing PUB or PUSH socket (zcm_socket_set_coalesce()) has its
+ * pending batch sent by zcm_poller_wait() once it is due. Such a socket never
+ * becomes readable, so watching it with ::ZCM_POLL_IN only does that.
+ *
+ * @param poller Poller.
+ * @param sock Socket to watch; must stay open while registered.
+ * @param events `ZCM_POLL_IN` and/or `ZCM_POLL_OUT`.
+ * @param user Pointer reported with the socket's events.
+ * @return `0` on success, `-1` on invalid arguments or allocation failure.
+ */
+int zcm_poller_add(zcm_poller_t *poller, zcm_socket_t *sock, int events, void *user);
+
+/**
+ * @brief Watch a plain file descriptor, or change the events of a watched one.
+ *
+ * Useful for application descriptors and for zcm_node_async_fd().
+ *
+ * @param poller Poller.
+ * @param fd File descriptor.
+ * @param events `ZCM_POLL_IN` and/or `ZCM_POLL_OUT`.
+ * @param user Pointer reported with the descriptor's events.
+ * @return `0` on success, `-1` on invalid arguments or allocation failure.
+ */
+int zcm_poller_add_fd(zcm_poller_t *poller, int fd, int events, void *user);
+
+/**
+ * @brief Stop watching a socket.
+ *
+ * @param poller Poller.
+ * @param sock Registered socket.
+ * @return `0` on success, `-1` when `sock` is not registered.
+ */
+int zcm_poller_remove(zcm_poller_t *poller, zcm_socket_t *sock);
+
+/**
+ * @brief Stop watching a file descriptor.
+ *
+ * @param poller Poller.
+ * @param fd Registered file descriptor.
+ * @return `0` on success, `-1` when `fd` is not registered.
+ */
+int zcm_poller_remove_fd(zcm_poller_t *poller, int fd);
+
+/**
+ * @brief Number of watched sockets and file descriptors.
+ *
+ * @param poller Poller.
+ * @return Entry count, `0` for `NULL`.
+ */
+size_t zcm_poller_size(const zcm_poller_t *poller);
+
+/**
+ * @brief Arm a timer.
+ *
+ * Timers live on a hashed wheel with millisecond ticks: arming is constant
+ * time and expiry only visits the slots of elapsed ticks. A repeating timer
+ * that falls behind skips the missed periods instead of firing in a burst.
+ *
+ * @param poller Poller.
+ * @param delay_ms Delay before the first expiry (`>= 0`).
+ * @param interval_ms Period of a repeating timer, or `0` for a one-shot.
+ * @param fn Callback.
+ * @param user Pointer passed to `fn`.
+ * @return Timer identifier (`> 0`), or `-1` on failure.
+ */
+int zcm_poller_add_timer(zcm_poller_t *poller, int delay_ms, int interval_ms,
+                         zcm_poller_timer_fn fn, void *user);
+
+/**
+ * @brief Cancel a timer. One-shot timers are released once they have fired.
+ *
+ * @param poller Poller.
+ * @param timer_id Identifier returned by zcm_poller_add_timer().
+ * @return `0` on success, `-1` when the timer does not exist (any more).
+ */
+int zcm_poller_cancel_timer(zcm_poller_t *poller, int timer_id);
+
+/**
+ * @brief Wait for readiness, running due timers meanwhile.
+ *
+ * Returns once at least one entry is ready, once timers have fired, or
+ * after `timeout_ms`. The wait never sleeps past the next timer expiry or
+ * past the next coalesced batch deadline of a watched socket, and sends the
+ * batches that are due.
+ *
+ * @param poller Poller.
+ * @param events Output array for ready entries.
+ * @param max Capacity of `events`; further ready entries are reported by the
+ *            next call.
+ * @param timeout_ms Maximum wait in milliseconds, `0` to poll, `-1` to wait
+ *                   indefinitely.
+ * @return Number of entries written (`0` on timeout or after timers only),
+ *         or `-1` on failure.
+ */
+int zcm_poller_wait(zcm_poller_t *poller, zcm_poll_event_t *events, size_t max, int timeout_ms);
+
+/** @} */
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* ZCM_ZCM_POLLER_H */
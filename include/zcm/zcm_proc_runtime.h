@@ -60,6 +60,22 @@ typedef struct zcm_proc_data_socket_cfg {
   char payload[256];
   /** Publish/push loop period in milliseconds. */
   int interval_ms;
+  /** Send high-water mark (`@sndHwm`), `-1` keeps the ØMQ default. */
+  int snd_hwm;
+  /** Receive high-water mark (`@rcvHwm`), `-1` keeps the ØMQ default. */
+  int rcv_hwm;
+  /** Kernel send buffer in bytes (`@sndBuf`), `-1` keeps the OS default. */
+  int snd_buf;
+  /** Kernel receive buffer in bytes (`@rcvBuf`), `-1` keeps the OS default. */
+  int rcv_buf;
+  /** Non-zero to keep only the latest message (`@conflate`). */
+  int conflate;
+  /** I/O thread bitmask (`@affinity`), `0` for any thread. */
+  uint64_t affinity;
+  /** TCP keepalive (`@tcpKeepalive`): `1` on, `0` off, `-1` OS default. */
+  int tcp_keepalive;
+  /** Largest accepted inbound message (`@maxMsgSize`), `-1` for no limit. */
+  int64_t max_msg_size;
 } zcm_proc_data_socket_cfg_t;
 
 /**
@@ -76,6 +92,22 @@ typedef enum zcm_proc_type_arg_kind {
   ZCM_PROC_TYPE_ARG_INT = 4
 } zcm_proc_type_arg_kind_t;
 
+/**
+ * @brief Decode plan compiled from a handler signature at config load.
+ */
+typedef struct zcm_proc_type_plan {
+  /** Non-zero once zcm_proc_runtime_compile_type_plan() filled the plan. */
+  int compiled;
+  /** Expected payload item tag (`ZCM_MSG_ITEM_*`) for each argument. */
+  uint8_t tags[ZCM_PROC_TYPE_HANDLER_ARG_MAX];
+  /** Payload bytes after the tag for each argument (`4` = text length prefix). */
+  uint8_t widths[ZCM_PROC_TYPE_HANDLER_ARG_MAX];
+  /** Payload byte count when every text argument is empty. */
+  size_t min_len;
+  /** Number of text arguments (`0` means `min_len` is the exact length). */
+  size_t text_count;
+} zcm_proc_type_plan_t;
+
 /**
  * @brief One configured typed request handler signature.
  */
@@ -88,8 +120,40 @@ typedef struct zcm_proc_type_handler_cfg {
   size_t arg_count;
   /** Raw format string from config (if provided). */
   char format[256];
+  /** Compiled payload decode plan for `args`. */
+  zcm_proc_type_plan_t plan;
+  /** Interned type ID of `name` (zcm_msg_type_id()), set at config load. */
+  uint32_t type_id;
 } zcm_proc_type_handler_cfg_t;
 
+/**
+ * @brief One decoded TYPE request argument.
+ */
+typedef struct zcm_proc_type_arg_value {
+  /** Argument kind (matches the handler signature). */
+  zcm_proc_type_arg_kind_t kind;
+  /** Text pointer for `ZCM_PROC_TYPE_ARG_TEXT` (message-owned, not null-terminated). */
+  const char *text;
+  /** Text length in bytes for `text`. */
+  uint32_t text_len;
+  /** Value for `ZCM_PROC_TYPE_ARG_DOUBLE`. */
+  double d;
+  /** Value for `ZCM_PROC_TYPE_ARG_FLOAT`. */
+  float f;
+  /** Value for `ZCM_PROC_TYPE_ARG_INT`. */
+  int32_t i;
+} zcm_proc_type_arg_value_t;
+
+/**
+ * @brief Decoded arguments of one TYPE request.
+ */
+typedef struct zcm_proc_type_args {
+  /** Decoded values in signature order. */
+  zcm_proc_type_arg_value_t values[ZCM_PROC_TYPE_HANDLER_ARG_MAX];
+  /** Number of valid entries in `values`. */
+  size_t count;
+} zcm_proc_type_args_t;
+
 /**
  * @brief Parsed runtime config for one `zcm_proc` instance.
  */
@@ -159,10 +223,78 @@ const zcm_proc_type_handler_cfg_t *zcm_proc_runtime_find_type_handler(
     const zcm_proc_runtime_cfg_t *cfg,
     const char *type_name);
 
+/**
+ * @brief Find the TYPE handler for a received message.
+ *
+ * Matches the message type ID against the interned handler IDs first, then
+ * falls back to the case-insensitive name match of
+ * zcm_proc_runtime_find_type_handler().
+ *
+ * @param cfg Runtime config to inspect.
+ * @param msg Received message.
+ * @return Matching handler pointer, or `NULL` if not found.
+ */
+const zcm_proc_type_handler_cfg_t *zcm_proc_runtime_find_type_handler_msg(
+    const zcm_proc_runtime_cfg_t *cfg,
+    const zcm_msg_t *msg);
+
+/**
+ * @brief Compile a handler signature into its decode plan.
+ *
+ * zcm_proc_runtime_load_config() compiles every handler it loads; call this
+ * after filling `args`/`arg_count` by hand.
+ *
+ * @param handler Handler to compile in place.
+ * @return `0` on success, `-1` on invalid signature.
+ */
+int zcm_proc_runtime_compile_type_plan(zcm_proc_type_handler_cfg_t *handler);
+
+/**
+ * @brief Decode a TYPE request payload with the handler's compiled plan.
+ *
+ * The whole payload signature is checked in one pass (length bound first,
+ * then item tags) and the values are written to `out`. Text values point
+ * into `msg` storage. The message read cursor is not used.
+ *
+ * @param msg Input message with encoded payload values.
+ * @param handler Handler with compiled plan.
+ * @param out Output decoded arguments.
+ * @return `0` on success, `-1` when the payload does not match the signature.
+ */
+int zcm_proc_runtime_decode_type_args(const zcm_msg_t *msg,
+                                      const zcm_proc_type_handler_cfg_t *handler,
+                                      zcm_proc_type_args_t *out);
+
+/**
+ * @brief Format decoded TYPE arguments as a human-readable summary.
+ *
+ * Produces `text=..., double=..., ...` in signature order.
+ *
+ * @param args Decoded arguments.
+ * @param summary Output text buffer.
+ * @param summary_size Size of `summary` in bytes.
+ * @return `0` on success, `-1` on invalid input.
+ */
+int zcm_proc_runtime_format_type_args(const zcm_proc_type_args_t *args,
+                                      char *summary,
+                                      size_t summary_size);
+
+/**
+ * @brief Whether daemons should log decoded TYPE payload summaries.
+ *
+ * Controlled by `ZCM_PROC_LOG_PAYLOAD` (`1` default, `0` disables). When
+ * disabled, request logs omit the summary and it is never formatted.
+ *
+ * @return Non-zero when payload summaries should be logged.
+ */
+int zcm_proc_runtime_log_payloads(void);
+
 /**
  * @brief Decode a message payload according to one TYPE handler signature.
  *
- * On success, a human-readable summary is written to `summary`.
+ * Convenience wrapper over zcm_proc_runtime_decode_type_args() and
+ * zcm_proc_runtime_format_type_args(). On success, a human-readable summary
+ * is written to `summary`.
  *
  * @param msg Input message with encoded payload values.
  * @param handler Expected type signature used for decoding.
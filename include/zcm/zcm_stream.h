@@ -0,0 +1,221 @@
+#ifndef ZCM_ZCM_STREAM_H
+#define ZCM_ZCM_STREAM_H
+
+/**
+ * @file zcm_stream.h
+ * @brief Chunked streaming of BYTES/ARRAY payloads larger than one message.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "zcm_msg.h"
+#include "zcm_node.h"
+
+/** @addtogroup zcm_low_level
+ * @{
+ */
+
+/** @brief Opaque sending side of a stream. */
+typedef struct zcm_stream_writer zcm_stream_writer_t;
+/** @brief Opaque receiving side of a stream. */
+typedef struct zcm_stream_reader zcm_stream_reader_t;
+
+/** @brief `total` value announcing a stream of unknown length. */
+#define ZCM_STREAM_SIZE_UNKNOWN UINT64_MAX
+
+/**
+ * @brief Stream tuning passed to zcm_stream_writer_new().
+ *
+ * Zero fields select the defaults.
+ */
+typedef struct zcm_stream_opts {
+  /** Payload bytes per chunk message (default 1 MiB, at most 64 MiB). */
+  size_t chunk_size;
+  /** Chunks in flight before the writer waits for an acknowledgement (default 8). */
+  uint32_t window;
+} zcm_stream_opts_t;
+
+/**
+ * @brief Stream header announced by the writer.
+ */
+typedef struct zcm_stream_info {
+  /** Writer-chosen stream identifier. */
+  uint64_t id;
+  /** Total payload bytes, or `ZCM_STREAM_SIZE_UNKNOWN`. */
+  uint64_t total;
+  /** Element type of an array stream, or `0` for a BYTES stream. */
+  zcm_msg_array_type_t elem_type;
+  /** Chunk size used by the writer. */
+  uint32_t chunk_size;
+  /** Flow-control window used by the writer. */
+  uint32_t window;
+  /** Application name of the stream (may be empty). */
+  char name[64];
+} zcm_stream_info_t;
+
+/**
+ * @brief One received chunk.
+ *
+ * `data` points into the received frame and stays valid until the next
+ * zcm_stream_read_chunk() call or zcm_stream_reader_free().
+ */
+typedef struct zcm_stream_chunk {
+  /** Byte offset of `data` within the stream. */
+  uint64_t offset;
+  /** Chunk bytes (host-order elements for array streams). */
+  const void *data;
+  /** Size of `data` in bytes. */
+  size_t len;
+  /** Non-zero for the final chunk. */
+  int last;
+} zcm_stream_chunk_t;
+
+/**
+ * @brief Incremental sink called for every chunk by zcm_stream_read().
+ *
+ * @param user Opaque pointer passed to zcm_stream_read().
+ * @param offset Byte offset of `data` within the stream.
+ * @param data Chunk bytes (valid only during the call).
+ * @param len Size of `data` in bytes.
+ * @return `0` to continue, non-zero to stop with an error.
+ */
+typedef int (*zcm_stream_sink_fn)(void *user, uint64_t offset, const void *data, size_t len);
+
+/**
+ * @brief Create a stream writer.
+ *
+ * Supported socket pairings:
+ * - `data` REQ, `ack` `NULL`: chunks are sent as batch frames of up to
+ *   `window` chunks and each batch waits for the REP side's acknowledgement.
+ * - `data` PUSH, `ack` PULL: chunks are sent as they fill and the writer
+ *   blocks once `window` chunks are unacknowledged; the reader acknowledges
+ *   every half window through its PUSH socket.
+ * - `data` PUSH, `ack` `NULL`: no acknowledgements; flow control is left to
+ *   the socket high-water mark.
+ *
+ * Waiting for acknowledgements honours the receive timeout of the socket
+ * they arrive on (zcm_socket_set_timeouts()). The sockets stay owned by the
+ * caller and must outlive the writer.
+ *
+ * @param data Socket carrying the chunks.
+ * @param ack Socket receiving acknowledgements, or `NULL`.
+ * @param name Application stream name (may be `NULL`).
+ * @param elem_type Array element type, or `0` for a BYTES stream.
+ * @param total Total payload bytes, or `ZCM_STREAM_SIZE_UNKNOWN`.
+ * @param opts Tuning, or `NULL` for defaults.
+ * @return Writer handle, or `NULL` on invalid arguments or allocation failure.
+ */
+zcm_stream_writer_t *zcm_stream_writer_new(zcm_socket_t *data, zcm_socket_t *ack,
+                                           const char *name,
+                                           zcm_msg_array_type_t elem_type,
+                                           uint64_t total,
+                                           const zcm_stream_opts_t *opts);
+
+/**
+ * @brief Append payload bytes to the stream.
+ *
+ * Bytes are staged in one chunk buffer and sent whenever it fills, so the
+ * writer never holds more than one chunk (REQ: one window) of payload. Array
+ * streams take host-order elements and must be written in whole elements.
+ *
+ * @param w Stream writer.
+ * @param data Payload bytes.
+ * @param len Size of `data` in bytes.
+ * @return `0` on success, `-1` on failure.
+ */
+int zcm_stream_write(zcm_stream_writer_t *w, const void *data, size_t len);
+
+/**
+ * @brief Send the final chunk and wait until the reader acknowledged it.
+ *
+ * Fails when a known `total` does not match the bytes written.
+ *
+ * @param w Stream writer.
+ * @return `0` on success, `-1` on failure.
+ */
+int zcm_stream_writer_finish(zcm_stream_writer_t *w);
+
+/**
+ * @brief Free a writer (does not send anything).
+ *
+ * @param w Writer to free. `NULL` is allowed.
+ */
+void zcm_stream_writer_free(zcm_stream_writer_t *w);
+
+/**
+ * @brief Create a stream reader.
+ *
+ * Pair `data` REP with a REQ writer, or `data` PULL with a PUSH writer; `ack`
+ * is the PUSH socket feeding the writer's acknowledgement PULL, or `NULL`
+ * when the writer has none.
+ *
+ * @param data Socket receiving chunks.
+ * @param ack Socket sending acknowledgements, or `NULL`.
+ * @return Reader handle, or `NULL` on invalid arguments or allocation failure.
+ */
+zcm_stream_reader_t *zcm_stream_reader_new(zcm_socket_t *data, zcm_socket_t *ack);
+
+/**
+ * @brief Receive the next chunk.
+ *
+ * A chunk is acknowledged when the next call is made, so the writer window
+ * bounds how far it can run ahead of the caller's processing.
+ *
+ * @param r Stream reader.
+ * @param chunk Output chunk view.
+ * @return `1` when a chunk was returned, `0` once the final chunk has been
+ * consumed and acknowledged, `-1` on failure (timeout, sequence gap, foreign
+ * stream, malformed chunk, a chunk not starting where the previous one ended,
+ * or data past a declared total).
+ */
+int zcm_stream_read_chunk(zcm_stream_reader_t *r, zcm_stream_chunk_t *chunk);
+
+/**
+ * @brief Receive the whole stream into an incremental sink.
+ *
+ * @param r Stream reader.
+ * @param sink Called once per chunk, in offset order.
+ * @param user Opaque pointer passed to `sink`.
+ * @return `0` on success, `-1` on failure or when `sink` stopped the stream.
+ */
+int zcm_stream_read(zcm_stream_reader_t *r, zcm_stream_sink_fn sink, void *user);
+
+/**
+ * @brief Receive the whole stream into a file.
+ *
+ * Chunks are written at their stream offset as they arrive; the file is
+ * created or truncated.
+ *
+ * @param r Stream reader.
+ * @param path Destination file path.
+ * @return `0` on success, `-1` on failure.
+ */
+int zcm_stream_read_to_file(zcm_stream_reader_t *r, const char *path);
+
+/**
+ * @brief Get the stream header once the first chunk call has run.
+ *
+ * @param r Stream reader.
+ * @return Stream header, or `NULL` before the header was received.
+ */
+const zcm_stream_info_t *zcm_stream_reader_info(const zcm_stream_reader_t *r);
+
+/**
+ * @brief Free a reader.
+ *
+ * @param r Reader to free. `NULL` is allowed.
+ */
+void zcm_stream_reader_free(zcm_stream_reader_t *r);
+
+/** @} */
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* ZCM_ZCM_STREAM_H */
@@ -40,6 +40,8 @@ struct zcm_broker {
   int remote_probe_interval_ms;
   int remote_probe_failures_before_drop;
   int trace_reg;
+  /* Bound PULL endpoint for binary metrics reports; NULL when disabled. */
+  char *metrics_endpoint;
   pthread_t thread;
   int running;
   struct zcm_broker_entry *head;
@@ -63,6 +65,12 @@ static int build_tcp_endpoint_text(const char *host, int port,
 #define ZCM_BROKER_REMOTE_PROBE_FAILS_MIN 1
 #define ZCM_BROKER_REMOTE_PROBE_FAILS_MAX 20
 #define ZCM_BROKER_STOP_ACK_GRACE_US 100000
+#define ZCM_BROKER_BIND_RETRIES 40
+#define ZCM_BROKER_BIND_RETRY_US 50000
+/* Names accepted in one LOOKUP_MANY request. */
+#define ZCM_BROKER_LOOKUP_MANY_MAX 256
+/* Metrics frames applied per wakeup, so a burst cannot starve the REP loop. */
+#define ZCM_BROKER_METRICS_DRAIN_MAX 256
 
 static const char *k_broker_stop_reply = "zcm_broker: stopped";
 
@@ -756,27 +764,28 @@ static int query_proc_command_once(zcm_context_t *ctx, const char *endpoint,
   zcm_socket_set_timeouts(req, 50);
   if (zcm_socket_connect(req, endpoint) != 0) goto out;
 
-  zcm_msg_t *q = zcm_msg_new();
+  zcm_msg_pool_t *pool = zcm_msg_pool_thread();
+  zcm_msg_t *q = zcm_msg_pool_acquire(pool);
   if (!q) goto out;
   zcm_msg_set_type(q, "ZCM_CMD");
   if (zcm_msg_put_text(q, cmd) != 0) {
-    zcm_msg_free(q);
+    zcm_msg_pool_release(pool, q);
     goto out;
   }
   if (include_code_field && zcm_msg_put_int(q, 200) != 0) {
-    zcm_msg_free(q);
+    zcm_msg_pool_release(pool, q);
     goto out;
   }
   if (zcm_socket_send_msg(req, q) != 0) {
-    zcm_msg_free(q);
+    zcm_msg_pool_release(pool, q);
     goto out;
   }
-  zcm_msg_free(q);
+  zcm_msg_pool_release(pool, q);
 
-  zcm_msg_t *reply = zcm_msg_new();
+  zcm_msg_t *reply = zcm_msg_pool_acquire(pool);
   if (!reply) goto out;
-  if (zcm_socket_recv_msg(req, reply) != 0) {
-    zcm_msg_free(reply);
+  if (zcm_socket_recv_msg_view(req, reply) != 0) {
+    zcm_msg_pool_release(pool, reply);
     goto out;
   }
 
@@ -806,7 +815,7 @@ static int query_proc_command_once(zcm_context_t *ctx, const char *endpoint,
     }
   }
 
-  zcm_msg_free(reply);
+  zcm_msg_pool_release(pool, reply);
 
 out:
   zcm_socket_free(req);
@@ -1059,16 +1068,151 @@ static int broker_recv_part_text(void *sock, char *out, size_t out_size) {
   return 0;
 }
 
+static void entry_apply_reported_role(struct zcm_broker_entry *e, const char *role) {
+  if (role[0] && strcmp(role, "-") != 0 && role_is_valid(role)) {
+    snprintf(e->role, sizeof(e->role), "%s", role);
+  }
+}
+
+static uint16_t rd_le16(const uint8_t *p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t rd_le32(const uint8_t *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+         ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/* Applies one binary metrics report frame (see docs/message-format.md).
+ * The frame is validated whole first, so a malformed one changes nothing;
+ * records for unknown names are skipped. */
+static int broker_apply_metrics_frame(struct zcm_broker *b, const uint8_t *p, size_t len) {
+  if (len < ZCM_NODE_METRICS_HEADER_SIZE || memcmp(p, ZCM_NODE_METRICS_MAGIC, 4) != 0 ||
+      rd_le16(p + 4) != ZCM_NODE_METRICS_VERSION) {
+    return -1;
+  }
+  size_t count = rd_le16(p + 6);
+  size_t off = ZCM_NODE_METRICS_HEADER_SIZE;
+  for (size_t i = 0; i < count; i++) {
+    if (len - off < ZCM_NODE_METRICS_RECORD_SIZE) return -1;
+    size_t name_len = rd_le16(p + off);
+    size_t role_len = rd_le16(p + off + 2);
+    if (name_len == 0 || name_len > ZCM_NODE_METRICS_NAME_MAX ||
+        role_len > ZCM_NODE_METRICS_ROLE_MAX) {
+      return -1;
+    }
+    off += ZCM_NODE_METRICS_RECORD_SIZE;
+    if (len - off < name_len + role_len) return -1;
+    off += name_len + role_len;
+  }
+  if (off != len) return -1;
+
+  int applied = 0;
+  off = ZCM_NODE_METRICS_HEADER_SIZE;
+  for (size_t i = 0; i < count; i++) {
+    const uint8_t *rec = p + off;
+    size_t name_len = rd_le16(rec);
+    size_t role_len = rd_le16(rec + 2);
+    char name[ZCM_NODE_METRICS_NAME_MAX + 1];
+    char role[ZCM_NODE_METRICS_ROLE_MAX + 1];
+    memcpy(name, rec + ZCM_NODE_METRICS_RECORD_SIZE, name_len);
+    name[name_len] = '\0';
+    memcpy(role, rec + ZCM_NODE_METRICS_RECORD_SIZE + name_len, role_len);
+    role[role_len] = '\0';
+    off += ZCM_NODE_METRICS_RECORD_SIZE + name_len + role_len;
+
+    struct zcm_broker_entry *e = entry_find(b, name);
+    if (!e) continue;
+    entry_apply_reported_role(e, role);
+    e->pub_port = (int32_t)rd_le32(rec + 4);
+    e->push_port = (int32_t)rd_le32(rec + 8);
+    e->pub_bytes = (int32_t)rd_le32(rec + 12);
+    e->sub_bytes = (int32_t)rd_le32(rec + 16);
+    e->push_bytes = (int32_t)rd_le32(rec + 20);
+    e->pull_bytes = (int32_t)rd_le32(rec + 24);
+    applied++;
+  }
+  return applied;
+}
+
+/* Binds the PULL socket for binary metrics reports: the
+ * ZCM_BROKER_METRICS_ENDPOINT override if set (`none` disables it), else an
+ * ephemeral port on the broker's TCP host, else `<endpoint>.metrics`. */
+static void *broker_bind_metrics(struct zcm_broker *b) {
+  char want[600];
+  const char *env = getenv("ZCM_BROKER_METRICS_ENDPOINT");
+  if (env && *env) {
+    if (strcmp(env, "none") == 0) return NULL;
+    snprintf(want, sizeof(want), "%s", env);
+  } else if (endpoint_has_scheme(b->endpoint, "tcp://")) {
+    char host[256] = {0};
+    int port = 0;
+    if (endpoint_tcp_parse_host_port(b->endpoint, host, sizeof(host), &port) != 0) return NULL;
+    snprintf(want, sizeof(want), "tcp://%s:*", host);
+  } else {
+    snprintf(want, sizeof(want), "%s.metrics", b->endpoint);
+  }
+
+  void *pull = zmq_socket(zcm_context_zmq(b->ctx), ZMQ_PULL);
+  if (!pull) return NULL;
+  int linger_ms = 0;
+  zmq_setsockopt(pull, ZMQ_LINGER, &linger_ms, sizeof(linger_ms));
+  char bound[600] = {0};
+  size_t bound_size = sizeof(bound);
+  if (zmq_bind(pull, want) != 0 ||
+      zmq_getsockopt(pull, ZMQ_LAST_ENDPOINT, bound, &bound_size) != 0) {
+    fprintf(stderr, "zcm_broker: metrics endpoint %s unavailable: %s\n", want,
+            zmq_strerror(zmq_errno()));
+    zmq_close(pull);
+    return NULL;
+  }
+  b->metrics_endpoint = strdup(bound);
+  if (!b->metrics_endpoint) {
+    zmq_close(pull);
+    return NULL;
+  }
+  return pull;
+}
+
+static void broker_drain_metrics(struct zcm_broker *b, void *pull) {
+  for (int i = 0; i < ZCM_BROKER_METRICS_DRAIN_MAX; i++) {
+    zmq_msg_t frame;
+    zmq_msg_init(&frame);
+    if (zmq_msg_recv(&frame, pull, ZMQ_DONTWAIT) < 0) {
+      zmq_msg_close(&frame);
+      break;
+    }
+    (void)broker_apply_metrics_frame(b, (const uint8_t *)zmq_msg_data(&frame), zmq_msg_size(&frame));
+    zmq_msg_close(&frame);
+  }
+}
+
 static void *broker_thread(void *arg) {
   struct zcm_broker *b = (struct zcm_broker *)arg;
   void *sock = zmq_socket(zcm_context_zmq(b->ctx), ZMQ_REP);
   if (!sock) return NULL;
-  if (zmq_bind(sock, b->endpoint) != 0) {
+  /* A broker restarted on the same endpoint can race the previous listener,
+   * which libzmq closes asynchronously; retry EADDRINUSE briefly. */
+  int bind_rc = zmq_bind(sock, b->endpoint);
+  for (int i = 0; bind_rc != 0 && zmq_errno() == EADDRINUSE &&
+                  i < ZCM_BROKER_BIND_RETRIES && b->running; i++) {
+    usleep(ZCM_BROKER_BIND_RETRY_US);
+    bind_rc = zmq_bind(sock, b->endpoint);
+  }
+  if (bind_rc != 0) {
     zmq_close(sock);
     return NULL;
   }
+  void *metrics = broker_bind_metrics(b);
 
   while (b->running) {
+    if (metrics) {
+      /* Metrics reports never get a reply; apply them between requests. */
+      zmq_pollitem_t items[2] = {{sock, 0, ZMQ_POLLIN, 0}, {metrics, 0, ZMQ_POLLIN, 0}};
+      if (zmq_poll(items, 2, -1) < 0) continue;
+      if (items[1].revents & ZMQ_POLLIN) broker_drain_metrics(b, metrics);
+      if (!(items[0].revents & ZMQ_POLLIN)) continue;
+    }
     zmq_msg_t part;
     zmq_msg_init(&part);
     int rc = zmq_msg_recv(&part, sock, 0);
@@ -1237,6 +1381,49 @@ static void *broker_thread(void *arg) {
         zmq_send(sock, e->host ? e->host : "", e->host ? strlen(e->host) : 0, ZMQ_SNDMORE);
         zmq_send(sock, pid_buf, strlen(pid_buf), 0);
       }
+    } else if (strcmp(cmd, "LOOKUP_MANY") == 0) {
+      /* One INFO-shaped record (status, endpoint, ctrl, host, pid) per name. */
+      char (*names)[256] = (char (*)[256])calloc(ZCM_BROKER_LOOKUP_MANY_MAX, sizeof(*names));
+      size_t count = 0;
+      int malformed = (names == NULL);
+      while (!malformed && broker_sock_has_more(sock)) {
+        if (count == ZCM_BROKER_LOOKUP_MANY_MAX ||
+            broker_recv_part_text(sock, names[count], sizeof(names[count])) != 0) {
+          malformed = 1;
+          break;
+        }
+        count++;
+      }
+      broker_sock_drain_remaining_parts(sock);
+      if (malformed || count == 0) {
+        free(names);
+        zmq_send(sock, "ERR_MALFORMED", 13, 0);
+        continue;
+      }
+
+      zmq_send(sock, "OK", 2, ZMQ_SNDMORE);
+      for (size_t i = 0; i < count; i++) {
+        int last = (i + 1 == count);
+        struct zcm_broker_entry *e = entry_find(b, names[i]);
+        if (!e) {
+          zmq_send(sock, "NOT_FOUND", 9, ZMQ_SNDMORE);
+          zmq_send(sock, "", 0, ZMQ_SNDMORE);
+          zmq_send(sock, "", 0, ZMQ_SNDMORE);
+          zmq_send(sock, "", 0, ZMQ_SNDMORE);
+          zmq_send(sock, "0", 1, last ? 0 : ZMQ_SNDMORE);
+          continue;
+        }
+        char pid_buf[32];
+        char endpoint[512] = {0};
+        entry_effective_endpoint(e, endpoint, sizeof(endpoint));
+        snprintf(pid_buf, sizeof(pid_buf), "%d", e->pid);
+        zmq_send(sock, "OK", 2, ZMQ_SNDMORE);
+        zmq_send(sock, endpoint, strlen(endpoint), ZMQ_SNDMORE);
+        zmq_send(sock, e->ctrl_endpoint ? e->ctrl_endpoint : "", e->ctrl_endpoint ? strlen(e->ctrl_endpoint) : 0, ZMQ_SNDMORE);
+        zmq_send(sock, e->host ? e->host : "", e->host ? strlen(e->host) : 0, ZMQ_SNDMORE);
+        zmq_send(sock, pid_buf, strlen(pid_buf), last ? 0 : ZMQ_SNDMORE);
+      }
+      free(names);
     } else if (strcmp(cmd, "UNREGISTER") == 0) {
       char name[256] = {0};
       RECV_PART_OR_REPLY_ERR(name);
@@ -1279,9 +1466,7 @@ static void *broker_thread(void *arg) {
       if (!e) {
         zmq_send(sock, "NOT_FOUND", 9, 0);
       } else {
-        if (role[0] && strcmp(role, "-") != 0 && role_is_valid(role)) {
-          snprintf(e->role, sizeof(e->role), "%s", role);
-        }
+        entry_apply_reported_role(e, role);
         int v = -1;
         if (parse_int_text(pub_port_str, &v) == 0) e->pub_port = v;
         if (parse_int_text(push_port_str, &v) == 0) e->push_port = v;
@@ -1291,6 +1476,14 @@ static void *broker_thread(void *arg) {
         if (parse_int_text(pull_bytes_str, &v) == 0) e->pull_bytes = v;
         zmq_send(sock, "OK", 2, 0);
       }
+    } else if (strcmp(cmd, "METRICS_ENDPOINT") == 0) {
+      broker_sock_drain_remaining_parts(sock);
+      if (!b->metrics_endpoint) {
+        zmq_send(sock, "NOT_FOUND", 9, 0);
+      } else {
+        zmq_send(sock, "OK", 2, ZMQ_SNDMORE);
+        zmq_send(sock, b->metrics_endpoint, strlen(b->metrics_endpoint), 0);
+      }
     } else if (strcmp(cmd, "PING") == 0) {
       broker_sock_drain_remaining_parts(sock);
       zmq_send(sock, "PONG", 4, 0);
@@ -1359,6 +1552,7 @@ static void *broker_thread(void *arg) {
 #undef RECV_PART_OR_REPLY_ERR
   }
 
+  if (metrics) zmq_close(metrics);
   zmq_close(sock);
   return NULL;
 }
@@ -1423,6 +1617,7 @@ void zcm_broker_stop(zcm_broker_t *broker) {
     entry_free(e);
     e = n;
   }
+  free(broker->metrics_endpoint);
   free(broker->endpoint);
   free(broker);
 }
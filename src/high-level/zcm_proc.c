@@ -9,6 +9,7 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <pthread.h>
+#include <sched.h>
 #include <sys/wait.h>
 #include <time.h>
 #include <unistd.h>
@@ -31,6 +32,22 @@
 #define ZCM_PROC_REANNOUNCE_BACKOFF_MAX_MS_MIN 1000
 #define ZCM_PROC_REANNOUNCE_BACKOFF_MAX_MS_MAX 300000
 
+#ifndef ZCM_PROC_LOOKUP_CACHE_MS_DEFAULT
+#define ZCM_PROC_LOOKUP_CACHE_MS_DEFAULT 0
+#endif
+
+#ifndef ZCM_PROC_LOOKUP_NEG_CACHE_MS_DEFAULT
+#define ZCM_PROC_LOOKUP_NEG_CACHE_MS_DEFAULT 0
+#endif
+
+#define ZCM_PROC_LOOKUP_CACHE_MS_MAX 600000
+
+/* Bounds for <context> attributes and their ZCM_PROC_* overrides. */
+#define ZCM_PROC_IO_THREADS_MAX 64
+#define ZCM_PROC_MAX_SOCKETS_MAX 1000000
+#define ZCM_PROC_THREAD_PRIORITY_MAX 99
+#define ZCM_PROC_THREAD_NAME_PREFIX_MAX 999999
+
 struct zcm_proc {
   zcm_context_t *ctx;
   zcm_node_t *node;
@@ -261,11 +278,155 @@ static int run_xmllint_xpath(const char *config_path, const char *xpath_expr,
   return 0;
 }
 
+/* "auto" I/O threads: half the online CPUs, leaving the rest to the
+ * application threads. */
+static int auto_io_threads(void) {
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  long n = (cpus > 1) ? cpus / 2 : 1;
+  if (n > ZCM_PROC_IO_THREADS_MAX) n = ZCM_PROC_IO_THREADS_MAX;
+  return (int)n;
+}
+
+/* CPU list such as "0-3,8,10-11". */
+static int parse_cpu_list(const char *text, zcm_context_opts_t *opts) {
+  if (!text || !*text) return -1;
+  size_t count = 0;
+  const char *p = text;
+  while (*p) {
+    char *end = NULL;
+    long first = strtol(p, &end, 10);
+    if (end == p || first < 0 || first > 4095) return -1;
+    long last = first;
+    p = end;
+    if (*p == '-') {
+      last = strtol(p + 1, &end, 10);
+      if (end == p + 1 || last < first || last > 4095) return -1;
+      p = end;
+    }
+    for (long cpu = first; cpu <= last; cpu++) {
+      if (count >= ZCM_CONTEXT_CPU_MAX) return -1;
+      opts->cpus[count++] = (int)cpu;
+    }
+    if (*p == ',') {
+      p++;
+      if (!*p) return -1;
+    } else if (*p) {
+      return -1;
+    }
+  }
+  opts->cpu_count = count;
+  return 0;
+}
+
+static int parse_sched_policy(const char *text, int *out) {
+  if (!text || !out) return -1;
+  if (strcasecmp(text, "other") == 0) { *out = SCHED_OTHER; return 0; }
+  if (strcasecmp(text, "fifo") == 0) { *out = SCHED_FIFO; return 0; }
+  if (strcasecmp(text, "rr") == 0) { *out = SCHED_RR; return 0; }
+#ifdef SCHED_BATCH
+  if (strcasecmp(text, "batch") == 0) { *out = SCHED_BATCH; return 0; }
+#endif
+#ifdef SCHED_IDLE
+  if (strcasecmp(text, "idle") == 0) { *out = SCHED_IDLE; return 0; }
+#endif
+  return -1;
+}
+
+/* <context> attributes, in the order of k_context_attrs. */
+typedef enum {
+  CONTEXT_IO_THREADS,
+  CONTEXT_IO_CPUS,
+  CONTEXT_MAX_SOCKETS,
+  CONTEXT_SCHED_POLICY,
+  CONTEXT_THREAD_PRIORITY,
+  CONTEXT_THREAD_NAME_PREFIX,
+  CONTEXT_ATTR_COUNT
+} context_attr_t;
+
+static const struct {
+  const char *attr;
+  const char *env;
+} k_context_attrs[CONTEXT_ATTR_COUNT] = {
+    {"ioThreads", "ZCM_PROC_IO_THREADS"},
+    {"ioCpus", "ZCM_PROC_IO_CPUS"},
+    {"maxSockets", "ZCM_PROC_MAX_SOCKETS"},
+    {"schedPolicy", "ZCM_PROC_IO_SCHED_POLICY"},
+    {"threadPriority", "ZCM_PROC_IO_THREAD_PRIORITY"},
+    {"threadNamePrefix", "ZCM_PROC_IO_THREAD_NAME_PREFIX"},
+};
+
+static int set_context_attr(zcm_context_opts_t *opts, context_attr_t which, const char *text) {
+  switch (which) {
+    case CONTEXT_IO_THREADS:
+      if (strcasecmp(text, "auto") == 0) {
+        opts->io_threads = auto_io_threads();
+        return 0;
+      }
+      return parse_positive_int_range(text, 1, ZCM_PROC_IO_THREADS_MAX, &opts->io_threads);
+    case CONTEXT_IO_CPUS:
+      return parse_cpu_list(text, opts);
+    case CONTEXT_MAX_SOCKETS:
+      return parse_positive_int_range(text, 1, ZCM_PROC_MAX_SOCKETS_MAX, &opts->max_sockets);
+    case CONTEXT_SCHED_POLICY:
+      return parse_sched_policy(text, &opts->thread_sched_policy);
+    case CONTEXT_THREAD_PRIORITY:
+      return parse_positive_int_range(text, 1, ZCM_PROC_THREAD_PRIORITY_MAX,
+                                      &opts->thread_priority);
+    case CONTEXT_THREAD_NAME_PREFIX:
+      return parse_positive_int_range(text, 1, ZCM_PROC_THREAD_NAME_PREFIX_MAX,
+                                      &opts->thread_name_prefix);
+    default:
+      return -1;
+  }
+}
+
+/* Read <context> with one xmllint run; attributes left out keep defaults. */
+static int load_context_config(const char *cfg_path, zcm_context_opts_t *opts) {
+  char xpath[1024];
+  int off = snprintf(xpath, sizeof(xpath), "concat(");
+  for (int k = 0; k < CONTEXT_ATTR_COUNT; k++) {
+    off += snprintf(xpath + off, sizeof(xpath) - (size_t)off,
+                    "%s/procConfig/process/context/@%s", k ? ",'|'," : "", k_context_attrs[k].attr);
+  }
+  snprintf(xpath + off, sizeof(xpath) - (size_t)off, ")");
+  char joined[512] = {0};
+  if (run_xmllint_xpath(cfg_path, xpath, joined, sizeof(joined)) != 0) return 0;
+
+  char *field = joined;
+  for (int k = 0; k < CONTEXT_ATTR_COUNT && field; k++) {
+    char *sep = strchr(field, '|');
+    if (sep) *sep = '\0';
+    if (field[0] && set_context_attr(opts, (context_attr_t)k, field) != 0) {
+      fprintf(stderr, "zcm_proc: invalid context@%s='%s' in %s\n",
+              k_context_attrs[k].attr, field, cfg_path);
+      return -1;
+    }
+    field = sep ? sep + 1 : NULL;
+  }
+  return 0;
+}
+
+/* ZCM_PROC_IO_* environment overrides; a bad value keeps the configured one. */
+static void load_context_env(zcm_context_opts_t *opts) {
+  for (int k = 0; k < CONTEXT_ATTR_COUNT; k++) {
+    const char *env = getenv(k_context_attrs[k].env);
+    if (!env || !*env) continue;
+    zcm_context_opts_t parsed = *opts;
+    if (set_context_attr(&parsed, (context_attr_t)k, env) == 0) {
+      *opts = parsed;
+    } else {
+      fprintf(stderr, "zcm_proc: invalid %s='%s', keeping configured value\n",
+              k_context_attrs[k].env, env);
+    }
+  }
+}
+
 static int load_proc_config(const char *name,
                             zcm_socket_type_t *data_type,
                             int *bind_data,
-                            int *ctrl_timeout_ms) {
-  if (!name || !data_type || !bind_data || !ctrl_timeout_ms) return -1;
+                            int *ctrl_timeout_ms,
+                            zcm_context_opts_t *ctx_opts) {
+  if (!name || !data_type || !bind_data || !ctrl_timeout_ms || !ctx_opts) return -1;
 
   const char *cfg_file = getenv("ZCM_PROC_CONFIG_FILE");
   char cfg_path[1024];
@@ -328,7 +489,7 @@ static int load_proc_config(const char *name,
     *ctrl_timeout_ms = (int)ms;
   }
 
-  return 0;
+  return load_context_config(cfg_path, ctx_opts);
 }
 
 static int load_domain_info(char **broker_ep, char **host_out,
@@ -406,11 +567,13 @@ static void *ctrl_thread_main(void *arg) {
     char ctrl_buf[512] = {0};
     size_t ctrl_len = 0;
     if (proc->stop) break;
-    if (zcm_socket_recv_bytes(proc->ctrl, ctrl_buf, sizeof(ctrl_buf) - 1, &ctrl_len) == 0) {
+    int got = zcm_socket_recv_bytes(proc->ctrl, ctrl_buf, sizeof(ctrl_buf) - 1, &ctrl_len);
+    if (got >= 0) {
+      /* A truncated request still gets a reply ("ERR") to keep REP in step. */
       int handled_control_msg = 0;
       zcm_msg_t *req = zcm_msg_new();
       zcm_msg_t *reply = zcm_msg_new();
-      if (req && reply && zcm_msg_from_bytes(req, ctrl_buf, ctrl_len) == 0) {
+      if (got == 0 && req && reply && zcm_msg_from_bytes(req, ctrl_buf, ctrl_len) == 0) {
         int should_exit = 0;
         int handled = zcm_node_handle_control_msg(req, reply, &should_exit);
         if (handled == 1) {
@@ -483,6 +646,10 @@ int zcm_proc_init(const char *name, zcm_socket_type_t data_type, int bind_data,
   int cfg_ctrl_timeout_ms = 200;
   int announce_interval_ms = ZCM_PROC_REANNOUNCE_MS_DEFAULT;
   int announce_backoff_max_ms = ZCM_PROC_REANNOUNCE_BACKOFF_MAX_MS_DEFAULT;
+  int lookup_cache_ms = ZCM_PROC_LOOKUP_CACHE_MS_DEFAULT;
+  int lookup_neg_cache_ms = ZCM_PROC_LOOKUP_NEG_CACHE_MS_DEFAULT;
+  zcm_context_opts_t ctx_opts;
+  memset(&ctx_opts, 0, sizeof(ctx_opts));
   int rc = -1;
 
   char *broker = NULL;
@@ -526,20 +693,54 @@ int zcm_proc_init(const char *name, zcm_socket_type_t data_type, int bind_data,
   if (announce_backoff_max_ms < announce_interval_ms) {
     announce_backoff_max_ms = announce_interval_ms;
   }
+  {
+    const char *cache_env = getenv("ZCM_PROC_LOOKUP_CACHE_MS");
+    if (cache_env && *cache_env) {
+      int parsed = 0;
+      if (parse_positive_int_range(cache_env, 0, ZCM_PROC_LOOKUP_CACHE_MS_MAX, &parsed) == 0) {
+        lookup_cache_ms = parsed;
+      } else {
+        fprintf(stderr,
+                "zcm_proc: invalid ZCM_PROC_LOOKUP_CACHE_MS='%s', using default %d ms\n",
+                cache_env, ZCM_PROC_LOOKUP_CACHE_MS_DEFAULT);
+      }
+    }
+    const char *neg_cache_env = getenv("ZCM_PROC_LOOKUP_NEG_CACHE_MS");
+    if (neg_cache_env && *neg_cache_env) {
+      int parsed = 0;
+      if (parse_positive_int_range(neg_cache_env, 0, ZCM_PROC_LOOKUP_CACHE_MS_MAX, &parsed) == 0) {
+        lookup_neg_cache_ms = parsed;
+      } else {
+        fprintf(stderr,
+                "zcm_proc: invalid ZCM_PROC_LOOKUP_NEG_CACHE_MS='%s', using default %d ms\n",
+                neg_cache_env, ZCM_PROC_LOOKUP_NEG_CACHE_MS_DEFAULT);
+      }
+    }
+  }
 
-  if (load_proc_config(name, &cfg_data_type, &cfg_bind_data, &cfg_ctrl_timeout_ms) != 0) {
+  if (load_proc_config(name, &cfg_data_type, &cfg_bind_data, &cfg_ctrl_timeout_ms,
+                       &ctx_opts) != 0) {
     goto fail;
   }
+  load_context_env(&ctx_opts);
   if (load_domain_info(&broker, &domain_host,
                        &port_range_start, &port_range_size) != 0) {
     fprintf(stderr, "zcm_proc: missing ZCMDOMAIN or ZCmDomains entry\n");
     goto fail;
   }
 
-  ctx = zcm_context_new();
+  ctx = zcm_context_new_ex(&ctx_opts);
+  if (!ctx) {
+    fprintf(stderr, "zcm_proc: context options rejected (ioThreads=%d ioCpus=%zu schedPolicy=%d "
+                    "threadPriority=%d), using defaults\n",
+            ctx_opts.io_threads, ctx_opts.cpu_count, ctx_opts.thread_sched_policy,
+            ctx_opts.thread_priority);
+    ctx = zcm_context_new();
+  }
   if (!ctx) goto fail;
   node = zcm_node_new(ctx, broker);
   if (!node) goto fail;
+  if (lookup_cache_ms > 0) zcm_node_set_cache(node, lookup_cache_ms, lookup_neg_cache_ms);
 
   if (cfg_bind_data) {
     data = zcm_socket_new(ctx, cfg_data_type);
@@ -36,6 +36,11 @@ static long long g_payload_last_rx_pull_ms = 0;
 #define ZCM_PROC_RX_STALE_MS_DEFAULT 5000
 #endif
 
+/* Payloads taken per wakeup by a SUB/PULL data socket worker. */
+#ifndef ZCM_PROC_RX_BATCH
+#define ZCM_PROC_RX_BATCH 32
+#endif
+
 static long long payload_now_ms(void) {
   struct timeval tv;
   gettimeofday(&tv, NULL);
@@ -62,6 +67,14 @@ static int payload_rx_stale_ms(void) {
   return cached;
 }
 
+int zcm_proc_runtime_log_payloads(void) {
+  static int cached = -1;
+  if (cached != -1) return cached;
+  const char *env = getenv("ZCM_PROC_LOG_PAYLOAD");
+  cached = (env && strcmp(env, "0") == 0) ? 0 : 1;
+  return cached;
+}
+
 static int payload_metric_get(int *slot) {
   int v = -1;
   if (!slot) return -1;
@@ -343,6 +356,17 @@ static int load_type_handlers(const char *cfg_path, zcm_proc_runtime_cfg_t *cfg)
     }
 
     build_type_format(handler);
+    if (zcm_proc_runtime_compile_type_plan(handler) != 0) {
+      fprintf(stderr, "zcm_proc: type '%s' has an invalid signature in %s\n",
+              handler->name, cfg_path);
+      return -1;
+    }
+    /* Interned so compact type-ID envelopes resolve back to this name. */
+    if (zcm_msg_type_intern(handler->name, &handler->type_id) != ZCM_MSG_OK) {
+      fprintf(stderr, "zcm_proc: type '%s' collides with an interned type ID in %s\n",
+              handler->name, cfg_path);
+      return -1;
+    }
   }
 
   return 0;
@@ -497,6 +521,96 @@ static int parse_topics_csv(const char *csv,
   return 0;
 }
 
+static int parse_int64_range_str(const char *text, long long min, long long max, long long *out) {
+  if (!text || !*text || !out) return -1;
+  char *end = NULL;
+  errno = 0;
+  long long v = strtoll(text, &end, 10);
+  if (errno != 0 || !end || *end != '\0') return -1;
+  if (v < min || v > max) return -1;
+  *out = v;
+  return 0;
+}
+
+/* xs:boolean lexical forms. */
+static int parse_bool_str(const char *text, int *out) {
+  if (!text || !out) return -1;
+  if (strcmp(text, "true") == 0 || strcmp(text, "1") == 0) { *out = 1; return 0; }
+  if (strcmp(text, "false") == 0 || strcmp(text, "0") == 0) { *out = 0; return 0; }
+  return -1;
+}
+
+/* Socket tuning attributes of one dataSocket, fetched with a single xmllint
+ * run; unset attributes keep the ØMQ/OS defaults. */
+static int load_data_socket_options(const char *cfg_path, int index,
+                                    zcm_proc_data_socket_cfg_t *opts) {
+  memset(opts, 0, sizeof(*opts));
+  opts->snd_hwm = -1;
+  opts->rcv_hwm = -1;
+  opts->snd_buf = -1;
+  opts->rcv_buf = -1;
+  opts->tcp_keepalive = -1;
+  opts->max_msg_size = -1;
+
+  int64_t affinity = 0;
+  enum { OPT_INT, OPT_INT64, OPT_BOOL };
+  const struct {
+    const char *attr;
+    int kind;
+    long long min;
+    void *out;
+  } specs[] = {
+      {"sndHwm", OPT_INT, 0, &opts->snd_hwm},
+      {"rcvHwm", OPT_INT, 0, &opts->rcv_hwm},
+      {"sndBuf", OPT_INT, 1, &opts->snd_buf},
+      {"rcvBuf", OPT_INT, 1, &opts->rcv_buf},
+      {"conflate", OPT_BOOL, 0, &opts->conflate},
+      {"affinity", OPT_INT64, 0, &affinity},
+      {"tcpKeepalive", OPT_BOOL, 0, &opts->tcp_keepalive},
+      {"maxMsgSize", OPT_INT64, 1, &opts->max_msg_size},
+  };
+  const size_t spec_count = sizeof(specs) / sizeof(specs[0]);
+
+  char xpath[512];
+  int off = snprintf(xpath, sizeof(xpath), "concat(");
+  for (size_t k = 0; k < spec_count; k++) {
+    off += snprintf(xpath + off, sizeof(xpath) - (size_t)off,
+                    "%s/procConfig/process/dataSocket[%d]/@%s", k ? ",'|'," : "", index,
+                    specs[k].attr);
+  }
+  snprintf(xpath + off, sizeof(xpath) - (size_t)off, ")");
+  char joined[512] = {0};
+  if (run_xmllint_xpath(cfg_path, xpath, joined, sizeof(joined)) != 0) return 0;
+
+  char *field = joined;
+  for (size_t k = 0; k < spec_count && field; k++) {
+    char *sep = strchr(field, '|');
+    if (sep) *sep = '\0';
+    trim_ws_inplace(field);
+    if (field[0]) {
+      long long v = 0;
+      int rc;
+      if (specs[k].kind == OPT_BOOL) {
+        rc = parse_bool_str(field, (int *)specs[k].out);
+      } else if (specs[k].kind == OPT_INT) {
+        rc = parse_int64_range_str(field, specs[k].min, INT32_MAX, &v);
+        if (rc == 0) *(int *)specs[k].out = (int)v;
+      } else {
+        rc = parse_int64_range_str(field, specs[k].min, INT64_MAX, &v);
+        if (rc == 0) *(int64_t *)specs[k].out = (int64_t)v;
+      }
+      if (rc != 0) {
+        fprintf(stderr, "zcm_proc: dataSocket[%d] invalid @%s='%s' in %s\n",
+                index, specs[k].attr, field, cfg_path);
+        return -1;
+      }
+    }
+    field = sep ? sep + 1 : NULL;
+  }
+  opts->affinity = (uint64_t)affinity;
+  return 0;
+}
+
 static int load_data_sockets(const char *cfg_path, zcm_proc_runtime_cfg_t *cfg) {
   char value[128] = {0};
   if (run_xmllint_xpath(cfg_path,
@@ -523,6 +637,7 @@ static int load_data_sockets(const char *cfg_path, zcm_proc_runtime_cfg_t *cfg)
     char topics_csv[512] = {0};
     char parsed_topics[ZCM_PROC_SUB_TOPIC_MAX][128] = {{0}};
     size_t parsed_topic_count = 0;
+    zcm_proc_data_socket_cfg_t opts;
 
     snprintf(xpath, sizeof(xpath), "string(/procConfig/process/dataSocket[%d]/@type)", i);
     if (run_xmllint_xpath(cfg_path, xpath, value, sizeof(value)) != 0 || !value[0]) break;
@@ -531,6 +646,7 @@ static int load_data_sockets(const char *cfg_path, zcm_proc_runtime_cfg_t *cfg)
               i, value, cfg_path);
       return -1;
     }
+    if (load_data_socket_options(cfg_path, i, &opts) != 0) return -1;
 
     if (kind == ZCM_PROC_DATA_SOCKET_PUB || kind == ZCM_PROC_DATA_SOCKET_PUSH) {
       snprintf(xpath, sizeof(xpath), "string(/procConfig/process/dataSocket[%d]/@port)", i);
@@ -556,7 +672,7 @@ static int load_data_sockets(const char *cfg_path, zcm_proc_runtime_cfg_t *cfg)
       }
 
       zcm_proc_data_socket_cfg_t *sock = &cfg->data_sockets[cfg->data_socket_count++];
-      memset(sock, 0, sizeof(*sock));
+      *sock = opts;
       sock->kind = kind;
       sock->port = 0;
       sock->interval_ms = interval_ms;
@@ -592,7 +708,7 @@ static int load_data_sockets(const char *cfg_path, zcm_proc_runtime_cfg_t *cfg)
       int added = 0;
       if (target_single[0]) {
         zcm_proc_data_socket_cfg_t *sock = &cfg->data_sockets[cfg->data_socket_count++];
-        memset(sock, 0, sizeof(*sock));
+        *sock = opts;
         sock->kind = kind;
         snprintf(sock->target, sizeof(sock->target), "%s", target_single);
         sock->topic_count = parsed_topic_count;
@@ -615,7 +731,7 @@ static int load_data_sockets(const char *cfg_path, zcm_proc_runtime_cfg_t *cfg)
             return -1;
           }
           zcm_proc_data_socket_cfg_t *sock = &cfg->data_sockets[cfg->data_socket_count++];
-          memset(sock, 0, sizeof(*sock));
+          *sock = opts;
           sock->kind = kind;
           snprintf(sock->target, sizeof(sock->target), "%s", tok);
           sock->topic_count = parsed_topic_count;
@@ -702,6 +818,19 @@ const zcm_proc_type_handler_cfg_t *zcm_proc_runtime_find_type_handler(
   return NULL;
 }
 
+const zcm_proc_type_handler_cfg_t *zcm_proc_runtime_find_type_handler_msg(
+    const zcm_proc_runtime_cfg_t *cfg,
+    const zcm_msg_t *msg) {
+  if (!cfg || !msg) return NULL;
+  uint32_t id = zcm_msg_get_type_id(msg);
+  if (id == 0) return NULL;
+  for (size_t i = 0; i < cfg->type_handler_count; i++) {
+    if (cfg->type_handlers[i].type_id == id) return &cfg->type_handlers[i];
+  }
+  /* Names differing only in case hash differently. */
+  return zcm_proc_runtime_find_type_handler(cfg, zcm_msg_get_type(msg));
+}
+
 static int append_summary(char *buf, size_t buf_size, size_t *off, const char *text) {
   if (!buf || buf_size == 0 || !off || !text) return -1;
   if (*off >= buf_size) return -1;
@@ -716,58 +845,144 @@ static int append_summary(char *buf, size_t buf_size, size_t *off, const char *t
   return 0;
 }
 
-int zcm_proc_runtime_decode_type_payload(zcm_msg_t *msg,
-                                         const zcm_proc_type_handler_cfg_t *handler,
-                                         char *summary,
-                                         size_t summary_size) {
-  if (!msg || !handler || !summary || summary_size == 0) return -1;
-  summary[0] = '\0';
-  size_t off = 0;
-  zcm_msg_rewind(msg);
+static uint32_t rd_le32(const uint8_t *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+         ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
 
-  for (size_t i = 0; i < handler->arg_count; i++) {
-    if (i > 0) (void)append_summary(summary, summary_size, &off, ", ");
+static uint64_t rd_le64(const uint8_t *p) {
+  return (uint64_t)rd_le32(p) | ((uint64_t)rd_le32(p + 4) << 32);
+}
 
-    if (handler->args[i] == ZCM_PROC_TYPE_ARG_TEXT) {
-      const char *text = NULL;
-      uint32_t text_len = 0;
-      if (zcm_msg_get_text(msg, &text, &text_len) != 0) return -1;
-      char item[256];
-      snprintf(item, sizeof(item), "text=%.*s", (int)text_len, text);
-      (void)append_summary(summary, summary_size, &off, item);
-      continue;
-    }
-    if (handler->args[i] == ZCM_PROC_TYPE_ARG_DOUBLE) {
-      double v = 0.0;
-      if (zcm_msg_get_double(msg, &v) != 0) return -1;
-      char item[96];
-      snprintf(item, sizeof(item), "double=%f", v);
-      (void)append_summary(summary, summary_size, &off, item);
-      continue;
-    }
-    if (handler->args[i] == ZCM_PROC_TYPE_ARG_FLOAT) {
-      float v = 0.0f;
-      if (zcm_msg_get_float(msg, &v) != 0) return -1;
-      char item[96];
-      snprintf(item, sizeof(item), "float=%f", v);
-      (void)append_summary(summary, summary_size, &off, item);
-      continue;
+int zcm_proc_runtime_compile_type_plan(zcm_proc_type_handler_cfg_t *handler) {
+  if (!handler || handler->arg_count > ZCM_PROC_TYPE_HANDLER_ARG_MAX) return -1;
+  zcm_proc_type_plan_t *plan = &handler->plan;
+  memset(plan, 0, sizeof(*plan));
+  for (size_t i = 0; i < handler->arg_count; i++) {
+    switch (handler->args[i]) {
+      case ZCM_PROC_TYPE_ARG_TEXT:
+        plan->tags[i] = ZCM_MSG_ITEM_TEXT;
+        plan->widths[i] = 4;
+        plan->text_count++;
+        break;
+      case ZCM_PROC_TYPE_ARG_DOUBLE:
+        plan->tags[i] = ZCM_MSG_ITEM_DOUBLE;
+        plan->widths[i] = 8;
+        break;
+      case ZCM_PROC_TYPE_ARG_FLOAT:
+        plan->tags[i] = ZCM_MSG_ITEM_FLOAT;
+        plan->widths[i] = 4;
+        break;
+      case ZCM_PROC_TYPE_ARG_INT:
+        plan->tags[i] = ZCM_MSG_ITEM_INT;
+        plan->widths[i] = 4;
+        break;
+      default:
+        return -1;
     }
-    if (handler->args[i] == ZCM_PROC_TYPE_ARG_INT) {
-      int32_t v = 0;
-      if (zcm_msg_get_int(msg, &v) != 0) return -1;
-      char item[96];
-      snprintf(item, sizeof(item), "int=%d", v);
-      (void)append_summary(summary, summary_size, &off, item);
-      continue;
+    plan->min_len += 1u + plan->widths[i];
+  }
+  plan->compiled = 1;
+  return 0;
+}
+
+int zcm_proc_runtime_decode_type_args(const zcm_msg_t *msg,
+                                      const zcm_proc_type_handler_cfg_t *handler,
+                                      zcm_proc_type_args_t *out) {
+  if (!msg || !handler || !out) return -1;
+  zcm_proc_type_handler_cfg_t compiled;
+  if (!handler->plan.compiled) {
+    compiled = *handler;
+    if (zcm_proc_runtime_compile_type_plan(&compiled) != 0) return -1;
+    handler = &compiled;
+  }
+  const zcm_proc_type_plan_t *plan = &handler->plan;
+
+  size_t len = 0;
+  const uint8_t *p = (const uint8_t *)zcm_msg_data(msg, &len);
+  if (plan->text_count == 0 ? (len != plan->min_len) : (len < plan->min_len)) return -1;
+
+  /* Text lengths are the only variable part: `slack` is what they may use. */
+  size_t slack = len - plan->min_len;
+  size_t off = 0;
+  for (size_t i = 0; i < handler->arg_count; i++) {
+    if (p[off] != plan->tags[i]) return -1;
+    const uint8_t *v = p + off + 1;
+    zcm_proc_type_arg_value_t *dst = &out->values[i];
+    dst->kind = handler->args[i];
+    switch (plan->tags[i]) {
+      case ZCM_MSG_ITEM_TEXT: {
+        uint32_t tl = rd_le32(v);
+        if (tl > slack) return -1;
+        slack -= tl;
+        dst->text = (const char *)(v + 4);
+        dst->text_len = tl;
+        off += tl;
+        break;
+      }
+      case ZCM_MSG_ITEM_DOUBLE: {
+        uint64_t bits = rd_le64(v);
+        memcpy(&dst->d, &bits, sizeof(bits));
+        break;
+      }
+      case ZCM_MSG_ITEM_FLOAT: {
+        uint32_t bits = rd_le32(v);
+        memcpy(&dst->f, &bits, sizeof(bits));
+        break;
+      }
+      default:
+        dst->i = (int32_t)rd_le32(v);
+        break;
     }
-    return -1;
+    off += 1u + plan->widths[i];
   }
+  if (slack != 0) return -1;
+  out->count = handler->arg_count;
+  return 0;
+}
 
-  if (zcm_msg_remaining(msg) != 0) return -1;
+int zcm_proc_runtime_format_type_args(const zcm_proc_type_args_t *args,
+                                      char *summary,
+                                      size_t summary_size) {
+  if (!args || !summary || summary_size == 0) return -1;
+  summary[0] = '\0';
+  size_t off = 0;
+  for (size_t i = 0; i < args->count; i++) {
+    const zcm_proc_type_arg_value_t *v = &args->values[i];
+    if (i > 0) (void)append_summary(summary, summary_size, &off, ", ");
+    char item[256];
+    switch (v->kind) {
+      case ZCM_PROC_TYPE_ARG_TEXT:
+        snprintf(item, sizeof(item), "text=%.*s", (int)v->text_len, v->text);
+        break;
+      case ZCM_PROC_TYPE_ARG_DOUBLE:
+        snprintf(item, sizeof(item), "double=%f", v->d);
+        break;
+      case ZCM_PROC_TYPE_ARG_FLOAT:
+        snprintf(item, sizeof(item), "float=%f", v->f);
+        break;
+      case ZCM_PROC_TYPE_ARG_INT:
+        snprintf(item, sizeof(item), "int=%d", v->i);
+        break;
+      default:
+        return -1;
+    }
+    (void)append_summary(summary, summary_size, &off, item);
+  }
   return 0;
 }
 
+int zcm_proc_runtime_decode_type_payload(zcm_msg_t *msg,
+                                         const zcm_proc_type_handler_cfg_t *handler,
+                                         char *summary,
+                                         size_t summary_size) {
+  if (!msg || !handler || !summary || summary_size == 0) return -1;
+  summary[0] = '\0';
+  zcm_proc_type_args_t args;
+  if (zcm_proc_runtime_decode_type_args(msg, handler, &args) != 0) return -1;
+  return zcm_proc_runtime_format_type_args(&args, summary, summary_size);
+}
+
 const char *zcm_proc_runtime_data_role(const zcm_proc_runtime_cfg_t *cfg) {
   if (!cfg) return "NONE";
   int mask = 0;
@@ -903,6 +1118,9 @@ typedef struct data_socket_worker_ctx {
   zcm_socket_t *bound_tx_socket;
   zcm_proc_runtime_sub_payload_cb_t on_sub_payload;
   void *user;
+  /* Target record resolved in bulk at startup, used for the first attempt. */
+  zcm_node_record_t target_rec;
+  int have_target_rec;
 } data_socket_worker_ctx_t;
 
 static int data_socket_is_sender(zcm_proc_data_socket_kind_t kind) {
@@ -915,29 +1133,12 @@ static int data_socket_is_receiver(zcm_proc_data_socket_kind_t kind) {
           kind == ZCM_PROC_DATA_SOCKET_PULL);
 }
 
-static int lookup_endpoint(zcm_proc_t *proc, const char *target, char *ep, size_t ep_size) {
+static int resolve_target(zcm_proc_t *proc, const char *target, zcm_node_record_t *rec) {
+  if (!proc || !target || !*target || !rec) return -1;
   zcm_node_t *node = zcm_proc_node(proc);
   if (!node) return -1;
-  if (zcm_node_lookup(node, target, ep, ep_size) != 0) {
-    fprintf(stderr, "lookup failed for '%s'\n", target);
-    return -1;
-  }
-  return 0;
-}
-
-static int resolve_target_host(zcm_proc_t *proc, const char *target, char *host, size_t host_size) {
-  if (!proc || !target || !*target || !host || host_size == 0) return -1;
-  zcm_node_t *node = zcm_proc_node(proc);
-  if (!node) return -1;
-
-  char data_ep[512] = {0};
-  char ctrl_ep[512] = {0};
-  int pid = 0;
-  if (zcm_node_info(node, target, data_ep, sizeof(data_ep),
-                    ctrl_ep, sizeof(ctrl_ep), host, host_size, &pid) != 0) {
-    return -1;
-  }
-  return host[0] ? 0 : -1;
+  if (zcm_node_resolve(node, target, rec) != 0) return -1;
+  return (rec->host[0] && rec->endpoint[0]) ? 0 : -1;
 }
 
 static int parse_port_from_reply(zcm_msg_t *reply, int *out_port) {
@@ -1034,13 +1235,10 @@ static int query_target_port_once(zcm_proc_t *proc, const char *endpoint,
   return rc;
 }
 
-static int request_target_data_port(zcm_proc_t *proc, const char *target,
+static int request_target_data_port(zcm_proc_t *proc, const char *target, const char *ep,
                                     const char *cmd, const char *legacy_cmd,
                                     int *out_port) {
-  if (!proc || !target || !*target || !cmd || !*cmd || !out_port) return -1;
-
-  char ep[256] = {0};
-  if (lookup_endpoint(proc, target, ep, sizeof(ep)) != 0) return -1;
+  if (!proc || !target || !*target || !ep || !*ep || !cmd || !*cmd || !out_port) return -1;
 
   const char *commands[2] = {cmd, legacy_cmd};
   for (size_t i = 0; i < 2; i++) {
@@ -1052,9 +1250,38 @@ static int request_target_data_port(zcm_proc_t *proc, const char *target,
       return 0;
     }
   }
+  /* The cached endpoint may belong to a restarted peer; refetch next time. */
+  zcm_node_cache_invalidate(zcm_proc_node(proc), target);
   return -1;
 }
 
+/* Apply the configured tuning before the socket binds or connects; a
+ * rejected option is reported and the ØMQ default kept. */
+static void apply_data_socket_options(zcm_socket_t *sock, const zcm_proc_data_socket_cfg_t *cfg) {
+  const struct {
+    zcm_socket_option_t opt;
+    const char *attr;
+    int set;
+    int64_t value;
+  } opts[] = {
+      {ZCM_SOCKOPT_SNDHWM, "sndHwm", cfg->snd_hwm >= 0, cfg->snd_hwm},
+      {ZCM_SOCKOPT_RCVHWM, "rcvHwm", cfg->rcv_hwm >= 0, cfg->rcv_hwm},
+      {ZCM_SOCKOPT_SNDBUF, "sndBuf", cfg->snd_buf > 0, cfg->snd_buf},
+      {ZCM_SOCKOPT_RCVBUF, "rcvBuf", cfg->rcv_buf > 0, cfg->rcv_buf},
+      {ZCM_SOCKOPT_CONFLATE, "conflate", cfg->conflate != 0, 1},
+      {ZCM_SOCKOPT_AFFINITY, "affinity", cfg->affinity != 0, (int64_t)cfg->affinity},
+      {ZCM_SOCKOPT_TCP_KEEPALIVE, "tcpKeepalive", cfg->tcp_keepalive >= 0, cfg->tcp_keepalive},
+      {ZCM_SOCKOPT_MAXMSGSIZE, "maxMsgSize", cfg->max_msg_size > 0, cfg->max_msg_size},
+  };
+  for (size_t i = 0; i < sizeof(opts) / sizeof(opts[0]); i++) {
+    if (!opts[i].set) continue;
+    if (zcm_socket_set_option(sock, opts[i].opt, opts[i].value) != 0) {
+      fprintf(stderr, "zcm_proc: %s dataSocket ignores @%s=%lld\n",
+              data_socket_kind_name(cfg->kind), opts[i].attr, (long long)opts[i].value);
+    }
+  }
+}
+
 static void *tx_worker_main(void *arg) {
   data_socket_worker_ctx_t *ctx = (data_socket_worker_ctx_t *)arg;
   if (!ctx) return NULL;
@@ -1096,6 +1323,7 @@ static void *rx_worker_main(void *arg) {
     return NULL;
   }
   zcm_socket_set_timeouts(rx, 1000);
+  apply_data_socket_options(rx, &ctx->sock);
 
   const char *kind_name = data_socket_kind_name(ctx->sock.kind);
   const char *peer_label =
@@ -1105,23 +1333,27 @@ static void *rx_worker_main(void *arg) {
   const char *legacy_cmd =
       (ctx->sock.kind == ZCM_PROC_DATA_SOCKET_SUB) ? "DATA_PORT" : NULL;
 
-  char host[256] = {0};
-  char ep[256] = {0};
+  zcm_node_record_t rec;
+  char ep[512] = {0};
   int data_port = 0;
   for (;;) {
-    if (resolve_target_host(ctx->proc, ctx->sock.target, host, sizeof(host)) != 0) {
+    if (ctx->have_target_rec) {
+      rec = ctx->target_rec;
+      ctx->have_target_rec = 0;
+    } else if (resolve_target(ctx->proc, ctx->sock.target, &rec) != 0) {
       usleep(300 * 1000);
       continue;
     }
-    if (request_target_data_port(ctx->proc, ctx->sock.target,
+    if (request_target_data_port(ctx->proc, ctx->sock.target, rec.endpoint,
                                  port_cmd, legacy_cmd, &data_port) != 0) {
       usleep(300 * 1000);
       continue;
     }
-    snprintf(ep, sizeof(ep), "tcp://%s:%d", host, data_port);
+    snprintf(ep, sizeof(ep), "tcp://%s:%d", rec.host, data_port);
 
     int connect_ok = (zcm_socket_connect(rx, ep) == 0);
     if (!connect_ok) {
+      zcm_node_cache_invalidate(zcm_proc_node(ctx->proc), ctx->sock.target);
       usleep(300 * 1000);
       continue;
     }
@@ -1160,10 +1392,16 @@ static void *rx_worker_main(void *arg) {
   }
   fflush(stdout);
 
+  char bufs[ZCM_PROC_RX_BATCH][512];
+  size_t lens[ZCM_PROC_RX_BATCH];
   for (;;) {
-    char buf[512] = {0};
-    size_t n = 0;
-    if (zcm_socket_recv_bytes(rx, buf, sizeof(buf) - 1, &n) == 0) {
+    /* Take a whole burst per wakeup; each payload is handled as before, and
+     * stdout is flushed once per burst rather than once per payload. */
+    int count =
+        zcm_socket_recv_many_bytes(rx, bufs, sizeof(bufs[0]), lens, ZCM_PROC_RX_BATCH, -1);
+    for (int i = 0; i < count; i++) {
+      char *buf = bufs[i];
+      size_t n = (lens[i] < sizeof(bufs[0]) - 1) ? lens[i] : sizeof(bufs[0]) - 1;
       if (ctx->sock.kind == ZCM_PROC_DATA_SOCKET_SUB) {
         payload_metric_set_with_rx_time(&g_payload_bytes_sub,
                                         &g_payload_last_rx_sub_ms,
@@ -1179,8 +1417,8 @@ static void *rx_worker_main(void *arg) {
       }
       printf("[%s %s] received payload from %s: \"%s\" (%zu bytes)\n",
              kind_name, ctx->proc_name, ctx->sock.target, buf, n);
-      fflush(stdout);
     }
+    if (count > 0) fflush(stdout);
   }
 
   zcm_socket_free(rx);
@@ -1194,6 +1432,29 @@ void zcm_proc_runtime_start_data_workers(zcm_proc_runtime_cfg_t *cfg,
                                          void *user) {
   if (!cfg || !proc) return;
   payload_metrics_reset();
+
+  /* Resolve every receiver target in one broker round trip up front rather
+   * than one request per worker thread. */
+  const char **targets = NULL;
+  zcm_node_record_t *target_recs = NULL;
+  size_t target_count = 0;
+  if (cfg->data_socket_count > 0) {
+    targets = (const char **)calloc(cfg->data_socket_count, sizeof(*targets));
+    target_recs = (zcm_node_record_t *)calloc(cfg->data_socket_count, sizeof(*target_recs));
+  }
+  if (targets && target_recs) {
+    for (size_t i = 0; i < cfg->data_socket_count; i++) {
+      if (data_socket_is_receiver(cfg->data_sockets[i].kind) && cfg->data_sockets[i].target[0]) {
+        targets[target_count++] = cfg->data_sockets[i].target;
+      }
+    }
+    if (target_count == 0 ||
+        zcm_node_resolve_many(zcm_proc_node(proc), targets, target_count, target_recs) < 0) {
+      target_count = 0;
+    }
+  }
+
+  size_t target_index = 0;
   for (size_t i = 0; i < cfg->data_socket_count; i++) {
     payload_metrics_record_config(&cfg->data_sockets[i]);
 
@@ -1205,6 +1466,14 @@ void zcm_proc_runtime_start_data_workers(zcm_proc_runtime_cfg_t *cfg,
     ctx->bound_tx_socket = NULL;
     ctx->on_sub_payload = on_sub_payload;
     ctx->user = user;
+    if (data_socket_is_receiver(ctx->sock.kind) && ctx->sock.target[0] &&
+        target_index < target_count) {
+      const zcm_node_record_t *rec = &target_recs[target_index++];
+      if (rec->host[0] && rec->endpoint[0]) {
+        ctx->target_rec = *rec;
+        ctx->have_target_rec = 1;
+      }
+    }
 
     if (!data_socket_is_sender(ctx->sock.kind) &&
         !data_socket_is_receiver(ctx->sock.kind)) {
@@ -1223,6 +1492,7 @@ void zcm_proc_runtime_start_data_workers(zcm_proc_runtime_cfg_t *cfg,
         free(ctx);
         continue;
       }
+      apply_data_socket_options(ctx->bound_tx_socket, &ctx->sock);
       if (bind_pub_in_domain_range(ctx->bound_tx_socket, &ctx->sock.port) != 0) {
         fprintf(stderr, "zcm_proc: failed to allocate %s dataSocket port\n",
                 data_socket_kind_name(ctx->sock.kind));
@@ -1244,4 +1514,6 @@ void zcm_proc_runtime_start_data_workers(zcm_proc_runtime_cfg_t *cfg,
     }
     pthread_detach(tid);
   }
+  free(targets);
+  free(target_recs);
 }
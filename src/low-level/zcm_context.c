@@ -1,6 +1,10 @@
 #include "zcm/zcm.h"
 
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
 #include <stdlib.h>
+#include <unistd.h>
 
 #include <zmq.h>
 
@@ -9,6 +13,88 @@ struct zcm_context {
 };
 
 zcm_context_t *zcm_context_new(void) {
+  return zcm_context_new_ex(NULL);
+}
+
+typedef struct sched_probe {
+  int policy;
+  int priority;
+  int rc;
+} sched_probe_t;
+
+/* Mirrors how libzmq applies ZMQ_THREAD_SCHED_POLICY/ZMQ_THREAD_PRIORITY to
+ * its I/O threads: real-time policies take the priority, the others keep
+ * priority 0 and ask for the highest nice boost (-20) instead. */
+static void *sched_probe_main(void *arg) {
+  sched_probe_t *probe = (sched_probe_t *)arg;
+  struct sched_param param;
+  int policy = 0;
+  probe->rc = pthread_getschedparam(pthread_self(), &policy, &param);
+  if (probe->rc != 0) return NULL;
+  if (probe->policy > 0) policy = probe->policy;
+  int realtime = (policy == SCHED_FIFO || policy == SCHED_RR);
+  if (probe->priority > 0) param.sched_priority = realtime ? probe->priority : 0;
+  probe->rc = pthread_setschedparam(pthread_self(), policy, &param);
+  if (probe->rc == 0 && !realtime && probe->priority > 0) {
+    errno = 0;
+    if (nice(-20) == -1 && errno != 0) probe->rc = errno;
+  }
+  return NULL;
+}
+
+/* libzmq aborts when an I/O thread cannot take its scheduling settings, so
+ * try them on a throwaway thread first. */
+static int sched_probe(int policy, int priority) {
+  sched_probe_t probe = {policy, priority, -1};
+  pthread_t tid;
+  if (pthread_create(&tid, NULL, sched_probe_main, &probe) != 0) return -1;
+  pthread_join(tid, NULL);
+  return (probe.rc == 0) ? 0 : -1;
+}
+
+static int context_apply_opts(void *zmq, const zcm_context_opts_t *opts) {
+  if (opts->io_threads < 0 || opts->max_sockets < 0 || opts->thread_sched_policy < 0 ||
+      opts->thread_priority < 0 || opts->thread_name_prefix < 0 ||
+      opts->cpu_count > ZCM_CONTEXT_CPU_MAX) {
+    return -1;
+  }
+  if (opts->io_threads > 0 && zmq_ctx_set(zmq, ZMQ_IO_THREADS, opts->io_threads) != 0) return -1;
+  if (opts->max_sockets > 0 && zmq_ctx_set(zmq, ZMQ_MAX_SOCKETS, opts->max_sockets) != 0) {
+    return -1;
+  }
+  if ((opts->thread_sched_policy > 0 || opts->thread_priority > 0) &&
+      sched_probe(opts->thread_sched_policy, opts->thread_priority) != 0) {
+    return -1;
+  }
+  if (opts->thread_sched_policy > 0 &&
+      zmq_ctx_set(zmq, ZMQ_THREAD_SCHED_POLICY, opts->thread_sched_policy) != 0) {
+    return -1;
+  }
+  if (opts->thread_priority > 0 &&
+      zmq_ctx_set(zmq, ZMQ_THREAD_PRIORITY, opts->thread_priority) != 0) {
+    return -1;
+  }
+#ifdef ZMQ_THREAD_AFFINITY_CPU_ADD
+  for (size_t i = 0; i < opts->cpu_count; i++) {
+    if (opts->cpus[i] < 0 || zmq_ctx_set(zmq, ZMQ_THREAD_AFFINITY_CPU_ADD, opts->cpus[i]) != 0) {
+      return -1;
+    }
+  }
+#else
+  if (opts->cpu_count > 0) return -1; /* needs libzmq >= 4.3 */
+#endif
+#ifdef ZMQ_THREAD_NAME_PREFIX
+  if (opts->thread_name_prefix > 0 &&
+      zmq_ctx_set(zmq, ZMQ_THREAD_NAME_PREFIX, opts->thread_name_prefix) != 0) {
+    return -1;
+  }
+#else
+  if (opts->thread_name_prefix > 0) return -1;
+#endif
+  return 0;
+}
+
+zcm_context_t *zcm_context_new_ex(const zcm_context_opts_t *opts) {
   zcm_context_t *ctx = (zcm_context_t *)calloc(1, sizeof(zcm_context_t));
   if (!ctx) return NULL;
   ctx->zmq = zmq_ctx_new();
@@ -16,6 +102,11 @@ zcm_context_t *zcm_context_new(void) {
     free(ctx);
     return NULL;
   }
+  if (opts && context_apply_opts(ctx->zmq, opts) != 0) {
+    zmq_ctx_term(ctx->zmq);
+    free(ctx);
+    return NULL;
+  }
   return ctx;
 }
 
@@ -1,21 +1,89 @@
 #include "zcm/zcm_msg.h"
 
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && \
+    __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define ZCM_HOST_BIG_ENDIAN 1
+#else
+#define ZCM_HOST_BIG_ENDIAN 0
+#endif
+
+#if ZCM_HOST_BIG_ENDIAN && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 #define ZCM_MAGIC 0x5A434D31u /* 'ZCM1' */
 #define ZCM_VERSION 1u
+#define ZCM_VERSION_BATCH 2u /* one frame carrying several version-1 envelopes */
+#define ZCM_VERSION_TYPE_ID 3u /* type carried as a 32-bit interned ID */
+#define ZCM_HEADER_LEN 12u
+#define ZCM_ID_HEADER_LEN 16u
+
+/* Shared ownership of a caller buffer recorded by zcm_msg_put_*_ref(): the
+ * message holds one reference and each in-flight transport frame another. */
+typedef struct zcm_msg_ref_hold {
+  atomic_int refs;
+  void (*release)(void *ctx);
+  void *ctx;
+} zcm_msg_ref_hold_t;
+
+/* External bytes logically spliced into the payload at local offset `off`. */
+typedef struct zcm_msg_ref {
+  size_t off;
+  const void *data;
+  size_t len;
+  zcm_msg_ref_hold_t *hold;
+} zcm_msg_ref_t;
 
 struct zcm_msg {
   char type[64];
+  /* Stable hash of `type`; 0 until first needed (see zcm_msg_get_type_id). */
+  uint32_t type_id;
+  uint8_t *base; /* owned allocation; buf == base unless borrowed */
   uint8_t *buf;
   size_t len;
-  size_t cap;
+  size_t cap;    /* owned payload capacity behind base */
   size_t read_off;
+  /* Borrowed receive view: buf points into a transport frame released here. */
+  void (*release)(void *ctx);
+  void *release_ctx;
+  /* Inline storage the transport may use for the borrowed frame handle. */
+  union {
+    unsigned char bytes[64];
+    void *align_ptr;
+    long double align_ld;
+  } transport_slot;
+  /* Host-order array copy handed out by zcm_msg_get_array() on big-endian hosts. */
+  uint8_t *scratch;
+  size_t scratch_cap;
+  /* Lazy item offset index (zcm_msg_item_count/seek/get_*_at). */
+  uint32_t *index;
+  size_t index_count;
+  size_t index_cap;
+  int index_valid;
+  /* Set with the index once a full walk found the payload well formed; typed
+   * reads then skip per-field range checks. Cleared on any mutation. */
+  int trusted;
+  /* Caller buffers not yet copied into buf (see flatten_refs). */
+  zcm_msg_ref_t *refs;
+  size_t ref_count;
+  size_t ref_cap;
+  size_t ref_bytes;
   char last_error[128];
 };
 
+struct zcm_msg_pool {
+  zcm_msg_t **items;
+  size_t count;
+  size_t max_cached;
+  size_t trim_cap;
+};
+
 static const char *k_value_marker = "__zcm_value__";
 static const char *k_value_kind_text = "text";
 static const char *k_value_kind_double = "double";
@@ -56,17 +124,265 @@ static uint64_t le64(uint64_t v) {
          ((v & 0xFF00000000000000ull) >> 56);
 }
 
+static size_t array_elem_size(uint8_t type) {
+  return zcm_msg_array_elem_size((zcm_msg_array_type_t)type);
+}
+
+/* Wire array type bit marking delta + zigzag-varint encoding of the base
+ * integer type in the low bits. */
+#define ZCM_ARRAY_DELTA 0x80u
+
+static int array_delta_base_ok(uint8_t type) {
+  return array_elem_size(type) != 0 &&
+         type != ZCM_MSG_ARRAY_FLOAT && type != ZCM_MSG_ARRAY_DOUBLE;
+}
+
+/* Load element `i` widened to 64 bits (sign-extended for signed types). */
+static uint64_t load_wide(const void *data, size_t i, uint8_t type) {
+  switch ((zcm_msg_array_type_t)type) {
+    case ZCM_MSG_ARRAY_CHAR: return (uint64_t)(int64_t)((const int8_t *)data)[i];
+    case ZCM_MSG_ARRAY_SHORT: return (uint64_t)(int64_t)((const int16_t *)data)[i];
+    case ZCM_MSG_ARRAY_INT: return (uint64_t)(int64_t)((const int32_t *)data)[i];
+    case ZCM_MSG_ARRAY_INT64: return (uint64_t)((const int64_t *)data)[i];
+    case ZCM_MSG_ARRAY_UINT8: return ((const uint8_t *)data)[i];
+    case ZCM_MSG_ARRAY_UINT16: return ((const uint16_t *)data)[i];
+    case ZCM_MSG_ARRAY_UINT32: return ((const uint32_t *)data)[i];
+    case ZCM_MSG_ARRAY_UINT64: return ((const uint64_t *)data)[i];
+    default: return 0;
+  }
+}
+
+static void store_wide(void *dst, size_t i, uint8_t type, uint64_t v) {
+  switch (array_elem_size(type)) {
+    case 1: ((uint8_t *)dst)[i] = (uint8_t)v; break;
+    case 2: ((uint16_t *)dst)[i] = (uint16_t)v; break;
+    case 4: ((uint32_t *)dst)[i] = (uint32_t)v; break;
+    case 8: ((uint64_t *)dst)[i] = v; break;
+    default: break;
+  }
+}
+
+static uint64_t zigzag_delta(uint64_t v, uint64_t prev) {
+  uint64_t d = v - prev;
+  return (d << 1) ^ (uint64_t)((int64_t)d >> 63);
+}
+
+static size_t varint_len(uint64_t v) {
+  size_t n = 1;
+  while (v >= 0x80u) {
+    v >>= 7;
+    n++;
+  }
+  return n;
+}
+
+/* Decode `elems` delta/zigzag varints into host-order elements of `type`.
+ * Runs of single-byte varints (small deltas) are detected eight bytes at a
+ * time and decoded without the per-byte continuation loop. */
+static int decode_delta_elems(void *dst, const uint8_t *src, size_t src_len,
+                              uint32_t elems, uint8_t type) {
+  size_t pos = 0;
+  uint64_t prev = 0;
+  uint32_t i = 0;
+  while (i < elems) {
+    if (i + 8 <= elems && pos + 8 <= src_len) {
+      uint64_t w = 0;
+      memcpy(&w, src + pos, 8);
+      if ((w & 0x8080808080808080ull) == 0) {
+        for (int k = 0; k < 8; k++) {
+          uint64_t zz = src[pos + k];
+          prev += (zz >> 1) ^ (0 - (zz & 1u));
+          store_wide(dst, i + k, type, prev);
+        }
+        pos += 8;
+        i += 8;
+        continue;
+      }
+    }
+    uint64_t zz = 0;
+    unsigned shift = 0;
+    for (;;) {
+      if (pos >= src_len || shift > 63) return ZCM_MSG_ERR_FORMAT;
+      uint8_t b = src[pos++];
+      zz |= (uint64_t)(b & 0x7Fu) << shift;
+      if (!(b & 0x80u)) break;
+      shift += 7;
+    }
+    prev += (zz >> 1) ^ (0 - (zz & 1u));
+    store_wide(dst, i, type, prev);
+    i++;
+  }
+  return (pos == src_len) ? ZCM_MSG_OK : ZCM_MSG_ERR_FORMAT;
+}
+
+/* Structural check of a varint stream: exactly `elems` terminated varints of
+ * at most ten bytes each. */
+static int check_varint_stream(const uint8_t *src, size_t src_len, uint32_t elems) {
+  size_t ends = 0;
+  size_t run = 0;
+  for (size_t i = 0; i < src_len; i++) {
+    if (src[i] & 0x80u) {
+      if (++run >= 10) return ZCM_MSG_ERR_FORMAT;
+    } else {
+      run = 0;
+      ends++;
+    }
+  }
+  if (run != 0 || ends != elems) return ZCM_MSG_ERR_FORMAT;
+  return ZCM_MSG_OK;
+}
+
+#if ZCM_HOST_BIG_ENDIAN
+/* Byte-reverse `n` elements of `elem_size` bytes from src to dst. One tight
+ * loop per width so the compiler can vectorize; NEON handles 16-byte blocks. */
+static void swap_elems(uint8_t *dst, const uint8_t *src, size_t n, size_t elem_size) {
+  size_t i = 0;
+  switch (elem_size) {
+    case 2:
+#if defined(__ARM_NEON)
+      for (; i + 8 <= n; i += 8) {
+        vst1q_u8(dst + i * 2, vrev16q_u8(vld1q_u8(src + i * 2)));
+      }
+#endif
+      for (; i < n; i++) {
+        uint16_t v = 0;
+        memcpy(&v, src + i * 2, 2);
+        v = __builtin_bswap16(v);
+        memcpy(dst + i * 2, &v, 2);
+      }
+      break;
+    case 4:
+#if defined(__ARM_NEON)
+      for (; i + 4 <= n; i += 4) {
+        vst1q_u8(dst + i * 4, vrev32q_u8(vld1q_u8(src + i * 4)));
+      }
+#endif
+      for (; i < n; i++) {
+        uint32_t v = 0;
+        memcpy(&v, src + i * 4, 4);
+        v = __builtin_bswap32(v);
+        memcpy(dst + i * 4, &v, 4);
+      }
+      break;
+    case 8:
+#if defined(__ARM_NEON)
+      for (; i + 2 <= n; i += 2) {
+        vst1q_u8(dst + i * 8, vrev64q_u8(vld1q_u8(src + i * 8)));
+      }
+#endif
+      for (; i < n; i++) {
+        uint64_t v = 0;
+        memcpy(&v, src + i * 8, 8);
+        v = __builtin_bswap64(v);
+        memcpy(dst + i * 8, &v, 8);
+      }
+      break;
+    default:
+      memcpy(dst, src, n * elem_size);
+      break;
+  }
+}
+#endif
+
+/* Copy array elements between host order and little-endian wire order
+ * (the conversion is symmetric). Never touches `src`. */
+static void copy_le_elems(void *dst, const void *src, size_t n, size_t elem_size) {
+  if (n == 0) return;
+#if ZCM_HOST_BIG_ENDIAN
+  if (elem_size > 1) {
+    swap_elems((uint8_t *)dst, (const uint8_t *)src, n, elem_size);
+    return;
+  }
+#endif
+  memcpy(dst, src, n * elem_size);
+}
+
+static void release_view(zcm_msg_t *msg) {
+  if (!msg->release) return;
+  msg->release(msg->release_ctx);
+  msg->release = NULL;
+  msg->release_ctx = NULL;
+  msg->buf = msg->base;
+}
+
+/* internal helper used by transport: drop one reference to a caller buffer */
+void zcm_msg__ref_drop(void *hold) {
+  zcm_msg_ref_hold_t *h = (zcm_msg_ref_hold_t *)hold;
+  if (!h) return;
+  if (atomic_fetch_sub(&h->refs, 1) != 1) return;
+  if (h->release) h->release(h->ctx);
+  free(h);
+}
+
+static void drop_refs(zcm_msg_t *msg) {
+  for (size_t i = 0; i < msg->ref_count; i++) zcm_msg__ref_drop(msg->refs[i].hold);
+  msg->ref_count = 0;
+  msg->ref_bytes = 0;
+}
+
+static int ensure_cap(zcm_msg_t *msg, size_t add);
+
+/* Copy referenced caller buffers into buf so the payload is contiguous again.
+ * Anything that reads the payload goes through here first; only the socket
+ * send path consumes references without copying. */
+static int flatten_refs(zcm_msg_t *msg) {
+  if (!msg || msg->ref_count == 0) return ZCM_MSG_OK;
+  zcm_msg_ref_t *refs = msg->refs;
+  size_t n = msg->ref_count;
+  size_t shift = msg->ref_bytes;
+  if (ensure_cap(msg, shift) != 0) {
+    set_error(msg, "out of memory");
+    return ZCM_MSG_ERR;
+  }
+  size_t end = msg->len;
+  for (size_t i = n; i-- > 0;) {
+    size_t off = refs[i].off;
+    memmove(msg->buf + off + shift, msg->buf + off, end - off);
+    shift -= refs[i].len;
+    memcpy(msg->buf + off + shift, refs[i].data, refs[i].len);
+    end = off;
+  }
+  msg->len += msg->ref_bytes;
+  drop_refs(msg);
+  return ZCM_MSG_OK;
+}
+
 static int ensure_cap(zcm_msg_t *msg, size_t add) {
   if (!msg) return ZCM_MSG_ERR;
+  msg->index_valid = 0;
+  msg->trusted = 0;
   size_t need = msg->len + add;
+  if (msg->release) {
+    /* Writing to a borrowed view: copy it into owned storage first. */
+    uint8_t *view = msg->buf;
+    size_t view_len = msg->len;
+    void (*release)(void *) = msg->release;
+    void *release_ctx = msg->release_ctx;
+    msg->release = NULL;
+    msg->release_ctx = NULL;
+    msg->buf = msg->base;
+    msg->len = 0;
+    if (ensure_cap(msg, need) != 0) {
+      msg->buf = view;
+      msg->len = view_len;
+      msg->release = release;
+      msg->release_ctx = release_ctx;
+      return ZCM_MSG_ERR;
+    }
+    if (view_len) memcpy(msg->buf, view, view_len);
+    msg->len = view_len;
+    release(release_ctx);
+    return ZCM_MSG_OK;
+  }
   if (need <= msg->cap) return ZCM_MSG_OK;
   size_t new_cap = msg->cap ? msg->cap : 256;
   while (new_cap < need) new_cap *= 2;
-  uint8_t *nb = (uint8_t *)realloc(msg->buf, new_cap);
+  uint8_t *nb = (uint8_t *)realloc(msg->base, new_cap);
   if (!nb) {
     set_error(msg, "out of memory");
     return ZCM_MSG_ERR;
   }
+  msg->base = nb;
   msg->buf = nb;
   msg->cap = new_cap;
   return ZCM_MSG_OK;
@@ -110,7 +426,7 @@ static int put_bytes(zcm_msg_t *msg, const void *data, size_t len) {
 }
 
 static int get_u8(zcm_msg_t *msg, uint8_t *v) {
-  if (!msg || msg->read_off + 1 > msg->len) {
+  if (!msg || (!msg->trusted && msg->read_off + 1 > msg->len)) {
     set_error(msg, "read overflow");
     return ZCM_MSG_ERR_RANGE;
   }
@@ -119,7 +435,7 @@ static int get_u8(zcm_msg_t *msg, uint8_t *v) {
 }
 
 static int get_u32(zcm_msg_t *msg, uint32_t *v) {
-  if (!msg || msg->read_off + 4 > msg->len) {
+  if (!msg || (!msg->trusted && msg->read_off + 4 > msg->len)) {
     set_error(msg, "read overflow");
     return ZCM_MSG_ERR_RANGE;
   }
@@ -131,7 +447,7 @@ static int get_u32(zcm_msg_t *msg, uint32_t *v) {
 }
 
 static int get_u16(zcm_msg_t *msg, uint16_t *v) {
-  if (!msg || msg->read_off + 2 > msg->len) {
+  if (!msg || (!msg->trusted && msg->read_off + 2 > msg->len)) {
     set_error(msg, "read overflow");
     return ZCM_MSG_ERR_RANGE;
   }
@@ -143,7 +459,7 @@ static int get_u16(zcm_msg_t *msg, uint16_t *v) {
 }
 
 static int get_u64(zcm_msg_t *msg, uint64_t *v) {
-  if (!msg || msg->read_off + 8 > msg->len) {
+  if (!msg || (!msg->trusted && msg->read_off + 8 > msg->len)) {
     set_error(msg, "read overflow");
     return ZCM_MSG_ERR_RANGE;
   }
@@ -155,7 +471,7 @@ static int get_u64(zcm_msg_t *msg, uint64_t *v) {
 }
 
 static int get_bytes(zcm_msg_t *msg, const void **data, uint32_t len) {
-  if (!msg || msg->read_off + len > msg->len) {
+  if (!msg || (!msg->trusted && msg->read_off + len > msg->len)) {
     set_error(msg, "read overflow");
     return ZCM_MSG_ERR_RANGE;
   }
@@ -171,15 +487,25 @@ zcm_msg_t *zcm_msg_new(void) {
 
 void zcm_msg_free(zcm_msg_t *msg) {
   if (!msg) return;
-  free(msg->buf);
+  release_view(msg);
+  drop_refs(msg);
+  free(msg->refs);
+  free(msg->base);
+  free(msg->scratch);
+  free(msg->index);
   free(msg);
 }
 
 void zcm_msg_reset(zcm_msg_t *msg) {
   if (!msg) return;
+  release_view(msg);
+  drop_refs(msg);
   msg->len = 0;
   msg->read_off = 0;
+  msg->index_valid = 0;
+  msg->trusted = 0;
   msg->type[0] = '\0';
+  msg->type_id = 0;
   msg->last_error[0] = '\0';
 }
 
@@ -188,10 +514,105 @@ void zcm_msg_rewind(zcm_msg_t *msg) {
   msg->read_off = 0;
 }
 
+static size_t pool_size_class(size_t bytes) {
+  size_t c = 256;
+  while (c < bytes && c < ((size_t)1 << 30)) c *= 2;
+  return c;
+}
+
+zcm_msg_pool_t *zcm_msg_pool_new(size_t max_cached, size_t trim_bytes) {
+  zcm_msg_pool_t *pool = (zcm_msg_pool_t *)calloc(1, sizeof(*pool));
+  if (!pool) return NULL;
+  pool->max_cached = max_cached ? max_cached : ZCM_MSG_POOL_DEFAULT_MAX;
+  pool->trim_cap = pool_size_class(trim_bytes ? trim_bytes : ZCM_MSG_POOL_DEFAULT_TRIM);
+  pool->items = (zcm_msg_t **)calloc(pool->max_cached, sizeof(*pool->items));
+  if (!pool->items) {
+    free(pool);
+    return NULL;
+  }
+  return pool;
+}
+
+void zcm_msg_pool_free(zcm_msg_pool_t *pool) {
+  if (!pool) return;
+  for (size_t i = 0; i < pool->count; i++) zcm_msg_free(pool->items[i]);
+  free(pool->items);
+  free(pool);
+}
+
+zcm_msg_t *zcm_msg_pool_acquire(zcm_msg_pool_t *pool) {
+  if (!pool || pool->count == 0) return zcm_msg_new();
+  return pool->items[--pool->count];
+}
+
+void zcm_msg_pool_release(zcm_msg_pool_t *pool, zcm_msg_t *msg) {
+  if (!msg) return;
+  if (!pool || pool->count >= pool->max_cached) {
+    zcm_msg_free(msg);
+    return;
+  }
+  zcm_msg_reset(msg);
+  if (msg->cap > pool->trim_cap) {
+    /* Shrink oversized payload buffers back to the pool trim limit. */
+    uint8_t *nb = (uint8_t *)realloc(msg->base, pool->trim_cap);
+    if (nb) {
+      msg->base = nb;
+      msg->buf = nb;
+      msg->cap = pool->trim_cap;
+    }
+  }
+  /* Secondary arrays are regrown lazily; drop the ones one large message left
+   * behind rather than keeping them pinned in the pool. */
+  if (msg->index_cap * sizeof(*msg->index) > pool->trim_cap) {
+    free(msg->index);
+    msg->index = NULL;
+    msg->index_cap = 0;
+    msg->index_count = 0;
+  }
+  if (msg->scratch_cap > pool->trim_cap) {
+    free(msg->scratch);
+    msg->scratch = NULL;
+    msg->scratch_cap = 0;
+  }
+  if (msg->ref_cap * sizeof(*msg->refs) > pool->trim_cap) {
+    free(msg->refs);
+    msg->refs = NULL;
+    msg->ref_cap = 0;
+  }
+  pool->items[pool->count++] = msg;
+}
+
+static pthread_key_t g_thread_pool_key;
+static pthread_once_t g_thread_pool_once = PTHREAD_ONCE_INIT;
+static int g_thread_pool_key_ok = 0;
+
+static void thread_pool_destroy(void *pool) {
+  zcm_msg_pool_free((zcm_msg_pool_t *)pool);
+}
+
+static void thread_pool_key_init(void) {
+  g_thread_pool_key_ok = (pthread_key_create(&g_thread_pool_key, thread_pool_destroy) == 0);
+}
+
+zcm_msg_pool_t *zcm_msg_pool_thread(void) {
+  pthread_once(&g_thread_pool_once, thread_pool_key_init);
+  if (!g_thread_pool_key_ok) return NULL;
+  zcm_msg_pool_t *pool = (zcm_msg_pool_t *)pthread_getspecific(g_thread_pool_key);
+  if (pool) return pool;
+  pool = zcm_msg_pool_new(0, 0);
+  if (!pool) return NULL;
+  if (pthread_setspecific(g_thread_pool_key, pool) != 0) {
+    zcm_msg_pool_free(pool);
+    return NULL;
+  }
+  return pool;
+}
+
 int zcm_msg_set_type(zcm_msg_t *msg, const char *type) {
   if (!msg || !type) return ZCM_MSG_ERR;
   strncpy(msg->type, type, sizeof(msg->type) - 1);
   msg->type[sizeof(msg->type) - 1] = '\0';
+  msg->type_id = msg->type[0] ? zcm_msg_type_id(msg->type) : 0;
   return ZCM_MSG_OK;
 }
 
@@ -200,6 +621,114 @@ const char *zcm_msg_get_type(const zcm_msg_t *msg) {
   return msg->type;
 }
 
+uint32_t zcm_msg_type_id(const char *type) {
+  if (!type) return 0;
+  /* FNV-1a over at most the stored type length, so a truncated name hashes
+   * the same as the copy kept in the message. */
+  uint32_t h = 2166136261u;
+  for (size_t i = 0; i < 63 && type[i]; i++) {
+    h ^= (uint8_t)type[i];
+    h *= 16777619u;
+  }
+  return h ? h : 1u;
+}
+
+/* zcm_msg_set_type() and compact envelopes store the ID; a type parsed from a
+ * version-1 envelope is hashed on demand without caching through the const
+ * handle. */
+uint32_t zcm_msg_get_type_id(const zcm_msg_t *msg) {
+  if (!msg || !msg->type[0]) return 0;
+  return msg->type_id ? msg->type_id : zcm_msg_type_id(msg->type);
+}
+
+/* Process-wide ID -> name table used to restore type strings from compact
+ * envelopes. Open addressing over a power-of-two array; IDs are never 0.
+ * Receive threads read it without locking: a slot's name is written before
+ * its ID is published, and a grown table replaces the old one through an
+ * atomic pointer. Tables are never freed once published, as readers may still
+ * walk them; they only double, so the retired ones stay smaller than the live
+ * one. Interning is serialized by g_type_lock. */
+typedef struct {
+  _Atomic uint32_t id;
+  char name[64];
+} type_entry_t;
+
+typedef struct type_table {
+  size_t cap;
+  struct type_table *retired; /* previous, smaller table */
+  type_entry_t slots[];
+} type_table_t;
+
+static pthread_mutex_t g_type_lock = PTHREAD_MUTEX_INITIALIZER;
+static _Atomic(type_table_t *) g_type_table = NULL;
+static size_t g_type_count = 0;
+
+static type_entry_t *type_slot(type_table_t *t, uint32_t id) {
+  size_t mask = t->cap - 1;
+  for (size_t i = id & mask;; i = (i + 1) & mask) {
+    uint32_t cur = atomic_load_explicit(&t->slots[i].id, memory_order_acquire);
+    if (cur == id || cur == 0) return &t->slots[i];
+  }
+}
+
+/* Lock-free lookup; the entry stays valid for the life of the process. */
+static const type_entry_t *type_lookup(uint32_t id) {
+  type_table_t *t = atomic_load_explicit(&g_type_table, memory_order_acquire);
+  if (!t) return NULL;
+  const type_entry_t *e = type_slot(t, id);
+  return atomic_load_explicit(&e->id, memory_order_acquire) == id ? e : NULL;
+}
+
+static type_table_t *type_table_grow(type_table_t *old) {
+  size_t cap = old ? old->cap * 2 : 64;
+  type_table_t *t = (type_table_t *)calloc(1, sizeof(*t) + cap * sizeof(type_entry_t));
+  if (!t) return NULL;
+  t->cap = cap;
+  t->retired = old;
+  for (size_t i = 0; old && i < old->cap; i++) {
+    uint32_t id = atomic_load_explicit(&old->slots[i].id, memory_order_relaxed);
+    if (!id) continue;
+    type_entry_t *e = type_slot(t, id);
+    memcpy(e->name, old->slots[i].name, sizeof(e->name));
+    atomic_store_explicit(&e->id, id, memory_order_relaxed);
+  }
+  atomic_store_explicit(&g_type_table, t, memory_order_release);
+  return t;
+}
+
+int zcm_msg_type_intern(const char *type, uint32_t *id) {
+  if (!type || !*type) return ZCM_MSG_ERR;
+  uint32_t h = zcm_msg_type_id(type);
+  int rc = ZCM_MSG_OK;
+  pthread_mutex_lock(&g_type_lock);
+  type_table_t *t = atomic_load_explicit(&g_type_table, memory_order_relaxed);
+  if (!t || (g_type_count + 1) * 2 > t->cap) t = type_table_grow(t);
+  if (!t) {
+    rc = ZCM_MSG_ERR;
+  } else {
+    type_entry_t *e = type_slot(t, h);
+    if (atomic_load_explicit(&e->id, memory_order_relaxed) == 0) {
+      strncpy(e->name, type, sizeof(e->name) - 1);
+      e->name[sizeof(e->name) - 1] = '\0';
+      atomic_store_explicit(&e->id, h, memory_order_release);
+      g_type_count++;
+    } else if (strncmp(e->name, type, sizeof(e->name) - 1) != 0) {
+      rc = ZCM_MSG_ERR_TYPE; /* hash collision with another interned name */
+    }
+  }
+  pthread_mutex_unlock(&g_type_lock);
+  if (rc == ZCM_MSG_OK && id) *id = h;
+  return rc;
+}
+
+int zcm_msg_type_name(uint32_t id, char *out, size_t out_size) {
+  if (!out || out_size == 0 || id == 0) return ZCM_MSG_ERR;
+  const type_entry_t *e = type_lookup(id);
+  if (!e) return ZCM_MSG_ERR_TYPE;
+  snprintf(out, out_size, "%s", e->name);
+  return ZCM_MSG_OK;
+}
+
 int zcm_msg_put_char(zcm_msg_t *msg, char value) {
   if (put_u8(msg, ZCM_MSG_ITEM_CHAR) != 0) return ZCM_MSG_ERR;
   return put_bytes(msg, &value, 1);
@@ -237,108 +766,304 @@ int zcm_msg_put_double(zcm_msg_t *msg, double value) {
 int zcm_msg_put_text(zcm_msg_t *msg, const char *value) {
   if (!value) value = "";
   uint32_t len = (uint32_t)strlen(value);
-  if (put_u8(msg, ZCM_MSG_ITEM_TEXT) != 0) return ZCM_MSG_ERR;
-  if (put_u32(msg, len) != 0) return ZCM_MSG_ERR;
+  if (ensure_cap(msg, 1 + 4 + (size_t)len) != 0) return ZCM_MSG_ERR;
+  put_u8(msg, ZCM_MSG_ITEM_TEXT);
+  put_u32(msg, len);
   return put_bytes(msg, value, len);
 }
 
 int zcm_msg_put_bytes(zcm_msg_t *msg, const void *data, uint32_t len) {
-  if (put_u8(msg, ZCM_MSG_ITEM_BYTES) != 0) return ZCM_MSG_ERR;
-  if (put_u32(msg, len) != 0) return ZCM_MSG_ERR;
+  if (ensure_cap(msg, 1 + 4 + (size_t)len) != 0) return ZCM_MSG_ERR;
+  put_u8(msg, ZCM_MSG_ITEM_BYTES);
+  put_u32(msg, len);
   return put_bytes(msg, data, len);
 }
 
+int zcm_msg_reserve(zcm_msg_t *msg, size_t bytes) {
+  if (!msg) return ZCM_MSG_ERR;
+  /* ensure_cap() drops the index; a reservation alone does not change the
+   * payload, so keep it. */
+  int index_valid = msg->index_valid;
+  int trusted = msg->trusted;
+  if (ensure_cap(msg, bytes) != 0) return ZCM_MSG_ERR;
+  msg->index_valid = index_valid;
+  msg->trusted = trusted;
+  return ZCM_MSG_OK;
+}
+
+int zcm_msg_writer_begin(zcm_msg_t *msg, zcm_msg_writer_t *w, size_t bytes) {
+  if (!w) return ZCM_MSG_ERR;
+  w->msg = NULL;
+  w->pos = w->end = NULL;
+  if (ensure_cap(msg, bytes) != 0) return ZCM_MSG_ERR;
+  w->msg = msg;
+  w->pos = msg->buf + msg->len;
+  w->end = w->pos + bytes;
+  return ZCM_MSG_OK;
+}
+
+int zcm_msg_writer_commit(zcm_msg_writer_t *w) {
+  if (!w || !w->msg) return ZCM_MSG_ERR;
+  zcm_msg_t *msg = w->msg;
+  uint8_t *start = msg->buf + msg->len;
+  if (w->pos < start || w->pos > w->end) {
+    set_error(msg, "writer overran its reservation");
+    w->msg = NULL;
+    return ZCM_MSG_ERR_RANGE;
+  }
+  msg->len += (size_t)(w->pos - start);
+  msg->index_valid = 0;
+  msg->trusted = 0;
+  w->msg = NULL;
+  return ZCM_MSG_OK;
+}
+
 int zcm_msg_put_array(zcm_msg_t *msg, zcm_msg_array_type_t type,
                       uint32_t elements, const void *data) {
-  if (put_u8(msg, ZCM_MSG_ITEM_ARRAY) != 0) return ZCM_MSG_ERR;
-  if (put_u8(msg, (uint8_t)type) != 0) return ZCM_MSG_ERR;
-  if (put_u32(msg, elements) != 0) return ZCM_MSG_ERR;
-  size_t elem_size = 0;
-  switch (type) {
-    case ZCM_MSG_ARRAY_CHAR: elem_size = 1; break;
-    case ZCM_MSG_ARRAY_SHORT: elem_size = 2; break;
-    case ZCM_MSG_ARRAY_INT: elem_size = 4; break;
-    case ZCM_MSG_ARRAY_FLOAT: elem_size = 4; break;
-    case ZCM_MSG_ARRAY_DOUBLE: elem_size = 8; break;
-    default: return ZCM_MSG_ERR_TYPE;
-  }
+  size_t elem_size = array_elem_size((uint8_t)type);
+  if (elem_size == 0) return ZCM_MSG_ERR_TYPE;
   if (elements > 0 && data == NULL) return ZCM_MSG_ERR;
-  if (type == ZCM_MSG_ARRAY_CHAR) {
-    return put_bytes(msg, data, elem_size * elements);
+  size_t total = elem_size * elements;
+  if (ensure_cap(msg, 1 + 1 + 4 + total) != 0) return ZCM_MSG_ERR;
+  put_u8(msg, ZCM_MSG_ITEM_ARRAY);
+  put_u8(msg, (uint8_t)type);
+  put_u32(msg, elements);
+  copy_le_elems(msg->buf + msg->len, data, elements, elem_size);
+  msg->len += total;
+  return ZCM_MSG_OK;
+}
+
+int zcm_msg_put_array_delta(zcm_msg_t *msg, zcm_msg_array_type_t type,
+                            uint32_t elements, const void *data) {
+  if (!array_delta_base_ok((uint8_t)type)) return ZCM_MSG_ERR_TYPE;
+  if (elements > 0 && data == NULL) return ZCM_MSG_ERR;
+
+  /* Size pass first so the buffer grows once to the exact encoded length. */
+  size_t coded = 0;
+  uint64_t prev = 0;
+  for (uint32_t i = 0; i < elements; i++) {
+    uint64_t v = load_wide(data, i, (uint8_t)type);
+    coded += varint_len(zigzag_delta(v, prev));
+    prev = v;
   }
-  if (ensure_cap(msg, elem_size * elements) != 0) return ZCM_MSG_ERR;
-  const uint8_t *src = (const uint8_t *)data;
+  if (coded > UINT32_MAX) return ZCM_MSG_ERR_RANGE;
+  if (ensure_cap(msg, 1 + 1 + 4 + 4 + coded) != 0) return ZCM_MSG_ERR;
+  put_u8(msg, ZCM_MSG_ITEM_ARRAY);
+  put_u8(msg, (uint8_t)(type | ZCM_ARRAY_DELTA));
+  put_u32(msg, elements);
+  put_u32(msg, (uint32_t)coded);
+
+  uint8_t *out = msg->buf + msg->len;
+  prev = 0;
   for (uint32_t i = 0; i < elements; i++) {
-    switch (type) {
-      case ZCM_MSG_ARRAY_SHORT: {
-        uint16_t v = 0;
-        memcpy(&v, src + i * elem_size, 2);
-        uint16_t w = le16(v);
-        memcpy(msg->buf + msg->len, &w, 2);
-        msg->len += 2;
-        break;
-      }
-      case ZCM_MSG_ARRAY_INT:
-      case ZCM_MSG_ARRAY_FLOAT: {
-        uint32_t v = 0;
-        memcpy(&v, src + i * elem_size, 4);
-        uint32_t w = le32(v);
-        memcpy(msg->buf + msg->len, &w, 4);
-        msg->len += 4;
-        break;
-      }
-      case ZCM_MSG_ARRAY_DOUBLE: {
-        uint64_t v = 0;
-        memcpy(&v, src + i * elem_size, 8);
-        uint64_t w = le64(v);
-        memcpy(msg->buf + msg->len, &w, 8);
-        msg->len += 8;
-        break;
-      }
-      default:
-        return ZCM_MSG_ERR_TYPE;
+    uint64_t v = load_wide(data, i, (uint8_t)type);
+    uint64_t zz = zigzag_delta(v, prev);
+    prev = v;
+    while (zz >= 0x80u) {
+      *out++ = (uint8_t)(zz | 0x80u);
+      zz >>= 7;
     }
+    *out++ = (uint8_t)zz;
   }
+  msg->len += coded;
   return ZCM_MSG_OK;
 }
 
+static int push_ref(zcm_msg_t *msg, const void *data, size_t len,
+                    void (*release)(void *ctx), void *ctx) {
+  if (msg->ref_count == msg->ref_cap) {
+    size_t new_cap = msg->ref_cap ? msg->ref_cap * 2 : 4;
+    zcm_msg_ref_t *nr = (zcm_msg_ref_t *)realloc(msg->refs, new_cap * sizeof(*nr));
+    if (!nr) return ZCM_MSG_ERR;
+    msg->refs = nr;
+    msg->ref_cap = new_cap;
+  }
+  zcm_msg_ref_hold_t *hold = (zcm_msg_ref_hold_t *)malloc(sizeof(*hold));
+  if (!hold) return ZCM_MSG_ERR;
+  atomic_init(&hold->refs, 1);
+  hold->release = release;
+  hold->ctx = ctx;
+  zcm_msg_ref_t *r = &msg->refs[msg->ref_count++];
+  r->off = msg->len;
+  r->data = data;
+  r->len = len;
+  r->hold = hold;
+  msg->ref_bytes += len;
+  return ZCM_MSG_OK;
+}
+
+int zcm_msg_put_bytes_ref(zcm_msg_t *msg, const void *data, uint32_t len,
+                          void (*release)(void *ctx), void *ctx) {
+  if (!msg || (!data && len)) return ZCM_MSG_ERR;
+  if (msg->len + msg->ref_bytes + 5 + (size_t)len > UINT32_MAX) return ZCM_MSG_ERR_RANGE;
+  size_t start = msg->len;
+  if (ensure_cap(msg, 1 + 4) != 0) return ZCM_MSG_ERR;
+  put_u8(msg, ZCM_MSG_ITEM_BYTES);
+  put_u32(msg, len);
+  if (push_ref(msg, data, len, release, ctx) != 0) {
+    msg->len = start;
+    return ZCM_MSG_ERR;
+  }
+  return ZCM_MSG_OK;
+}
+
+int zcm_msg_put_array_ref(zcm_msg_t *msg, zcm_msg_array_type_t type, uint32_t elements,
+                          const void *data, void (*release)(void *ctx), void *ctx) {
+  size_t elem_size = array_elem_size((uint8_t)type);
+  if (!msg) return ZCM_MSG_ERR;
+  if (elem_size == 0) return ZCM_MSG_ERR_TYPE;
+  if (elements > 0 && data == NULL) return ZCM_MSG_ERR;
+  size_t total = elem_size * elements;
+  if (msg->len + msg->ref_bytes + 6 + total > UINT32_MAX) return ZCM_MSG_ERR_RANGE;
+#if ZCM_HOST_BIG_ENDIAN
+  /* Elements need byte swapping for the wire, so they cannot be referenced. */
+  if (elem_size > 1) {
+    int rc = zcm_msg_put_array(msg, type, elements, data);
+    if (rc == ZCM_MSG_OK && release) release(ctx);
+    return rc;
+  }
+#endif
+  size_t start = msg->len;
+  if (ensure_cap(msg, 1 + 1 + 4) != 0) return ZCM_MSG_ERR;
+  put_u8(msg, ZCM_MSG_ITEM_ARRAY);
+  put_u8(msg, (uint8_t)type);
+  put_u32(msg, elements);
+  if (push_ref(msg, data, total, release, ctx) != 0) {
+    msg->len = start;
+    return ZCM_MSG_ERR;
+  }
+  return ZCM_MSG_OK;
+}
+
+/* Value helpers write the marker/kind/value triplet every peer decodes; the
+ * compact VALUE item is opt-in (ZCM_MSG_VALUE_COMPACT=1 or
+ * zcm_msg_set_value_compact()) until all readers understand it. */
+static pthread_once_t g_value_compact_once = PTHREAD_ONCE_INIT;
+static atomic_int g_value_compact;
+
+static void value_compact_init(void) {
+  const char *env = getenv("ZCM_MSG_VALUE_COMPACT");
+  atomic_store(&g_value_compact, (env && strcmp(env, "1") == 0) ? 1 : 0);
+}
+
+static int value_compact_encoding(void) {
+  pthread_once(&g_value_compact_once, value_compact_init);
+  return atomic_load(&g_value_compact);
+}
+
+void zcm_msg_set_value_compact(int enable) {
+  pthread_once(&g_value_compact_once, value_compact_init);
+  atomic_store(&g_value_compact, enable ? 1 : 0);
+}
+
+int zcm_msg_value_compact(void) {
+  return value_compact_encoding();
+}
+
+size_t zcm_msg_size_hint_value(zcm_msg_value_kind_t kind, size_t text_len) {
+  size_t body = 0;
+  const char *legacy_kind = NULL;
+  switch (kind) {
+    case ZCM_MSG_VALUE_TEXT:
+      body = 4 + text_len;
+      legacy_kind = k_value_kind_text;
+      break;
+    case ZCM_MSG_VALUE_DOUBLE:
+      body = 8;
+      legacy_kind = k_value_kind_double;
+      break;
+    case ZCM_MSG_VALUE_FLOAT:
+      body = 4;
+      legacy_kind = k_value_kind_float;
+      break;
+    case ZCM_MSG_VALUE_INT:
+      body = 4;
+      legacy_kind = k_value_kind_int;
+      break;
+    default:
+      return 0;
+  }
+  if (value_compact_encoding()) return 2 + body;
+  /* marker TEXT + kind TEXT + tagged value item */
+  return (1 + 4 + strlen(k_value_marker)) + (1 + 4 + strlen(legacy_kind)) + 1 + body;
+}
+
 static int put_value_prefix(zcm_msg_t *msg, const char *kind) {
   if (zcm_msg_put_text(msg, k_value_marker) != 0) return ZCM_MSG_ERR;
   if (zcm_msg_put_text(msg, kind) != 0) return ZCM_MSG_ERR;
   return ZCM_MSG_OK;
 }
 
+static int put_value_head(zcm_msg_t *msg, zcm_msg_value_kind_t kind, size_t body) {
+  if (ensure_cap(msg, 2 + body) != 0) return ZCM_MSG_ERR;
+  put_u8(msg, ZCM_MSG_ITEM_VALUE);
+  put_u8(msg, (uint8_t)kind);
+  return ZCM_MSG_OK;
+}
+
 int zcm_msg_put_value_text(zcm_msg_t *msg, const char *value) {
   if (!msg) return ZCM_MSG_ERR;
-  if (put_value_prefix(msg, k_value_kind_text) != 0) return ZCM_MSG_ERR;
-  return zcm_msg_put_text(msg, value);
+  if (!value_compact_encoding()) {
+    if (put_value_prefix(msg, k_value_kind_text) != 0) return ZCM_MSG_ERR;
+    return zcm_msg_put_text(msg, value);
+  }
+  if (!value) value = "";
+  size_t len = strlen(value);
+  if (len > UINT32_MAX) return ZCM_MSG_ERR_RANGE;
+  if (put_value_head(msg, ZCM_MSG_VALUE_TEXT, 4 + len) != 0) return ZCM_MSG_ERR;
+  put_u32(msg, (uint32_t)len);
+  return put_bytes(msg, value, len);
 }
 
 int zcm_msg_put_value_double(zcm_msg_t *msg, double value) {
   if (!msg) return ZCM_MSG_ERR;
-  if (put_value_prefix(msg, k_value_kind_double) != 0) return ZCM_MSG_ERR;
-  return zcm_msg_put_double(msg, value);
+  if (!value_compact_encoding()) {
+    if (put_value_prefix(msg, k_value_kind_double) != 0) return ZCM_MSG_ERR;
+    return zcm_msg_put_double(msg, value);
+  }
+  uint64_t bits = 0;
+  memcpy(&bits, &value, sizeof(bits));
+  if (put_value_head(msg, ZCM_MSG_VALUE_DOUBLE, 8) != 0) return ZCM_MSG_ERR;
+  return put_u64(msg, bits);
 }
 
 int zcm_msg_put_value_float(zcm_msg_t *msg, float value) {
   if (!msg) return ZCM_MSG_ERR;
-  if (put_value_prefix(msg, k_value_kind_float) != 0) return ZCM_MSG_ERR;
-  return zcm_msg_put_float(msg, value);
+  if (!value_compact_encoding()) {
+    if (put_value_prefix(msg, k_value_kind_float) != 0) return ZCM_MSG_ERR;
+    return zcm_msg_put_float(msg, value);
+  }
+  uint32_t bits = 0;
+  memcpy(&bits, &value, sizeof(bits));
+  if (put_value_head(msg, ZCM_MSG_VALUE_FLOAT, 4) != 0) return ZCM_MSG_ERR;
+  return put_u32(msg, bits);
 }
 
 int zcm_msg_put_value_int(zcm_msg_t *msg, int32_t value) {
   if (!msg) return ZCM_MSG_ERR;
-  if (put_value_prefix(msg, k_value_kind_int) != 0) return ZCM_MSG_ERR;
-  return zcm_msg_put_int(msg, value);
+  if (!value_compact_encoding()) {
+    if (put_value_prefix(msg, k_value_kind_int) != 0) return ZCM_MSG_ERR;
+    return zcm_msg_put_int(msg, value);
+  }
+  if (put_value_head(msg, ZCM_MSG_VALUE_INT, 4) != 0) return ZCM_MSG_ERR;
+  return put_u32(msg, (uint32_t)value);
 }
 
+/* Consumes the item tag when it matches. The end-of-payload check stays even
+ * for trusted messages: a trusted cursor always sits on an item boundary, so
+ * it is the only check the item body needs. */
 static int expect_type(zcm_msg_t *msg, zcm_msg_item_type_t type) {
-  uint8_t t = 0;
-  if (get_u8(msg, &t) != 0) return ZCM_MSG_ERR_RANGE;
-  if (t != (uint8_t)type) {
+  if (!msg) return ZCM_MSG_ERR;
+  if (msg->ref_count && flatten_refs(msg) != 0) return ZCM_MSG_ERR;
+  if (msg->read_off >= msg->len) {
+    set_error(msg, "read overflow");
+    return ZCM_MSG_ERR_RANGE;
+  }
+  if (msg->buf[msg->read_off] != (uint8_t)type) {
     set_error(msg, "unexpected item type");
     return ZCM_MSG_ERR_TYPE;
   }
+  msg->read_off++;
   return ZCM_MSG_OK;
 }
 
@@ -420,56 +1145,92 @@ int zcm_msg_get_bytes(zcm_msg_t *msg, const void **data, uint32_t *len) {
   return ZCM_MSG_OK;
 }
 
+/* Reads an array item header. `*wire` points at `*wire_len` payload bytes:
+ * little-endian elements, or the varint stream when `*delta` is set (in which
+ * case `*type` is the base element type). */
+static int read_array_header(zcm_msg_t *msg, uint8_t *type, uint32_t *elems,
+                             size_t *elem_size, const void **wire, uint32_t *wire_len,
+                             int *delta) {
+  if (expect_type(msg, ZCM_MSG_ITEM_ARRAY) != 0) return ZCM_MSG_ERR_TYPE;
+  if (get_u8(msg, type) != 0) return ZCM_MSG_ERR_RANGE;
+  if (get_u32(msg, elems) != 0) return ZCM_MSG_ERR_RANGE;
+  *delta = (*type & ZCM_ARRAY_DELTA) != 0;
+  if (*delta) {
+    *type &= (uint8_t)~ZCM_ARRAY_DELTA;
+    if (!array_delta_base_ok(*type)) {
+      set_error(msg, "unknown array type");
+      return ZCM_MSG_ERR_TYPE;
+    }
+    *elem_size = array_elem_size(*type);
+    if (get_u32(msg, wire_len) != 0) return ZCM_MSG_ERR_RANGE;
+    if (*elems > *wire_len) { /* every element takes at least one byte */
+      set_error(msg, "malformed varint array");
+      return ZCM_MSG_ERR_FORMAT;
+    }
+    if (get_bytes(msg, wire, *wire_len) != 0) return ZCM_MSG_ERR_RANGE;
+    return ZCM_MSG_OK;
+  }
+  *elem_size = array_elem_size(*type);
+  if (*elem_size == 0) {
+    set_error(msg, "unknown array type");
+    return ZCM_MSG_ERR_TYPE;
+  }
+  uint64_t total = (uint64_t)*elem_size * *elems;
+  if (total > UINT32_MAX) {
+    set_error(msg, "read overflow");
+    return ZCM_MSG_ERR_RANGE;
+  }
+  *wire_len = (uint32_t)total;
+  if (get_bytes(msg, wire, *wire_len) != 0) return ZCM_MSG_ERR_RANGE;
+  return ZCM_MSG_OK;
+}
+
+/* Host-order elements of the array just read into `dst`. */
+static int decode_array(zcm_msg_t *msg, void *dst, const void *wire, uint32_t wire_len,
+                        uint32_t elems, uint8_t type, size_t elem_size, int delta) {
+  if (!delta) {
+    copy_le_elems(dst, wire, elems, elem_size);
+    return ZCM_MSG_OK;
+  }
+  int rc = decode_delta_elems(dst, (const uint8_t *)wire, wire_len, elems, type);
+  if (rc != ZCM_MSG_OK) set_error(msg, "malformed varint array");
+  return rc;
+}
+
 int zcm_msg_get_array(zcm_msg_t *msg, zcm_msg_array_type_t *type,
                       uint32_t *elements, const void **data) {
   if (!type || !elements || !data) return ZCM_MSG_ERR;
-  if (expect_type(msg, ZCM_MSG_ITEM_ARRAY) != 0) return ZCM_MSG_ERR_TYPE;
+  size_t start = msg ? msg->read_off : 0;
   uint8_t t = 0;
-  if (get_u8(msg, &t) != 0) return ZCM_MSG_ERR_RANGE;
   uint32_t elems = 0;
-  if (get_u32(msg, &elems) != 0) return ZCM_MSG_ERR_RANGE;
   size_t elem_size = 0;
-  switch ((zcm_msg_array_type_t)t) {
-    case ZCM_MSG_ARRAY_CHAR: elem_size = 1; break;
-    case ZCM_MSG_ARRAY_SHORT: elem_size = 2; break;
-    case ZCM_MSG_ARRAY_INT: elem_size = 4; break;
-    case ZCM_MSG_ARRAY_FLOAT: elem_size = 4; break;
-    case ZCM_MSG_ARRAY_DOUBLE: elem_size = 8; break;
-    default: return ZCM_MSG_ERR_TYPE;
-  }
-  size_t total = elem_size * elems;
   const void *p = NULL;
-  if (get_bytes(msg, &p, (uint32_t)total) != 0) return ZCM_MSG_ERR_RANGE;
-  if (t != ZCM_MSG_ARRAY_CHAR) {
-    uint8_t *buf = (uint8_t *)p;
-    for (uint32_t i = 0; i < elems; i++) {
-      switch ((zcm_msg_array_type_t)t) {
-        case ZCM_MSG_ARRAY_SHORT: {
-          uint16_t v = 0;
-          memcpy(&v, buf + i * elem_size, 2);
-          v = le16(v);
-          memcpy(buf + i * elem_size, &v, 2);
-          break;
-        }
-        case ZCM_MSG_ARRAY_INT:
-        case ZCM_MSG_ARRAY_FLOAT: {
-          uint32_t v = 0;
-          memcpy(&v, buf + i * elem_size, 4);
-          v = le32(v);
-          memcpy(buf + i * elem_size, &v, 4);
-          break;
-        }
-        case ZCM_MSG_ARRAY_DOUBLE: {
-          uint64_t v = 0;
-          memcpy(&v, buf + i * elem_size, 8);
-          v = le64(v);
-          memcpy(buf + i * elem_size, &v, 8);
-          break;
-        }
-        default:
-          return ZCM_MSG_ERR_TYPE;
+  uint32_t wire_len = 0;
+  int delta = 0;
+  int rc = read_array_header(msg, &t, &elems, &elem_size, &p, &wire_len, &delta);
+  if (rc != ZCM_MSG_OK) return rc;
+  int need_copy = delta;
+#if ZCM_HOST_BIG_ENDIAN
+  if (elem_size > 1) need_copy = 1;
+#endif
+  if (need_copy && elems > 0) {
+    size_t total = elem_size * elems;
+    if (total > msg->scratch_cap) {
+      uint8_t *ns = (uint8_t *)realloc(msg->scratch, total);
+      if (!ns) {
+        msg->read_off = start;
+        set_error(msg, "out of memory");
+        return ZCM_MSG_ERR;
       }
+      msg->scratch = ns;
+      msg->scratch_cap = total;
+    }
+    rc = decode_array(msg, msg->scratch, p, wire_len, elems, t, elem_size, delta);
+    if (rc != ZCM_MSG_OK) {
+      msg->read_off = start;
+      return rc;
     }
+    p = msg->scratch;
   }
   *type = (zcm_msg_array_type_t)t;
   *elements = elems;
@@ -477,14 +1238,88 @@ int zcm_msg_get_array(zcm_msg_t *msg, zcm_msg_array_type_t *type,
   return ZCM_MSG_OK;
 }
 
+int zcm_msg_get_array_copy(zcm_msg_t *msg, zcm_msg_array_type_t *type,
+                           uint32_t *elements, void *dst, size_t dst_len) {
+  if (!msg || !type || !elements || (!dst && dst_len)) return ZCM_MSG_ERR;
+  size_t start = msg->read_off;
+  uint8_t t = 0;
+  uint32_t elems = 0;
+  size_t elem_size = 0;
+  const void *p = NULL;
+  uint32_t wire_len = 0;
+  int delta = 0;
+  int rc = read_array_header(msg, &t, &elems, &elem_size, &p, &wire_len, &delta);
+  if (rc != ZCM_MSG_OK) return rc;
+  *type = (zcm_msg_array_type_t)t;
+  *elements = elems;
+  if (elem_size * elems > dst_len) {
+    msg->read_off = start;
+    set_error(msg, "destination too small");
+    return ZCM_MSG_ERR_RANGE;
+  }
+  rc = decode_array(msg, dst, p, wire_len, elems, t, elem_size, delta);
+  if (rc != ZCM_MSG_OK) msg->read_off = start;
+  return rc;
+}
+
 static int text_eq(const char *ptr, uint32_t len, const char *lit) {
   size_t n = strlen(lit);
   if (len != n) return 0;
   return memcmp(ptr, lit, n) == 0;
 }
 
+static int get_value_compact(zcm_msg_t *msg, zcm_msg_value_t *out) {
+  size_t start = msg->read_off;
+  uint8_t kind = 0;
+  msg->read_off++; /* item tag, checked by the caller */
+  if (get_u8(msg, &kind) != 0) goto fail;
+  memset(out, 0, sizeof(*out));
+  switch (kind) {
+    case ZCM_MSG_VALUE_TEXT: {
+      uint32_t l = 0;
+      const void *p = NULL;
+      if (get_u32(msg, &l) != 0 || get_bytes(msg, &p, l) != 0) goto fail;
+      out->text = (const char *)p;
+      out->text_len = l;
+      break;
+    }
+    case ZCM_MSG_VALUE_DOUBLE: {
+      uint64_t bits = 0;
+      if (get_u64(msg, &bits) != 0) goto fail;
+      memcpy(&out->d, &bits, sizeof(bits));
+      break;
+    }
+    case ZCM_MSG_VALUE_FLOAT: {
+      uint32_t bits = 0;
+      if (get_u32(msg, &bits) != 0) goto fail;
+      memcpy(&out->f, &bits, sizeof(bits));
+      break;
+    }
+    case ZCM_MSG_VALUE_INT: {
+      uint32_t v = 0;
+      if (get_u32(msg, &v) != 0) goto fail;
+      out->i = (int32_t)v;
+      break;
+    }
+    default:
+      msg->read_off = start;
+      set_error(msg, "unknown value kind");
+      return ZCM_MSG_ERR_TYPE;
+  }
+  out->kind = (zcm_msg_value_kind_t)kind;
+  return ZCM_MSG_OK;
+
+fail:
+  msg->read_off = start;
+  return ZCM_MSG_ERR_RANGE;
+}
+
 int zcm_msg_get_value(zcm_msg_t *msg, zcm_msg_value_t *out) {
   if (!msg || !out) return ZCM_MSG_ERR;
+  if (flatten_refs(msg) != 0) return ZCM_MSG_ERR;
+  if (msg->read_off < msg->len && msg->buf[msg->read_off] == ZCM_MSG_ITEM_VALUE) {
+    return get_value_compact(msg, out);
+  }
 
   const char *marker = NULL;
   uint32_t marker_len = 0;
@@ -537,39 +1372,70 @@ int zcm_msg_get_value(zcm_msg_t *msg, zcm_msg_value_t *out) {
   return ZCM_MSG_ERR_TYPE;
 }
 
+/* Read-only: with references pending the payload is not contiguous yet. */
 const void *zcm_msg_data(const zcm_msg_t *msg, size_t *len) {
-  if (!msg) return NULL;
+  if (!msg || msg->ref_count) return NULL;
   if (len) *len = msg->len;
   return msg->buf;
 }
 
 size_t zcm_msg_remaining(const zcm_msg_t *msg) {
   if (!msg) return 0;
+  if (msg->ref_count) return msg->len + msg->ref_bytes - msg->read_off;
   if (msg->read_off >= msg->len) return 0;
   return msg->len - msg->read_off;
 }
 
-int zcm_msg_from_bytes(zcm_msg_t *msg, const void *data, size_t len) {
-  if (!msg || !data || len < 12) return ZCM_MSG_ERR_FORMAT;
+static int parse_envelope(zcm_msg_t *msg, const void *data, size_t len,
+                          const uint8_t **payload, uint32_t *payload_len) {
+  if (!msg || !data || len < ZCM_HEADER_LEN) return ZCM_MSG_ERR_FORMAT;
   const uint8_t *p = (const uint8_t *)data;
   uint32_t magic = 0;
   uint16_t version = 0;
   uint16_t type_len = 0;
-  uint32_t payload_len = 0;
+  uint32_t plen = 0;
   memcpy(&magic, p, 4); p += 4;
   memcpy(&version, p, 2); p += 2;
   memcpy(&type_len, p, 2); p += 2;
-  memcpy(&payload_len, p, 4); p += 4;
+  memcpy(&plen, p, 4); p += 4;
   magic = le32(magic);
   version = le16(version);
   type_len = le16(type_len);
-  payload_len = le32(payload_len);
-
+  plen = le32(plen);
+
+  if (magic == ZCM_MAGIC && version == ZCM_VERSION_TYPE_ID) {
+    /* Compact envelope: the u16 after the version is reserved and a u32
+     * type ID follows the payload length. */
+    if (len < ZCM_ID_HEADER_LEN) return ZCM_MSG_ERR_FORMAT;
+    uint32_t id = 0;
+    memcpy(&id, p, 4); p += 4;
+    id = le32(id);
+    if (len - ZCM_ID_HEADER_LEN < plen) {
+      set_error(msg, "truncated message");
+      return ZCM_MSG_ERR_RANGE;
+    }
+    zcm_msg_reset(msg);
+    if (id == 0) {
+      set_error(msg, "bad type id");
+      return ZCM_MSG_ERR_FORMAT;
+    }
+    /* Unknown IDs stay dispatchable by number; the name is a placeholder. */
+    const type_entry_t *known = type_lookup(id);
+    if (known) {
+      memcpy(msg->type, known->name, strlen(known->name) + 1);
+    } else {
+      snprintf(msg->type, sizeof(msg->type), "#%08x", id);
+    }
+    msg->type_id = id;
+    *payload = p;
+    *payload_len = plen;
+    return ZCM_MSG_OK;
+  }
   if (magic != ZCM_MAGIC || version != ZCM_VERSION) {
     set_error(msg, "bad magic/version");
     return ZCM_MSG_ERR_FORMAT;
   }
-  size_t need = 12 + type_len + payload_len;
+  size_t need = ZCM_HEADER_LEN + type_len + plen;
   if (len < need) {
     set_error(msg, "truncated message");
     return ZCM_MSG_ERR_RANGE;
@@ -584,111 +1450,608 @@ int zcm_msg_from_bytes(zcm_msg_t *msg, const void *data, size_t len) {
   memcpy(msg->type, type, type_len);
   msg->type[type_len] = '\0';
 
-  const uint8_t *payload = p + type_len;
+  *payload = p + type_len;
+  *payload_len = plen;
+  return ZCM_MSG_OK;
+}
+
+int zcm_msg_from_bytes(zcm_msg_t *msg, const void *data, size_t len) {
+  const uint8_t *payload = NULL;
+  uint32_t payload_len = 0;
+  int rc = parse_envelope(msg, data, len, &payload, &payload_len);
+  if (rc != ZCM_MSG_OK) return rc;
   if (ensure_cap(msg, payload_len) != 0) return ZCM_MSG_ERR;
-  memcpy(msg->buf, payload, payload_len);
+  if (payload_len) memcpy(msg->buf, payload, payload_len);
   msg->len = payload_len;
   msg->read_off = 0;
   return ZCM_MSG_OK;
 }
 
-int zcm_msg_validate(const zcm_msg_t *msg) {
-  if (!msg) return ZCM_MSG_ERR;
-  zcm_msg_t tmp = *msg;
-  tmp.read_off = 0;
-  tmp.last_error[0] = '\0';
-
-  while (tmp.read_off < tmp.len) {
-    uint8_t t = 0;
-    if (get_u8(&tmp, &t) != 0) return ZCM_MSG_ERR_RANGE;
-    switch (t) {
-      case ZCM_MSG_ITEM_CHAR:
-        if (tmp.read_off + 1 > tmp.len) return ZCM_MSG_ERR_RANGE;
-        tmp.read_off += 1;
-        break;
-      case ZCM_MSG_ITEM_SHORT:
-        if (tmp.read_off + 2 > tmp.len) return ZCM_MSG_ERR_RANGE;
-        tmp.read_off += 2;
-        break;
-      case ZCM_MSG_ITEM_INT:
-      case ZCM_MSG_ITEM_FLOAT:
-        if (tmp.read_off + 4 > tmp.len) return ZCM_MSG_ERR_RANGE;
-        tmp.read_off += 4;
-        break;
-      case ZCM_MSG_ITEM_LONG:
-      case ZCM_MSG_ITEM_DOUBLE:
-        if (tmp.read_off + 8 > tmp.len) return ZCM_MSG_ERR_RANGE;
-        tmp.read_off += 8;
-        break;
-      case ZCM_MSG_ITEM_TEXT:
-      case ZCM_MSG_ITEM_BYTES: {
-        uint32_t l = 0;
-        if (get_u32(&tmp, &l) != 0) return ZCM_MSG_ERR_RANGE;
-        if (tmp.read_off + l > tmp.len) return ZCM_MSG_ERR_RANGE;
-        tmp.read_off += l;
-        break;
-      }
-      case ZCM_MSG_ITEM_ARRAY: {
-        uint8_t at = 0;
-        if (get_u8(&tmp, &at) != 0) return ZCM_MSG_ERR_RANGE;
-        uint32_t elems = 0;
-        if (get_u32(&tmp, &elems) != 0) return ZCM_MSG_ERR_RANGE;
-        size_t elem_size = 0;
-        switch ((zcm_msg_array_type_t)at) {
-          case ZCM_MSG_ARRAY_CHAR: elem_size = 1; break;
-          case ZCM_MSG_ARRAY_SHORT: elem_size = 2; break;
-          case ZCM_MSG_ARRAY_INT: elem_size = 4; break;
-          case ZCM_MSG_ARRAY_FLOAT: elem_size = 4; break;
-          case ZCM_MSG_ARRAY_DOUBLE: elem_size = 8; break;
-          default: return ZCM_MSG_ERR_TYPE;
-        }
-        size_t total = elem_size * elems;
-        if (tmp.read_off + total > tmp.len) return ZCM_MSG_ERR_RANGE;
-        tmp.read_off += total;
-        break;
+/* internal helper used by transport: adopt a received frame without copying.
+ * On success `release(ctx)` is called once the message drops the view; on
+ * failure ownership stays with the caller. */
+int zcm_msg__from_borrowed(zcm_msg_t *msg, void *data, size_t len,
+                           void (*release)(void *ctx), void *ctx) {
+  if (!release) return ZCM_MSG_ERR;
+  const uint8_t *payload = NULL;
+  uint32_t payload_len = 0;
+  int rc = parse_envelope(msg, data, len, &payload, &payload_len);
+  if (rc != ZCM_MSG_OK) return rc;
+  msg->buf = (uint8_t *)payload;
+  msg->len = payload_len;
+  msg->read_off = 0;
+  msg->release = release;
+  msg->release_ctx = ctx;
+  return ZCM_MSG_OK;
+}
+
+/* internal helper used by transport: inline storage for a frame handle, so a
+ * borrowed receive needs no extra allocation. Only valid while no view is held. */
+void *zcm_msg__transport_slot(zcm_msg_t *msg, size_t size) {
+  if (!msg || msg->release || size > sizeof(msg->transport_slot)) return NULL;
+  return &msg->transport_slot;
+}
+
+static int index_push(zcm_msg_t *owner, size_t off) {
+  if (owner->index_count == owner->index_cap) {
+    size_t new_cap = owner->index_cap ? owner->index_cap * 2 : 16;
+    uint32_t *ni = (uint32_t *)realloc(owner->index, new_cap * sizeof(*ni));
+    if (!ni) {
+      set_error(owner, "out of memory");
+      return ZCM_MSG_ERR;
+    }
+    owner->index = ni;
+    owner->index_cap = new_cap;
+  }
+  owner->index[owner->index_count++] = (uint32_t)off;
+  return ZCM_MSG_OK;
+}
+
+static uint32_t rd_le32(const uint8_t *p) {
+  uint32_t v = 0;
+  memcpy(&v, p, 4);
+  return le32(v);
+}
+
+/* Size of the array item body starting at `p` (after the tag). */
+static int array_body_len(const uint8_t *p, size_t avail, size_t *body) {
+  if (avail < 5) return ZCM_MSG_ERR_RANGE;
+  uint8_t at = p[0];
+  uint32_t elems = rd_le32(p + 1);
+  if (at & ZCM_ARRAY_DELTA) {
+    if (!array_delta_base_ok((uint8_t)(at & ~ZCM_ARRAY_DELTA))) return ZCM_MSG_ERR_TYPE;
+    if (avail < 9) return ZCM_MSG_ERR_RANGE;
+    uint32_t coded = rd_le32(p + 5);
+    if (coded > avail - 9) return ZCM_MSG_ERR_RANGE;
+    if (check_varint_stream(p + 9, coded, elems) != 0) return ZCM_MSG_ERR_FORMAT;
+    *body = 9 + (size_t)coded;
+    return ZCM_MSG_OK;
+  }
+  size_t elem_size = array_elem_size(at);
+  if (elem_size == 0) return ZCM_MSG_ERR_TYPE;
+  uint64_t total = (uint64_t)elem_size * elems;
+  if (total > avail - 5) return ZCM_MSG_ERR_RANGE;
+  *body = 5 + (size_t)total;
+  return ZCM_MSG_OK;
+}
+
+/* Length of the item body after tag `t`, with `avail` bytes left at `p`.
+ * Dispatch is on the tag itself: fixed widths are immediates, so the walk
+ * carries no table load between reading a tag and the next offset. */
+static inline int item_body_len(uint8_t t, const uint8_t *p, size_t avail, size_t *out) {
+  size_t body = 0;
+  switch (t) {
+    case ZCM_MSG_ITEM_CHAR:
+      body = 1;
+      break;
+    case ZCM_MSG_ITEM_SHORT:
+      body = 2;
+      break;
+    case ZCM_MSG_ITEM_INT:
+    case ZCM_MSG_ITEM_FLOAT:
+      body = 4;
+      break;
+    case ZCM_MSG_ITEM_LONG:
+    case ZCM_MSG_ITEM_DOUBLE:
+      body = 8;
+      break;
+    case ZCM_MSG_ITEM_TEXT:
+    case ZCM_MSG_ITEM_BYTES:
+      if (avail < 4) return ZCM_MSG_ERR_RANGE;
+      body = 4 + (size_t)rd_le32(p);
+      break;
+    case ZCM_MSG_ITEM_VALUE: {
+      if (avail < 1) return ZCM_MSG_ERR_RANGE;
+      switch (p[0]) {
+        case ZCM_MSG_VALUE_TEXT:
+          if (avail < 5) return ZCM_MSG_ERR_RANGE;
+          body = 5 + (size_t)rd_le32(p + 1);
+          break;
+        case ZCM_MSG_VALUE_DOUBLE:
+          body = 9;
+          break;
+        case ZCM_MSG_VALUE_FLOAT:
+        case ZCM_MSG_VALUE_INT:
+          body = 5;
+          break;
+        default:
+          return ZCM_MSG_ERR_TYPE;
       }
-      default:
-        return ZCM_MSG_ERR_TYPE;
+      break;
     }
+    case ZCM_MSG_ITEM_ARRAY: {
+      int rc = array_body_len(p, avail, &body);
+      if (rc != ZCM_MSG_OK) return rc;
+      break;
+    }
+    default:
+      return ZCM_MSG_ERR_TYPE;
+  }
+  *out = body;
+  return ZCM_MSG_OK;
+}
+
+/* Single structural pass over the payload, recording the start offset of
+ * every item into the message index. */
+static int walk_items(zcm_msg_t *msg) {
+  if (flatten_refs(msg) != 0) return ZCM_MSG_ERR;
+  const uint8_t *p = msg->buf;
+  size_t len = msg->len;
+  size_t off = 0;
+  msg->index_count = 0;
+  /* Index slots are written through a local cursor so the hot loop does not
+   * reload message fields after every store. */
+  uint32_t *slot = msg->index;
+  uint32_t *slot_end = msg->index + msg->index_cap;
+
+  while (off < len) {
+    if (slot == slot_end) {
+      msg->index_count = (size_t)(slot - msg->index);
+      if (index_push(msg, off) != 0) return ZCM_MSG_ERR;
+      slot = msg->index + msg->index_count;
+      slot_end = msg->index + msg->index_cap;
+    } else {
+      *slot++ = (uint32_t)off;
+    }
+    uint8_t t = p[off++];
+    size_t avail = len - off;
+    size_t body = 0;
+    int rc = item_body_len(t, p + off, avail, &body);
+    if (rc == ZCM_MSG_OK && body > avail) rc = ZCM_MSG_ERR_RANGE;
+    if (rc != ZCM_MSG_OK) {
+      msg->index_count = (size_t)(slot - msg->index);
+      return rc;
+    }
+    off += body;
+  }
+
+  msg->index_count = (size_t)(slot - msg->index);
+  return ZCM_MSG_OK;
+}
+
+/* Structural pass that records nothing, for read-only validation. */
+static int scan_items(const uint8_t *p, size_t len) {
+  size_t off = 0;
+  while (off < len) {
+    uint8_t t = p[off++];
+    size_t avail = len - off;
+    size_t body = 0;
+    int rc = item_body_len(t, p + off, avail, &body);
+    if (rc != ZCM_MSG_OK) return rc;
+    if (body > avail) return ZCM_MSG_ERR_RANGE;
+    off += body;
+  }
+  return ZCM_MSG_OK;
+}
+
+static int ensure_index(zcm_msg_t *msg) {
+  if (msg->index_valid) return ZCM_MSG_OK;
+  int rc = walk_items(msg);
+  if (rc != ZCM_MSG_OK) {
+    msg->index_count = 0;
+    if (rc != ZCM_MSG_ERR) set_error(msg, "malformed payload");
+    return rc;
+  }
+  msg->index_valid = 1;
+  msg->trusted = 1;
+  return ZCM_MSG_OK;
+}
+
+/* Read-only: never touches the message, so concurrent validation of a shared
+ * message is safe. Pending references are checked on a temporary copy. */
+int zcm_msg_validate(const zcm_msg_t *msg) {
+  if (!msg) return ZCM_MSG_ERR;
+  if (msg->index_valid) return ZCM_MSG_OK;
+  if (msg->ref_count == 0) return scan_items(msg->buf, msg->len);
+
+  size_t total = msg->len + msg->ref_bytes;
+  uint8_t *flat = (uint8_t *)malloc(total ? total : 1);
+  if (!flat) return ZCM_MSG_ERR;
+  size_t src = 0;
+  size_t dst = 0;
+  for (size_t i = 0; i < msg->ref_count; i++) {
+    const zcm_msg_ref_t *r = &msg->refs[i];
+    memcpy(flat + dst, msg->buf + src, r->off - src);
+    dst += r->off - src;
+    src = r->off;
+    if (r->len) memcpy(flat + dst, r->data, r->len);
+    dst += r->len;
+  }
+  memcpy(flat + dst, msg->buf + src, msg->len - src);
+  int rc = scan_items(flat, total);
+  free(flat);
+  return rc;
+}
+
+int zcm_msg_validate_index(zcm_msg_t *msg) {
+  if (!msg) return ZCM_MSG_ERR;
+  return ensure_index(msg);
+}
+
+int zcm_msg_item_count(zcm_msg_t *msg, uint32_t *count) {
+  if (!msg || !count) return ZCM_MSG_ERR;
+  int rc = ensure_index(msg);
+  if (rc != ZCM_MSG_OK) return rc;
+  *count = (uint32_t)msg->index_count;
+  return ZCM_MSG_OK;
+}
+
+int zcm_msg_seek(zcm_msg_t *msg, uint32_t index) {
+  if (!msg) return ZCM_MSG_ERR;
+  int rc = ensure_index(msg);
+  if (rc != ZCM_MSG_OK) return rc;
+  if (index > msg->index_count) {
+    set_error(msg, "item index out of range");
+    return ZCM_MSG_ERR_RANGE;
   }
+  msg->read_off = (index == msg->index_count) ? msg->len : msg->index[index];
+  return ZCM_MSG_OK;
+}
 
+/* Position the cursor on an existing item for an indexed getter; the caller
+ * restores `*saved` afterwards so the sequential cursor is left untouched. */
+static int seek_item(zcm_msg_t *msg, uint32_t index, size_t *saved) {
+  if (!msg) return ZCM_MSG_ERR;
+  *saved = msg->read_off;
+  int rc = ensure_index(msg);
+  if (rc != ZCM_MSG_OK) return rc;
+  if (index >= msg->index_count) {
+    set_error(msg, "item index out of range");
+    return ZCM_MSG_ERR_RANGE;
+  }
+  msg->read_off = msg->index[index];
   return ZCM_MSG_OK;
 }
 
+int zcm_msg_get_char_at(zcm_msg_t *msg, uint32_t index, char *value) {
+  size_t saved = 0;
+  int rc = seek_item(msg, index, &saved);
+  if (rc == ZCM_MSG_OK) rc = zcm_msg_get_char(msg, value);
+  if (msg) msg->read_off = saved;
+  return rc;
+}
+
+int zcm_msg_get_short_at(zcm_msg_t *msg, uint32_t index, int16_t *value) {
+  size_t saved = 0;
+  int rc = seek_item(msg, index, &saved);
+  if (rc == ZCM_MSG_OK) rc = zcm_msg_get_short(msg, value);
+  if (msg) msg->read_off = saved;
+  return rc;
+}
+
+int zcm_msg_get_int_at(zcm_msg_t *msg, uint32_t index, int32_t *value) {
+  size_t saved = 0;
+  int rc = seek_item(msg, index, &saved);
+  if (rc == ZCM_MSG_OK) rc = zcm_msg_get_int(msg, value);
+  if (msg) msg->read_off = saved;
+  return rc;
+}
+
+int zcm_msg_get_long_at(zcm_msg_t *msg, uint32_t index, int64_t *value) {
+  size_t saved = 0;
+  int rc = seek_item(msg, index, &saved);
+  if (rc == ZCM_MSG_OK) rc = zcm_msg_get_long(msg, value);
+  if (msg) msg->read_off = saved;
+  return rc;
+}
+
+int zcm_msg_get_float_at(zcm_msg_t *msg, uint32_t index, float *value) {
+  size_t saved = 0;
+  int rc = seek_item(msg, index, &saved);
+  if (rc == ZCM_MSG_OK) rc = zcm_msg_get_float(msg, value);
+  if (msg) msg->read_off = saved;
+  return rc;
+}
+
+int zcm_msg_get_double_at(zcm_msg_t *msg, uint32_t index, double *value) {
+  size_t saved = 0;
+  int rc = seek_item(msg, index, &saved);
+  if (rc == ZCM_MSG_OK) rc = zcm_msg_get_double(msg, value);
+  if (msg) msg->read_off = saved;
+  return rc;
+}
+
+int zcm_msg_get_text_at(zcm_msg_t *msg, uint32_t index, const char **value, uint32_t *len) {
+  size_t saved = 0;
+  int rc = seek_item(msg, index, &saved);
+  if (rc == ZCM_MSG_OK) rc = zcm_msg_get_text(msg, value, len);
+  if (msg) msg->read_off = saved;
+  return rc;
+}
+
+int zcm_msg_get_bytes_at(zcm_msg_t *msg, uint32_t index, const void **data, uint32_t *len) {
+  size_t saved = 0;
+  int rc = seek_item(msg, index, &saved);
+  if (rc == ZCM_MSG_OK) rc = zcm_msg_get_bytes(msg, data, len);
+  if (msg) msg->read_off = saved;
+  return rc;
+}
+
+int zcm_msg_get_array_at(zcm_msg_t *msg, uint32_t index, zcm_msg_array_type_t *type,
+                          uint32_t *elements, const void **data) {
+  size_t saved = 0;
+  int rc = seek_item(msg, index, &saved);
+  if (rc == ZCM_MSG_OK) rc = zcm_msg_get_array(msg, type, elements, data);
+  if (msg) msg->read_off = saved;
+  return rc;
+}
+
 const char *zcm_msg_last_error(const zcm_msg_t *msg) {
   if (!msg) return NULL;
   return msg->last_error;
 }
 
-static int zcm_msg_build_envelope(const zcm_msg_t *msg, uint8_t **out, size_t *out_len) {
-  if (!msg || !out || !out_len) return ZCM_MSG_ERR;
-  size_t type_len = strlen(msg->type);
-  size_t total = 12 + type_len + msg->len;
-  uint8_t *buf = (uint8_t *)malloc(total);
-  if (!buf) return ZCM_MSG_ERR;
+static void write_header(uint8_t *dst, size_t type_len, size_t payload_len) {
   uint32_t magic = le32(ZCM_MAGIC);
   uint16_t version = le16((uint16_t)ZCM_VERSION);
   uint16_t tlen = le16((uint16_t)type_len);
-  uint32_t plen = le32((uint32_t)msg->len);
-  memcpy(buf, &magic, 4);
-  memcpy(buf + 4, &version, 2);
-  memcpy(buf + 6, &tlen, 2);
-  memcpy(buf + 8, &plen, 4);
-  memcpy(buf + 12, msg->type, type_len);
-  memcpy(buf + 12 + type_len, msg->buf, msg->len);
-  *out = buf;
-  *out_len = total;
-  return ZCM_MSG_OK;
+  uint32_t plen = le32((uint32_t)payload_len);
+  memcpy(dst, &magic, 4);
+  memcpy(dst + 4, &version, 2);
+  memcpy(dst + 6, &tlen, 2);
+  memcpy(dst + 8, &plen, 4);
 }
 
-/* internal helper used by transport */
-int zcm_msg__serialize(const zcm_msg_t *msg, const void **data, size_t *len, void **owned) {
+/* Compact header: magic, version 3, reserved u16, payload_len, type ID. */
+static void write_id_header(uint8_t *dst, uint32_t type_id, size_t payload_len) {
+  uint32_t magic = le32(ZCM_MAGIC);
+  uint16_t version = le16((uint16_t)ZCM_VERSION_TYPE_ID);
+  uint16_t reserved = 0;
+  uint32_t plen = le32((uint32_t)payload_len);
+  uint32_t id = le32(type_id);
+  memcpy(dst, &magic, 4);
+  memcpy(dst + 4, &version, 2);
+  memcpy(dst + 6, &reserved, 2);
+  memcpy(dst + 8, &plen, 4);
+  memcpy(dst + 12, &id, 4);
+}
+
+/* Header (plus type string for version 1) length of the envelope. */
+static size_t envelope_head_len(const zcm_msg_t *msg, int compact) {
+  return compact ? ZCM_ID_HEADER_LEN : ZCM_HEADER_LEN + strlen(msg->type);
+}
+
+static void write_envelope_head(const zcm_msg_t *msg, int compact, uint8_t *dst,
+                                size_t payload_len) {
+  if (compact) {
+    write_id_header(dst, zcm_msg_get_type_id(msg), payload_len);
+    return;
+  }
+  size_t type_len = strlen(msg->type);
+  write_header(dst, type_len, payload_len);
+  memcpy(dst + ZCM_HEADER_LEN, msg->type, type_len);
+}
+
+/* Copy the payload to `dst`, splicing referenced caller buffers back in at
+ * their offsets. Reads the message only, so a const message can be sent. */
+static void gather_payload(const zcm_msg_t *msg, uint8_t *dst) {
+  size_t off = 0;
+  for (size_t i = 0; i < msg->ref_count; i++) {
+    const zcm_msg_ref_t *r = &msg->refs[i];
+    if (r->off > off) memcpy(dst, msg->buf + off, r->off - off);
+    dst += r->off - off;
+    if (r->len) memcpy(dst, r->data, r->len);
+    dst += r->len;
+    off = r->off;
+  }
+  if (msg->len > off) memcpy(dst, msg->buf + off, msg->len - off);
+}
+
+static int envelope_compact(const zcm_msg_t *msg, int compact) {
+  return compact && msg->type[0]; /* no type to identify otherwise */
+}
+
+static size_t envelope_size(const zcm_msg_t *msg, int compact) {
+  return envelope_head_len(msg, compact) + msg->len + msg->ref_bytes;
+}
+
+static void write_envelope(const zcm_msg_t *msg, int compact, uint8_t *dst) {
+  write_envelope_head(msg, compact, dst, msg->len + msg->ref_bytes);
+  gather_payload(msg, dst + envelope_head_len(msg, compact));
+}
+
+static int serialize_envelope(const zcm_msg_t *msg, int compact, const void **data,
+                              size_t *len, void **owned) {
   if (!msg || !data || !len || !owned) return ZCM_MSG_ERR;
-  uint8_t *buf = NULL;
-  size_t blen = 0;
-  if (zcm_msg_build_envelope(msg, &buf, &blen) != 0) return ZCM_MSG_ERR;
+  compact = envelope_compact(msg, compact);
+  size_t total = envelope_size(msg, compact);
+  uint8_t *buf = (uint8_t *)malloc(total);
+  if (!buf) return ZCM_MSG_ERR;
+  write_envelope(msg, compact, buf);
   *data = buf;
-  *len = blen;
+  *len = total;
   *owned = buf;
   return ZCM_MSG_OK;
 }
+
+/* internal helper used by transport */
+int zcm_msg__serialize(const zcm_msg_t *msg, const void **data, size_t *len, void **owned) {
+  return serialize_envelope(msg, 0, data, len, owned);
+}
+
+/* internal helper used by transport: like zcm_msg__serialize() but frames a
+ * compact (version 3) envelope carrying the type ID instead of its name. */
+int zcm_msg__serialize_id(const zcm_msg_t *msg, const void **data, size_t *len,
+                          void **owned) {
+  return serialize_envelope(msg, 1, data, len, owned);
+}
+
+/* internal helper used by transport: byte size of the envelope that
+ * zcm_msg__write_envelope() produces, so it can go straight into a frame. */
+size_t zcm_msg__envelope_size(const zcm_msg_t *msg, int compact) {
+  return msg ? envelope_size(msg, envelope_compact(msg, compact)) : 0;
+}
+
+/* internal helper used by transport: write the whole envelope, references
+ * included, to `dst` (zcm_msg__envelope_size() bytes). */
+void zcm_msg__write_envelope(const zcm_msg_t *msg, int compact, void *dst) {
+  if (!msg || !dst) return;
+  write_envelope(msg, envelope_compact(msg, compact), (uint8_t *)dst);
+}
+
+/* internal helper used by transport: total envelope length announced by a
+ * version-1 or compact header, or 0 when `data` does not start with one. */
+size_t zcm_msg__envelope_len(const void *data, size_t len) {
+  if (!data || len < ZCM_HEADER_LEN) return 0;
+  const uint8_t *p = (const uint8_t *)data;
+  uint32_t magic = 0;
+  uint16_t version = 0;
+  uint16_t type_len = 0;
+  uint32_t plen = 0;
+  memcpy(&magic, p, 4);
+  memcpy(&version, p + 4, 2);
+  memcpy(&type_len, p + 6, 2);
+  memcpy(&plen, p + 8, 4);
+  if (le32(magic) != ZCM_MAGIC) return 0;
+  if (le16(version) == ZCM_VERSION_TYPE_ID) return ZCM_ID_HEADER_LEN + (size_t)le32(plen);
+  if (le16(version) != ZCM_VERSION) return 0;
+  return ZCM_HEADER_LEN + (size_t)le16(type_len) + (size_t)le32(plen);
+}
+
+/* internal helper used by transport: number of referenced caller buffers. */
+size_t zcm_msg__ref_count(const zcm_msg_t *msg) {
+  return msg ? msg->ref_count : 0;
+}
+
+/* internal helper used by transport: length of the head frame of a message
+ * that still holds references, the header + type + local payload up to the
+ * first reference. */
+size_t zcm_msg__head_size(const zcm_msg_t *msg) {
+  if (!msg) return 0;
+  return ZCM_HEADER_LEN + strlen(msg->type) + (msg->ref_count ? msg->refs[0].off : msg->len);
+}
+
+/* internal helper used by transport: write that head frame to `dst`;
+ * payload_len in the header covers the referenced bytes. */
+void zcm_msg__write_head(const zcm_msg_t *msg, void *dst) {
+  if (!msg || !dst) return;
+  uint8_t *d = (uint8_t *)dst;
+  size_t type_len = strlen(msg->type);
+  size_t local = msg->ref_count ? msg->refs[0].off : msg->len;
+  write_header(d, type_len, msg->len + msg->ref_bytes);
+  memcpy(d + ZCM_HEADER_LEN, msg->type, type_len);
+  if (local) memcpy(d + ZCM_HEADER_LEN + type_len, msg->buf, local);
+}
+
+/*
+ * internal helper used by transport: reference `i` and the local payload
+ * span that follows it (up to the next reference). Takes a reference on the
+ * caller buffer for the transport, dropped with zcm_msg__ref_drop(`*hold`).
+ */
+int zcm_msg__ref_part(const zcm_msg_t *msg, size_t i, const void **data, size_t *len,
+                      void **hold, const void **tail, size_t *tail_len) {
+  if (!msg || i >= msg->ref_count) return ZCM_MSG_ERR;
+  const zcm_msg_ref_t *r = &msg->refs[i];
+  size_t next = (i + 1 < msg->ref_count) ? msg->refs[i + 1].off : msg->len;
+  atomic_fetch_add(&r->hold->refs, 1);
+  *data = r->data;
+  *len = r->len;
+  *hold = r->hold;
+  *tail = msg->buf + r->off;
+  *tail_len = next - r->off;
+  return ZCM_MSG_OK;
+}
+
+/*
+ * Batch envelope (version 2): magic u32, version u16 = 2, reserved u16 = 0,
+ * count u32, then `count` entries of (len u32, version-1 or compact envelope).
+ */
+
+/* internal helper used by transport: append one message to a batch buffer,
+ * writing the batch header first when the buffer is empty. `compact` selects
+ * the type-ID envelope for the entry. */
+int zcm_msg__batch_append(const zcm_msg_t *msg, int compact, uint8_t **buf, size_t *len,
+                          size_t *cap) {
+  if (!msg || !buf || !len || !cap) return ZCM_MSG_ERR;
+  compact = envelope_compact(msg, compact);
+  size_t env_len = envelope_size(msg, compact);
+  if (env_len > UINT32_MAX) return ZCM_MSG_ERR_RANGE;
+
+  size_t head = (*len == 0) ? ZCM_HEADER_LEN : 0;
+  size_t need = *len + head + 4 + env_len;
+  if (need > *cap) {
+    size_t new_cap = *cap ? *cap : 4096;
+    while (new_cap < need) new_cap *= 2;
+    uint8_t *nb = (uint8_t *)realloc(*buf, new_cap);
+    if (!nb) return ZCM_MSG_ERR;
+    *buf = nb;
+    *cap = new_cap;
+  }
+
+  uint8_t *b = *buf;
+  if (head) {
+    uint32_t magic = le32(ZCM_MAGIC);
+    uint16_t version = le16((uint16_t)ZCM_VERSION_BATCH);
+    uint16_t reserved = 0;
+    uint32_t count = 0;
+    memcpy(b, &magic, 4);
+    memcpy(b + 4, &version, 2);
+    memcpy(b + 6, &reserved, 2);
+    memcpy(b + 8, &count, 4);
+    *len = ZCM_HEADER_LEN;
+  }
+  uint32_t count = 0;
+  memcpy(&count, b + 8, 4);
+  count = le32(le32(count) + 1u);
+  memcpy(b + 8, &count, 4);
+
+  uint32_t elen = le32((uint32_t)env_len);
+  memcpy(b + *len, &elen, 4);
+  write_envelope(msg, compact, b + *len + 4);
+  *len += 4 + env_len;
+  return ZCM_MSG_OK;
+}
+
+/* internal helper used by transport: returns 1 and the entry count for a
+ * batch frame, 0 for any other frame. */
+int zcm_msg__batch_header(const void *data, size_t len, uint32_t *count) {
+  if (!data || len < ZCM_HEADER_LEN) return 0;
+  const uint8_t *p = (const uint8_t *)data;
+  uint32_t magic = 0;
+  uint16_t version = 0;
+  memcpy(&magic, p, 4);
+  memcpy(&version, p + 4, 2);
+  if (le32(magic) != ZCM_MAGIC || le16(version) != ZCM_VERSION_BATCH) return 0;
+  uint32_t n = 0;
+  memcpy(&n, p + 8, 4);
+  if (count) *count = le32(n);
+  return 1;
+}
+
+/* internal helper used by transport: next entry of a batch frame. `*off`
+ * starts at 0 and is advanced past the returned entry. */
+int zcm_msg__batch_next(const void *data, size_t len, size_t *off,
+                        const void **entry, size_t *entry_len) {
+  if (!data || !off || !entry || !entry_len) return ZCM_MSG_ERR;
+  const uint8_t *p = (const uint8_t *)data;
+  size_t pos = (*off == 0) ? ZCM_HEADER_LEN : *off;
+  if (pos + 4 > len) return ZCM_MSG_ERR_RANGE;
+  uint32_t elen = 0;
+  memcpy(&elen, p + pos, 4);
+  elen = le32(elen);
+  if (elen > len - pos - 4) return ZCM_MSG_ERR_RANGE;
+  *entry = p + pos + 4;
+  *entry_len = elen;
+  *off = pos + 4 + elen;
+  return ZCM_MSG_OK;
+}
@@ -1,25 +1,130 @@
 #include "zcm/zcm_node.h"
 #include "zcm/zcm.h"
 
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <time.h>
 
 #include <zmq.h>
 
 struct zcm_node {
   zcm_context_t *ctx;
   char *broker_endpoint;
+  /* Long-lived DEALER to the broker; NULL until the first request and after
+   * a failed one. Serialized by `lock`. */
+  pthread_mutex_t lock;
+  void *conn;
+  uint32_t next_req_id;
+  /* Written under both locks, so holders of either may read it. */
+  int timeout_ms;
+  /* Guards the cache. Held only briefly, never across broker I/O, so it can
+   * be taken inside `lock` and by the async API without waiting for a
+   * blocking request. */
+  pthread_mutex_t state_lock;
+  /* Opt-in resolution cache (zcm_node_set_cache); off while cache_ttl_ms is 0. */
+  int cache_ttl_ms;
+  int cache_neg_ttl_ms;
+  struct node_cache_entry *cache;
+  size_t cache_count;
+  /* Asynchronous requests (zcm_node_*_async): a second DEALER and the table
+   * of requests awaiting a reply, both owned by the thread driving them. */
+  void *async_conn;
+  uint32_t async_next_id;
+  struct node_async_req *async_reqs;
+  size_t async_count;
+  size_t async_cap;
+  /* Binary metrics channel (zcm_node_push_metrics): a PUSH to the broker's
+   * metrics endpoint, or the text METRICS request on brokers without one.
+   * Guarded by state_lock; discovery is retried no sooner than
+   * metrics_retry_at. */
+  void *metrics_push;
+  char metrics_endpoint[512];
+  int metrics_stale;
+  int metrics_legacy;
+  uint64_t metrics_retry_at;
 };
 
+#define ZCM_NODE_CACHE_MAX 64
+/* Names per LOOKUP_MANY request; larger lookups are pipelined. */
+#define ZCM_NODE_RESOLVE_BATCH_MAX 64
+/* Report frames queued towards an unreachable broker before dropping. */
+#define ZCM_NODE_METRICS_HWM 64
+#define ZCM_NODE_METRICS_RETRY_MS 1000
+#define ZCM_NODE_METRICS_LEGACY_RETRY_MS 30000
+
+typedef enum {
+  NODE_ASYNC_LOOKUP,
+  NODE_ASYNC_RESOLVE,
+  NODE_ASYNC_REGISTER,
+  NODE_ASYNC_UNREGISTER
+} node_async_kind_t;
+
+typedef struct node_async_req {
+  uint32_t id;
+  node_async_kind_t kind;
+  char name[256];
+  zcm_node_async_cb_t cb;
+  void *user;
+  uint64_t deadline_ms;
+} node_async_req_t;
+
+/* Resolved record, or a negative entry (found == 0) for an unknown name. */
+typedef struct node_cache_entry {
+  char name[256];
+  int found;
+  zcm_node_record_t rec;
+  uint64_t expires_ms;
+} node_cache_entry_t;
+
 struct zcm_socket {
   void *sock;
+  zcm_socket_type_t type;
+  /* Sender-side coalescing (zcm_socket_set_coalesce). */
+  int coalesce_delay_ms;
+  size_t coalesce_max_bytes;
+  uint8_t *tx_batch;
+  size_t tx_len;
+  size_t tx_cap;
+  uint64_t tx_first_ms;
+  /* Entries of a received batch frame not yet handed out. */
+  zmq_msg_t rx_batch;
+  int rx_pending;
+  size_t rx_off;
+  uint32_t rx_left;
+  /* Send compact type-ID envelopes (zcm_socket_set_type_ids). */
+  int type_ids;
 };
 
 /* from zcm_msg.c */
-int zcm_msg__serialize(const zcm_msg_t *msg, const void **data, size_t *len, void **owned);
+size_t zcm_msg__envelope_size(const zcm_msg_t *msg, int compact);
+void zcm_msg__write_envelope(const zcm_msg_t *msg, int compact, void *dst);
+int zcm_msg__from_borrowed(zcm_msg_t *msg, void *data, size_t len,
+                           void (*release)(void *ctx), void *ctx);
+void *zcm_msg__transport_slot(zcm_msg_t *msg, size_t size);
+int zcm_msg__batch_append(const zcm_msg_t *msg, int compact, uint8_t **buf, size_t *len,
+                          size_t *cap);
+int zcm_msg__batch_header(const void *data, size_t len, uint32_t *count);
+int zcm_msg__batch_next(const void *data, size_t len, size_t *off,
+                        const void **entry, size_t *entry_len);
+size_t zcm_msg__envelope_len(const void *data, size_t len);
+size_t zcm_msg__ref_count(const zcm_msg_t *msg);
+size_t zcm_msg__head_size(const zcm_msg_t *msg);
+void zcm_msg__write_head(const zcm_msg_t *msg, void *dst);
+int zcm_msg__ref_part(const zcm_msg_t *msg, size_t i, const void **data, size_t *len,
+                      void **hold, const void **tail, size_t *tail_len);
+void zcm_msg__ref_drop(void *hold);
+
+static uint64_t monotonic_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000u + (uint64_t)(ts.tv_nsec / 1000000);
+}
 
 static int map_socket_type(zcm_socket_type_t type) {
   switch (type) {
@@ -44,21 +149,52 @@ zcm_node_t *zcm_node_new(zcm_context_t *ctx, const char *broker_endpoint) {
     free(n);
     return NULL;
   }
+  if (pthread_mutex_init(&n->lock, NULL) != 0) {
+    free(n->broker_endpoint);
+    free(n);
+    return NULL;
+  }
+  if (pthread_mutex_init(&n->state_lock, NULL) != 0) {
+    pthread_mutex_destroy(&n->lock);
+    free(n->broker_endpoint);
+    free(n);
+    return NULL;
+  }
+  n->timeout_ms = ZCM_NODE_TIMEOUT_MS_DEFAULT;
   return n;
 }
 
+static void node_drop_conn(zcm_node_t *node) {
+  if (!node->conn) return;
+  zmq_close(node->conn);
+  node->conn = NULL;
+}
+
+static void node_async_cancel_all(zcm_node_t *node);
+
 void zcm_node_free(zcm_node_t *node) {
   if (!node) return;
+  node_async_cancel_all(node);
+  if (node->async_conn) zmq_close(node->async_conn);
+  free(node->async_reqs);
+  if (node->metrics_push) zmq_close(node->metrics_push);
+  node_drop_conn(node);
+  free(node->cache);
+  pthread_mutex_destroy(&node->state_lock);
+  pthread_mutex_destroy(&node->lock);
   free(node->broker_endpoint);
   free(node);
 }
 
-static int send_frames_req(void *sock, const char *cmd, const char *name, const char *endpoint) {
-  if (zmq_send(sock, cmd, strlen(cmd), ZMQ_SNDMORE) < 0) return -1;
-  if (zmq_send(sock, name, strlen(name), endpoint ? ZMQ_SNDMORE : 0) < 0) return -1;
-  if (endpoint) {
-    if (zmq_send(sock, endpoint, strlen(endpoint), 0) < 0) return -1;
-  }
+int zcm_node_set_timeout(zcm_node_t *node, int timeout_ms) {
+  if (!node || timeout_ms <= 0) return -1;
+  pthread_mutex_lock(&node->lock);
+  pthread_mutex_lock(&node->state_lock);
+  node->timeout_ms = timeout_ms;
+  pthread_mutex_unlock(&node->state_lock);
+  /* Socket timeouts are applied at connect time. */
+  node_drop_conn(node);
+  pthread_mutex_unlock(&node->lock);
   return 0;
 }
 
@@ -71,32 +207,205 @@ static void set_req_socket_options(void *sock, int timeout_ms) {
   zmq_setsockopt(sock, ZMQ_IMMEDIATE, &immediate, sizeof(immediate));
 }
 
-static int recv_with_timeout(void *sock, void *buf, size_t len, int timeout_ms) {
-  zmq_pollitem_t items[] = { { sock, 0, ZMQ_POLLIN, 0 } };
-  int rc = zmq_poll(items, 1, timeout_ms);
-  if (rc <= 0) return -1;
-  int n = zmq_recv(sock, buf, len, ZMQ_DONTWAIT);
-  return n;
+/* Broker reply frames, copied out of the socket: frame i is
+ * data[offs[i] .. offs[i + 1]). */
+typedef struct node_reply {
+  uint8_t *data;
+  size_t len;
+  size_t cap;
+  size_t *offs;
+  size_t count;
+  size_t offs_cap;
+} node_reply_t;
+
+static void node_reply_free(node_reply_t *r) {
+  free(r->data);
+  free(r->offs);
+  memset(r, 0, sizeof(*r));
 }
 
-int zcm_node_unregister(zcm_node_t *node, const char *name) {
-  if (!node || !name) return -1;
-  void *sock = zmq_socket(zcm_context_zmq(node->ctx), ZMQ_REQ);
-  if (!sock) return -1;
-  set_req_socket_options(sock, 1000);
-  if (zmq_connect(sock, node->broker_endpoint) != 0) {
-    zmq_close(sock);
-    return -1;
+static int node_reply_push(node_reply_t *r, const void *data, size_t len) {
+  if (r->count + 2 > r->offs_cap) {
+    size_t cap = r->offs_cap ? r->offs_cap * 2 : 16;
+    size_t *offs = (size_t *)realloc(r->offs, cap * sizeof(*offs));
+    if (!offs) return -1;
+    r->offs = offs;
+    r->offs_cap = cap;
   }
-  if (send_frames_req(sock, "UNREGISTER", name, NULL) != 0) {
-    zmq_close(sock);
-    return -1;
+  if (r->len + len > r->cap) {
+    size_t cap = r->cap ? r->cap : 256;
+    while (cap < r->len + len) cap *= 2;
+    uint8_t *nd = (uint8_t *)realloc(r->data, cap);
+    if (!nd) return -1;
+    r->data = nd;
+    r->cap = cap;
   }
-  char reply[32] = {0};
-  int n = zmq_recv(sock, reply, sizeof(reply) - 1, 0);
-  zmq_close(sock);
-  if (n <= 0) return -1;
-  return (strncmp(reply, "OK", 2) == 0) ? 0 : -1;
+  if (len) memcpy(r->data + r->len, data, len);
+  r->offs[r->count] = r->len;
+  r->len += len;
+  r->count++;
+  r->offs[r->count] = r->len;
+  return 0;
+}
+
+static size_t node_reply_part(const node_reply_t *r, size_t i, const void **data) {
+  if (i >= r->count) {
+    *data = NULL;
+    return 0;
+  }
+  *data = r->data + r->offs[i];
+  return r->offs[i + 1] - r->offs[i];
+}
+
+/* Copy frame `i` as text, truncated to `out_size - 1`; -1 when missing. */
+static int node_reply_text(const node_reply_t *r, size_t i, char *out, size_t out_size) {
+  const void *data = NULL;
+  size_t n = node_reply_part(r, i, &data);
+  if (!data || !out || out_size == 0) return -1;
+  if (n >= out_size) n = out_size - 1;
+  memcpy(out, data, n);
+  out[n] = '\0';
+  return (int)n;
+}
+
+/* Prefix match, as the status checks always did with strncmp. */
+static int node_reply_is(const node_reply_t *r, size_t i, const char *status) {
+  const void *data = NULL;
+  size_t n = node_reply_part(r, i, &data);
+  size_t want = strlen(status);
+  return data && n >= want && memcmp(data, status, want) == 0;
+}
+
+static int sock_has_more(void *sock) {
+  int more = 0;
+  size_t more_size = sizeof(more);
+  if (zmq_getsockopt(sock, ZMQ_RCVMORE, &more, &more_size) != 0) return 0;
+  return more;
+}
+
+/* Receive the rest of a multipart message, keeping it when `keep` is set. */
+static int node_recv_rest(void *sock, node_reply_t *reply, int keep) {
+  int rc = 0;
+  while (sock_has_more(sock)) {
+    zmq_msg_t part;
+    zmq_msg_init(&part);
+    if (zmq_msg_recv(&part, sock, 0) < 0) {
+      zmq_msg_close(&part);
+      return -1;
+    }
+    if (keep && rc == 0) rc = node_reply_push(reply, zmq_msg_data(&part), zmq_msg_size(&part));
+    zmq_msg_close(&part);
+  }
+  return rc;
+}
+
+/* Requests go over the node's DEALER connection, caller holds node->lock.
+ * The broker socket is REP, which echoes everything before the empty
+ * delimiter, so each request is sent as [id][""][parts...] and replies are
+ * matched by id; replies to requests that timed out are skipped. REP serves
+ * one connection's requests in order, so several may be in flight at once.
+ * Any failure closes the connection; the next request reconnects. */
+static int node_send_locked(zcm_node_t *node, const char *const *parts, size_t n,
+                            uint32_t *out_id) {
+  if (!node->conn) {
+    void *sock = zmq_socket(zcm_context_zmq(node->ctx), ZMQ_DEALER);
+    if (!sock) return -1;
+    set_req_socket_options(sock, node->timeout_ms);
+    if (zmq_connect(sock, node->broker_endpoint) != 0) {
+      zmq_close(sock);
+      return -1;
+    }
+    node->conn = sock;
+  }
+  void *sock = node->conn;
+  uint32_t id = ++node->next_req_id;
+  if (zmq_send(sock, &id, sizeof(id), ZMQ_SNDMORE) < 0) goto fail;
+  if (zmq_send(sock, "", 0, ZMQ_SNDMORE) < 0) goto fail;
+  for (size_t i = 0; i < n; i++) {
+    if (zmq_send(sock, parts[i], strlen(parts[i]), (i + 1 < n) ? ZMQ_SNDMORE : 0) < 0) goto fail;
+  }
+  *out_id = id;
+  return 0;
+
+fail:
+  node_drop_conn(node);
+  return -1;
+}
+
+/* Receive the reply to one of the `count` requests sent with consecutive ids
+ * from `first_id`, storing its position in `*out_index`. */
+static int node_recv_locked(zcm_node_t *node, uint32_t first_id, uint32_t count,
+                            node_reply_t *reply, uint32_t *out_index) {
+  memset(reply, 0, sizeof(*reply));
+  void *sock = node->conn;
+  if (!sock) return -1;
+  uint64_t deadline = monotonic_ms() + (uint64_t)node->timeout_ms;
+  for (;;) {
+    uint64_t now = monotonic_ms();
+    if (now >= deadline) goto fail;
+    zmq_pollitem_t items[] = { { sock, 0, ZMQ_POLLIN, 0 } };
+    if (zmq_poll(items, 1, (long)(deadline - now)) <= 0) goto fail;
+
+    zmq_msg_t head;
+    zmq_msg_init(&head);
+    if (zmq_msg_recv(&head, sock, ZMQ_DONTWAIT) < 0) {
+      zmq_msg_close(&head);
+      goto fail;
+    }
+    uint32_t id = 0;
+    int match = zmq_msg_size(&head) == sizeof(id);
+    if (match) {
+      memcpy(&id, zmq_msg_data(&head), sizeof(id));
+      match = (uint32_t)(id - first_id) < count;
+    }
+    zmq_msg_close(&head);
+    if (!sock_has_more(sock)) continue;
+    zmq_msg_t delim;
+    zmq_msg_init(&delim);
+    int delim_ok = zmq_msg_recv(&delim, sock, 0) == 0;
+    zmq_msg_close(&delim);
+    if (!delim_ok) match = 0;
+    if (node_recv_rest(sock, reply, match) != 0) goto fail;
+    if (match) {
+      *out_index = id - first_id;
+      return 0;
+    }
+    node_reply_free(reply);
+  }
+
+fail:
+  node_reply_free(reply);
+  node_drop_conn(node);
+  return -1;
+}
+
+/* One broker round trip. */
+static int node_request_locked(zcm_node_t *node, const char *const *parts, size_t n,
+                               node_reply_t *reply) {
+  uint32_t id = 0;
+  uint32_t index = 0;
+  memset(reply, 0, sizeof(*reply));
+  if (node_send_locked(node, parts, n, &id) != 0) return -1;
+  return node_recv_locked(node, id, 1, reply, &index);
+}
+
+static int node_request(zcm_node_t *node, const char *const *parts, size_t n,
+                        node_reply_t *reply) {
+  pthread_mutex_lock(&node->lock);
+  int rc = node_request_locked(node, parts, n, reply);
+  pthread_mutex_unlock(&node->lock);
+  return rc;
+}
+
+int zcm_node_unregister(zcm_node_t *node, const char *name) {
+  if (!node || !name) return -1;
+  zcm_node_cache_invalidate(node, name);
+  const char *parts[] = { "UNREGISTER", name };
+  node_reply_t reply;
+  if (node_request(node, parts, 2, &reply) != 0) return -1;
+  int rc = node_reply_is(&reply, 0, "OK") ? 0 : -1;
+  node_reply_free(&reply);
+  return rc;
 }
 
 int zcm_node_register_ex(zcm_node_t *node, const char *name, const char *endpoint,
@@ -104,126 +413,304 @@ int zcm_node_register_ex(zcm_node_t *node, const char *name, const char *endpoin
                          const char *role, int pub_port, int push_port) {
   if (!node || !name || !endpoint || !ctrl_endpoint || !host || !role) return -1;
   if (!name[0] || !endpoint[0] || !ctrl_endpoint[0] || !host[0] || pid <= 0 || !role[0]) return -1;
-  void *sock = zmq_socket(zcm_context_zmq(node->ctx), ZMQ_REQ);
-  if (!sock) return -1;
-  set_req_socket_options(sock, 1000);
-  if (zmq_connect(sock, node->broker_endpoint) != 0) {
-    zmq_close(sock);
-    return -1;
-  }
-  if (zmq_send(sock, "REGISTER_EX", 11, ZMQ_SNDMORE) < 0) { zmq_close(sock); return -1; }
-  if (zmq_send(sock, name, strlen(name), ZMQ_SNDMORE) < 0) { zmq_close(sock); return -1; }
-  if (zmq_send(sock, endpoint, strlen(endpoint), ZMQ_SNDMORE) < 0) { zmq_close(sock); return -1; }
-  if (zmq_send(sock, ctrl_endpoint, strlen(ctrl_endpoint), ZMQ_SNDMORE) < 0) { zmq_close(sock); return -1; }
-  if (zmq_send(sock, host, strlen(host), ZMQ_SNDMORE) < 0) { zmq_close(sock); return -1; }
   char pid_buf[32];
   char pub_port_buf[32];
   char push_port_buf[32];
   snprintf(pid_buf, sizeof(pid_buf), "%d", pid);
   snprintf(pub_port_buf, sizeof(pub_port_buf), "%d", pub_port);
   snprintf(push_port_buf, sizeof(push_port_buf), "%d", push_port);
-  if (zmq_send(sock, pid_buf, strlen(pid_buf), ZMQ_SNDMORE) < 0) { zmq_close(sock); return -1; }
-  if (zmq_send(sock, role, strlen(role), ZMQ_SNDMORE) < 0) { zmq_close(sock); return -1; }
-  if (zmq_send(sock, pub_port_buf, strlen(pub_port_buf), ZMQ_SNDMORE) < 0) { zmq_close(sock); return -1; }
-  if (zmq_send(sock, push_port_buf, strlen(push_port_buf), 0) < 0) { zmq_close(sock); return -1; }
-  char reply[32] = {0};
-  int n = zmq_recv(sock, reply, sizeof(reply) - 1, 0);
-  zmq_close(sock);
-  if (n <= 0) return -1;
-  reply[n] = '\0';
-  if (strncmp(reply, "OK", 2) == 0) return 0;
-  if (strncmp(reply, "DUPLICATE", 9) == 0) return ZCM_NODE_REGISTER_EX_DUPLICATE;
-  return -1;
+  zcm_node_cache_invalidate(node, name);
+  const char *parts[] = { "REGISTER_EX", name, endpoint, ctrl_endpoint, host,
+                          pid_buf, role, pub_port_buf, push_port_buf };
+  node_reply_t reply;
+  if (node_request(node, parts, sizeof(parts) / sizeof(parts[0]), &reply) != 0) return -1;
+  int rc = -1;
+  if (node_reply_is(&reply, 0, "OK")) {
+    rc = 0;
+  } else if (node_reply_is(&reply, 0, "DUPLICATE")) {
+    rc = ZCM_NODE_REGISTER_EX_DUPLICATE;
+  }
+  node_reply_free(&reply);
+  return rc;
 }
 
-int zcm_node_info(zcm_node_t *node, const char *name,
-                  char *out_endpoint, size_t out_ep_size,
-                  char *out_ctrl_endpoint, size_t out_ctrl_size,
-                  char *out_host, size_t out_host_size,
-                  int *out_pid) {
-  if (!node || !name) return -1;
-  void *sock = zmq_socket(zcm_context_zmq(node->ctx), ZMQ_REQ);
-  if (!sock) return -1;
-  set_req_socket_options(sock, 1000);
-  if (zmq_connect(sock, node->broker_endpoint) != 0) {
-    zmq_close(sock);
+/* Parse the record at frame `i` laid out as INFO replies it: status, then
+ * endpoint, control endpoint, host and PID. 0 when found, 1 for NOT_FOUND,
+ * -1 when malformed. */
+static int node_reply_record(const node_reply_t *reply, size_t i, zcm_node_record_t *rec) {
+  char pid_buf[32] = {0};
+  if (node_reply_is(reply, i, "NOT_FOUND")) return 1;
+  if (!node_reply_is(reply, i, "OK") ||
+      node_reply_text(reply, i + 1, rec->endpoint, sizeof(rec->endpoint)) < 0 ||
+      node_reply_text(reply, i + 2, rec->ctrl_endpoint, sizeof(rec->ctrl_endpoint)) < 0 ||
+      node_reply_text(reply, i + 3, rec->host, sizeof(rec->host)) < 0 ||
+      node_reply_text(reply, i + 4, pid_buf, sizeof(pid_buf)) < 0) {
     return -1;
   }
-  if (send_frames_req(sock, "INFO", name, NULL) != 0) {
-    zmq_close(sock);
-    return -1;
+  rec->pid = atoi(pid_buf);
+  return 0;
+}
+
+/* Fetch the full record of `name`: 0 when found, 1 when the broker does not
+ * know the name, -1 on transport failure or a malformed reply. */
+static int node_fetch_record(zcm_node_t *node, const char *name, zcm_node_record_t *rec) {
+  const char *parts[] = { "INFO", name };
+  node_reply_t reply;
+  if (node_request(node, parts, 2, &reply) != 0) return -1;
+  int rc = node_reply_record(&reply, 0, rec);
+  node_reply_free(&reply);
+  return rc;
+}
+
+/* Cache helpers; the caller holds node->state_lock. */
+static node_cache_entry_t *cache_find(zcm_node_t *node, const char *name, uint64_t now) {
+  for (size_t i = 0; i < node->cache_count; i++) {
+    node_cache_entry_t *e = &node->cache[i];
+    if (strcmp(e->name, name) != 0) continue;
+    if (e->expires_ms > now) return e;
+    node->cache[i] = node->cache[--node->cache_count];
+    return NULL;
   }
-  char status[32] = {0};
-  int n = zmq_recv(sock, status, sizeof(status) - 1, 0);
-  if (n <= 0 || strncmp(status, "OK", 2) != 0) {
-    zmq_close(sock);
-    return -1;
+  return NULL;
+}
+
+static void cache_remove(zcm_node_t *node, const char *name) {
+  for (size_t i = 0; i < node->cache_count; i++) {
+    if (strcmp(node->cache[i].name, name) == 0) {
+      node->cache[i] = node->cache[--node->cache_count];
+      return;
+    }
   }
+}
 
-  char ep[512] = {0};
-  char ctrl[512] = {0};
-  char host[256] = {0};
-  char pid_buf[32] = {0};
+/* Store a positive (`rec`) or negative (`rec == NULL`) entry, replacing the
+ * entry closest to expiry when the cache is full. */
+static void cache_store(zcm_node_t *node, const char *name, const zcm_node_record_t *rec,
+                        uint64_t now) {
+  int ttl = rec ? node->cache_ttl_ms : node->cache_neg_ttl_ms;
+  if (ttl <= 0 || strlen(name) >= sizeof(node->cache[0].name)) return;
+  if (!node->cache) {
+    node->cache = (node_cache_entry_t *)calloc(ZCM_NODE_CACHE_MAX, sizeof(*node->cache));
+    if (!node->cache) return;
+  }
+  cache_remove(node, name);
+  node_cache_entry_t *e = NULL;
+  if (node->cache_count < ZCM_NODE_CACHE_MAX) {
+    e = &node->cache[node->cache_count++];
+  } else {
+    e = &node->cache[0];
+    for (size_t i = 1; i < node->cache_count; i++) {
+      if (node->cache[i].expires_ms < e->expires_ms) e = &node->cache[i];
+    }
+  }
+  snprintf(e->name, sizeof(e->name), "%s", name);
+  e->found = rec ? 1 : 0;
+  if (rec) {
+    e->rec = *rec;
+  } else {
+    memset(&e->rec, 0, sizeof(e->rec));
+  }
+  e->expires_ms = now + (uint64_t)ttl;
+}
 
-  n = zmq_recv(sock, ep, sizeof(ep) - 1, 0);
-  if (n < 0) { zmq_close(sock); return -1; }
-  ep[n] = '\0';
-  n = zmq_recv(sock, ctrl, sizeof(ctrl) - 1, 0);
-  if (n < 0) { zmq_close(sock); return -1; }
-  ctrl[n] = '\0';
-  n = zmq_recv(sock, host, sizeof(host) - 1, 0);
-  if (n < 0) { zmq_close(sock); return -1; }
-  host[n] = '\0';
-  n = zmq_recv(sock, pid_buf, sizeof(pid_buf) - 1, 0);
-  if (n < 0) { zmq_close(sock); return -1; }
-  pid_buf[n] = '\0';
-  zmq_close(sock);
+int zcm_node_set_cache(zcm_node_t *node, int ttl_ms, int negative_ttl_ms) {
+  if (!node || ttl_ms < 0 || negative_ttl_ms < 0) return -1;
+  pthread_mutex_lock(&node->state_lock);
+  node->cache_ttl_ms = ttl_ms;
+  node->cache_neg_ttl_ms = ttl_ms > 0 ? negative_ttl_ms : 0;
+  node->cache_count = 0;
+  pthread_mutex_unlock(&node->state_lock);
+  return 0;
+}
+
+void zcm_node_cache_invalidate(zcm_node_t *node, const char *name) {
+  if (!node) return;
+  pthread_mutex_lock(&node->state_lock);
+  if (name) {
+    cache_remove(node, name);
+  } else {
+    node->cache_count = 0;
+  }
+  pthread_mutex_unlock(&node->state_lock);
+}
+
+/* Serve `name` from the cache: 0 found, 1 cached as unknown, -1 not cached.
+ * The caller holds node->state_lock. */
+static int cache_lookup(zcm_node_t *node, const char *name, zcm_node_record_t *out) {
+  if (node->cache_ttl_ms <= 0) return -1;
+  const node_cache_entry_t *e = cache_find(node, name, monotonic_ms());
+  if (!e) return -1;
+  if (!e->found) return 1;
+  *out = e->rec;
+  return 0;
+}
+
+/* node_fetch_record(), caching definite answers. */
+static int node_fetch_cached(zcm_node_t *node, const char *name, zcm_node_record_t *out) {
+  int rc = node_fetch_record(node, name, out);
+  if (rc >= 0) {
+    pthread_mutex_lock(&node->state_lock);
+    if (node->cache_ttl_ms > 0) cache_store(node, name, rc == 0 ? out : NULL, monotonic_ms());
+    pthread_mutex_unlock(&node->state_lock);
+  }
+  return rc;
+}
+
+int zcm_node_resolve(zcm_node_t *node, const char *name, zcm_node_record_t *out) {
+  if (!node || !name || !out) return -1;
+  memset(out, 0, sizeof(*out));
+
+  pthread_mutex_lock(&node->state_lock);
+  int rc = cache_lookup(node, name, out);
+  pthread_mutex_unlock(&node->state_lock);
+  if (rc < 0) rc = node_fetch_cached(node, name, out);
+  return rc == 0 ? 0 : -1;
+}
+
+int zcm_node_resolve_many(zcm_node_t *node, const char *const *names, size_t n,
+                          zcm_node_record_t *out_records) {
+  if (!node || (n > 0 && (!names || !out_records))) return -1;
+  for (size_t i = 0; i < n; i++) {
+    if (!names[i]) return -1;
+  }
+  if (n == 0) return 0;
+  memset(out_records, 0, n * sizeof(*out_records));
+
+  size_t *pending = (size_t *)malloc(n * sizeof(*pending));
+  if (!pending) return -1;
+  size_t pending_count = 0;
+  size_t found = 0;
+  int rc = -1;
+
+  pthread_mutex_lock(&node->state_lock);
+  for (size_t i = 0; i < n; i++) {
+    int cached = cache_lookup(node, names[i], &out_records[i]);
+    if (cached == 0) {
+      found++;
+    } else if (cached < 0) {
+      pending[pending_count++] = i;
+    }
+  }
+  pthread_mutex_unlock(&node->state_lock);
+
+  pthread_mutex_lock(&node->lock);
+
+  /* Send every batch before reading any reply so a large request costs one
+   * round trip plus transfer time rather than one round trip per batch. */
+  size_t batch_count = (pending_count + ZCM_NODE_RESOLVE_BATCH_MAX - 1) / ZCM_NODE_RESOLVE_BATCH_MAX;
+  uint8_t *fallback = (uint8_t *)calloc(batch_count ? batch_count : 1, 1);
+  uint32_t first_id = 0;
+  if (!fallback) goto unlock;
+  for (size_t b = 0; b < batch_count; b++) {
+    const char *parts[1 + ZCM_NODE_RESOLVE_BATCH_MAX];
+    size_t base = b * ZCM_NODE_RESOLVE_BATCH_MAX;
+    size_t len = pending_count - base;
+    if (len > ZCM_NODE_RESOLVE_BATCH_MAX) len = ZCM_NODE_RESOLVE_BATCH_MAX;
+    parts[0] = "LOOKUP_MANY";
+    for (size_t k = 0; k < len; k++) parts[1 + k] = names[pending[base + k]];
+    uint32_t id = 0;
+    if (node_send_locked(node, parts, 1 + len, &id) != 0) goto unlock;
+    if (b == 0) first_id = id;
+  }
+  for (size_t r = 0; r < batch_count; r++) {
+    node_reply_t reply;
+    uint32_t b = 0;
+    if (node_recv_locked(node, first_id, (uint32_t)batch_count, &reply, &b) != 0) goto unlock;
+    size_t base = (size_t)b * ZCM_NODE_RESOLVE_BATCH_MAX;
+    size_t len = pending_count - base;
+    if (len > ZCM_NODE_RESOLVE_BATCH_MAX) len = ZCM_NODE_RESOLVE_BATCH_MAX;
+    if (!node_reply_is(&reply, 0, "OK")) {
+      /* Brokers without LOOKUP_MANY answer ERR; resolve those one by one. */
+      fallback[b] = 1;
+      node_reply_free(&reply);
+      continue;
+    }
+    uint64_t now = monotonic_ms();
+    for (size_t k = 0; k < len; k++) {
+      size_t idx = pending[base + k];
+      int one = node_reply_record(&reply, 1 + k * 5, &out_records[idx]);
+      if (one < 0) {
+        node_reply_free(&reply);
+        node_drop_conn(node);
+        goto unlock;
+      }
+      if (one == 0) found++;
+      pthread_mutex_lock(&node->state_lock);
+      if (node->cache_ttl_ms > 0) {
+        cache_store(node, names[idx], one == 0 ? &out_records[idx] : NULL, now);
+      }
+      pthread_mutex_unlock(&node->state_lock);
+    }
+    node_reply_free(&reply);
+  }
+  rc = 0;
+
+unlock:
+  pthread_mutex_unlock(&node->lock);
+  for (size_t b = 0; rc == 0 && b < batch_count; b++) {
+    if (!fallback[b]) continue;
+    for (size_t k = b * ZCM_NODE_RESOLVE_BATCH_MAX;
+         k < pending_count && k < (b + 1) * ZCM_NODE_RESOLVE_BATCH_MAX; k++) {
+      int one = node_fetch_cached(node, names[pending[k]], &out_records[pending[k]]);
+      if (one < 0) {
+        rc = -1;
+        break;
+      }
+      if (one == 0) found++;
+    }
+  }
+  free(fallback);
+  free(pending);
+  return rc == 0 ? (int)found : -1;
+}
+
+int zcm_node_info(zcm_node_t *node, const char *name,
+                  char *out_endpoint, size_t out_ep_size,
+                  char *out_ctrl_endpoint, size_t out_ctrl_size,
+                  char *out_host, size_t out_host_size,
+                  int *out_pid) {
+  zcm_node_record_t rec;
+  if (zcm_node_resolve(node, name, &rec) != 0) return -1;
 
   if (out_endpoint && out_ep_size) {
-    strncpy(out_endpoint, ep, out_ep_size - 1);
+    strncpy(out_endpoint, rec.endpoint, out_ep_size - 1);
     out_endpoint[out_ep_size - 1] = '\0';
   }
   if (out_ctrl_endpoint && out_ctrl_size) {
-    strncpy(out_ctrl_endpoint, ctrl, out_ctrl_size - 1);
+    strncpy(out_ctrl_endpoint, rec.ctrl_endpoint, out_ctrl_size - 1);
     out_ctrl_endpoint[out_ctrl_size - 1] = '\0';
   }
   if (out_host && out_host_size) {
-    strncpy(out_host, host, out_host_size - 1);
+    strncpy(out_host, rec.host, out_host_size - 1);
     out_host[out_host_size - 1] = '\0';
   }
-  if (out_pid) *out_pid = atoi(pid_buf);
+  if (out_pid) *out_pid = rec.pid;
   return 0;
 }
 
 int zcm_node_lookup(zcm_node_t *node, const char *name, char *out_endpoint, size_t out_size) {
   if (!node || !name || !out_endpoint || out_size == 0) return -1;
-  void *sock = zmq_socket(zcm_context_zmq(node->ctx), ZMQ_REQ);
-  if (!sock) return -1;
-  set_req_socket_options(sock, 1000);
-  int rc = zmq_connect(sock, node->broker_endpoint);
-  if (rc != 0) {
-    zmq_close(sock);
-    return -1;
-  }
-  if (send_frames_req(sock, "LOOKUP", name, NULL) != 0) {
-    zmq_close(sock);
-    return -1;
-  }
-  char status[32] = {0};
-  int n = zmq_recv(sock, status, sizeof(status) - 1, 0);
-  if (n <= 0) {
-    zmq_close(sock);
-    return -1;
+  pthread_mutex_lock(&node->state_lock);
+  int cached = node->cache_ttl_ms > 0;
+  pthread_mutex_unlock(&node->state_lock);
+  if (cached) {
+    /* Resolve the full record so a following zcm_node_info() is a hit too. */
+    zcm_node_record_t rec;
+    if (zcm_node_resolve(node, name, &rec) != 0 || !rec.endpoint[0]) return -1;
+    snprintf(out_endpoint, out_size, "%s", rec.endpoint);
+    return 0;
   }
-  if (strncmp(status, "OK", 2) != 0) {
-    zmq_close(sock);
-    return -1;
+
+  const char *parts[] = { "LOOKUP", name };
+  node_reply_t reply;
+  if (node_request(node, parts, 2, &reply) != 0) return -1;
+  int rc = -1;
+  if (node_reply_is(&reply, 0, "OK") &&
+      node_reply_text(&reply, 1, out_endpoint, out_size) > 0) {
+    rc = 0;
   }
-  n = zmq_recv(sock, out_endpoint, out_size - 1, 0);
-  zmq_close(sock);
-  if (n <= 0) return -1;
-  out_endpoint[n] = '\0';
-  return 0;
+  node_reply_free(&reply);
+  return rc;
 }
 
 int zcm_node_list(zcm_node_t *node, zcm_node_entry_t **out_entries, size_t *out_count) {
@@ -231,57 +718,36 @@ int zcm_node_list(zcm_node_t *node, zcm_node_entry_t **out_entries, size_t *out_
   *out_entries = NULL;
   *out_count = 0;
 
-  void *sock = zmq_socket(zcm_context_zmq(node->ctx), ZMQ_REQ);
-  if (!sock) return -1;
-  set_req_socket_options(sock, 1000);
-  if (zmq_connect(sock, node->broker_endpoint) != 0) {
-    zmq_close(sock);
-    return -1;
-  }
-  if (zmq_send(sock, "LIST", 4, 0) < 0) {
-    zmq_close(sock);
-    return -1;
-  }
-
-  char status[16] = {0};
-  int n = recv_with_timeout(sock, status, sizeof(status) - 1, 1000);
-  if (n <= 0) {
-    zmq_close(sock);
-    return -1;
-  }
-  status[n] = '\0';
-  if (strncmp(status, "OK", 2) != 0) {
-    zmq_close(sock);
-    return -1;
-  }
-
+  const char *parts[] = { "LIST" };
+  node_reply_t reply;
+  if (node_request(node, parts, 1, &reply) != 0) return -1;
+  const void *count_data = NULL;
   int count = 0;
-  n = recv_with_timeout(sock, &count, sizeof(count), 1000);
-  if (n <= 0) {
-    zmq_close(sock);
+  if (!node_reply_is(&reply, 0, "OK") ||
+      node_reply_part(&reply, 1, &count_data) < sizeof(count)) {
+    node_reply_free(&reply);
     return -1;
   }
+  memcpy(&count, count_data, sizeof(count));
   if (count <= 0) {
-    zmq_close(sock);
+    node_reply_free(&reply);
     return 0;
   }
 
   zcm_node_entry_t *entries = (zcm_node_entry_t *)calloc((size_t)count, sizeof(zcm_node_entry_t));
   if (!entries) {
-    zmq_close(sock);
+    node_reply_free(&reply);
     return -1;
   }
 
   for (int i = 0; i < count; i++) {
     char name[256] = {0};
     char endpoint[512] = {0};
-    n = recv_with_timeout(sock, name, sizeof(name) - 1, 1000);
-    if (n <= 0) { count = i; break; }
-    name[n] = '\0';
-
-    n = recv_with_timeout(sock, endpoint, sizeof(endpoint) - 1, 1000);
-    if (n <= 0) { count = i; break; }
-    endpoint[n] = '\0';
+    if (node_reply_text(&reply, 2 + 2 * (size_t)i, name, sizeof(name)) <= 0 ||
+        node_reply_text(&reply, 3 + 2 * (size_t)i, endpoint, sizeof(endpoint)) <= 0) {
+      count = i;
+      break;
+    }
 
     entries[i].name = strdup(name);
     entries[i].endpoint = strdup(endpoint);
@@ -291,7 +757,7 @@ int zcm_node_list(zcm_node_t *node, zcm_node_entry_t **out_entries, size_t *out_
     }
   }
 
-  zmq_close(sock);
+  node_reply_free(&reply);
 
   *out_entries = entries;
   *out_count = (size_t)count;
@@ -313,14 +779,6 @@ int zcm_node_report_metrics(zcm_node_t *node, const char *name, const char *role
                             int push_bytes, int pull_bytes) {
   if (!node || !name || !*name || !role || !*role) return -1;
 
-  void *sock = zmq_socket(zcm_context_zmq(node->ctx), ZMQ_REQ);
-  if (!sock) return -1;
-  set_req_socket_options(sock, 1000);
-  if (zmq_connect(sock, node->broker_endpoint) != 0) {
-    zmq_close(sock);
-    return -1;
-  }
-
   char pub_port_s[32];
   char push_port_s[32];
   char pub_bytes_s[32];
@@ -334,22 +792,434 @@ int zcm_node_report_metrics(zcm_node_t *node, const char *name, const char *role
   snprintf(push_bytes_s, sizeof(push_bytes_s), "%d", push_bytes);
   snprintf(pull_bytes_s, sizeof(pull_bytes_s), "%d", pull_bytes);
 
-  if (zmq_send(sock, "METRICS", 7, ZMQ_SNDMORE) < 0) { zmq_close(sock); return -1; }
-  if (zmq_send(sock, name, strlen(name), ZMQ_SNDMORE) < 0) { zmq_close(sock); return -1; }
-  if (zmq_send(sock, role, strlen(role), ZMQ_SNDMORE) < 0) { zmq_close(sock); return -1; }
-  if (zmq_send(sock, pub_port_s, strlen(pub_port_s), ZMQ_SNDMORE) < 0) { zmq_close(sock); return -1; }
-  if (zmq_send(sock, push_port_s, strlen(push_port_s), ZMQ_SNDMORE) < 0) { zmq_close(sock); return -1; }
-  if (zmq_send(sock, pub_bytes_s, strlen(pub_bytes_s), ZMQ_SNDMORE) < 0) { zmq_close(sock); return -1; }
-  if (zmq_send(sock, sub_bytes_s, strlen(sub_bytes_s), ZMQ_SNDMORE) < 0) { zmq_close(sock); return -1; }
-  if (zmq_send(sock, push_bytes_s, strlen(push_bytes_s), ZMQ_SNDMORE) < 0) { zmq_close(sock); return -1; }
-  if (zmq_send(sock, pull_bytes_s, strlen(pull_bytes_s), 0) < 0) { zmq_close(sock); return -1; }
+  const char *parts[] = { "METRICS", name, role, pub_port_s, push_port_s,
+                          pub_bytes_s, sub_bytes_s, push_bytes_s, pull_bytes_s };
+  node_reply_t reply;
+  if (node_request(node, parts, sizeof(parts) / sizeof(parts[0]), &reply) != 0) return -1;
+  int rc = node_reply_is(&reply, 0, "OK") ? 0 : -1;
+  node_reply_free(&reply);
+  return rc;
+}
+
+/* A broker bound to a wildcard address advertises it as such; reach its
+ * metrics port through the host used for the broker itself. */
+static void node_metrics_fix_host(const char *broker_ep, char *ep, size_t ep_size) {
+  if (strncmp(ep, "tcp://", 6) != 0 || strncmp(broker_ep, "tcp://", 6) != 0) return;
+  const char *host = ep + 6;
+  const char *colon = strrchr(host, ':');
+  const char *broker_host = broker_ep + 6;
+  const char *broker_colon = strrchr(broker_host, ':');
+  if (!colon || !broker_colon) return;
+  size_t host_len = (size_t)(colon - host);
+  if (!((host_len == 7 && strncmp(host, "0.0.0.0", 7) == 0) ||
+        (host_len == 1 && host[0] == '*') ||
+        (host_len == 4 && strncmp(host, "[::]", 4) == 0))) {
+    return;
+  }
+  char fixed[512];
+  snprintf(fixed, sizeof(fixed), "tcp://%.*s%s", (int)(broker_colon - broker_host), broker_host,
+           colon);
+  snprintf(ep, ep_size, "%s", fixed);
+}
+
+/* Returns 0 with the metrics endpoint, 1 when the broker has none (or does
+ * not know the command), -1 when the broker did not answer. */
+static int node_metrics_discover(zcm_node_t *node, char *ep, size_t ep_size) {
+  const char *parts[] = { "METRICS_ENDPOINT" };
+  node_reply_t reply;
+  if (node_request(node, parts, 1, &reply) != 0) return -1;
+  int rc = 1;
+  if (node_reply_is(&reply, 0, "OK") && node_reply_text(&reply, 1, ep, ep_size) > 0) {
+    node_metrics_fix_host(node->broker_endpoint, ep, ep_size);
+    rc = 0;
+  }
+  node_reply_free(&reply);
+  return rc;
+}
+
+static void *node_metrics_connect(zcm_node_t *node, const char *endpoint) {
+  void *sock = zmq_socket(zcm_context_zmq(node->ctx), ZMQ_PUSH);
+  if (!sock) return NULL;
+  int linger_ms = 0;
+  int hwm = ZCM_NODE_METRICS_HWM;
+  zmq_setsockopt(sock, ZMQ_LINGER, &linger_ms, sizeof(linger_ms));
+  zmq_setsockopt(sock, ZMQ_SNDHWM, &hwm, sizeof(hwm));
+  if (zmq_connect(sock, endpoint) != 0) {
+    zmq_close(sock);
+    return NULL;
+  }
+  return sock;
+}
+
+/* Returns 0 once the frame is queued, 1 when the broker only takes text
+ * METRICS requests, -1 otherwise. */
+static int node_metrics_send(zcm_node_t *node, const void *frame, size_t len) {
+  uint64_t now = monotonic_ms();
+  pthread_mutex_lock(&node->state_lock);
+  int discover = (!node->metrics_push || node->metrics_stale) && now >= node->metrics_retry_at;
+  pthread_mutex_unlock(&node->state_lock);
+
+  if (discover) {
+    char ep[512] = {0};
+    int found = node_metrics_discover(node, ep, sizeof(ep));
+    pthread_mutex_lock(&node->state_lock);
+    int same = (found == 0 && node->metrics_push && strcmp(ep, node->metrics_endpoint) == 0);
+    pthread_mutex_unlock(&node->state_lock);
+    void *sock = (found == 0 && !same) ? node_metrics_connect(node, ep) : NULL;
+    pthread_mutex_lock(&node->state_lock);
+    if (sock || found == 1) {
+      if (node->metrics_push) zmq_close(node->metrics_push);
+      node->metrics_push = sock;
+      snprintf(node->metrics_endpoint, sizeof(node->metrics_endpoint), "%s", sock ? ep : "");
+    }
+    if (same || sock || found == 1) node->metrics_stale = 0;
+    node->metrics_legacy = (found == 1);
+    node->metrics_retry_at = now + (found == 1 ? ZCM_NODE_METRICS_LEGACY_RETRY_MS
+                                               : ZCM_NODE_METRICS_RETRY_MS);
+    pthread_mutex_unlock(&node->state_lock);
+  }
+
+  int rc = -1;
+  pthread_mutex_lock(&node->state_lock);
+  if (node->metrics_push) {
+    if (zmq_send(node->metrics_push, frame, len, ZMQ_DONTWAIT) >= 0) {
+      rc = 0;
+    } else {
+      /* Queue full: a burst, or the broker is gone or moved. Drop the
+       * report and check the endpoint on a later call. */
+      node->metrics_stale = 1;
+    }
+  } else if (node->metrics_legacy) {
+    rc = 1;
+  }
+  pthread_mutex_unlock(&node->state_lock);
+  return rc;
+}
+
+static uint8_t *put_le16(uint8_t *p, uint16_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  return p + 2;
+}
+
+static uint8_t *put_le32(uint8_t *p, uint32_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  p[2] = (uint8_t)(v >> 16);
+  p[3] = (uint8_t)(v >> 24);
+  return p + 4;
+}
+
+int zcm_node_push_metrics(zcm_node_t *node, const zcm_node_metrics_t *reports, size_t count) {
+  if (!node || !reports || count == 0 || count > ZCM_NODE_METRICS_BATCH_MAX) return -1;
+  size_t len = ZCM_NODE_METRICS_HEADER_SIZE;
+  for (size_t i = 0; i < count; i++) {
+    const zcm_node_metrics_t *r = &reports[i];
+    if (!r->name || !*r->name) return -1;
+    size_t name_len = strlen(r->name);
+    size_t role_len = r->role ? strlen(r->role) : 0;
+    if (name_len > ZCM_NODE_METRICS_NAME_MAX || role_len > ZCM_NODE_METRICS_ROLE_MAX) return -1;
+    len += ZCM_NODE_METRICS_RECORD_SIZE + name_len + role_len;
+  }
+
+  uint8_t *frame = (uint8_t *)malloc(len);
+  if (!frame) return -1;
+  uint8_t *p = frame;
+  memcpy(p, ZCM_NODE_METRICS_MAGIC, 4);
+  p = put_le16(p + 4, ZCM_NODE_METRICS_VERSION);
+  p = put_le16(p, (uint16_t)count);
+  for (size_t i = 0; i < count; i++) {
+    const zcm_node_metrics_t *r = &reports[i];
+    size_t name_len = strlen(r->name);
+    size_t role_len = r->role ? strlen(r->role) : 0;
+    p = put_le16(p, (uint16_t)name_len);
+    p = put_le16(p, (uint16_t)role_len);
+    p = put_le32(p, (uint32_t)r->pub_port);
+    p = put_le32(p, (uint32_t)r->push_port);
+    p = put_le32(p, (uint32_t)r->pub_bytes);
+    p = put_le32(p, (uint32_t)r->sub_bytes);
+    p = put_le32(p, (uint32_t)r->push_bytes);
+    p = put_le32(p, (uint32_t)r->pull_bytes);
+    memcpy(p, r->name, name_len);
+    p += name_len;
+    if (role_len) memcpy(p, r->role, role_len);
+    p += role_len;
+  }
+
+  int rc = node_metrics_send(node, frame, len);
+  free(frame);
+  if (rc != 1) return rc;
+
+  rc = 0;
+  for (size_t i = 0; i < count; i++) {
+    const zcm_node_metrics_t *r = &reports[i];
+    const char *role = (r->role && *r->role) ? r->role : "-";
+    if (zcm_node_report_metrics(node, r->name, role, r->pub_port, r->push_port, r->pub_bytes,
+                                r->sub_bytes, r->push_bytes, r->pull_bytes) != 0) {
+      rc = -1;
+    }
+  }
+  return rc;
+}
+
+/* ---- asynchronous requests --------------------------------------------- */
+
+static void *node_async_conn(zcm_node_t *node) {
+  if (node->async_conn) return node->async_conn;
+  void *sock = zmq_socket(zcm_context_zmq(node->ctx), ZMQ_DEALER);
+  if (!sock) return NULL;
+  int linger_ms = 0;
+  zmq_setsockopt(sock, ZMQ_LINGER, &linger_ms, sizeof(linger_ms));
+  if (zmq_connect(sock, node->broker_endpoint) != 0) {
+    zmq_close(sock);
+    return NULL;
+  }
+  node->async_conn = sock;
+  return sock;
+}
+
+/* Queue [id][""][parts...] without blocking and remember the request. */
+static int node_async_send(zcm_node_t *node, node_async_kind_t kind, const char *name,
+                           const char *const *parts, size_t n,
+                           zcm_node_async_cb_t cb, void *user) {
+  if (!cb || strlen(name) >= sizeof(((node_async_req_t *)0)->name)) return -1;
+  void *sock = node_async_conn(node);
+  if (!sock) return -1;
+  if (node->async_count == node->async_cap) {
+    size_t cap = node->async_cap ? node->async_cap * 2 : 16;
+    node_async_req_t *reqs =
+        (node_async_req_t *)realloc(node->async_reqs, cap * sizeof(*reqs));
+    if (!reqs) return -1;
+    node->async_reqs = reqs;
+    node->async_cap = cap;
+  }
+
+  pthread_mutex_lock(&node->state_lock);
+  int timeout_ms = node->timeout_ms;
+  pthread_mutex_unlock(&node->state_lock);
+
+  uint32_t id = ++node->async_next_id;
+  /* A multipart message is queued whole once its first frame is accepted. */
+  if (zmq_send(sock, &id, sizeof(id), ZMQ_SNDMORE | ZMQ_DONTWAIT) < 0) return -1;
+  zmq_send(sock, "", 0, ZMQ_SNDMORE);
+  for (size_t i = 0; i < n; i++) {
+    zmq_send(sock, parts[i], strlen(parts[i]), (i + 1 < n) ? ZMQ_SNDMORE : 0);
+  }
+
+  node_async_req_t *req = &node->async_reqs[node->async_count++];
+  req->id = id;
+  req->kind = kind;
+  snprintf(req->name, sizeof(req->name), "%s", name);
+  req->cb = cb;
+  req->user = user;
+  req->deadline_ms = monotonic_ms() + (uint64_t)timeout_ms;
+  return 0;
+}
 
-  char reply[32] = {0};
-  int n = zmq_recv(sock, reply, sizeof(reply) - 1, 0);
-  zmq_close(sock);
-  if (n <= 0) return -1;
-  reply[n] = '\0';
-  return (strncmp(reply, "OK", 2) == 0) ? 0 : -1;
+/* Remove request `i`, keeping the rest in issue order. */
+static node_async_req_t node_async_take(zcm_node_t *node, size_t i) {
+  node_async_req_t req = node->async_reqs[i];
+  memmove(&node->async_reqs[i], &node->async_reqs[i + 1],
+          (node->async_count - i - 1) * sizeof(*node->async_reqs));
+  node->async_count--;
+  return req;
+}
+
+static void node_async_complete(zcm_node_t *node, const node_async_req_t *req,
+                                const node_reply_t *reply) {
+  zcm_node_record_t rec;
+  memset(&rec, 0, sizeof(rec));
+  int status = -1;
+  switch (req->kind) {
+    case NODE_ASYNC_LOOKUP:
+      if (node_reply_is(reply, 0, "OK") &&
+          node_reply_text(reply, 1, rec.endpoint, sizeof(rec.endpoint)) > 0) {
+        status = 0;
+      }
+      break;
+    case NODE_ASYNC_RESOLVE: {
+      int rc = node_reply_record(reply, 0, &rec);
+      if (rc >= 0) {
+        pthread_mutex_lock(&node->state_lock);
+        if (node->cache_ttl_ms > 0) cache_store(node, req->name, rc == 0 ? &rec : NULL, monotonic_ms());
+        pthread_mutex_unlock(&node->state_lock);
+      }
+      if (rc == 0) status = 0;
+      break;
+    }
+    case NODE_ASYNC_REGISTER:
+      if (node_reply_is(reply, 0, "OK")) {
+        status = 0;
+      } else if (node_reply_is(reply, 0, "DUPLICATE")) {
+        status = ZCM_NODE_REGISTER_EX_DUPLICATE;
+      }
+      break;
+    case NODE_ASYNC_UNREGISTER:
+      if (node_reply_is(reply, 0, "OK")) status = 0;
+      break;
+  }
+  req->cb(node, req->name, status, status == 0 && (req->kind == NODE_ASYNC_LOOKUP ||
+                                                   req->kind == NODE_ASYNC_RESOLVE)
+                                       ? &rec : NULL,
+          req->user);
+}
+
+/* Receive one reply without blocking: 1 when a request completed, 0 when
+ * nothing (matching) was ready, -1 on socket failure. */
+static int node_async_recv_one(zcm_node_t *node) {
+  void *sock = node->async_conn;
+  if (!sock) return 0;
+  for (;;) {
+    zmq_msg_t head;
+    zmq_msg_init(&head);
+    if (zmq_msg_recv(&head, sock, ZMQ_DONTWAIT) < 0) {
+      zmq_msg_close(&head);
+      return zmq_errno() == EAGAIN ? 0 : -1;
+    }
+    uint32_t id = 0;
+    int have_id = zmq_msg_size(&head) == sizeof(id);
+    if (have_id) memcpy(&id, zmq_msg_data(&head), sizeof(id));
+    zmq_msg_close(&head);
+
+    node_reply_t reply;
+    memset(&reply, 0, sizeof(reply));
+    if (sock_has_more(sock)) {
+      zmq_msg_t delim;
+      zmq_msg_init(&delim);
+      if (zmq_msg_recv(&delim, sock, 0) != 0) have_id = 0;
+      zmq_msg_close(&delim);
+      if (node_recv_rest(sock, &reply, have_id) != 0) {
+        node_reply_free(&reply);
+        return -1;
+      }
+    }
+    size_t i = 0;
+    while (have_id && i < node->async_count && node->async_reqs[i].id != id) i++;
+    if (!have_id || i == node->async_count) {
+      /* Late reply to a request that already timed out. */
+      node_reply_free(&reply);
+      continue;
+    }
+    node_async_req_t req = node_async_take(node, i);
+    node_async_complete(node, &req, &reply);
+    node_reply_free(&reply);
+    return 1;
+  }
+}
+
+/* Index of the request with the earliest deadline. Deadlines follow the
+ * timeout in force when each request was issued, so issue order is not
+ * deadline order once zcm_node_set_timeout() shortens it. */
+static size_t node_async_earliest(const zcm_node_t *node) {
+  size_t best = 0;
+  for (size_t i = 1; i < node->async_count; i++) {
+    if (node->async_reqs[i].deadline_ms < node->async_reqs[best].deadline_ms) best = i;
+  }
+  return best;
+}
+
+static int node_async_expire_one(zcm_node_t *node) {
+  if (node->async_count == 0) return 0;
+  size_t i = node_async_earliest(node);
+  if (node->async_reqs[i].deadline_ms > monotonic_ms()) return 0;
+  node_async_req_t req = node_async_take(node, i);
+  req.cb(node, req.name, ZCM_NODE_ASYNC_TIMEOUT, NULL, req.user);
+  return 1;
+}
+
+static void node_async_cancel_all(zcm_node_t *node) {
+  while (node->async_count > 0) {
+    node_async_req_t req = node_async_take(node, 0);
+    req.cb(node, req.name, ZCM_NODE_ASYNC_CANCELLED, NULL, req.user);
+  }
+}
+
+int zcm_node_lookup_async(zcm_node_t *node, const char *name,
+                          zcm_node_async_cb_t cb, void *user) {
+  if (!node || !name) return -1;
+  const char *parts[] = { "LOOKUP", name };
+  return node_async_send(node, NODE_ASYNC_LOOKUP, name, parts, 2, cb, user);
+}
+
+int zcm_node_resolve_async(zcm_node_t *node, const char *name,
+                           zcm_node_async_cb_t cb, void *user) {
+  if (!node || !name) return -1;
+  const char *parts[] = { "INFO", name };
+  return node_async_send(node, NODE_ASYNC_RESOLVE, name, parts, 2, cb, user);
+}
+
+int zcm_node_register_async(zcm_node_t *node, const char *name, const char *endpoint,
+                            const char *ctrl_endpoint, const char *host, int pid,
+                            const char *role, int pub_port, int push_port,
+                            zcm_node_async_cb_t cb, void *user) {
+  if (!node || !name || !endpoint || !ctrl_endpoint || !host || !role) return -1;
+  if (!name[0] || !endpoint[0] || !ctrl_endpoint[0] || !host[0] || pid <= 0 || !role[0]) return -1;
+  char pid_buf[32];
+  char pub_port_buf[32];
+  char push_port_buf[32];
+  snprintf(pid_buf, sizeof(pid_buf), "%d", pid);
+  snprintf(pub_port_buf, sizeof(pub_port_buf), "%d", pub_port);
+  snprintf(push_port_buf, sizeof(push_port_buf), "%d", push_port);
+  zcm_node_cache_invalidate(node, name);
+  const char *parts[] = { "REGISTER_EX", name, endpoint, ctrl_endpoint, host,
+                          pid_buf, role, pub_port_buf, push_port_buf };
+  return node_async_send(node, NODE_ASYNC_REGISTER, name, parts,
+                         sizeof(parts) / sizeof(parts[0]), cb, user);
+}
+
+int zcm_node_unregister_async(zcm_node_t *node, const char *name,
+                              zcm_node_async_cb_t cb, void *user) {
+  if (!node || !name) return -1;
+  zcm_node_cache_invalidate(node, name);
+  const char *parts[] = { "UNREGISTER", name };
+  return node_async_send(node, NODE_ASYNC_UNREGISTER, name, parts, 2, cb, user);
+}
+
+int zcm_node_async_fd(zcm_node_t *node, int *out_fd) {
+  if (!node || !out_fd) return -1;
+  void *sock = node_async_conn(node);
+  if (!sock) return -1;
+  int fd = -1;
+  size_t fd_size = sizeof(fd);
+  if (zmq_getsockopt(sock, ZMQ_FD, &fd, &fd_size) != 0) return -1;
+  *out_fd = fd;
+  return 0;
+}
+
+int zcm_node_async_timeout_ms(zcm_node_t *node) {
+  if (!node || node->async_count == 0) return -1;
+  uint64_t now = monotonic_ms();
+  uint64_t deadline = node->async_reqs[node_async_earliest(node)].deadline_ms;
+  return deadline > now ? (int)(deadline - now) : 0;
+}
+
+size_t zcm_node_async_pending(zcm_node_t *node) {
+  return node ? node->async_count : 0;
+}
+
+int zcm_node_async_process(zcm_node_t *node, int timeout_ms) {
+  if (!node) return -1;
+  uint64_t deadline = monotonic_ms() + (uint64_t)(timeout_ms > 0 ? timeout_ms : 0);
+  int done = 0;
+  for (;;) {
+    int rc = node_async_recv_one(node);
+    if (rc < 0) return done > 0 ? done : -1;
+    if (rc == 0) rc = node_async_expire_one(node);
+    if (rc > 0) {
+      done++;
+      continue;
+    }
+    if (done > 0 || timeout_ms == 0 || node->async_count == 0) return done;
+
+    /* Nothing ready: wait for a reply, the earliest request deadline or the
+     * caller's timeout, whichever comes first. */
+    uint64_t now = monotonic_ms();
+    if (timeout_ms > 0 && now >= deadline) return 0;
+    uint64_t wake = node->async_reqs[node_async_earliest(node)].deadline_ms;
+    if (timeout_ms > 0 && deadline < wake) wake = deadline;
+    zmq_pollitem_t items[] = { { node->async_conn, 0, ZMQ_POLLIN, 0 } };
+    if (zmq_poll(items, 1, wake > now ? (long)(wake - now) : 0) < 0) return -1;
+  }
 }
 
 static int text_equals_nocase(const char *text, uint32_t len, const char *lit) {
@@ -362,12 +1232,18 @@ static int text_equals_nocase(const char *text, uint32_t len, const char *lit) {
 static const char *k_default_data_metrics =
   "ROLE=NONE;PUB_PORT=-1;PUSH_PORT=-1;PUB_BYTES=-1;SUB_BYTES=-1;PUSH_BYTES=-1;PULL_BYTES=-1;SUB_TARGETS=-;SUB_TARGET_BYTES=-";
 
+/* zcm_msg_type_id("ZCM_CMD"), so dispatch is one integer compare. */
+static const uint32_t k_cmd_type_id = 0x7b990e1eu;
+
 int zcm_node_handle_control_msg(zcm_msg_t *req, zcm_msg_t *reply, int *out_should_exit) {
   if (!req || !reply || !out_should_exit) return -1;
   *out_should_exit = 0;
 
+  if (zcm_msg_get_type_id(req) != k_cmd_type_id) return 0;
+  /* A named type must match exactly; an un-interned compact ID carries only
+   * a "#xxxxxxxx" placeholder and is taken by number. */
   const char *type = zcm_msg_get_type(req);
-  if (!type || strcmp(type, "ZCM_CMD") != 0) return 0;
+  if (!type || (type[0] != '#' && strcmp(type, "ZCM_CMD") != 0)) return 0;
 
   const char *cmd = NULL;
   uint32_t cmd_len = 0;
@@ -428,6 +1304,7 @@ zcm_socket_t *zcm_socket_new(zcm_context_t *ctx, zcm_socket_type_t type) {
   if (zt < 0) return NULL;
   zcm_socket_t *s = (zcm_socket_t *)calloc(1, sizeof(zcm_socket_t));
   if (!s) return NULL;
+  s->type = type;
   s->sock = zmq_socket(zcm_context_zmq(ctx), zt);
   if (!s->sock) {
     free(s);
@@ -444,8 +1321,18 @@ zcm_socket_t *zcm_socket_new(zcm_context_t *ctx, zcm_socket_type_t type) {
   return s;
 }
 
+static int flush_batch(zcm_socket_t *sock, int flags) {
+  if (sock->tx_len == 0) return 0;
+  int rc = zmq_send(sock->sock, sock->tx_batch, sock->tx_len, flags);
+  sock->tx_len = 0;
+  return (rc >= 0) ? 0 : -1;
+}
+
 void zcm_socket_free(zcm_socket_t *sock) {
   if (!sock) return;
+  if (sock->sock) (void)flush_batch(sock, ZMQ_DONTWAIT);
+  if (sock->rx_pending) zmq_msg_close(&sock->rx_batch);
+  free(sock->tx_batch);
   if (sock->sock) zmq_close(sock->sock);
   free(sock);
 }
@@ -465,29 +1352,380 @@ int zcm_socket_set_subscribe(zcm_socket_t *sock, const char *prefix, size_t len)
   return zmq_setsockopt(sock->sock, ZMQ_SUBSCRIBE, prefix, len);
 }
 
+static void free_ref_frame(void *data, void *hint) {
+  (void)data;
+  zcm_msg__ref_drop(hint);
+}
+
+/* Send a message holding zcm_msg_put_*_ref() buffers as one multipart
+ * message: the envelope head and the local spans between references are
+ * copied (they are item headers), each referenced buffer goes out as a
+ * zero-copy frame that keeps the buffer alive until ØMQ is done with it. */
+static int send_ref_frames(zcm_socket_t *sock, const zcm_msg_t *msg) {
+  zmq_msg_t head;
+  if (zmq_msg_init_size(&head, zcm_msg__head_size(msg)) != 0) return -1;
+  zcm_msg__write_head(msg, zmq_msg_data(&head));
+  if (zmq_msg_send(&head, sock->sock, ZMQ_SNDMORE) < 0) {
+    zmq_msg_close(&head);
+    return -1;
+  }
+  size_t n = zcm_msg__ref_count(msg);
+  for (size_t i = 0; i < n; i++) {
+    const void *ref = NULL;
+    const void *tail = NULL;
+    size_t ref_len = 0;
+    size_t tail_len = 0;
+    void *hold = NULL;
+    if (zcm_msg__ref_part(msg, i, &ref, &ref_len, &hold, &tail, &tail_len) != 0) return -1;
+    int more = (i + 1 < n || tail_len > 0) ? ZMQ_SNDMORE : 0;
+    if (ref_len == 0) {
+      zcm_msg__ref_drop(hold);
+      if (zmq_send(sock->sock, "", 0, more) < 0) return -1;
+    } else {
+      zmq_msg_t part;
+      if (zmq_msg_init_data(&part, (void *)ref, ref_len, free_ref_frame, hold) != 0) {
+        zcm_msg__ref_drop(hold);
+        return -1;
+      }
+      if (zmq_msg_send(&part, sock->sock, more) < 0) {
+        zmq_msg_close(&part);
+        return -1;
+      }
+    }
+    if (tail_len > 0 &&
+        zmq_send(sock->sock, tail, tail_len, (i + 1 < n) ? ZMQ_SNDMORE : 0) < 0) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+static void drain_more(void *zsock) {
+  int more = 0;
+  size_t more_len = sizeof(more);
+  while (zmq_getsockopt(zsock, ZMQ_RCVMORE, &more, &more_len) == 0 && more) {
+    zmq_msg_t part;
+    zmq_msg_init(&part);
+    if (zmq_msg_recv(&part, zsock, 0) < 0) {
+      zmq_msg_close(&part);
+      return;
+    }
+    zmq_msg_close(&part);
+    more_len = sizeof(more);
+  }
+}
+
+/* Reassemble a message that was sent as several frames (see send_ref_frames)
+ * into one owned buffer adopted by `msg`. `first` is left for the caller.
+ * The announced total comes from an untrusted header, so it is only a cap
+ * (together with the socket's ZMQ_MAXMSGSIZE): the buffer grows with the
+ * bytes that actually arrive. */
+static int recv_ref_frames(zcm_socket_t *sock, zmq_msg_t *first, zcm_msg_t *msg) {
+  size_t first_len = zmq_msg_size(first);
+  size_t total = zcm_msg__envelope_len(zmq_msg_data(first), first_len);
+  int64_t max_size = -1;
+  size_t max_size_len = sizeof(max_size);
+  if (zmq_getsockopt(sock->sock, ZMQ_MAXMSGSIZE, &max_size, &max_size_len) != 0) max_size = -1;
+  if (total < first_len || (max_size >= 0 && (uint64_t)total > (uint64_t)max_size)) {
+    drain_more(sock->sock);
+    return -1;
+  }
+  size_t cap = first_len ? first_len : 1;
+  uint8_t *buf = (uint8_t *)malloc(cap);
+  if (!buf) {
+    drain_more(sock->sock);
+    return -1;
+  }
+  memcpy(buf, zmq_msg_data(first), first_len);
+  size_t len = first_len;
+  int more = 1;
+  while (more) {
+    zmq_msg_t part;
+    zmq_msg_init(&part);
+    if (zmq_msg_recv(&part, sock->sock, 0) < 0) {
+      zmq_msg_close(&part);
+      free(buf);
+      return -1;
+    }
+    size_t n = zmq_msg_size(&part);
+    more = zmq_msg_more(&part);
+    if (n > total - len) {
+      zmq_msg_close(&part);
+      if (more) drain_more(sock->sock);
+      free(buf);
+      return -1;
+    }
+    if (len + n > cap) {
+      size_t new_cap = cap * 2 > len + n ? cap * 2 : len + n;
+      if (new_cap > total) new_cap = total;
+      uint8_t *nb = (uint8_t *)realloc(buf, new_cap);
+      if (!nb) {
+        zmq_msg_close(&part);
+        if (more) drain_more(sock->sock);
+        free(buf);
+        return -1;
+      }
+      buf = nb;
+      cap = new_cap;
+    }
+    if (n) memcpy(buf + len, zmq_msg_data(&part), n);
+    len += n;
+    zmq_msg_close(&part);
+  }
+  if (len != total || zcm_msg__from_borrowed(msg, buf, len, free, buf) != 0) {
+    free(buf);
+    return -1;
+  }
+  return 0;
+}
+
 int zcm_socket_send_msg(zcm_socket_t *sock, const zcm_msg_t *msg) {
   if (!sock || !sock->sock || !msg) return -1;
-  const void *data = NULL;
-  size_t len = 0;
-  void *owned = NULL;
-  if (zcm_msg__serialize(msg, &data, &len, &owned) != 0) return -1;
-  int rc = zmq_send(sock->sock, data, len, 0);
-  free(owned);
-  return (rc >= 0) ? 0 : -1;
+  if (sock->coalesce_max_bytes > 0) {
+    uint64_t now = monotonic_ms();
+    if (sock->tx_len == 0) sock->tx_first_ms = now;
+    if (zcm_msg__batch_append(msg, sock->type_ids, &sock->tx_batch, &sock->tx_len,
+                              &sock->tx_cap) != 0)
+      return -1;
+    if (sock->tx_len >= sock->coalesce_max_bytes ||
+        now - sock->tx_first_ms >= (uint64_t)sock->coalesce_delay_ms) {
+      return flush_batch(sock, 0);
+    }
+    return 0;
+  }
+  if (zcm_msg__ref_count(msg) > 0) return send_ref_frames(sock, msg);
+  /* Frame the envelope straight into the ØMQ message: one copy, same as
+   * zmq_send() would make, and the message itself is only read. */
+  zmq_msg_t frame;
+  if (zmq_msg_init_size(&frame, zcm_msg__envelope_size(msg, sock->type_ids)) != 0) return -1;
+  zcm_msg__write_envelope(msg, sock->type_ids, zmq_msg_data(&frame));
+  if (zmq_msg_send(&frame, sock->sock, 0) < 0) {
+    zmq_msg_close(&frame);
+    return -1;
+  }
+  return 0;
 }
 
-int zcm_socket_recv_msg(zcm_socket_t *sock, zcm_msg_t *msg) {
-  if (!sock || !sock->sock || !msg) return -1;
+int zcm_socket_set_coalesce(zcm_socket_t *sock, int max_delay_ms, size_t max_bytes) {
+  if (!sock || !sock->sock) return -1;
+  if (sock->type != ZCM_SOCK_PUB && sock->type != ZCM_SOCK_PUSH) return -1;
+  if (max_delay_ms < 0 || max_bytes == 0) {
+    int rc = flush_batch(sock, 0);
+    sock->coalesce_delay_ms = 0;
+    sock->coalesce_max_bytes = 0;
+    return rc;
+  }
+  sock->coalesce_delay_ms = max_delay_ms;
+  sock->coalesce_max_bytes = max_bytes;
+  return 0;
+}
+
+/* internal helper used by zcm_stream.c */
+zcm_socket_type_t zcm_socket__type(const zcm_socket_t *sock) {
+  return sock ? sock->type : (zcm_socket_type_t)0;
+}
+
+/* internal helpers used by zcm_poller.c */
+void *zcm_socket__zmq(const zcm_socket_t *sock) {
+  return sock ? sock->sock : NULL;
+}
+
+int zcm_socket__rx_pending(const zcm_socket_t *sock) {
+  return sock ? sock->rx_pending : 0;
+}
+
+int zcm_socket_set_type_ids(zcm_socket_t *sock, int enable) {
+  if (!sock || !sock->sock) return -1;
+  sock->type_ids = enable ? 1 : 0;
+  return 0;
+}
+
+int zcm_socket_flush(zcm_socket_t *sock) {
+  if (!sock || !sock->sock) return -1;
+  return flush_batch(sock, 0);
+}
+
+int zcm_socket_flush_timeout_ms(zcm_socket_t *sock) {
+  if (!sock || !sock->sock || sock->tx_len == 0) return -1;
+  uint64_t now = monotonic_ms();
+  uint64_t due = sock->tx_first_ms + (uint64_t)sock->coalesce_delay_ms;
+  return due > now ? (int)(due - now) : 0;
+}
+
+int zcm_socket_send_batch(zcm_socket_t *sock, const zcm_msg_t *const *msgs, size_t count) {
+  if (!sock || !sock->sock || !msgs || count == 0 || count > UINT32_MAX) return -1;
+  if (flush_batch(sock, 0) != 0) return -1;
+  for (size_t i = 0; i < count; i++) {
+    if (!msgs[i] ||
+        zcm_msg__batch_append(msgs[i], sock->type_ids, &sock->tx_batch, &sock->tx_len,
+                              &sock->tx_cap) != 0) {
+      sock->tx_len = 0;
+      return -1;
+    }
+  }
+  return flush_batch(sock, 0);
+}
+
+/* Decode the next entry of the pending batch frame into `msg`. */
+static int take_batch_entry(zcm_socket_t *sock, zcm_msg_t *msg) {
+  const void *entry = NULL;
+  size_t entry_len = 0;
+  int rc = zcm_msg__batch_next(zmq_msg_data(&sock->rx_batch), zmq_msg_size(&sock->rx_batch),
+                               &sock->rx_off, &entry, &entry_len);
+  if (rc == 0) rc = zcm_msg_from_bytes(msg, entry, entry_len);
+  if (rc != 0 || --sock->rx_left == 0) {
+    zmq_msg_close(&sock->rx_batch);
+    sock->rx_pending = 0;
+    sock->rx_left = 0;
+  }
+  return (rc == 0) ? 0 : -1;
+}
+
+/* Park a freshly received batch frame; returns 1 if `zmsg` was one. */
+static int adopt_batch_frame(zcm_socket_t *sock, zmq_msg_t *zmsg) {
+  uint32_t count = 0;
+  if (!zcm_msg__batch_header(zmq_msg_data(zmsg), zmq_msg_size(zmsg), &count)) return 0;
+  zmq_msg_init(&sock->rx_batch);
+  zmq_msg_move(&sock->rx_batch, zmsg);
+  zmq_msg_close(zmsg);
+  sock->rx_pending = 1;
+  sock->rx_off = 0;
+  sock->rx_left = count;
+  if (count == 0) {
+    zmq_msg_close(&sock->rx_batch);
+    sock->rx_pending = 0;
+  }
+  return 1;
+}
+
+/* Receive and decode one message with ØMQ `flags`; returns -2 when nothing
+ * arrived in time (EAGAIN), -1 on other errors. */
+static int recv_msg_flags(zcm_socket_t *sock, zcm_msg_t *msg, int flags) {
+  if (sock->rx_pending) return take_batch_entry(sock, msg);
   zmq_msg_t zmsg;
   zmq_msg_init(&zmsg);
-  int rc = zmq_msg_recv(&zmsg, sock->sock, 0);
+  int rc = zmq_msg_recv(&zmsg, sock->sock, flags);
   if (rc < 0) {
+    int again = (zmq_errno() == EAGAIN);
     zmq_msg_close(&zmsg);
-    return -1;
+    return again ? -2 : -1;
+  }
+  if (zmq_msg_more(&zmsg)) {
+    rc = recv_ref_frames(sock, &zmsg, msg);
+    zmq_msg_close(&zmsg);
+    return rc;
+  }
+  if (adopt_batch_frame(sock, &zmsg)) {
+    return sock->rx_pending ? take_batch_entry(sock, msg) : -1;
   }
   rc = zcm_msg_from_bytes(msg, zmq_msg_data(&zmsg), zmq_msg_size(&zmsg));
   zmq_msg_close(&zmsg);
-  return rc;
+  return (rc == 0) ? 0 : -1;
+}
+
+int zcm_socket_recv_msg(zcm_socket_t *sock, zcm_msg_t *msg) {
+  if (!sock || !sock->sock || !msg) return -1;
+  return (recv_msg_flags(sock, msg, 0) == 0) ? 0 : -1;
+}
+
+/* Wait up to `timeout_ms` for the socket to become readable; 1 when it is,
+ * 0 on timeout, -1 on error. A negative timeout defers to the blocking
+ * receive (and the socket's receive timeout). */
+static int wait_readable(zcm_socket_t *sock, int timeout_ms) {
+  if (timeout_ms < 0 || sock->rx_pending) return 1;
+  zmq_pollitem_t item = {sock->sock, 0, ZMQ_POLLIN, 0};
+  int rc = zmq_poll(&item, 1, timeout_ms);
+  if (rc < 0) return -1;
+  return (item.revents & ZMQ_POLLIN) ? 1 : 0;
+}
+
+int zcm_socket_recv_many(zcm_socket_t *sock, zcm_msg_t **msgs, size_t max, int timeout_ms) {
+  if (!sock || !sock->sock || !msgs || max == 0 || max > INT_MAX) return -1;
+  int rc = wait_readable(sock, timeout_ms);
+  if (rc <= 0) return rc;
+  size_t n = 0;
+  while (n < max) {
+    if (!msgs[n]) return n ? (int)n : -1;
+    rc = recv_msg_flags(sock, msgs[n], (n == 0 && timeout_ms < 0) ? 0 : ZMQ_DONTWAIT);
+    if (rc != 0) break;
+    n++;
+  }
+  if (n == 0) return (rc == -2) ? 0 : -1;
+  return (int)n;
+}
+
+int zcm_socket_recv_many_bytes(zcm_socket_t *sock, void *bufs, size_t slot_len, size_t *lens,
+                               size_t max, int timeout_ms) {
+  if (!sock || !sock->sock || !bufs || slot_len == 0 || !lens || max == 0 || max > INT_MAX)
+    return -1;
+  int rc = wait_readable(sock, timeout_ms);
+  if (rc <= 0) return rc;
+  size_t n = 0;
+  while (n < max) {
+    int flags = (n == 0 && timeout_ms < 0) ? 0 : ZMQ_DONTWAIT;
+    int got = zmq_recv(sock->sock, (uint8_t *)bufs + n * slot_len, slot_len, flags);
+    if (got < 0) {
+      if (n == 0) return (zmq_errno() == EAGAIN) ? 0 : -1;
+      break;
+    }
+    /* zmq_recv() reports the untruncated size. */
+    lens[n++] = ((size_t)got > slot_len) ? slot_len : (size_t)got;
+  }
+  return (int)n;
+}
+
+int zcm_socket_recv_batch(zcm_socket_t *sock, zcm_msg_t **msgs, size_t max, size_t *out_count) {
+  if (out_count) *out_count = 0;
+  if (!sock || !sock->sock || !msgs || max == 0) return -1;
+  if (zcm_socket_recv_msg(sock, msgs[0]) != 0) return -1;
+  size_t n = 1;
+  while (n < max && sock->rx_pending) {
+    if (take_batch_entry(sock, msgs[n]) != 0) break;
+    n++;
+  }
+  if (out_count) *out_count = n;
+  return 0;
+}
+
+static void release_zmq_frame(void *ctx) {
+  zmq_msg_t *zmsg = (zmq_msg_t *)ctx;
+  zmq_msg_close(zmsg);
+  free(zmsg);
+}
+
+static void release_zmq_frame_inline(void *ctx) {
+  zmq_msg_close((zmq_msg_t *)ctx);
+}
+
+int zcm_socket_recv_msg_view(zcm_socket_t *sock, zcm_msg_t *msg) {
+  if (!sock || !sock->sock || !msg) return -1;
+  zcm_msg_reset(msg);
+  if (sock->rx_pending) return take_batch_entry(sock, msg);
+  void (*release)(void *) = release_zmq_frame_inline;
+  zmq_msg_t *zmsg = (zmq_msg_t *)zcm_msg__transport_slot(msg, sizeof(zmq_msg_t));
+  if (!zmsg) {
+    zmsg = (zmq_msg_t *)malloc(sizeof(*zmsg));
+    if (!zmsg) return -1;
+    release = release_zmq_frame;
+  }
+  zmq_msg_init(zmsg);
+  int rc = zmq_msg_recv(zmsg, sock->sock, 0);
+  if (rc >= 0 && zmq_msg_more(zmsg)) {
+    rc = recv_ref_frames(sock, zmsg, msg);
+    release(zmsg);
+    return rc;
+  }
+  if (rc >= 0) {
+    if (adopt_batch_frame(sock, zmsg)) {
+      if (release == release_zmq_frame) free(zmsg);
+      return sock->rx_pending ? take_batch_entry(sock, msg) : -1;
+    }
+    rc = zcm_msg__from_borrowed(msg, zmq_msg_data(zmsg), zmq_msg_size(zmsg),
+                                release, zmsg);
+    if (rc == 0) return 0;
+  }
+  release(zmsg);
+  return -1;
 }
 
 int zcm_socket_send_bytes(zcm_socket_t *sock, const void *data, size_t len) {
@@ -500,13 +1738,142 @@ int zcm_socket_recv_bytes(zcm_socket_t *sock, void *buf, size_t buf_len, size_t
   if (!sock || !sock->sock || !buf || buf_len == 0) return -1;
   int n = zmq_recv(sock->sock, buf, buf_len, 0);
   if (n < 0) return -1;
-  if (out_len) *out_len = (size_t)n;
+  /* zmq_recv() reports the untruncated size. */
+  if (out_len) *out_len = ((size_t)n > buf_len) ? buf_len : (size_t)n;
+  return ((size_t)n > buf_len) ? 1 : 0;
+}
+
+int zcm_socket_send_frames(zcm_socket_t *sock, const zcm_iov_t *frames, size_t count, int flags) {
+  if (!sock || !sock->sock || !frames || count == 0) return -1;
+  /* Check every frame before the first goes out: a failure after a frame was
+   * sent with ZMQ_SNDMORE would leave the message open for the next send. */
+  int rc = 0;
+  for (size_t i = 0; i < count; i++) {
+    if (!frames[i].data && frames[i].len) rc = -1;
+  }
+  if (rc == 0) rc = flush_batch(sock, 0);
+  for (size_t i = 0; i < count; i++) {
+    const zcm_iov_t *f = &frames[i];
+    int more = (i + 1 < count || (flags & ZCM_FRAME_MORE)) ? ZMQ_SNDMORE : 0;
+    if (f->release) {
+      /* Ownership passed to us: hand it on, or release it ourselves. */
+      if (rc != 0) {
+        f->release((void *)f->data, f->hint);
+        continue;
+      }
+      zmq_msg_t part;
+      if (zmq_msg_init_data(&part, (void *)f->data, f->len, f->release, f->hint) != 0) {
+        f->release((void *)f->data, f->hint);
+        rc = -1;
+        continue;
+      }
+      if (zmq_msg_send(&part, sock->sock, more) < 0) {
+        zmq_msg_close(&part);
+        rc = -1;
+      }
+    } else if (rc == 0) {
+      if (zmq_send(sock->sock, f->data, f->len, more) < 0) rc = -1;
+    }
+  }
+  return rc;
+}
+
+int zcm_socket_recv_frame(zcm_socket_t *sock, zcm_frame_t *frame) {
+  if (!sock || !sock->sock || !frame) return -1;
+  zmq_msg_t *zmsg = (zmq_msg_t *)frame->impl;
+  if (zmsg) {
+    zmq_msg_close(zmsg);
+  } else {
+    zmsg = (zmq_msg_t *)malloc(sizeof(*zmsg));
+    if (!zmsg) return -1;
+    frame->impl = zmsg;
+  }
+  frame->data = NULL;
+  frame->size = 0;
+  frame->more = 0;
+  zmq_msg_init(zmsg);
+  if (zmq_msg_recv(zmsg, sock->sock, 0) < 0) return -1;
+  frame->data = zmq_msg_data(zmsg);
+  frame->size = zmq_msg_size(zmsg);
+  frame->more = zmq_msg_more(zmsg);
   return 0;
 }
 
+void zcm_frame_release(zcm_frame_t *frame) {
+  if (!frame) return;
+  if (frame->impl) {
+    zmq_msg_close((zmq_msg_t *)frame->impl);
+    free(frame->impl);
+  }
+  frame->data = NULL;
+  frame->size = 0;
+  frame->more = 0;
+  frame->impl = NULL;
+}
+
 int zcm_socket_set_timeouts(zcm_socket_t *sock, int ms) {
   if (!sock || !sock->sock) return -1;
   if (zmq_setsockopt(sock->sock, ZMQ_RCVTIMEO, &ms, sizeof(ms)) != 0) return -1;
   if (zmq_setsockopt(sock->sock, ZMQ_SNDTIMEO, &ms, sizeof(ms)) != 0) return -1;
   return 0;
 }
+
+/* How a zcm_socket_option_t maps onto ØMQ: option, value width and range. */
+typedef struct sockopt_spec {
+  int zmq_opt;
+  int width; /* 4 = int, 8 = int64_t/uint64_t */
+  int64_t min;
+  int64_t max;
+} sockopt_spec_t;
+
+static const sockopt_spec_t *sockopt_lookup(zcm_socket_option_t opt) {
+  static const sockopt_spec_t specs[] = {
+      [ZCM_SOCKOPT_SNDHWM] = {ZMQ_SNDHWM, 4, 0, INT_MAX},
+      [ZCM_SOCKOPT_RCVHWM] = {ZMQ_RCVHWM, 4, 0, INT_MAX},
+      [ZCM_SOCKOPT_SNDBUF] = {ZMQ_SNDBUF, 4, -1, INT_MAX},
+      [ZCM_SOCKOPT_RCVBUF] = {ZMQ_RCVBUF, 4, -1, INT_MAX},
+      [ZCM_SOCKOPT_CONFLATE] = {ZMQ_CONFLATE, 4, 0, 1},
+      [ZCM_SOCKOPT_AFFINITY] = {ZMQ_AFFINITY, 8, 0, INT64_MAX},
+      [ZCM_SOCKOPT_TCP_KEEPALIVE] = {ZMQ_TCP_KEEPALIVE, 4, -1, 1},
+      [ZCM_SOCKOPT_MAXMSGSIZE] = {ZMQ_MAXMSGSIZE, 8, -1, INT64_MAX},
+  };
+  if ((int)opt <= 0 || (size_t)opt >= sizeof(specs) / sizeof(specs[0])) return NULL;
+  return &specs[opt];
+}
+
+int zcm_socket_set_option(zcm_socket_t *sock, zcm_socket_option_t opt, int64_t value) {
+  if (!sock || !sock->sock) return -1;
+  const sockopt_spec_t *spec = sockopt_lookup(opt);
+  if (!spec || value < spec->min || value > spec->max) return -1;
+  if (opt == ZCM_SOCKOPT_CONFLATE && sock->type != ZCM_SOCK_PUB && sock->type != ZCM_SOCK_SUB &&
+      sock->type != ZCM_SOCK_PUSH && sock->type != ZCM_SOCK_PULL) {
+    return -1;
+  }
+  int rc;
+  if (spec->width == 4) {
+    int v = (int)value;
+    rc = zmq_setsockopt(sock->sock, spec->zmq_opt, &v, sizeof(v));
+  } else {
+    /* ZMQ_AFFINITY is unsigned; the checked range is the same either way. */
+    rc = zmq_setsockopt(sock->sock, spec->zmq_opt, &value, sizeof(value));
+  }
+  return (rc == 0) ? 0 : -1;
+}
+
+int zcm_socket_get_option(zcm_socket_t *sock, zcm_socket_option_t opt, int64_t *out_value) {
+  if (!sock || !sock->sock || !out_value) return -1;
+  const sockopt_spec_t *spec = sockopt_lookup(opt);
+  if (!spec) return -1;
+  if (spec->width == 4) {
+    int v = 0;
+    size_t len = sizeof(v);
+    if (zmq_getsockopt(sock->sock, spec->zmq_opt, &v, &len) != 0) return -1;
+    *out_value = v;
+  } else {
+    int64_t v = 0;
+    size_t len = sizeof(v);
+    if (zmq_getsockopt(sock->sock, spec->zmq_opt, &v, &len) != 0) return -1;
+    *out_value = v;
+  }
+  return 0;
+}
@@ -0,0 +1,367 @@
+#include "zcm/zcm_poller.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <zmq.h>
+
+/* from zcm_node.c */
+void *zcm_socket__zmq(const zcm_socket_t *sock);
+int zcm_socket__rx_pending(const zcm_socket_t *sock);
+
+/*
+ * Timers hang off a hashed wheel of WHEEL_SLOTS one-millisecond slots: a
+ * timer sits in slot `due % WHEEL_SLOTS` and is checked once per rotation
+ * until it is due, so expiry work per tick only depends on that slot.
+ * `wheel_ms` is the first tick not processed yet; timers armed in the past
+ * go into its slot.
+ */
+#define WHEEL_SLOTS 1024u
+
+typedef struct poller_timer {
+  int id;
+  uint64_t due_ms;
+  int interval_ms;
+  zcm_poller_timer_fn fn;
+  void *user;
+  unsigned slot;
+  int in_wheel;
+  int cancelled;
+  struct poller_timer *prev;
+  struct poller_timer *next;
+} poller_timer_t;
+
+typedef struct poller_entry {
+  zcm_socket_t *sock;
+  int fd;
+  int events;
+  void *user;
+} poller_entry_t;
+
+struct zcm_poller {
+  /* entries[i] and items[i] describe the same socket or descriptor. */
+  poller_entry_t *entries;
+  zmq_pollitem_t *items;
+  size_t count;
+  size_t cap;
+  size_t rotate; /* first entry reported by the next wait */
+  poller_timer_t *wheel[WHEEL_SLOTS];
+  uint64_t wheel_ms;
+  /* Every live timer, for lookup by id. */
+  poller_timer_t **timers;
+  size_t timer_count;
+  size_t timer_cap;
+  int next_timer_id;
+};
+
+static uint64_t monotonic_ms(void) {
+  struct timespec ts;
+  if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) return 0;
+  return ((uint64_t)ts.tv_sec * 1000ULL) + ((uint64_t)ts.tv_nsec / 1000000ULL);
+}
+
+zcm_poller_t *zcm_poller_new(void) {
+  zcm_poller_t *p = (zcm_poller_t *)calloc(1, sizeof(zcm_poller_t));
+  if (!p) return NULL;
+  p->wheel_ms = monotonic_ms();
+  return p;
+}
+
+void zcm_poller_free(zcm_poller_t *poller) {
+  if (!poller) return;
+  for (size_t i = 0; i < poller->timer_count; i++) free(poller->timers[i]);
+  free(poller->timers);
+  free(poller->entries);
+  free(poller->items);
+  free(poller);
+}
+
+/* ---- entries ------------------------------------------------------------ */
+
+static short zmq_events(int events) {
+  short e = 0;
+  if (events & ZCM_POLL_IN) e |= ZMQ_POLLIN;
+  if (events & ZCM_POLL_OUT) e |= ZMQ_POLLOUT;
+  return e;
+}
+
+static int poller_find(const zcm_poller_t *p, const zcm_socket_t *sock, int fd) {
+  for (size_t i = 0; i < p->count; i++) {
+    if (sock ? p->entries[i].sock == sock : (!p->entries[i].sock && p->entries[i].fd == fd)) {
+      return (int)i;
+    }
+  }
+  return -1;
+}
+
+static int poller_put(zcm_poller_t *p, zcm_socket_t *sock, int fd, int events, void *user) {
+  if (!(events & (ZCM_POLL_IN | ZCM_POLL_OUT))) return -1;
+  int i = poller_find(p, sock, fd);
+  if (i < 0) {
+    if (p->count == p->cap) {
+      size_t cap = p->cap ? p->cap * 2 : 8;
+      poller_entry_t *entries = (poller_entry_t *)realloc(p->entries, cap * sizeof(*entries));
+      if (!entries) return -1;
+      p->entries = entries;
+      zmq_pollitem_t *items = (zmq_pollitem_t *)realloc(p->items, cap * sizeof(*items));
+      if (!items) return -1;
+      p->items = items;
+      p->cap = cap;
+    }
+    i = (int)p->count++;
+  }
+  p->entries[i].sock = sock;
+  p->entries[i].fd = sock ? -1 : fd;
+  p->entries[i].events = events;
+  p->entries[i].user = user;
+  p->items[i].socket = sock ? zcm_socket__zmq(sock) : NULL;
+  p->items[i].fd = sock ? 0 : fd;
+  p->items[i].events = zmq_events(events);
+  p->items[i].revents = 0;
+  return 0;
+}
+
+static int poller_drop(zcm_poller_t *p, int i) {
+  if (i < 0) return -1;
+  p->count--;
+  p->entries[i] = p->entries[p->count];
+  p->items[i] = p->items[p->count];
+  if (p->rotate >= p->count) p->rotate = 0;
+  return 0;
+}
+
+int zcm_poller_add(zcm_poller_t *poller, zcm_socket_t *sock, int events, void *user) {
+  if (!poller || !sock || !zcm_socket__zmq(sock)) return -1;
+  return poller_put(poller, sock, -1, events, user);
+}
+
+int zcm_poller_add_fd(zcm_poller_t *poller, int fd, int events, void *user) {
+  if (!poller || fd < 0) return -1;
+  return poller_put(poller, NULL, fd, events, user);
+}
+
+int zcm_poller_remove(zcm_poller_t *poller, zcm_socket_t *sock) {
+  if (!poller || !sock) return -1;
+  return poller_drop(poller, poller_find(poller, sock, -1));
+}
+
+int zcm_poller_remove_fd(zcm_poller_t *poller, int fd) {
+  if (!poller || fd < 0) return -1;
+  return poller_drop(poller, poller_find(poller, NULL, fd));
+}
+
+size_t zcm_poller_size(const zcm_poller_t *poller) {
+  return poller ? poller->count : 0;
+}
+
+/* ---- timers ------------------------------------------------------------- */
+
+static void wheel_insert(zcm_poller_t *p, poller_timer_t *t) {
+  uint64_t tick = (t->due_ms < p->wheel_ms) ? p->wheel_ms : t->due_ms;
+  t->slot = (unsigned)(tick % WHEEL_SLOTS);
+  poller_timer_t **slot = &p->wheel[t->slot];
+  t->prev = NULL;
+  t->next = *slot;
+  if (*slot) (*slot)->prev = t;
+  *slot = t;
+  t->in_wheel = 1;
+}
+
+static void wheel_unlink(zcm_poller_t *p, poller_timer_t *t) {
+  if (t->prev) {
+    t->prev->next = t->next;
+  } else {
+    p->wheel[t->slot] = t->next;
+  }
+  if (t->next) t->next->prev = t->prev;
+  t->prev = t->next = NULL;
+  t->in_wheel = 0;
+}
+
+static void timer_release(zcm_poller_t *p, poller_timer_t *t) {
+  for (size_t i = 0; i < p->timer_count; i++) {
+    if (p->timers[i] == t) {
+      p->timers[i] = p->timers[--p->timer_count];
+      break;
+    }
+  }
+  free(t);
+}
+
+int zcm_poller_add_timer(zcm_poller_t *poller, int delay_ms, int interval_ms,
+                         zcm_poller_timer_fn fn, void *user) {
+  if (!poller || !fn || delay_ms < 0 || interval_ms < 0) return -1;
+  if (poller->timer_count == poller->timer_cap) {
+    size_t cap = poller->timer_cap ? poller->timer_cap * 2 : 8;
+    poller_timer_t **timers =
+        (poller_timer_t **)realloc(poller->timers, cap * sizeof(*timers));
+    if (!timers) return -1;
+    poller->timers = timers;
+    poller->timer_cap = cap;
+  }
+  poller_timer_t *t = (poller_timer_t *)calloc(1, sizeof(*t));
+  if (!t) return -1;
+  if (poller->next_timer_id <= 0) poller->next_timer_id = 1;
+  t->id = poller->next_timer_id++;
+  t->due_ms = monotonic_ms() + (uint64_t)delay_ms;
+  t->interval_ms = interval_ms;
+  t->fn = fn;
+  t->user = user;
+  poller->timers[poller->timer_count++] = t;
+  wheel_insert(poller, t);
+  return t->id;
+}
+
+int zcm_poller_cancel_timer(zcm_poller_t *poller, int timer_id) {
+  if (!poller || timer_id <= 0) return -1;
+  for (size_t i = 0; i < poller->timer_count; i++) {
+    poller_timer_t *t = poller->timers[i];
+    if (t->id != timer_id || t->cancelled) continue;
+    if (t->in_wheel) {
+      wheel_unlink(poller, t);
+      timer_release(poller, t);
+    } else {
+      /* Firing or queued to fire: released by poller_run_timers(). */
+      t->cancelled = 1;
+    }
+    return 0;
+  }
+  return -1;
+}
+
+/* Fire every timer due at `now`; returns how many callbacks ran. */
+static int poller_run_timers(zcm_poller_t *p, uint64_t now) {
+  if (now < p->wheel_ms) return 0;
+  if (p->timer_count == 0) {
+    p->wheel_ms = now + 1;
+    return 0;
+  }
+  uint64_t ticks = now - p->wheel_ms + 1;
+  if (ticks > WHEEL_SLOTS) ticks = WHEEL_SLOTS;
+  poller_timer_t *due = NULL;
+  poller_timer_t **due_tail = &due;
+  for (uint64_t k = 0; k < ticks; k++) {
+    poller_timer_t *t = p->wheel[(p->wheel_ms + k) % WHEEL_SLOTS];
+    while (t) {
+      poller_timer_t *next = t->next;
+      if (t->due_ms <= now) {
+        wheel_unlink(p, t);
+        *due_tail = t;
+        due_tail = &t->next;
+      }
+      t = next;
+    }
+  }
+  p->wheel_ms = now + 1;
+
+  int fired = 0;
+  while (due) {
+    poller_timer_t *t = due;
+    due = t->next;
+    t->next = NULL;
+    if (!t->cancelled) {
+      t->fn(p, t->id, t->user);
+      fired++;
+    }
+    if (t->cancelled || t->interval_ms == 0) {
+      timer_release(p, t);
+      continue;
+    }
+    uint64_t period = (uint64_t)t->interval_ms;
+    t->due_ms += period;
+    if (t->due_ms <= now) t->due_ms += ((now - t->due_ms) / period + 1) * period;
+    wheel_insert(p, t);
+  }
+  return fired;
+}
+
+/* Milliseconds until the next timer expiry, capped at one rotation (the
+ * wait then rescans); -1 without timers. */
+static long poller_timer_wait_ms(const zcm_poller_t *p, uint64_t now) {
+  if (p->timer_count == 0) return -1;
+  for (uint64_t k = 0; k < WHEEL_SLOTS; k++) {
+    uint64_t tick = p->wheel_ms + k;
+    for (const poller_timer_t *t = p->wheel[tick % WHEEL_SLOTS]; t; t = t->next) {
+      if (t->due_ms <= tick) return (tick > now) ? (long)(tick - now) : 0;
+    }
+  }
+  return (long)WHEEL_SLOTS;
+}
+
+/* ---- waiting ------------------------------------------------------------ */
+
+static int entry_has_batch(const poller_entry_t *e) {
+  return e->sock && (e->events & ZCM_POLL_IN) && zcm_socket__rx_pending(e->sock);
+}
+
+/* Send the coalesced batches that are due on watched sockets; returns the
+ * milliseconds until the next one is, or -1 when none is pending. */
+static long poller_flush_batches(zcm_poller_t *p) {
+  long next = -1;
+  for (size_t i = 0; i < p->count; i++) {
+    zcm_socket_t *sock = p->entries[i].sock;
+    if (!sock) continue;
+    int ms = zcm_socket_flush_timeout_ms(sock);
+    if (ms == 0) {
+      (void)zcm_socket_flush(sock);
+    } else if (ms > 0 && (next < 0 || ms < next)) {
+      next = ms;
+    }
+  }
+  return next;
+}
+
+static int poller_collect(zcm_poller_t *p, zcm_poll_event_t *out, size_t max) {
+  size_t n = 0;
+  for (size_t k = 0; k < p->count; k++) {
+    size_t i = (p->rotate + k) % p->count;
+    if (n == max) {
+      /* Out of room: start the next report with the entries left out. */
+      p->rotate = i;
+      return (int)n;
+    }
+    short re = p->items[i].revents;
+    int ev = 0;
+    if (re & ZMQ_POLLIN) ev |= ZCM_POLL_IN;
+    if (re & ZMQ_POLLOUT) ev |= ZCM_POLL_OUT;
+    if (re & ZMQ_POLLERR) ev |= ZCM_POLL_ERR;
+    if (entry_has_batch(&p->entries[i])) ev |= ZCM_POLL_IN;
+    if (!ev) continue;
+    out[n].sock = p->entries[i].sock;
+    out[n].fd = p->entries[i].fd;
+    out[n].events = ev;
+    out[n].user = p->entries[i].user;
+    n++;
+  }
+  return (int)n;
+}
+
+int zcm_poller_wait(zcm_poller_t *poller, zcm_poll_event_t *events, size_t max, int timeout_ms) {
+  if (!poller || !events || max == 0) return -1;
+  uint64_t deadline = (timeout_ms < 0) ? UINT64_MAX : monotonic_ms() + (uint64_t)timeout_ms;
+  for (;;) {
+    uint64_t now = monotonic_ms();
+    int fired = poller_run_timers(poller, now);
+    long flush_ms = poller_flush_batches(poller);
+    int ready = 0;
+    for (size_t i = 0; i < poller->count && !ready; i++) {
+      ready = entry_has_batch(&poller->entries[i]);
+    }
+    long wait_ms = 0;
+    if (!fired && !ready && now < deadline) {
+      wait_ms = (deadline == UINT64_MAX) ? -1 : (long)(deadline - now);
+      long timer_ms = poller_timer_wait_ms(poller, now);
+      if (timer_ms >= 0 && (wait_ms < 0 || timer_ms < wait_ms)) wait_ms = timer_ms;
+      if (flush_ms >= 0 && (wait_ms < 0 || flush_ms < wait_ms)) wait_ms = flush_ms;
+    }
+    if (zmq_poll(poller->items, (int)poller->count, wait_ms) < 0) return -1;
+    int n = poller_collect(poller, events, max);
+    if (n > 0 || fired) return n;
+    if (monotonic_ms() >= deadline) {
+      (void)poller_run_timers(poller, monotonic_ms());
+      return 0;
+    }
+  }
+}
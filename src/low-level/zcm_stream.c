@@ -0,0 +1,464 @@
+#include "zcm/zcm_stream.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/*
+ * Wire protocol (all ordinary typed messages):
+ *   ZCM_STREAM_OPEN  long id, long seq = 0, long total (-1 = unknown),
+ *                    char elem_type, int chunk_size, int window, char flags,
+ *                    text name
+ *   ZCM_STREAM       long id, long seq, long offset, char flags,
+ *                    BYTES item or ARRAY item of elem_type
+ *   ZCM_STREAM_ACK   long id, long next_seq (every lower seq was consumed)
+ * Sequence numbers start at 0 with the header and increase by one per chunk.
+ */
+#define STREAM_TYPE_OPEN "ZCM_STREAM_OPEN"
+#define STREAM_TYPE_CHUNK "ZCM_STREAM"
+#define STREAM_TYPE_ACK "ZCM_STREAM_ACK"
+
+#define STREAM_FLAG_LAST 0x01u
+#define STREAM_FLAG_ACK 0x02u /* acknowledge once this message is consumed */
+
+#define STREAM_CHUNK_DEFAULT ((size_t)1 << 20)
+#define STREAM_CHUNK_MAX ((size_t)64 << 20)
+#define STREAM_WINDOW_DEFAULT 8u
+
+/* from zcm_node.c */
+zcm_socket_type_t zcm_socket__type(const zcm_socket_t *sock);
+
+struct zcm_stream_writer {
+  zcm_socket_t *data;
+  zcm_socket_t *ack;
+  int lockstep; /* REQ: batches of `window` messages, one reply each */
+  zcm_stream_info_t info;
+  size_t elem_size;
+  uint8_t *chunk;
+  size_t fill;
+  uint64_t offset; /* stream bytes already handed to earlier chunks */
+  uint64_t seq;    /* next sequence number */
+  uint64_t acked;  /* every sequence number below was acknowledged */
+  uint32_t ack_every;
+  /* REQ batch under construction; PUSH reuses pending[0]. */
+  zcm_msg_t **pending;
+  size_t pending_count;
+  zcm_msg_t *rx;
+  int header_sent;
+  int finished;
+  int failed;
+};
+
+struct zcm_stream_reader {
+  zcm_socket_t *data;
+  zcm_socket_t *ack;
+  int lockstep; /* REP: acknowledgements are the replies */
+  zcm_msg_t *msg;
+  zcm_msg_t *reply;
+  zcm_stream_info_t info;
+  int have_info;
+  uint64_t next_seq;
+  uint64_t next_offset; /* stream bytes received so far */
+  int ack_pending;
+  int last_seen;
+  int done;
+};
+
+static uint64_t new_stream_id(const void *salt) {
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  uint64_t id = ((uint64_t)ts.tv_sec << 30) ^ (uint64_t)ts.tv_nsec;
+  id ^= (uint64_t)getpid() << 40;
+  id ^= (uint64_t)(uintptr_t)salt;
+  return id;
+}
+
+zcm_stream_writer_t *zcm_stream_writer_new(zcm_socket_t *data, zcm_socket_t *ack,
+                                           const char *name,
+                                           zcm_msg_array_type_t elem_type,
+                                           uint64_t total,
+                                           const zcm_stream_opts_t *opts) {
+  if (!data) return NULL;
+  zcm_socket_type_t st = zcm_socket__type(data);
+  if (st == ZCM_SOCK_REQ) {
+    if (ack) return NULL;
+  } else if (st == ZCM_SOCK_PUSH) {
+    if (ack && zcm_socket__type(ack) != ZCM_SOCK_PULL) return NULL;
+  } else {
+    return NULL;
+  }
+  size_t elem_size = 1;
+  if (elem_type != 0) {
+    elem_size = zcm_msg_array_elem_size(elem_type);
+    if (elem_size == 0) return NULL;
+  }
+
+  size_t chunk_size = (opts && opts->chunk_size) ? opts->chunk_size : STREAM_CHUNK_DEFAULT;
+  if (chunk_size > STREAM_CHUNK_MAX) chunk_size = STREAM_CHUNK_MAX;
+  chunk_size -= chunk_size % elem_size;
+  if (chunk_size == 0) return NULL;
+  uint32_t window = (opts && opts->window) ? opts->window : STREAM_WINDOW_DEFAULT;
+
+  zcm_stream_writer_t *w = (zcm_stream_writer_t *)calloc(1, sizeof(*w));
+  if (!w) return NULL;
+  w->data = data;
+  w->ack = ack;
+  w->lockstep = (st == ZCM_SOCK_REQ);
+  w->elem_size = elem_size;
+  w->info.id = new_stream_id(w);
+  w->info.total = total;
+  w->info.elem_type = elem_type;
+  w->info.chunk_size = (uint32_t)chunk_size;
+  w->info.window = window;
+  if (name) snprintf(w->info.name, sizeof(w->info.name), "%s", name);
+  w->ack_every = (window > 1) ? window / 2 : 1;
+
+  size_t slots = w->lockstep ? window : 1;
+  w->chunk = (uint8_t *)malloc(chunk_size);
+  w->pending = (zcm_msg_t **)calloc(slots, sizeof(*w->pending));
+  w->rx = zcm_msg_new();
+  if (!w->chunk || !w->pending || !w->rx) {
+    zcm_stream_writer_free(w);
+    return NULL;
+  }
+  for (size_t i = 0; i < slots; i++) {
+    w->pending[i] = zcm_msg_new();
+    if (!w->pending[i]) {
+      zcm_stream_writer_free(w);
+      return NULL;
+    }
+  }
+  return w;
+}
+
+void zcm_stream_writer_free(zcm_stream_writer_t *w) {
+  if (!w) return;
+  size_t slots = w->lockstep ? w->info.window : 1;
+  if (w->pending) {
+    for (size_t i = 0; i < slots; i++) zcm_msg_free(w->pending[i]);
+  }
+  free(w->pending);
+  zcm_msg_free(w->rx);
+  free(w->chunk);
+  free(w);
+}
+
+/* Receive one acknowledgement and advance `acked`. */
+static int writer_wait_ack(zcm_stream_writer_t *w) {
+  zcm_socket_t *sock = w->lockstep ? w->data : w->ack;
+  if (zcm_socket_recv_msg(sock, w->rx) != 0) return -1;
+  int64_t id = 0;
+  int64_t next = 0;
+  if (strcmp(zcm_msg_get_type(w->rx), STREAM_TYPE_ACK) != 0) return -1;
+  if (zcm_msg_get_long(w->rx, &id) != 0 || (uint64_t)id != w->info.id) return -1;
+  if (zcm_msg_get_long(w->rx, &next) != 0) return -1;
+  if ((uint64_t)next > w->seq) return -1;
+  if ((uint64_t)next > w->acked) w->acked = (uint64_t)next;
+  return 0;
+}
+
+/* Whether the message with the next sequence number asks for an ack. */
+static int writer_wants_ack(const zcm_stream_writer_t *w, int last) {
+  if (w->lockstep) return last || w->pending_count + 1 == w->info.window;
+  if (!w->ack) return 0;
+  return last || (w->seq + 1) % w->ack_every == 0;
+}
+
+/* Slot to build the next message in. */
+static zcm_msg_t *writer_slot(zcm_stream_writer_t *w) {
+  zcm_msg_t *m = w->pending[w->lockstep ? w->pending_count : 0];
+  zcm_msg_reset(m);
+  return m;
+}
+
+/* Hand the message built in writer_slot() to the transport. */
+static int writer_emit(zcm_stream_writer_t *w, int want_ack) {
+  if (w->lockstep) {
+    w->pending_count++;
+    w->seq++;
+    if (!want_ack) return 0;
+    int rc = zcm_socket_send_batch(w->data, (const zcm_msg_t *const *)w->pending,
+                                   w->pending_count);
+    w->pending_count = 0;
+    if (rc != 0 || writer_wait_ack(w) != 0) return -1;
+    return (w->acked == w->seq) ? 0 : -1;
+  }
+  while (w->ack && w->seq - w->acked >= w->info.window) {
+    if (writer_wait_ack(w) != 0) return -1;
+  }
+  if (zcm_socket_send_msg(w->data, w->pending[0]) != 0) return -1;
+  w->seq++;
+  return 0;
+}
+
+static int writer_send_header(zcm_stream_writer_t *w) {
+  int want_ack = writer_wants_ack(w, 0);
+  zcm_msg_t *m = writer_slot(w);
+  int64_t total = (w->info.total == ZCM_STREAM_SIZE_UNKNOWN) ? -1 : (int64_t)w->info.total;
+  zcm_msg_set_type(m, STREAM_TYPE_OPEN);
+  if (zcm_msg_put_long(m, (int64_t)w->info.id) != 0 ||
+      zcm_msg_put_long(m, 0) != 0 ||
+      zcm_msg_put_long(m, total) != 0 ||
+      zcm_msg_put_char(m, (char)w->info.elem_type) != 0 ||
+      zcm_msg_put_int(m, (int32_t)w->info.chunk_size) != 0 ||
+      zcm_msg_put_int(m, (int32_t)w->info.window) != 0 ||
+      zcm_msg_put_char(m, (char)(want_ack ? STREAM_FLAG_ACK : 0)) != 0 ||
+      zcm_msg_put_text(m, w->info.name) != 0) {
+    return -1;
+  }
+  w->header_sent = 1;
+  return writer_emit(w, want_ack);
+}
+
+static int writer_send_chunk(zcm_stream_writer_t *w, const void *data, size_t len, int last) {
+  if (!w->header_sent && writer_send_header(w) != 0) return -1;
+  int want_ack = writer_wants_ack(w, last);
+  uint8_t flags = (uint8_t)((last ? STREAM_FLAG_LAST : 0) | (want_ack ? STREAM_FLAG_ACK : 0));
+  zcm_msg_t *m = writer_slot(w);
+  zcm_msg_set_type(m, STREAM_TYPE_CHUNK);
+  if (zcm_msg_put_long(m, (int64_t)w->info.id) != 0 ||
+      zcm_msg_put_long(m, (int64_t)w->seq) != 0 ||
+      zcm_msg_put_long(m, (int64_t)w->offset) != 0 ||
+      zcm_msg_put_char(m, (char)flags) != 0) {
+    return -1;
+  }
+  int rc = (w->info.elem_type == 0)
+               ? zcm_msg_put_bytes(m, data, (uint32_t)len)
+               : zcm_msg_put_array(m, w->info.elem_type, (uint32_t)(len / w->elem_size), data);
+  if (rc != 0) return -1;
+  w->offset += len;
+  return writer_emit(w, want_ack);
+}
+
+int zcm_stream_write(zcm_stream_writer_t *w, const void *data, size_t len) {
+  if (!w || (!data && len) || w->finished || w->failed) return -1;
+  if (len % w->elem_size != 0) return -1;
+  const uint8_t *p = (const uint8_t *)data;
+  size_t chunk_size = w->info.chunk_size;
+  while (len > 0) {
+    /* Whole chunks straight from the caller skip the staging copy. */
+    if (w->fill == 0 && len >= chunk_size) {
+      if (writer_send_chunk(w, p, chunk_size, 0) != 0) goto fail;
+      p += chunk_size;
+      len -= chunk_size;
+      continue;
+    }
+    size_t n = chunk_size - w->fill;
+    if (n > len) n = len;
+    memcpy(w->chunk + w->fill, p, n);
+    w->fill += n;
+    p += n;
+    len -= n;
+    if (w->fill == chunk_size) {
+      if (writer_send_chunk(w, w->chunk, w->fill, 0) != 0) goto fail;
+      w->fill = 0;
+    }
+  }
+  return 0;
+
+fail:
+  w->failed = 1;
+  return -1;
+}
+
+int zcm_stream_writer_finish(zcm_stream_writer_t *w) {
+  if (!w || w->finished || w->failed) return -1;
+  if (w->info.total != ZCM_STREAM_SIZE_UNKNOWN && w->offset + w->fill != w->info.total) {
+    return -1;
+  }
+  w->finished = 1;
+  if (writer_send_chunk(w, w->chunk, w->fill, 1) != 0) {
+    w->failed = 1;
+    return -1;
+  }
+  w->fill = 0;
+  while (!w->lockstep && w->ack && w->acked < w->seq) {
+    if (writer_wait_ack(w) != 0) {
+      w->failed = 1;
+      return -1;
+    }
+  }
+  return 0;
+}
+
+zcm_stream_reader_t *zcm_stream_reader_new(zcm_socket_t *data, zcm_socket_t *ack) {
+  if (!data) return NULL;
+  zcm_socket_type_t st = zcm_socket__type(data);
+  if (st == ZCM_SOCK_REP) {
+    if (ack) return NULL;
+  } else if (st == ZCM_SOCK_PULL) {
+    if (ack && zcm_socket__type(ack) != ZCM_SOCK_PUSH) return NULL;
+  } else {
+    return NULL;
+  }
+  zcm_stream_reader_t *r = (zcm_stream_reader_t *)calloc(1, sizeof(*r));
+  if (!r) return NULL;
+  r->data = data;
+  r->ack = ack;
+  r->lockstep = (st == ZCM_SOCK_REP);
+  r->msg = zcm_msg_new();
+  r->reply = zcm_msg_new();
+  if (!r->msg || !r->reply) {
+    zcm_stream_reader_free(r);
+    return NULL;
+  }
+  return r;
+}
+
+void zcm_stream_reader_free(zcm_stream_reader_t *r) {
+  if (!r) return;
+  zcm_msg_free(r->msg);
+  zcm_msg_free(r->reply);
+  free(r);
+}
+
+const zcm_stream_info_t *zcm_stream_reader_info(const zcm_stream_reader_t *r) {
+  if (!r || !r->have_info) return NULL;
+  return &r->info;
+}
+
+static int reader_send_ack(zcm_stream_reader_t *r) {
+  zcm_socket_t *sock = r->lockstep ? r->data : r->ack;
+  if (!sock) return 0;
+  zcm_msg_reset(r->reply);
+  zcm_msg_set_type(r->reply, STREAM_TYPE_ACK);
+  if (zcm_msg_put_long(r->reply, (int64_t)r->info.id) != 0 ||
+      zcm_msg_put_long(r->reply, (int64_t)r->next_seq) != 0) {
+    return -1;
+  }
+  return zcm_socket_send_msg(sock, r->reply);
+}
+
+static int reader_take_header(zcm_stream_reader_t *r) {
+  int64_t id = 0, seq = 0, total = 0;
+  char elem_type = 0, flags = 0;
+  int32_t chunk_size = 0, window = 0;
+  const char *name = NULL;
+  uint32_t name_len = 0;
+  if (r->have_info) return -1;
+  if (zcm_msg_get_long(r->msg, &id) != 0 || zcm_msg_get_long(r->msg, &seq) != 0 ||
+      zcm_msg_get_long(r->msg, &total) != 0 || zcm_msg_get_char(r->msg, &elem_type) != 0 ||
+      zcm_msg_get_int(r->msg, &chunk_size) != 0 || zcm_msg_get_int(r->msg, &window) != 0 ||
+      zcm_msg_get_char(r->msg, &flags) != 0 ||
+      zcm_msg_get_text(r->msg, &name, &name_len) != 0) {
+    return -1;
+  }
+  if (seq != 0 || chunk_size <= 0 || window <= 0) return -1;
+  if (elem_type != 0 && zcm_msg_array_elem_size((zcm_msg_array_type_t)elem_type) == 0) return -1;
+  r->info.id = (uint64_t)id;
+  r->info.total = (total < 0) ? ZCM_STREAM_SIZE_UNKNOWN : (uint64_t)total;
+  r->info.elem_type = (zcm_msg_array_type_t)elem_type;
+  r->info.chunk_size = (uint32_t)chunk_size;
+  r->info.window = (uint32_t)window;
+  if (name_len >= sizeof(r->info.name)) name_len = sizeof(r->info.name) - 1;
+  memcpy(r->info.name, name, name_len);
+  r->info.name[name_len] = '\0';
+  r->have_info = 1;
+  r->next_seq = 1;
+  r->next_offset = 0;
+  /* Nothing for the caller to process: acknowledge right away. */
+  if (((uint8_t)flags & STREAM_FLAG_ACK) && reader_send_ack(r) != 0) return -1;
+  return 0;
+}
+
+static int reader_take_chunk(zcm_stream_reader_t *r, zcm_stream_chunk_t *chunk) {
+  int64_t id = 0, seq = 0, offset = 0;
+  char flags = 0;
+  if (!r->have_info) return -1;
+  if (zcm_msg_get_long(r->msg, &id) != 0 || (uint64_t)id != r->info.id) return -1;
+  if (zcm_msg_get_long(r->msg, &seq) != 0 || (uint64_t)seq != r->next_seq) return -1;
+  /* Chunks are contiguous: a peer cannot place data anywhere else. */
+  if (zcm_msg_get_long(r->msg, &offset) != 0 || (uint64_t)offset != r->next_offset) return -1;
+  if (zcm_msg_get_char(r->msg, &flags) != 0) return -1;
+
+  if (r->info.elem_type == 0) {
+    const void *data = NULL;
+    uint32_t len = 0;
+    if (zcm_msg_get_bytes(r->msg, &data, &len) != 0) return -1;
+    chunk->data = data;
+    chunk->len = len;
+  } else {
+    zcm_msg_array_type_t type = 0;
+    uint32_t elems = 0;
+    const void *data = NULL;
+    if (zcm_msg_get_array(r->msg, &type, &elems, &data) != 0) return -1;
+    if (type != r->info.elem_type) return -1;
+    chunk->data = data;
+    chunk->len = (size_t)elems * zcm_msg_array_elem_size(type);
+  }
+  chunk->last = ((uint8_t)flags & STREAM_FLAG_LAST) != 0;
+  if (r->info.total != ZCM_STREAM_SIZE_UNKNOWN) {
+    uint64_t left = r->info.total - r->next_offset;
+    if (chunk->len > left || (chunk->last && chunk->len != left)) return -1;
+  }
+  chunk->offset = r->next_offset;
+  r->next_offset += chunk->len;
+  r->next_seq++;
+  r->ack_pending = ((uint8_t)flags & STREAM_FLAG_ACK) != 0;
+  r->last_seen = chunk->last;
+  return 0;
+}
+
+int zcm_stream_read_chunk(zcm_stream_reader_t *r, zcm_stream_chunk_t *chunk) {
+  if (!r || !chunk || r->done < 0) return -1;
+  if (r->ack_pending) {
+    r->ack_pending = 0;
+    if (reader_send_ack(r) != 0) goto fail;
+  }
+  if (r->last_seen) r->done = 1;
+  if (r->done) return 0;
+
+  for (;;) {
+    if (zcm_socket_recv_msg_view(r->data, r->msg) != 0) goto fail;
+    const char *type = zcm_msg_get_type(r->msg);
+    if (strcmp(type, STREAM_TYPE_OPEN) == 0) {
+      if (reader_take_header(r) != 0) goto fail;
+      continue;
+    }
+    if (strcmp(type, STREAM_TYPE_CHUNK) != 0 || reader_take_chunk(r, chunk) != 0) goto fail;
+    return 1;
+  }
+
+fail:
+  r->done = -1;
+  return -1;
+}
+
+int zcm_stream_read(zcm_stream_reader_t *r, zcm_stream_sink_fn sink, void *user) {
+  if (!r || !sink) return -1;
+  zcm_stream_chunk_t chunk;
+  int rc = 0;
+  while ((rc = zcm_stream_read_chunk(r, &chunk)) == 1) {
+    if (chunk.len && sink(user, chunk.offset, chunk.data, chunk.len) != 0) return -1;
+  }
+  return rc;
+}
+
+static int file_sink(void *user, uint64_t offset, const void *data, size_t len) {
+  int fd = *(int *)user;
+  const uint8_t *p = (const uint8_t *)data;
+  while (len > 0) {
+    ssize_t n = pwrite(fd, p, len, (off_t)offset);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      return -1;
+    }
+    p += n;
+    len -= (size_t)n;
+    offset += (uint64_t)n;
+  }
+  return 0;
+}
+
+int zcm_stream_read_to_file(zcm_stream_reader_t *r, const char *path) {
+  if (!r || !path) return -1;
+  int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) return -1;
+  int rc = zcm_stream_read(r, file_sink, &fd);
+  if (close(fd) != 0) rc = -1;
+  return rc;
+}
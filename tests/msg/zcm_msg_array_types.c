@@ -0,0 +1,108 @@
+#include "zcm/zcm_msg.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+static int roundtrip_fixed(zcm_msg_t *m) {
+  const int64_t i64[3] = {INT64_MIN, -1, INT64_MAX};
+  const uint8_t u8[4] = {0, 1, 128, 255};
+  const uint16_t u16[2] = {1, 65535};
+  const uint32_t u32[2] = {7, 4000000000u};
+  const uint64_t u64[2] = {0, UINT64_MAX};
+
+  zcm_msg_reset(m);
+  if (zcm_msg_put_array(m, ZCM_MSG_ARRAY_INT64, 3, i64) != 0) return -1;
+  if (zcm_msg_put_array(m, ZCM_MSG_ARRAY_UINT8, 4, u8) != 0) return -1;
+  if (zcm_msg_put_array(m, ZCM_MSG_ARRAY_UINT16, 2, u16) != 0) return -1;
+  if (zcm_msg_put_array(m, ZCM_MSG_ARRAY_UINT32, 2, u32) != 0) return -1;
+  if (zcm_msg_put_array(m, ZCM_MSG_ARRAY_UINT64, 2, u64) != 0) return -1;
+  if (zcm_msg_validate(m) != 0) return -1;
+
+  zcm_msg_array_type_t t;
+  uint32_t n = 0;
+  const void *p = NULL;
+  if (zcm_msg_get_array(m, &t, &n, &p) != 0 || t != ZCM_MSG_ARRAY_INT64 || n != 3) return -1;
+  if (memcmp(p, i64, sizeof(i64)) != 0) return -1;
+  if (zcm_msg_get_array(m, &t, &n, &p) != 0 || t != ZCM_MSG_ARRAY_UINT8 || n != 4) return -1;
+  if (memcmp(p, u8, sizeof(u8)) != 0) return -1;
+  if (zcm_msg_get_array(m, &t, &n, &p) != 0 || t != ZCM_MSG_ARRAY_UINT16) return -1;
+  if (memcmp(p, u16, sizeof(u16)) != 0) return -1;
+  if (zcm_msg_get_array(m, &t, &n, &p) != 0 || t != ZCM_MSG_ARRAY_UINT32) return -1;
+  if (memcmp(p, u32, sizeof(u32)) != 0) return -1;
+  uint64_t back[2] = {1, 1};
+  if (zcm_msg_get_array_copy(m, &t, &n, back, sizeof(back)) != 0) return -1;
+  if (t != ZCM_MSG_ARRAY_UINT64 || memcmp(back, u64, sizeof(u64)) != 0) return -1;
+  return 0;
+}
+
+static int roundtrip_delta(zcm_msg_t *m) {
+  uint64_t stamps[100];
+  for (int i = 0; i < 100; i++) stamps[i] = 1700000000000ull + (uint64_t)i * 10u + (uint64_t)(i % 3);
+  const int32_t wavy[6] = {5, -3, INT32_MAX, INT32_MIN, 0, 1};
+  const uint64_t extremes[3] = {UINT64_MAX, 0, UINT64_MAX};
+
+  zcm_msg_reset(m);
+  if (zcm_msg_put_array_delta(m, ZCM_MSG_ARRAY_UINT64, 100, stamps) != 0) return -1;
+  size_t len = 0;
+  zcm_msg_data(m, &len);
+  /* First delta is large; the remaining 99 fit in one byte each. */
+  if (len > 1 + 1 + 4 + 4 + 7 + 99) return -1;
+  if (zcm_msg_put_array_delta(m, ZCM_MSG_ARRAY_INT, 6, wavy) != 0) return -1;
+  if (zcm_msg_put_array_delta(m, ZCM_MSG_ARRAY_UINT64, 3, extremes) != 0) return -1;
+  if (zcm_msg_put_array_delta(m, ZCM_MSG_ARRAY_SHORT, 0, NULL) != 0) return -1;
+  if (zcm_msg_put_array_delta(m, ZCM_MSG_ARRAY_DOUBLE, 0, NULL) != ZCM_MSG_ERR_TYPE) return -1;
+  if (zcm_msg_validate(m) != 0) return -1;
+
+  zcm_msg_array_type_t t;
+  uint32_t n = 0;
+  const void *p = NULL;
+  if (zcm_msg_get_array(m, &t, &n, &p) != 0 || t != ZCM_MSG_ARRAY_UINT64 || n != 100) return -1;
+  if (memcmp(p, stamps, sizeof(stamps)) != 0) return -1;
+  int32_t wback[6];
+  if (zcm_msg_get_array_copy(m, &t, &n, wback, sizeof(wback)) != 0) return -1;
+  if (t != ZCM_MSG_ARRAY_INT || n != 6 || memcmp(wback, wavy, sizeof(wavy)) != 0) return -1;
+  if (zcm_msg_get_array(m, &t, &n, &p) != 0 || memcmp(p, extremes, sizeof(extremes)) != 0)
+    return -1;
+  if (zcm_msg_get_array(m, &t, &n, &p) != 0 || t != ZCM_MSG_ARRAY_SHORT || n != 0) return -1;
+
+  printf("zcm_msg_array_types: random access decodes delta arrays\n");
+  if (zcm_msg_get_array_at(m, 1, &t, &n, &p) != 0 || ((const int32_t *)p)[2] != INT32_MAX)
+    return -1;
+  return 0;
+}
+
+static int reject_bad_varint(zcm_msg_t *m) {
+  /* Claims 3 elements but carries two terminated varints. */
+  static const uint8_t bad[] = {
+    0x31, 0x4D, 0x43, 0x5A, 0x01, 0x00, 0x00, 0x00, 0x0D, 0x00, 0x00, 0x00,
+    ZCM_MSG_ITEM_ARRAY, 0x80 | ZCM_MSG_ARRAY_UINT32, 0x03, 0x00, 0x00, 0x00,
+    0x03, 0x00, 0x00, 0x00, 0x02, 0x84, 0x01
+  };
+  if (zcm_msg_from_bytes(m, bad, sizeof(bad)) != 0) return -1;
+  if (zcm_msg_validate(m) != ZCM_MSG_ERR_FORMAT) return -1;
+  zcm_msg_array_type_t t;
+  uint32_t n = 0;
+  const void *p = NULL;
+  if (zcm_msg_get_array(m, &t, &n, &p) != ZCM_MSG_ERR_FORMAT) return -1;
+  if (zcm_msg_remaining(m) != 13) return -1;
+  return 0;
+}
+
+int main(void) {
+  zcm_msg_t *m = zcm_msg_new();
+  if (!m) return 1;
+
+  printf("zcm_msg_array_types: int64 and unsigned arrays\n");
+  if (roundtrip_fixed(m) != 0) return 1;
+
+  printf("zcm_msg_array_types: delta + zigzag varint arrays\n");
+  if (roundtrip_delta(m) != 0) return 1;
+
+  printf("zcm_msg_array_types: malformed varint stream is rejected\n");
+  if (reject_bad_varint(m) != 0) return 1;
+
+  zcm_msg_free(m);
+  printf("zcm_msg_array_types: PASS\n");
+  return 0;
+}
@@ -0,0 +1,91 @@
+#include "zcm/zcm_msg.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+int main(void) {
+  zcm_msg_t *m = zcm_msg_new();
+  if (!m) return 1;
+
+  printf("zcm_msg_index: build wide message\n");
+  zcm_msg_set_type(m, "Wide");
+  for (int32_t i = 0; i < 40; i++) {
+    if (zcm_msg_put_int(m, i * 10) != 0) return 1;
+  }
+  if (zcm_msg_put_text(m, "forty") != 0) return 1;
+  const float farr[3] = {1.0f, 2.0f, 3.0f};
+  if (zcm_msg_put_array(m, ZCM_MSG_ARRAY_FLOAT, 3, farr) != 0) return 1;
+  if (zcm_msg_put_double(m, 6.5) != 0) return 1;
+
+  printf("zcm_msg_index: item count\n");
+  uint32_t count = 0;
+  if (zcm_msg_item_count(m, &count) != 0 || count != 43) return 1;
+
+  printf("zcm_msg_index: random access keeps cursor\n");
+  int32_t v = 0;
+  if (zcm_msg_get_int(m, &v) != 0 || v != 0) return 1;
+  const char *t = NULL;
+  uint32_t tlen = 0;
+  if (zcm_msg_get_text_at(m, 40, &t, &tlen) != 0) return 1;
+  if (tlen != 5 || memcmp(t, "forty", 5) != 0) return 1;
+  if (zcm_msg_get_int_at(m, 17, &v) != 0 || v != 170) return 1;
+  double d = 0.0;
+  if (zcm_msg_get_double_at(m, 42, &d) != 0 || d != 6.5) return 1;
+  zcm_msg_array_type_t at;
+  uint32_t elems = 0;
+  const void *ap = NULL;
+  if (zcm_msg_get_array_at(m, 41, &at, &elems, &ap) != 0) return 1;
+  if (at != ZCM_MSG_ARRAY_FLOAT || elems != 3 || ((const float *)ap)[2] != 3.0f) return 1;
+  if (zcm_msg_get_int(m, &v) != 0 || v != 10) return 1;
+
+  printf("zcm_msg_index: type mismatch and range errors\n");
+  if (zcm_msg_get_double_at(m, 3, &d) != ZCM_MSG_ERR_TYPE) return 1;
+  if (zcm_msg_get_int_at(m, 43, &v) != ZCM_MSG_ERR_RANGE) return 1;
+
+  printf("zcm_msg_index: type mismatch leaves the cursor on the item\n");
+  if (zcm_msg_seek(m, 2) != 0) return 1;
+  if (zcm_msg_get_double(m, &d) != ZCM_MSG_ERR_TYPE) return 1;
+  if (zcm_msg_get_int(m, &v) != 0 || v != 20) return 1;
+
+  printf("zcm_msg_index: seek moves the sequential cursor\n");
+  if (zcm_msg_seek(m, 39) != 0) return 1;
+  if (zcm_msg_get_int(m, &v) != 0 || v != 390) return 1;
+  if (zcm_msg_seek(m, 43) != 0 || zcm_msg_remaining(m) != 0) return 1;
+  if (zcm_msg_seek(m, 44) != ZCM_MSG_ERR_RANGE) return 1;
+
+  printf("zcm_msg_index: index follows payload changes\n");
+  if (zcm_msg_put_char(m, 'z') != 0) return 1;
+  char c = 0;
+  if (zcm_msg_item_count(m, &count) != 0 || count != 44) return 1;
+  if (zcm_msg_get_char_at(m, 43, &c) != 0 || c != 'z') return 1;
+  zcm_msg_reset(m);
+  if (zcm_msg_item_count(m, &count) != 0 || count != 0) return 1;
+
+  printf("zcm_msg_index: validate_index builds the index\n");
+  zcm_msg_put_int(m, 5);
+  zcm_msg_put_text(m, "after");
+  if (zcm_msg_validate(m) != 0) return 1;
+  if (zcm_msg_validate_index(m) != 0) return 1;
+  if (zcm_msg_get_text_at(m, 1, &t, &tlen) != 0 || tlen != 5) return 1;
+  if (zcm_msg_get_int(m, &v) != 0 || v != 5) return 1;
+  if (zcm_msg_get_text(m, &t, &tlen) != 0 || memcmp(t, "after", 5) != 0) return 1;
+  if (zcm_msg_get_int(m, &v) == 0) return 1;
+  zcm_msg_reset(m);
+
+  printf("zcm_msg_index: malformed payload is rejected\n");
+  static const uint8_t bad[] = {
+    0x31, 0x4D, 0x43, 0x5A, 0x01, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00,
+    ZCM_MSG_ITEM_INT, 0x01, 0x02
+  };
+  if (zcm_msg_from_bytes(m, bad, sizeof(bad)) != 0) return 1;
+  if (zcm_msg_item_count(m, &count) != ZCM_MSG_ERR_RANGE) return 1;
+  if (zcm_msg_validate(m) != ZCM_MSG_ERR_RANGE) return 1;
+  if (zcm_msg_validate_index(m) != ZCM_MSG_ERR_RANGE) return 1;
+  int32_t partial = 0;
+  if (zcm_msg_get_int(m, &partial) != ZCM_MSG_ERR_RANGE) return 1;
+
+  zcm_msg_free(m);
+  printf("zcm_msg_index: PASS\n");
+  return 0;
+}
@@ -0,0 +1,146 @@
+#include "zcm/zcm.h"
+#include "zcm/zcm_msg.h"
+#include "zcm/zcm_node.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Linked with -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc (see CMakeLists.txt). */
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+static size_t g_allocs = 0;
+
+void *__wrap_malloc(size_t size) {
+  g_allocs++;
+  return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t n, size_t size) {
+  g_allocs++;
+  return __real_calloc(n, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+  g_allocs++;
+  return __real_realloc(ptr, size);
+}
+
+/* One request/reply cycle as served by zcm_proc: the client builds and sends
+ * a request from its pool, the server receives it as a borrowed view, replies
+ * from its pool, and the client receives the reply. */
+static int handle_once(zcm_msg_pool_t *pool, zcm_socket_t *req_sock, zcm_socket_t *rep_sock,
+                       const double *samples, uint32_t n) {
+  zcm_msg_t *req = zcm_msg_pool_acquire(pool);
+  if (!req) return -1;
+  zcm_msg_set_type(req, "QUERY");
+  if (zcm_msg_put_text(req, "status") != 0) return -1;
+  if (zcm_msg_put_array(req, ZCM_MSG_ARRAY_DOUBLE, n, samples) != 0) return -1;
+  if (zcm_socket_send_msg(req_sock, req) != 0) return -1;
+  zcm_msg_pool_release(pool, req);
+
+  zcm_msg_t *in = zcm_msg_pool_acquire(pool);
+  if (!in || zcm_socket_recv_msg_view(rep_sock, in) != 0) return -1;
+  const char *text = NULL;
+  uint32_t text_len = 0;
+  if (zcm_msg_get_text(in, &text, &text_len) != 0 || text_len != 6) return -1;
+  zcm_msg_t *reply = zcm_msg_pool_acquire(pool);
+  if (!reply) return -1;
+  zcm_msg_set_type(reply, "QUERY_RPL");
+  if (zcm_msg_put_text(reply, "OK") != 0) return -1;
+  if (zcm_msg_put_int(reply, 200) != 0) return -1;
+  if (zcm_socket_send_msg(rep_sock, reply) != 0) return -1;
+  zcm_msg_pool_release(pool, reply);
+  zcm_msg_pool_release(pool, in);
+
+  zcm_msg_t *answer = zcm_msg_pool_acquire(pool);
+  if (!answer || zcm_socket_recv_msg_view(req_sock, answer) != 0) return -1;
+  int32_t code = 0;
+  if (zcm_msg_get_text(answer, &text, &text_len) != 0 || text_len != 2) return -1;
+  if (zcm_msg_get_int(answer, &code) != 0 || code != 200) return -1;
+  zcm_msg_pool_release(pool, answer);
+  return 0;
+}
+
+int main(void) {
+  double samples[512];
+  for (size_t i = 0; i < 512; i++) samples[i] = (double)i * 0.5;
+
+  printf("zcm_msg_pool_alloc: connect inproc req/rep and warm up pool\n");
+  zcm_context_t *ctx = zcm_context_new();
+  if (!ctx) return 1;
+  zcm_socket_t *rep = zcm_socket_new(ctx, ZCM_SOCK_REP);
+  zcm_socket_t *req = zcm_socket_new(ctx, ZCM_SOCK_REQ);
+  if (!rep || !req) return 1;
+  if (zcm_socket_bind(rep, "inproc://zcm-pool-alloc") != 0) return 1;
+  if (zcm_socket_connect(req, "inproc://zcm-pool-alloc") != 0) return 1;
+  zcm_socket_set_timeouts(rep, 2000);
+  zcm_socket_set_timeouts(req, 2000);
+  zcm_msg_pool_t *pool = zcm_msg_pool_new(8, 0);
+  if (!pool) return 1;
+  for (int i = 0; i < 4; i++) {
+    if (handle_once(pool, req, rep, samples, 512) != 0) return 1;
+  }
+
+  /* libzmq is a shared library, so only allocations made by zCm are counted. */
+  printf("zcm_msg_pool_alloc: steady-state request/reply performs no allocations\n");
+  size_t before = g_allocs;
+  for (int i = 0; i < 1000; i++) {
+    if (handle_once(pool, req, rep, samples, 512) != 0) return 1;
+  }
+  if (g_allocs != before) {
+    fprintf(stderr, "zcm_msg_pool_alloc: %zu allocations in steady state\n",
+            g_allocs - before);
+    return 1;
+  }
+
+  printf("zcm_msg_pool_alloc: oversized buffers are trimmed on release\n");
+  zcm_msg_pool_t *small = zcm_msg_pool_new(2, 1024);
+  if (!small) return 1;
+  zcm_msg_t *big = zcm_msg_pool_acquire(small);
+  if (!big) return 1;
+  uint8_t blob[8192];
+  memset(blob, 0xAB, sizeof(blob));
+  if (zcm_msg_put_bytes(big, blob, (uint32_t)sizeof(blob)) != 0) return 1;
+  zcm_msg_pool_release(small, big);
+  zcm_msg_t *again = zcm_msg_pool_acquire(small);
+  if (again != big || zcm_msg_remaining(again) != 0) return 1;
+  /* Filling past the trimmed class has to grow the buffer again. */
+  before = g_allocs;
+  if (zcm_msg_put_bytes(again, blob, (uint32_t)sizeof(blob)) != 0) return 1;
+  if (g_allocs == before) return 1;
+  zcm_msg_pool_release(small, again);
+
+  printf("zcm_msg_pool_alloc: oversized item index is dropped on release\n");
+  zcm_msg_t *wide = zcm_msg_pool_acquire(small);
+  if (!wide) return 1;
+  for (int i = 0; i < 600; i++) {
+    if (zcm_msg_put_char(wide, 'x') != 0) return 1;
+  }
+  uint32_t items = 0;
+  if (zcm_msg_item_count(wide, &items) != 0 || items != 600) return 1;
+  zcm_msg_pool_release(small, wide);
+  zcm_msg_t *narrow = zcm_msg_pool_acquire(small);
+  if (narrow != wide) return 1;
+  if (zcm_msg_put_char(narrow, 'y') != 0) return 1;
+  /* The 2400-byte index was freed, so indexing has to allocate a fresh one. */
+  before = g_allocs;
+  if (zcm_msg_item_count(narrow, &items) != 0 || items != 1) return 1;
+  if (g_allocs == before) return 1;
+  zcm_msg_pool_release(small, narrow);
+
+  printf("zcm_msg_pool_alloc: per-thread pool is stable\n");
+  zcm_msg_pool_t *tp = zcm_msg_pool_thread();
+  if (!tp || tp != zcm_msg_pool_thread()) return 1;
+
+  zcm_msg_pool_free(small);
+  zcm_msg_pool_free(pool);
+  zcm_socket_free(req);
+  zcm_socket_free(rep);
+  zcm_context_free(ctx);
+  printf("zcm_msg_pool_alloc: PASS\n");
+  return 0;
+}
@@ -64,6 +64,37 @@ static int roundtrip(void) {
   const int32_t *arr2 = (const int32_t *)ap;
   if (arr2[0] != 7 || arr2[1] != 8 || arr2[2] != 9) return 1;
 
+  printf("zcm_msg_roundtrip: array decode is repeatable\n");
+  for (int pass = 0; pass < 2; pass++) {
+    zcm_msg_rewind(m2);
+    if (zcm_msg_get_char(m2, &c) != 0 || zcm_msg_get_short(m2, &s) != 0 ||
+        zcm_msg_get_int(m2, &i) != 0 || zcm_msg_get_long(m2, &l) != 0 ||
+        zcm_msg_get_float(m2, &f) != 0 || zcm_msg_get_double(m2, &d) != 0 ||
+        zcm_msg_get_text(m2, &t, &tlen) != 0 || zcm_msg_get_bytes(m2, &b, &blen) != 0) {
+      return 1;
+    }
+    int32_t copy[3] = {0};
+    if (zcm_msg_get_array_copy(m2, &at, &elems, copy, sizeof(copy)) != 0) return 1;
+    if (at != ZCM_MSG_ARRAY_INT || elems != 3) return 1;
+    if (copy[0] != 7 || copy[1] != 8 || copy[2] != 9) return 1;
+  }
+
+  printf("zcm_msg_roundtrip: array copy rejects short buffer\n");
+  {
+    zcm_msg_t *dm = zcm_msg_new();
+    if (!dm) return 1;
+    const double dv[5] = {0.5, -1.25, 2.0, 1e300, -0.0};
+    if (zcm_msg_put_array(dm, ZCM_MSG_ARRAY_DOUBLE, 5, dv) != 0) return 1;
+    double small[2];
+    if (zcm_msg_get_array_copy(dm, &at, &elems, small, sizeof(small)) != ZCM_MSG_ERR_RANGE) return 1;
+    if (elems != 5) return 1;
+    double full[5];
+    if (zcm_msg_get_array_copy(dm, &at, &elems, full, sizeof(full)) != 0) return 1;
+    if (memcmp(full, dv, sizeof(dv)) != 0) return 1;
+    if (zcm_msg_put_array(dm, (zcm_msg_array_type_t)99, 1, dv) != ZCM_MSG_ERR_TYPE) return 1;
+    zcm_msg_free(dm);
+  }
+
   free(owned);
   zcm_msg_free(m);
   zcm_msg_free(m2);
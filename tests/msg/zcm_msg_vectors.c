@@ -64,15 +64,101 @@ static int test_value_property(void) {
   if (zcm_msg_get_value(m2, &value) != 0) return 1;
   if (value.kind != ZCM_MSG_VALUE_INT || value.i != 42) return 1;
 
+  printf("zcm_msg_vectors: value triplet is the default encoding\n");
+  if (zcm_msg_value_compact() != 0) return 1;
+  size_t plen = 0;
+  const uint8_t *payload = (const uint8_t *)zcm_msg_data(m, &plen);
+  static const uint8_t k_int_triplet[] = {
+      ZCM_MSG_ITEM_TEXT, 13, 0, 0, 0, '_', '_', 'z', 'c', 'm', '_', 'v', 'a', 'l', 'u', 'e', '_', '_',
+      ZCM_MSG_ITEM_TEXT, 3, 0, 0, 0, 'i', 'n', 't',
+      ZCM_MSG_ITEM_INT, 42, 0, 0, 0};
+  if (plen != sizeof(k_int_triplet) || memcmp(payload, k_int_triplet, plen) != 0) return 1;
+
+  printf("zcm_msg_vectors: compact value item (opt-in)\n");
+  zcm_msg_set_value_compact(1);
+  if (zcm_msg_value_compact() != 1) return 1;
+  zcm_msg_reset(m);
+  if (zcm_msg_put_value_int(m, 42) != 0) return 1;
+  payload = (const uint8_t *)zcm_msg_data(m, &plen);
+  static const uint8_t k_int_value[] = {ZCM_MSG_ITEM_VALUE, ZCM_MSG_VALUE_INT, 42, 0, 0, 0};
+  if (plen != sizeof(k_int_value) || memcmp(payload, k_int_value, plen) != 0) return 1;
+
+  zcm_msg_reset(m);
+  if (zcm_msg_put_value_text(m, "ok") != 0) return 1;
+  if (zcm_msg_put_value_double(m, 2.5) != 0) return 1;
+  if (zcm_msg_validate(m) != 0) return 1;
+  if (zcm_msg_get_value(m, &value) != 0) return 1;
+  if (value.kind != ZCM_MSG_VALUE_TEXT || value.text_len != 2 || memcmp(value.text, "ok", 2) != 0)
+    return 1;
+  if (zcm_msg_get_value(m, &value) != 0 || value.kind != ZCM_MSG_VALUE_DOUBLE || value.d != 2.5)
+    return 1;
+
+  zcm_msg_set_value_compact(0);
+
+  printf("zcm_msg_vectors: legacy value triplet\n");
+  zcm_msg_reset(m);
+  zcm_msg_put_text(m, "__zcm_value__");
+  zcm_msg_put_text(m, "float");
+  zcm_msg_put_float(m, 0.25f);
+  if (zcm_msg_get_value(m, &value) != 0) return 1;
+  if (value.kind != ZCM_MSG_VALUE_FLOAT || value.f != 0.25f) return 1;
+
   free(owned);
   zcm_msg_free(m);
   zcm_msg_free(m2);
   return 0;
 }
 
+static int test_read_only_envelope(void) {
+  zcm_msg_t *m = zcm_msg_new();
+  if (!m) return 1;
+
+  printf("zcm_msg_vectors: read-only envelope\n");
+  zcm_msg_set_type(m, "ReadOnly");
+  if (zcm_msg_put_double(m, 1.5) != 0) return 1;
+
+  const void *data = NULL;
+  size_t len = 0;
+  void *owned = NULL;
+  extern int zcm_msg__serialize(const zcm_msg_t *, const void **, size_t *, void **);
+  size_t payload_len = 0;
+  const void *payload = zcm_msg_data(m, &payload_len);
+  uint8_t before[64];
+  if (!payload || payload_len > sizeof(before)) return 1;
+  memcpy(before, payload, payload_len);
+  if (zcm_msg__serialize(m, &data, &len, &owned) != 0 || owned != data) return 1;
+  if (len != 12 + strlen("ReadOnly") + payload_len) return 1;
+  if (memcmp((const uint8_t *)data + len - payload_len, before, payload_len) != 0) return 1;
+  free(owned);
+
+  /* The message is untouched, including the bytes in front of the payload. */
+  size_t after_len = 0;
+  if (zcm_msg_data(m, &after_len) != payload || after_len != payload_len) return 1;
+  if (memcmp(payload, before, payload_len) != 0) return 1;
+
+  /* Framing again after more writes must still yield a coherent envelope. */
+  if (zcm_msg_put_text(m, "tail") != 0) return 1;
+  if (zcm_msg__serialize(m, &data, &len, &owned) != 0) return 1;
+
+  zcm_msg_t *m2 = zcm_msg_new();
+  if (!m2) return 1;
+  if (zcm_msg_from_bytes(m2, data, len) != 0) return 1;
+  free(owned);
+  double d = 0.0;
+  const char *t = NULL;
+  uint32_t tlen = 0;
+  if (zcm_msg_get_double(m2, &d) != 0 || d != 1.5) return 1;
+  if (zcm_msg_get_text(m2, &t, &tlen) != 0 || tlen != 4) return 1;
+
+  zcm_msg_free(m);
+  zcm_msg_free(m2);
+  return 0;
+}
+
 int main(void) {
   int rc = test_vector_simple();
   if (rc == 0) rc = test_value_property();
+  if (rc == 0) rc = test_read_only_envelope();
   if (rc != 0) {
     fprintf(stderr, "zcm_msg_vectors failed\n");
   } else {
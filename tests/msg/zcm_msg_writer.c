@@ -0,0 +1,149 @@
+#include "zcm/zcm_msg.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static size_t payload_len(const zcm_msg_t *m) {
+  size_t len = 0;
+  (void)zcm_msg_data(m, &len);
+  return len;
+}
+
+int main(void) {
+  zcm_msg_t *a = zcm_msg_new();
+  zcm_msg_t *b = zcm_msg_new();
+  if (!a || !b) return 1;
+
+  const int32_t samples[5] = {1, -2, 300000, -400000, 5};
+  const uint8_t raw[3] = {0xDE, 0xAD, 0x00};
+
+  printf("zcm_msg_writer: size hints match encoded sizes\n");
+  size_t before = payload_len(a);
+  if (zcm_msg_put_char(a, 'x') != 0) return 1;
+  if (payload_len(a) - before != zcm_msg_size_hint_scalar(ZCM_MSG_ITEM_CHAR)) return 1;
+  before = payload_len(a);
+  if (zcm_msg_put_short(a, -3) != 0) return 1;
+  if (payload_len(a) - before != zcm_msg_size_hint_scalar(ZCM_MSG_ITEM_SHORT)) return 1;
+  before = payload_len(a);
+  if (zcm_msg_put_int(a, 123456) != 0) return 1;
+  if (payload_len(a) - before != zcm_msg_size_hint_scalar(ZCM_MSG_ITEM_INT)) return 1;
+  before = payload_len(a);
+  if (zcm_msg_put_long(a, -9876543210LL) != 0) return 1;
+  if (payload_len(a) - before != zcm_msg_size_hint_scalar(ZCM_MSG_ITEM_LONG)) return 1;
+  before = payload_len(a);
+  if (zcm_msg_put_float(a, 2.5f) != 0) return 1;
+  if (payload_len(a) - before != zcm_msg_size_hint_scalar(ZCM_MSG_ITEM_FLOAT)) return 1;
+  before = payload_len(a);
+  if (zcm_msg_put_double(a, -0.125) != 0) return 1;
+  if (payload_len(a) - before != zcm_msg_size_hint_scalar(ZCM_MSG_ITEM_DOUBLE)) return 1;
+  before = payload_len(a);
+  if (zcm_msg_put_text(a, "record") != 0) return 1;
+  if (payload_len(a) - before != zcm_msg_size_hint_text(6)) return 1;
+  before = payload_len(a);
+  if (zcm_msg_put_bytes(a, raw, sizeof(raw)) != 0) return 1;
+  if (payload_len(a) - before != zcm_msg_size_hint_bytes(sizeof(raw))) return 1;
+  before = payload_len(a);
+  if (zcm_msg_put_array(a, ZCM_MSG_ARRAY_INT, 5, samples) != 0) return 1;
+  if (payload_len(a) - before != zcm_msg_size_hint_array(ZCM_MSG_ARRAY_INT, 5)) return 1;
+  /* Value hints follow the selected encoding: check both. */
+  for (int compact = 0; compact <= 1; compact++) {
+    zcm_msg_set_value_compact(compact);
+    before = payload_len(a);
+    if (zcm_msg_put_value_text(a, "ok") != 0) return 1;
+    if (payload_len(a) - before != zcm_msg_size_hint_value(ZCM_MSG_VALUE_TEXT, 2)) return 1;
+    before = payload_len(a);
+    if (zcm_msg_put_value_double(a, 1.0) != 0) return 1;
+    if (payload_len(a) - before != zcm_msg_size_hint_value(ZCM_MSG_VALUE_DOUBLE, 0)) return 1;
+  }
+  zcm_msg_set_value_compact(0);
+  if (zcm_msg_size_hint_scalar(ZCM_MSG_ITEM_TEXT) != 0) return 1;
+  if (zcm_msg_size_hint_array((zcm_msg_array_type_t)99, 4) != 0) return 1;
+
+  printf("zcm_msg_writer: cursor output matches put_* output\n");
+  size_t record = zcm_msg_size_hint_scalar(ZCM_MSG_ITEM_CHAR) +
+                  zcm_msg_size_hint_scalar(ZCM_MSG_ITEM_SHORT) +
+                  zcm_msg_size_hint_scalar(ZCM_MSG_ITEM_INT) +
+                  zcm_msg_size_hint_scalar(ZCM_MSG_ITEM_LONG) +
+                  zcm_msg_size_hint_scalar(ZCM_MSG_ITEM_FLOAT) +
+                  zcm_msg_size_hint_scalar(ZCM_MSG_ITEM_DOUBLE) +
+                  zcm_msg_size_hint_text(6) + zcm_msg_size_hint_bytes(sizeof(raw)) +
+                  zcm_msg_size_hint_array(ZCM_MSG_ARRAY_INT, 5);
+  zcm_msg_writer_t w;
+  if (zcm_msg_writer_begin(b, &w, record) != 0) return 1;
+  zcm_msg_writer_put_char(&w, 'x');
+  zcm_msg_writer_put_short(&w, -3);
+  zcm_msg_writer_put_int(&w, 123456);
+  zcm_msg_writer_put_long(&w, -9876543210LL);
+  zcm_msg_writer_put_float(&w, 2.5f);
+  zcm_msg_writer_put_double(&w, -0.125);
+  zcm_msg_writer_put_text(&w, "record", 6);
+  zcm_msg_writer_put_bytes(&w, raw, sizeof(raw));
+  zcm_msg_writer_put_array(&w, ZCM_MSG_ARRAY_INT, 5, samples);
+  if (w.pos != w.end) return 1;
+  if (zcm_msg_writer_commit(&w) != 0) return 1;
+  for (int compact = 0; compact <= 1; compact++) {
+    zcm_msg_set_value_compact(compact);
+    if (zcm_msg_put_value_text(b, "ok") != 0) return 1;
+    if (zcm_msg_put_value_double(b, 1.0) != 0) return 1;
+  }
+  zcm_msg_set_value_compact(0);
+
+  size_t la = 0;
+  size_t lb = 0;
+  const void *pa = zcm_msg_data(a, &la);
+  const void *pb = zcm_msg_data(b, &lb);
+  if (la != lb || memcmp(pa, pb, la) != 0) return 1;
+  if (zcm_msg_validate(b) != ZCM_MSG_OK) return 1;
+
+  int16_t s = 0;
+  int64_t l = 0;
+  const char *text = NULL;
+  uint32_t text_len = 0;
+  char c = 0;
+  int32_t i = 0;
+  if (zcm_msg_get_char(b, &c) != 0 || c != 'x') return 1;
+  if (zcm_msg_get_short(b, &s) != 0 || s != -3) return 1;
+  if (zcm_msg_get_int(b, &i) != 0 || i != 123456) return 1;
+  if (zcm_msg_get_long(b, &l) != 0 || l != -9876543210LL) return 1;
+  float f = 0.0f;
+  double d = 0.0;
+  if (zcm_msg_get_float(b, &f) != 0 || f != 2.5f) return 1;
+  if (zcm_msg_get_double(b, &d) != 0 || d != -0.125) return 1;
+  if (zcm_msg_get_text(b, &text, &text_len) != 0) return 1;
+  if (text_len != 6 || memcmp(text, "record", 6) != 0) return 1;
+
+  printf("zcm_msg_writer: reserve keeps the buffer in place\n");
+  zcm_msg_reset(a);
+  if (zcm_msg_reserve(a, 64 * zcm_msg_size_hint_scalar(ZCM_MSG_ITEM_DOUBLE) + 1024) != 0) return 1;
+  if (zcm_msg_put_double(a, 0.0) != 0) return 1;
+  const void *start = zcm_msg_data(a, &la);
+  for (int k = 1; k < 64; k++) {
+    if (zcm_msg_put_double(a, (double)k) != 0) return 1;
+  }
+  uint8_t block[1000];
+  memset(block, 7, sizeof(block));
+  if (zcm_msg_put_array(a, ZCM_MSG_ARRAY_UINT8, sizeof(block), block) != 0) return 1;
+  if (zcm_msg_data(a, &la) != start) return 1;
+
+  printf("zcm_msg_writer: reserve keeps a validated index\n");
+  if (zcm_msg_validate_index(b) != ZCM_MSG_OK) return 1;
+  if (zcm_msg_reserve(b, 1 << 16) != 0) return 1;
+  double seek_d = 0.0;
+  if (zcm_msg_get_double_at(b, 5, &seek_d) != 0 || seek_d != -0.125) return 1;
+
+  printf("zcm_msg_writer: overrun is rejected\n");
+  zcm_msg_reset(b);
+  if (zcm_msg_reserve(b, 64) != 0) return 1;
+  if (zcm_msg_writer_begin(b, &w, zcm_msg_size_hint_scalar(ZCM_MSG_ITEM_INT)) != 0) return 1;
+  zcm_msg_writer_put_int(&w, 1);
+  zcm_msg_writer_put_int(&w, 2); /* stays within capacity, past the reservation */
+  if (zcm_msg_writer_commit(&w) != ZCM_MSG_ERR_RANGE) return 1;
+  if (payload_len(b) != 0) return 1;
+  if (zcm_msg_writer_commit(&w) != ZCM_MSG_ERR) return 1;
+  if (zcm_msg_writer_begin(NULL, &w, 8) == 0) return 1;
+
+  zcm_msg_free(a);
+  zcm_msg_free(b);
+  printf("zcm_msg_writer: PASS\n");
+  return 0;
+}
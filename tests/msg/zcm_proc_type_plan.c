@@ -0,0 +1,92 @@
+#include "zcm/zcm_msg.h"
+#include "zcm/zcm_proc_runtime.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static void make_query_handler(zcm_proc_type_handler_cfg_t *h) {
+  memset(h, 0, sizeof(*h));
+  snprintf(h->name, sizeof(h->name), "QUERY");
+  h->args[h->arg_count++] = ZCM_PROC_TYPE_ARG_DOUBLE;
+  h->args[h->arg_count++] = ZCM_PROC_TYPE_ARG_TEXT;
+  h->args[h->arg_count++] = ZCM_PROC_TYPE_ARG_FLOAT;
+  h->args[h->arg_count++] = ZCM_PROC_TYPE_ARG_INT;
+}
+
+int main(void) {
+  zcm_proc_type_handler_cfg_t h;
+  make_query_handler(&h);
+
+  printf("zcm_proc_type_plan: compile plan\n");
+  if (zcm_proc_runtime_compile_type_plan(&h) != 0) return 1;
+  if (!h.plan.compiled || h.plan.text_count != 1) return 1;
+  if (h.plan.min_len != 9 + 5 + 5 + 5) return 1;
+
+  printf("zcm_proc_type_plan: decode matching payload\n");
+  zcm_msg_t *m = zcm_msg_new();
+  if (!m) return 1;
+  zcm_msg_set_type(m, "QUERY");
+  zcm_msg_put_double(m, 5.0);
+  zcm_msg_put_text(m, "action");
+  zcm_msg_put_float(m, 1.5f);
+  zcm_msg_put_int(m, -7);
+
+  zcm_proc_type_args_t args;
+  if (zcm_proc_runtime_decode_type_args(m, &h, &args) != 0) return 1;
+  if (args.count != 4) return 1;
+  if (args.values[0].d != 5.0) return 1;
+  if (args.values[1].text_len != 6 || memcmp(args.values[1].text, "action", 6) != 0) return 1;
+  if (args.values[2].f != 1.5f || args.values[3].i != -7) return 1;
+
+  printf("zcm_proc_type_plan: summary is built on demand\n");
+  char summary[256];
+  if (zcm_proc_runtime_format_type_args(&args, summary, sizeof(summary)) != 0) return 1;
+  if (strcmp(summary, "double=5.000000, text=action, float=1.500000, int=-7") != 0) return 1;
+  if (zcm_proc_runtime_decode_type_payload(m, &h, summary, sizeof(summary)) != 0) return 1;
+  if (strncmp(summary, "double=5.000000", 15) != 0) return 1;
+
+  printf("zcm_proc_type_plan: reject mismatched payloads\n");
+  zcm_msg_reset(m);
+  zcm_msg_put_double(m, 5.0);
+  zcm_msg_put_text(m, "action");
+  zcm_msg_put_int(m, 1); /* float expected */
+  zcm_msg_put_int(m, -7);
+  if (zcm_proc_runtime_decode_type_args(m, &h, &args) == 0) return 1;
+
+  zcm_msg_reset(m);
+  zcm_msg_put_double(m, 5.0);
+  zcm_msg_put_text(m, "action");
+  zcm_msg_put_float(m, 1.5f);
+  if (zcm_proc_runtime_decode_type_args(m, &h, &args) == 0) return 1; /* too short */
+
+  zcm_msg_put_int(m, -7);
+  zcm_msg_put_int(m, 8);
+  if (zcm_proc_runtime_decode_type_args(m, &h, &args) == 0) return 1; /* trailing item */
+
+  /* A text length that claims more bytes than the payload holds. */
+  zcm_msg_reset(m);
+  zcm_msg_put_double(m, 5.0);
+  zcm_msg_put_text(m, "x");
+  zcm_msg_put_float(m, 1.5f);
+  zcm_msg_put_int(m, -7);
+  size_t len = 0;
+  uint8_t *raw = (uint8_t *)zcm_msg_data(m, &len);
+  raw[10] = 0xFF;
+  if (zcm_proc_runtime_decode_type_args(m, &h, &args) == 0) return 1;
+
+  printf("zcm_proc_type_plan: fixed-width handler\n");
+  zcm_proc_type_handler_cfg_t fixed;
+  memset(&fixed, 0, sizeof(fixed));
+  fixed.args[fixed.arg_count++] = ZCM_PROC_TYPE_ARG_INT;
+  fixed.args[fixed.arg_count++] = ZCM_PROC_TYPE_ARG_INT;
+  /* Not compiled: decode compiles a temporary plan. */
+  zcm_msg_reset(m);
+  zcm_msg_put_int(m, 1);
+  zcm_msg_put_int(m, 2);
+  if (zcm_proc_runtime_decode_type_args(m, &fixed, &args) != 0) return 1;
+  if (args.values[0].i != 1 || args.values[1].i != 2) return 1;
+
+  zcm_msg_free(m);
+  printf("zcm_proc_type_plan: PASS\n");
+  return 0;
+}
@@ -245,8 +245,9 @@ static void *legacy_ping_server_main(void *arg) {
       continue;
     }
     if (n == 4 && memcmp(buf, "PING", 4) == 0) {
+      /* Keep the socket open until main() is done: closing right after the
+       * send can drop PONG before it leaves. */
       (void)zcm_socket_send_bytes(rep, "PONG", 4);
-      srv->done = 1;
     } else {
       (void)zcm_socket_send_bytes(rep, "ERR", 3);
     }
@@ -0,0 +1,120 @@
+#include "zcm/zcm.h"
+#include "zcm/zcm_node.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <zmq.h>
+
+static int pick_free_tcp_port(void) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) return -1;
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(0);
+  socklen_t len = sizeof(addr);
+  if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+      getsockname(fd, (struct sockaddr *)&addr, &len) != 0) {
+    close(fd);
+    return -1;
+  }
+  close(fd);
+  return (int)ntohs(addr.sin_port);
+}
+
+/* TCP rather than inproc so the message actually crosses the I/O threads. */
+static int ping_pong(zcm_context_t *ctx) {
+  int port = pick_free_tcp_port();
+  if (port <= 0) return -1;
+  char endpoint[64];
+  snprintf(endpoint, sizeof(endpoint), "tcp://127.0.0.1:%d", port);
+  zcm_socket_t *pull = zcm_socket_new(ctx, ZCM_SOCK_PULL);
+  zcm_socket_t *push = zcm_socket_new(ctx, ZCM_SOCK_PUSH);
+  int rc = -1;
+  if (pull && push && zcm_socket_bind(pull, endpoint) == 0 &&
+      zcm_socket_connect(push, endpoint) == 0) {
+    zcm_socket_set_timeouts(pull, 2000);
+    char buf[16];
+    size_t n = 0;
+    if (zcm_socket_send_bytes(push, "ping", 4) == 0 &&
+        zcm_socket_recv_bytes(pull, buf, sizeof(buf), &n) == 0 && n == 4 &&
+        memcmp(buf, "ping", 4) == 0) {
+      rc = 0;
+    }
+  }
+  zcm_socket_free(push);
+  zcm_socket_free(pull);
+  return rc;
+}
+
+int main(void) {
+  zcm_context_opts_t opts;
+
+  printf("zcm_context_opts: NULL and zeroed options keep the defaults\n");
+  zcm_context_t *ctx = zcm_context_new_ex(NULL);
+  if (!ctx) return 1;
+  if (zmq_ctx_get(zcm_context_zmq(ctx), ZMQ_IO_THREADS) != 1) return 1;
+  zcm_context_free(ctx);
+  memset(&opts, 0, sizeof(opts));
+  ctx = zcm_context_new_ex(&opts);
+  if (!ctx) return 1;
+  if (zmq_ctx_get(zcm_context_zmq(ctx), ZMQ_IO_THREADS) != 1) return 1;
+  zcm_context_free(ctx);
+
+  printf("zcm_context_opts: out-of-range options rejected\n");
+  memset(&opts, 0, sizeof(opts));
+  opts.io_threads = -1;
+  if (zcm_context_new_ex(&opts)) return 1;
+  memset(&opts, 0, sizeof(opts));
+  opts.max_sockets = -5;
+  if (zcm_context_new_ex(&opts)) return 1;
+  memset(&opts, 0, sizeof(opts));
+  opts.cpu_count = ZCM_CONTEXT_CPU_MAX + 1;
+  if (zcm_context_new_ex(&opts)) return 1;
+  memset(&opts, 0, sizeof(opts));
+  opts.cpu_count = 1;
+  opts.cpus[0] = -1;
+  if (zcm_context_new_ex(&opts)) return 1;
+
+  printf("zcm_context_opts: I/O threads and socket limit read back\n");
+  memset(&opts, 0, sizeof(opts));
+  opts.io_threads = 4;
+  opts.max_sockets = 64;
+  opts.thread_name_prefix = 7;
+  ctx = zcm_context_new_ex(&opts);
+  if (!ctx) return 1;
+  if (zmq_ctx_get(zcm_context_zmq(ctx), ZMQ_IO_THREADS) != 4) return 1;
+  if (zmq_ctx_get(zcm_context_zmq(ctx), ZMQ_MAX_SOCKETS) != 64) return 1;
+  if (ping_pong(ctx) != 0) return 1;
+  zcm_context_free(ctx);
+
+  printf("zcm_context_opts: pinned I/O thread still carries traffic\n");
+  memset(&opts, 0, sizeof(opts));
+  opts.cpus[0] = 0;
+  opts.cpu_count = 1;
+  ctx = zcm_context_new_ex(&opts);
+  if (!ctx) return 1;
+  if (ping_pong(ctx) != 0) return 1;
+  zcm_context_free(ctx);
+
+  printf("zcm_context_opts: refused real-time scheduling fails without aborting\n");
+  memset(&opts, 0, sizeof(opts));
+  opts.thread_sched_policy = SCHED_FIFO;
+  opts.thread_priority = 50;
+  ctx = zcm_context_new_ex(&opts);
+  if (ctx) {
+    /* Privileged run: the I/O thread must come up with the policy. */
+    if (ping_pong(ctx) != 0) return 1;
+    zcm_context_free(ctx);
+  }
+
+  printf("zcm_context_opts: PASS\n");
+  return 0;
+}
@@ -0,0 +1,188 @@
+#include "zcm/zcm.h"
+#include "zcm/zcm_node.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#define NAMES 8
+#define LOOKUPS 200
+
+static int pick_free_tcp_port(void) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) return -1;
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(0);
+  socklen_t len = sizeof(addr);
+  if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+      getsockname(fd, (struct sockaddr *)&addr, &len) != 0) {
+    close(fd);
+    return -1;
+  }
+  close(fd);
+  return (int)ntohs(addr.sin_port);
+}
+
+static uint64_t now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000u + (uint64_t)(ts.tv_nsec / 1000000);
+}
+
+typedef struct {
+  int done;
+  int ok;
+  int failed;
+  int timeouts;
+  int cancelled;
+  int bad_endpoint;
+  zcm_node_record_t last;
+} tally_t;
+
+static void on_done(zcm_node_t *node, const char *name, int status,
+                    const zcm_node_record_t *rec, void *user) {
+  tally_t *t = (tally_t *)user;
+  (void)node;
+  t->done++;
+  if (status == 0) {
+    t->ok++;
+    if (rec) {
+      /* "async.N" is registered at tcp://127.0.0.1:(7000 + N). */
+      char want[64];
+      snprintf(want, sizeof(want), "tcp://127.0.0.1:%d", 7000 + (name[6] - '0'));
+      if (strcmp(rec->endpoint, want) != 0) t->bad_endpoint++;
+      t->last = *rec;
+    }
+  } else if (status == ZCM_NODE_ASYNC_TIMEOUT) {
+    t->timeouts++;
+  } else if (status == ZCM_NODE_ASYNC_CANCELLED) {
+    t->cancelled++;
+  } else {
+    t->failed++;
+  }
+}
+
+/* Event loop as an application would run it: poll the node FD next to its
+ * own descriptors, bounded by the node's next request deadline. */
+static int drive(zcm_node_t *node, tally_t *t, int want_done) {
+  int fd = -1;
+  if (zcm_node_async_fd(node, &fd) != 0) return -1;
+  uint64_t give_up = now_ms() + 5000;
+  while (t->done < want_done) {
+    if (now_ms() > give_up) return -1;
+    if (zcm_node_async_process(node, 0) < 0) return -1;
+    if (t->done >= want_done) break;
+    int wait_ms = zcm_node_async_timeout_ms(node);
+    if (wait_ms < 0 || wait_ms > 100) wait_ms = 100;
+    struct pollfd pfd = {fd, POLLIN, 0};
+    if (poll(&pfd, 1, wait_ms) < 0) return -1;
+  }
+  return 0;
+}
+
+int main(void) {
+  int port = pick_free_tcp_port();
+  if (port <= 0) {
+    printf("zcm_node_async: SKIP (no local TCP port allocation available)\n");
+    return 0;
+  }
+  char broker_ep[64];
+  snprintf(broker_ep, sizeof(broker_ep), "tcp://127.0.0.1:%d", port);
+
+  zcm_context_t *ctx = zcm_context_new();
+  if (!ctx) return 1;
+  zcm_broker_t *broker = zcm_broker_start(ctx, broker_ep);
+  zcm_node_t *node = zcm_node_new(ctx, broker_ep);
+  if (!broker || !node) return 1;
+  if (zcm_node_set_timeout(node, 1000) != 0) return 1;
+
+  printf("zcm_node_async: argument checks\n");
+  tally_t t;
+  memset(&t, 0, sizeof(t));
+  if (zcm_node_lookup_async(node, "async.0", NULL, &t) == 0) return 1;
+  if (zcm_node_lookup_async(NULL, "async.0", on_done, &t) == 0) return 1;
+  if (zcm_node_register_async(node, "async.0", "", "x", "h", 1, "NONE", -1, -1, on_done, &t) == 0)
+    return 1;
+  if (zcm_node_async_pending(node) != 0 || zcm_node_async_timeout_ms(node) != -1) return 1;
+  if (zcm_node_async_process(node, 0) != 0) return 1;
+
+  printf("zcm_node_async: registrations in flight together\n");
+  for (int i = 0; i < NAMES; i++) {
+    char name[32];
+    char ep[64];
+    snprintf(name, sizeof(name), "async.%d", i);
+    snprintf(ep, sizeof(ep), "tcp://127.0.0.1:%d", 7000 + i);
+    if (zcm_node_register_async(node, name, ep, ep, "127.0.0.1", (int)getpid(), "NONE", -1, -1,
+                                on_done, &t) != 0) {
+      return 1;
+    }
+  }
+  if (zcm_node_async_pending(node) != NAMES) return 1;
+  if (drive(node, &t, NAMES) != 0 || t.ok != NAMES) return 1;
+
+  printf("zcm_node_async: %d lookups from one thread\n", LOOKUPS);
+  memset(&t, 0, sizeof(t));
+  for (int i = 0; i < LOOKUPS; i++) {
+    char name[32];
+    snprintf(name, sizeof(name), "async.%d", i % NAMES);
+    if (zcm_node_lookup_async(node, name, on_done, &t) != 0) return 1;
+  }
+  if (zcm_node_lookup_async(node, "async.missing", on_done, &t) != 0) return 1;
+  if (drive(node, &t, LOOKUPS + 1) != 0) return 1;
+  if (t.ok != LOOKUPS || t.failed != 1 || t.bad_endpoint != 0) return 1;
+
+  printf("zcm_node_async: resolve, blocking call in between, unregister\n");
+  memset(&t, 0, sizeof(t));
+  if (zcm_node_resolve_async(node, "async.3", on_done, &t) != 0) return 1;
+  char ep[256];
+  if (zcm_node_lookup(node, "async.4", ep, sizeof(ep)) != 0) return 1;
+  if (zcm_node_async_process(node, 1000) != 1 || t.ok != 1) return 1;
+  if (strcmp(t.last.ctrl_endpoint, "tcp://127.0.0.1:7003") != 0) return 1;
+  if (strcmp(t.last.host, "127.0.0.1") != 0 || t.last.pid != (int)getpid()) return 1;
+  if (zcm_node_unregister_async(node, "async.3", on_done, &t) != 0) return 1;
+  if (zcm_node_resolve_async(node, "async.3", on_done, &t) != 0) return 1;
+  if (drive(node, &t, 3) != 0 || t.ok != 2 || t.failed != 1) return 1;
+
+  printf("zcm_node_async: broker down completes with a timeout\n");
+  zcm_broker_stop(broker);
+  broker = NULL;
+  if (zcm_node_set_timeout(node, 200) != 0) return 1;
+  memset(&t, 0, sizeof(t));
+  uint64_t t0 = now_ms();
+  if (zcm_node_lookup_async(node, "async.0", on_done, &t) != 0) return 1;
+  if (zcm_node_async_timeout_ms(node) > 200) return 1;
+  if (zcm_node_async_process(node, -1) != 1 || t.timeouts != 1) return 1;
+  if (now_ms() - t0 > 1000 || zcm_node_async_pending(node) != 0) return 1;
+
+  printf("zcm_node_async: shortened timeout expires the newer request first\n");
+  tally_t slow;
+  memset(&slow, 0, sizeof(slow));
+  memset(&t, 0, sizeof(t));
+  if (zcm_node_set_timeout(node, 5000) != 0) return 1;
+  if (zcm_node_lookup_async(node, "async.0", on_done, &slow) != 0) return 1;
+  if (zcm_node_set_timeout(node, 200) != 0) return 1;
+  t0 = now_ms();
+  if (zcm_node_lookup_async(node, "async.1", on_done, &t) != 0) return 1;
+  if (zcm_node_async_timeout_ms(node) > 200) return 1;
+  if (zcm_node_async_process(node, -1) != 1 || t.timeouts != 1 || slow.done != 0) return 1;
+  if (now_ms() - t0 > 1000 || zcm_node_async_pending(node) != 1) return 1;
+
+  printf("zcm_node_async: free cancels pending requests\n");
+  if (zcm_node_lookup_async(node, "async.1", on_done, &t) != 0) return 1;
+  if (zcm_node_lookup_async(node, "async.2", on_done, &t) != 0) return 1;
+  zcm_node_free(node);
+  if (t.cancelled != 2 || slow.cancelled != 1) return 1;
+
+  zcm_context_free(ctx);
+  printf("zcm_node_async: PASS\n");
+  return 0;
+}
@@ -0,0 +1,127 @@
+#include "zcm/zcm.h"
+#include "zcm/zcm_node.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static int pick_free_tcp_port(void) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) return -1;
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(0);
+  socklen_t len = sizeof(addr);
+  if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+      getsockname(fd, (struct sockaddr *)&addr, &len) != 0) {
+    close(fd);
+    return -1;
+  }
+  close(fd);
+  return (int)ntohs(addr.sin_port);
+}
+
+int main(void) {
+  int port = pick_free_tcp_port();
+  if (port <= 0) {
+    printf("zcm_node_cache: SKIP (no local TCP port allocation available)\n");
+    return 0;
+  }
+  char broker_ep[64];
+  snprintf(broker_ep, sizeof(broker_ep), "tcp://127.0.0.1:%d", port);
+
+  zcm_context_t *ctx = zcm_context_new();
+  if (!ctx) return 1;
+  zcm_broker_t *broker = zcm_broker_start(ctx, broker_ep);
+  zcm_node_t *node = zcm_node_new(ctx, broker_ep);
+  if (!broker || !node) return 1;
+  if (zcm_node_set_timeout(node, 300) != 0) return 1;
+  if (zcm_node_set_cache(node, -1, 0) == 0) return 1;
+
+  int rc = -1;
+  for (int i = 0; i < 20 && rc != 0; i++) {
+    rc = zcm_node_register_ex(node, "cache.svc", "tcp://127.0.0.1:7000", "tcp://127.0.0.1:7001",
+                              "127.0.0.1", (int)getpid(), "NONE", -1, -1);
+  }
+  if (rc != 0) return 1;
+
+  printf("zcm_node_cache: resolve without cache\n");
+  zcm_node_record_t rec;
+  if (zcm_node_resolve(node, "cache.svc", &rec) != 0) return 1;
+  if (strcmp(rec.endpoint, "tcp://127.0.0.1:7000") != 0) return 1;
+  if (strcmp(rec.ctrl_endpoint, "tcp://127.0.0.1:7001") != 0) return 1;
+  if (strcmp(rec.host, "127.0.0.1") != 0 || rec.pid != (int)getpid()) return 1;
+  if (zcm_node_resolve(node, "cache.missing", &rec) == 0) return 1;
+
+  printf("zcm_node_cache: cached entries are served without the broker\n");
+  if (zcm_node_set_cache(node, 60000, 200) != 0) return 1;
+  char ep[256];
+  char ctrl[256];
+  int pid = 0;
+  if (zcm_node_lookup(node, "cache.svc", ep, sizeof(ep)) != 0) return 1;
+  if (zcm_node_lookup(node, "cache.missing", ep, sizeof(ep)) == 0) return 1;
+  zcm_broker_stop(broker);
+  broker = NULL;
+  for (int i = 0; i < 100; i++) {
+    if (zcm_node_lookup(node, "cache.svc", ep, sizeof(ep)) != 0) return 1;
+    if (strcmp(ep, "tcp://127.0.0.1:7000") != 0) return 1;
+  }
+  if (zcm_node_info(node, "cache.svc", ep, sizeof(ep), ctrl, sizeof(ctrl), NULL, 0, &pid) != 0)
+    return 1;
+  if (strcmp(ctrl, "tcp://127.0.0.1:7001") != 0 || pid != (int)getpid()) return 1;
+  if (zcm_node_lookup(node, "cache.missing", ep, sizeof(ep)) == 0) return 1;
+
+  printf("zcm_node_cache: negative entries expire\n");
+  usleep(300 * 1000);
+  /* Expired, so this goes to the (stopped) broker and must not be cached. */
+  if (zcm_node_lookup(node, "cache.missing", ep, sizeof(ep)) == 0) return 1;
+
+  printf("zcm_node_cache: invalidation forces a refetch\n");
+  zcm_node_cache_invalidate(node, "cache.svc");
+  if (zcm_node_lookup(node, "cache.svc", ep, sizeof(ep)) == 0) return 1;
+
+  broker = zcm_broker_start(ctx, broker_ep);
+  if (!broker) return 1;
+  rc = -1;
+  for (int i = 0; i < 20 && rc != 0; i++) {
+    rc = zcm_node_register_ex(node, "cache.svc", "tcp://127.0.0.1:7100", "tcp://127.0.0.1:7101",
+                              "127.0.0.1", (int)getpid(), "NONE", -1, -1);
+  }
+  if (rc != 0) return 1;
+  if (zcm_node_resolve(node, "cache.svc", &rec) != 0) return 1;
+  if (strcmp(rec.endpoint, "tcp://127.0.0.1:7100") != 0) return 1;
+  zcm_node_cache_invalidate(node, NULL);
+
+  printf("zcm_node_cache: positive entries expire\n");
+  if (zcm_node_set_cache(node, 200, 0) != 0) return 1;
+  if (zcm_node_resolve(node, "cache.svc", &rec) != 0) return 1;
+  zcm_broker_stop(broker);
+  broker = NULL;
+  if (zcm_node_resolve(node, "cache.svc", &rec) != 0) return 1;
+  usleep(300 * 1000);
+  if (zcm_node_resolve(node, "cache.svc", &rec) == 0) return 1;
+
+  printf("zcm_node_cache: disabling the cache drops entries\n");
+  broker = zcm_broker_start(ctx, broker_ep);
+  if (!broker) return 1;
+  rc = -1;
+  for (int i = 0; i < 20 && rc != 0; i++) {
+    rc = zcm_node_register_ex(node, "cache.svc", "tcp://127.0.0.1:7100", "tcp://127.0.0.1:7101",
+                              "127.0.0.1", (int)getpid(), "NONE", -1, -1);
+  }
+  if (rc != 0 || zcm_node_resolve(node, "cache.svc", &rec) != 0) return 1;
+  if (zcm_node_set_cache(node, 0, 0) != 0) return 1;
+  zcm_broker_stop(broker);
+  broker = NULL;
+  if (zcm_node_resolve(node, "cache.svc", &rec) == 0) return 1;
+
+  zcm_node_free(node);
+  zcm_context_free(ctx);
+  printf("zcm_node_cache: PASS\n");
+  return 0;
+}
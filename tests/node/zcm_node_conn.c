@@ -0,0 +1,148 @@
+#include "zcm/zcm.h"
+#include "zcm/zcm_node.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#define WORKERS 4
+#define WORKER_LOOKUPS 100
+
+static int pick_free_tcp_port(void) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) return -1;
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(0);
+  socklen_t len = sizeof(addr);
+  if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+      getsockname(fd, (struct sockaddr *)&addr, &len) != 0) {
+    close(fd);
+    return -1;
+  }
+  close(fd);
+  return (int)ntohs(addr.sin_port);
+}
+
+static uint64_t now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000u + (uint64_t)(ts.tv_nsec / 1000000);
+}
+
+static int register_svc(zcm_node_t *node, const char *name, const char *ep) {
+  return zcm_node_register_ex(node, name, ep, "tcp://127.0.0.1:7001", "127.0.0.1",
+                              (int)getpid(), "NONE", -1, -1);
+}
+
+/* Retry while a freshly started broker binds. */
+static int lookup_retry(zcm_node_t *node, const char *name, char *out, size_t out_size) {
+  for (int i = 0; i < 20; i++) {
+    if (zcm_node_lookup(node, name, out, out_size) == 0) return 0;
+  }
+  return -1;
+}
+
+typedef struct {
+  zcm_node_t *node;
+  int failures;
+} worker_t;
+
+static void *lookup_worker(void *arg) {
+  worker_t *w = (worker_t *)arg;
+  for (int i = 0; i < WORKER_LOOKUPS; i++) {
+    char ep[256];
+    int pid = 0;
+    if (i % 2 == 0) {
+      if (zcm_node_lookup(w->node, "conn.svc", ep, sizeof(ep)) != 0 ||
+          strcmp(ep, "tcp://127.0.0.1:7000") != 0) {
+        w->failures++;
+      }
+    } else if (zcm_node_info(w->node, "conn.svc", ep, sizeof(ep), NULL, 0, NULL, 0, &pid) != 0 ||
+               pid != (int)getpid()) {
+      w->failures++;
+    }
+  }
+  return NULL;
+}
+
+int main(void) {
+  int port = pick_free_tcp_port();
+  if (port <= 0) {
+    printf("zcm_node_conn: SKIP (no local TCP port allocation available)\n");
+    return 0;
+  }
+  char broker_ep[64];
+  snprintf(broker_ep, sizeof(broker_ep), "tcp://127.0.0.1:%d", port);
+
+  zcm_context_t *ctx = zcm_context_new();
+  if (!ctx) return 1;
+  zcm_broker_t *broker = zcm_broker_start(ctx, broker_ep);
+  zcm_node_t *node = zcm_node_new(ctx, broker_ep);
+  if (!broker || !node) return 1;
+  if (zcm_node_set_timeout(node, 0) == 0) return 1;
+  if (zcm_node_set_timeout(node, 300) != 0) return 1;
+
+  printf("zcm_node_conn: sequential requests on one connection\n");
+  int rc = -1;
+  for (int i = 0; i < 20 && rc != 0; i++) rc = register_svc(node, "conn.svc", "tcp://127.0.0.1:7000");
+  if (rc != 0) return 1;
+  char ep[256];
+  for (int i = 0; i < 200; i++) {
+    if (zcm_node_lookup(node, "conn.svc", ep, sizeof(ep)) != 0) return 1;
+    if (strcmp(ep, "tcp://127.0.0.1:7000") != 0) return 1;
+  }
+  if (zcm_node_lookup(node, "conn.missing", ep, sizeof(ep)) == 0) return 1;
+  /* A negative reply must not poison the connection. */
+  if (zcm_node_lookup(node, "conn.svc", ep, sizeof(ep)) != 0) return 1;
+  zcm_node_entry_t *entries = NULL;
+  size_t count = 0;
+  if (zcm_node_list(node, &entries, &count) != 0 || count < 2) return 1;
+  zcm_node_list_free(entries, count);
+  if (zcm_node_report_metrics(node, "conn.svc", "NONE", -1, -1, 1, 2, 3, 4) != 0) return 1;
+
+  printf("zcm_node_conn: concurrent requests share the node\n");
+  pthread_t th[WORKERS];
+  worker_t workers[WORKERS];
+  for (int i = 0; i < WORKERS; i++) {
+    workers[i].node = node;
+    workers[i].failures = 0;
+    if (pthread_create(&th[i], NULL, lookup_worker, &workers[i]) != 0) return 1;
+  }
+  for (int i = 0; i < WORKERS; i++) {
+    pthread_join(th[i], NULL);
+    if (workers[i].failures != 0) return 1;
+  }
+
+  printf("zcm_node_conn: broker down fails within the timeout\n");
+  zcm_broker_stop(broker);
+  broker = NULL;
+  uint64_t t0 = now_ms();
+  if (zcm_node_lookup(node, "conn.svc", ep, sizeof(ep)) == 0) return 1;
+  if (now_ms() - t0 > 2000) return 1;
+
+  printf("zcm_node_conn: reconnect after broker restart\n");
+  broker = zcm_broker_start(ctx, broker_ep);
+  if (!broker) return 1;
+  rc = -1;
+  for (int i = 0; i < 20 && rc != 0; i++) rc = register_svc(node, "conn.svc", "tcp://127.0.0.1:7002");
+  if (rc != 0) return 1;
+  if (lookup_retry(node, "conn.svc", ep, sizeof(ep)) != 0) return 1;
+  if (strcmp(ep, "tcp://127.0.0.1:7002") != 0) return 1;
+  if (zcm_node_unregister(node, "conn.svc") != 0) return 1;
+  if (zcm_node_lookup(node, "conn.svc", ep, sizeof(ep)) == 0) return 1;
+
+  zcm_node_free(node);
+  zcm_broker_stop(broker);
+  zcm_context_free(ctx);
+  printf("zcm_node_conn: PASS\n");
+  return 0;
+}
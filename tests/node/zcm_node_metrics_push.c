@@ -0,0 +1,231 @@
+#include "zcm/zcm.h"
+#include "zcm/zcm_node.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <zmq.h>
+
+#define NAMES 3
+#define BURST 1000
+
+static int pick_free_tcp_port(void) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) return -1;
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(0);
+  socklen_t len = sizeof(addr);
+  if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+      getsockname(fd, (struct sockaddr *)&addr, &len) != 0) {
+    close(fd);
+    return -1;
+  }
+  close(fd);
+  return (int)ntohs(addr.sin_port);
+}
+
+static uint64_t now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000u + (uint64_t)(ts.tv_nsec / 1000000);
+}
+
+static int recv_text(void *sock, char *out, size_t out_size) {
+  int n = zmq_recv(sock, out, out_size - 1, 0);
+  if (n < 0) return -1;
+  if ((size_t)n >= out_size) n = (int)out_size - 1;
+  out[n] = '\0';
+  return 0;
+}
+
+/* Raw broker request; returns a connected REQ socket with the reply pending. */
+static void *broker_req(zcm_context_t *ctx, const char *broker_ep, const char *cmd) {
+  void *req = zmq_socket(zcm_context_zmq(ctx), ZMQ_REQ);
+  int timeout_ms = 1000;
+  int linger_ms = 0;
+  if (!req) return NULL;
+  zmq_setsockopt(req, ZMQ_RCVTIMEO, &timeout_ms, sizeof(timeout_ms));
+  zmq_setsockopt(req, ZMQ_LINGER, &linger_ms, sizeof(linger_ms));
+  if (zmq_connect(req, broker_ep) != 0 || zmq_send(req, cmd, strlen(cmd), 0) < 0) {
+    zmq_close(req);
+    return NULL;
+  }
+  return req;
+}
+
+/* Reads role and the six metric values of `name` from LIST_EX. */
+static int list_ex_metrics(zcm_context_t *ctx, const char *broker_ep, const char *name,
+                           char *role, size_t role_size, int vals[6]) {
+  void *req = broker_req(ctx, broker_ep, "LIST_EX");
+  if (!req) return -1;
+  char text[512];
+  int count = 0;
+  int rc = -1;
+  if (recv_text(req, text, sizeof(text)) != 0 || strcmp(text, "OK") != 0 ||
+      zmq_recv(req, &count, sizeof(count), 0) != (int)sizeof(count)) {
+    zmq_close(req);
+    return -1;
+  }
+  for (int i = 0; i < count; i++) {
+    char entry[10][512];
+    for (int f = 0; f < 10; f++) {
+      if (recv_text(req, entry[f], sizeof(entry[f])) != 0) {
+        zmq_close(req);
+        return -1;
+      }
+    }
+    if (strcmp(entry[0], name) != 0) continue;
+    snprintf(role, role_size, "%s", entry[3]);
+    for (int f = 0; f < 6; f++) vals[f] = atoi(entry[4 + f]);
+    rc = 0;
+  }
+  zmq_close(req);
+  return rc;
+}
+
+/* Polls LIST_EX until `name` shows pub_bytes == want (reports carry no ack). */
+static int wait_pub_bytes(zcm_context_t *ctx, const char *broker_ep, const char *name, int want) {
+  uint64_t give_up = now_ms() + 3000;
+  while (now_ms() < give_up) {
+    char role[512];
+    int vals[6];
+    if (list_ex_metrics(ctx, broker_ep, name, role, sizeof(role), vals) == 0 && vals[2] == want) {
+      return 0;
+    }
+    usleep(10 * 1000);
+  }
+  return -1;
+}
+
+static int register_names(zcm_node_t *node) {
+  for (int i = 0; i < NAMES; i++) {
+    char name[32];
+    char ep[64];
+    snprintf(name, sizeof(name), "metrics.%d", i);
+    snprintf(ep, sizeof(ep), "tcp://127.0.0.1:%d", 7400 + i);
+    int rc = -1;
+    for (int k = 0; k < 20 && rc != 0; k++) {
+      rc = zcm_node_register_ex(node, name, ep, ep, "127.0.0.1", (int)getpid(), "NONE", -1, -1);
+    }
+    if (rc != 0) return -1;
+  }
+  return 0;
+}
+
+int main(void) {
+  int port = pick_free_tcp_port();
+  if (port <= 0) {
+    printf("zcm_node_metrics_push: SKIP (no local TCP port allocation available)\n");
+    return 0;
+  }
+  char broker_ep[64];
+  snprintf(broker_ep, sizeof(broker_ep), "tcp://127.0.0.1:%d", port);
+
+  zcm_context_t *ctx = zcm_context_new();
+  if (!ctx) return 1;
+  zcm_broker_t *broker = zcm_broker_start(ctx, broker_ep);
+  zcm_node_t *node = zcm_node_new(ctx, broker_ep);
+  if (!broker || !node) return 1;
+  if (zcm_node_set_timeout(node, 1000) != 0 || register_names(node) != 0) return 1;
+
+  printf("zcm_node_metrics_push: argument checks\n");
+  zcm_node_metrics_t reports[NAMES + 1];
+  memset(reports, 0, sizeof(reports));
+  if (zcm_node_push_metrics(NULL, reports, 1) == 0) return 1;
+  if (zcm_node_push_metrics(node, reports, 0) == 0) return 1;
+  if (zcm_node_push_metrics(node, reports, 1) == 0) return 1; /* no name */
+
+  printf("zcm_node_metrics_push: one frame for several sockets\n");
+  static char names[NAMES][32];
+  for (int i = 0; i < NAMES; i++) {
+    snprintf(names[i], sizeof(names[i]), "metrics.%d", i);
+    reports[i].name = names[i];
+    reports[i].role = (i == 0) ? "PUB" : NULL;
+    reports[i].pub_port = 7400 + i;
+    reports[i].push_port = -1;
+    reports[i].pub_bytes = 100 + i;
+    reports[i].sub_bytes = -1;
+    reports[i].push_bytes = -1;
+    reports[i].pull_bytes = 200 + i;
+  }
+  reports[NAMES] = reports[0];
+  reports[NAMES].name = "metrics.unknown";
+  if (zcm_node_push_metrics(node, reports, NAMES + 1) != 0) return 1;
+  for (int i = 0; i < NAMES; i++) {
+    if (wait_pub_bytes(ctx, broker_ep, names[i], 100 + i) != 0) return 1;
+  }
+  char role[512];
+  int vals[6];
+  if (list_ex_metrics(ctx, broker_ep, "metrics.0", role, sizeof(role), vals) != 0) return 1;
+  if (strcmp(role, "PUB") != 0 || vals[0] != 7400 || vals[1] != -1 || vals[5] != 200) return 1;
+
+  printf("zcm_node_metrics_push: malformed frames are dropped\n");
+  void *req = broker_req(ctx, broker_ep, "METRICS_ENDPOINT");
+  char text[512];
+  char metrics_ep[512];
+  if (!req || recv_text(req, text, sizeof(text)) != 0 || strcmp(text, "OK") != 0 ||
+      recv_text(req, metrics_ep, sizeof(metrics_ep)) != 0) {
+    return 1;
+  }
+  zmq_close(req);
+  void *push = zmq_socket(zcm_context_zmq(ctx), ZMQ_PUSH);
+  if (!push || zmq_connect(push, metrics_ep) != 0) return 1;
+  static const uint8_t truncated[] = {'Z', 'C', 'M', 'R', 1, 0, 1, 0, 9, 0, 0, 0};
+  if (zmq_send(push, truncated, sizeof(truncated), 0) < 0) return 1;
+  if (zmq_send(push, "garbage", 7, 0) < 0) return 1;
+  reports[0].pub_bytes = 150;
+  if (zcm_node_push_metrics(node, reports, 1) != 0) return 1;
+  if (wait_pub_bytes(ctx, broker_ep, "metrics.0", 150) != 0) return 1;
+  int linger_ms = 0;
+  zmq_setsockopt(push, ZMQ_LINGER, &linger_ms, sizeof(linger_ms));
+  zmq_close(push);
+
+  printf("zcm_node_metrics_push: %d reports interleaved with lookups\n", BURST);
+  /* A burst may overrun the bounded queue; drops are reported, not fatal. */
+  int sent = 0;
+  for (int i = 0; i < BURST; i++) {
+    reports[1].pub_bytes = 1000 + i;
+    if (zcm_node_push_metrics(node, &reports[1], 1) == 0) sent++;
+    if (i % 50 == 0) {
+      char ep[256];
+      if (zcm_node_lookup(node, "metrics.2", ep, sizeof(ep)) != 0) return 1;
+    }
+  }
+  if (sent == 0) return 1;
+  usleep(100 * 1000);
+  reports[1].pub_bytes = 5000;
+  if (zcm_node_push_metrics(node, &reports[1], 1) != 0) return 1;
+  if (wait_pub_bytes(ctx, broker_ep, "metrics.1", 5000) != 0) return 1;
+
+  zcm_node_free(node);
+  zcm_broker_stop(broker);
+
+  printf("zcm_node_metrics_push: falls back to METRICS without a metrics endpoint\n");
+  setenv("ZCM_BROKER_METRICS_ENDPOINT", "none", 1);
+  broker = zcm_broker_start(ctx, broker_ep);
+  node = zcm_node_new(ctx, broker_ep);
+  if (!broker || !node || register_names(node) != 0) return 1;
+  unsetenv("ZCM_BROKER_METRICS_ENDPOINT");
+  reports[2].pub_bytes = 321;
+  if (zcm_node_push_metrics(node, &reports[2], 1) != 0) return 1;
+  /* Acknowledged request: visible right away. */
+  if (list_ex_metrics(ctx, broker_ep, "metrics.2", role, sizeof(role), vals) != 0) return 1;
+  if (vals[2] != 321) return 1;
+  if (zcm_node_push_metrics(node, &reports[NAMES], 1) == 0) return 1; /* unknown name */
+
+  zcm_node_free(node);
+  zcm_broker_stop(broker);
+  zcm_context_free(ctx);
+  printf("zcm_node_metrics_push: PASS\n");
+  return 0;
+}
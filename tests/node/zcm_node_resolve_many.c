@@ -0,0 +1,174 @@
+#include "zcm/zcm.h"
+#include "zcm/zcm_node.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <zmq.h>
+
+#define NAME_COUNT 150
+
+static int pick_free_tcp_port(void) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) return -1;
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(0);
+  socklen_t len = sizeof(addr);
+  if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+      getsockname(fd, (struct sockaddr *)&addr, &len) != 0) {
+    close(fd);
+    return -1;
+  }
+  close(fd);
+  return (int)ntohs(addr.sin_port);
+}
+
+/* Stand-in for a broker without LOOKUP_MANY: answers INFO, ERR otherwise. */
+static int send_frames(void *sock, const char *const *frames, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    if (zmq_send(sock, frames[i], strlen(frames[i]), (i + 1 < n) ? ZMQ_SNDMORE : 0) < 0) return -1;
+  }
+  return 0;
+}
+
+static void *legacy_broker_main(void *arg) {
+  void *rep = arg;
+  for (;;) {
+    char cmd[32] = {0};
+    char name[256] = {0};
+    int n = zmq_recv(rep, cmd, sizeof(cmd) - 1, 0);
+    if (n < 0) continue;
+    int more = 0;
+    size_t more_size = sizeof(more);
+    while (zmq_getsockopt(rep, ZMQ_RCVMORE, &more, &more_size) == 0 && more) {
+      memset(name, 0, sizeof(name));
+      if (zmq_recv(rep, name, sizeof(name) - 1, 0) < 0) break;
+    }
+    if (strcmp(cmd, "QUIT") == 0) {
+      zmq_send(rep, "OK", 2, 0);
+      return NULL;
+    }
+    if (strcmp(cmd, "INFO") != 0) {
+      zmq_send(rep, "ERR", 3, 0);
+    } else if (strcmp(name, "legacy.missing") == 0) {
+      zmq_send(rep, "NOT_FOUND", 9, 0);
+    } else {
+      const char *reply[] = {"OK", "tcp://127.0.0.1:7300", "", "127.0.0.1", "42"};
+      send_frames(rep, reply, 5);
+    }
+  }
+}
+
+int main(void) {
+  int port = pick_free_tcp_port();
+  if (port <= 0) {
+    printf("zcm_node_resolve_many: SKIP (no local TCP port allocation available)\n");
+    return 0;
+  }
+  char broker_ep[64];
+  snprintf(broker_ep, sizeof(broker_ep), "tcp://127.0.0.1:%d", port);
+
+  zcm_context_t *ctx = zcm_context_new();
+  if (!ctx) return 1;
+  zcm_broker_t *broker = zcm_broker_start(ctx, broker_ep);
+  zcm_node_t *node = zcm_node_new(ctx, broker_ep);
+  if (!broker || !node) return 1;
+  if (zcm_node_set_timeout(node, 1000) != 0) return 1;
+
+  printf("zcm_node_resolve_many: register names\n");
+  static char names_buf[NAME_COUNT + 1][64];
+  const char *names[NAME_COUNT + 1];
+  for (int i = 0; i < NAME_COUNT; i++) {
+    char ep[64];
+    char ctrl[64];
+    snprintf(names_buf[i], sizeof(names_buf[i]), "many.%03d", i);
+    snprintf(ep, sizeof(ep), "tcp://127.0.0.1:%d", 20000 + i);
+    snprintf(ctrl, sizeof(ctrl), "tcp://127.0.0.1:%d", 30000 + i);
+    names[i] = names_buf[i];
+    int rc = -1;
+    for (int k = 0; k < 20 && rc != 0; k++) {
+      rc = zcm_node_register_ex(node, names[i], ep, ctrl, "127.0.0.1", (int)getpid(), "NONE", -1, -1);
+    }
+    if (rc != 0) return 1;
+  }
+  snprintf(names_buf[NAME_COUNT], sizeof(names_buf[NAME_COUNT]), "many.missing");
+  names[NAME_COUNT] = names_buf[NAME_COUNT];
+
+  printf("zcm_node_resolve_many: pipelined batches\n");
+  static zcm_node_record_t recs[NAME_COUNT + 1];
+  if (zcm_node_resolve_many(node, names, NAME_COUNT + 1, recs) != NAME_COUNT) return 1;
+  for (int i = 0; i < NAME_COUNT; i++) {
+    char ep[64];
+    char ctrl[64];
+    snprintf(ep, sizeof(ep), "tcp://127.0.0.1:%d", 20000 + i);
+    snprintf(ctrl, sizeof(ctrl), "tcp://127.0.0.1:%d", 30000 + i);
+    if (strcmp(recs[i].endpoint, ep) != 0 || strcmp(recs[i].ctrl_endpoint, ctrl) != 0) return 1;
+    if (strcmp(recs[i].host, "127.0.0.1") != 0 || recs[i].pid != (int)getpid()) return 1;
+  }
+  if (recs[NAME_COUNT].endpoint[0] || recs[NAME_COUNT].pid != 0) return 1;
+  if (zcm_node_resolve_many(node, names, 0, NULL) != 0) return 1;
+  if (zcm_node_resolve_many(node, NULL, 2, recs) != -1) return 1;
+
+  printf("zcm_node_resolve_many: duplicates and a single request\n");
+  const char *dup[3] = {"many.007", "many.missing", "many.007"};
+  zcm_node_record_t dup_recs[3];
+  if (zcm_node_resolve_many(node, dup, 3, dup_recs) != 2) return 1;
+  if (strcmp(dup_recs[0].endpoint, dup_recs[2].endpoint) != 0 || dup_recs[1].endpoint[0]) return 1;
+  zcm_node_record_t one;
+  if (zcm_node_resolve(node, "many.007", &one) != 0 || strcmp(one.endpoint, dup_recs[0].endpoint) != 0)
+    return 1;
+
+  printf("zcm_node_resolve_many: cached names are served locally\n");
+  /* Fits the node's cache: 40 names plus the unknown one, cached negative. */
+  const char *cached[41];
+  for (int i = 0; i < 40; i++) cached[i] = names[i * 3];
+  cached[40] = names[NAME_COUNT];
+  if (zcm_node_set_cache(node, 60000, 60000) != 0) return 1;
+  if (zcm_node_resolve_many(node, cached, 41, recs) != 40) return 1;
+  zcm_broker_stop(broker);
+  broker = NULL;
+  memset(recs, 0, sizeof(recs));
+  if (zcm_node_resolve_many(node, cached, 41, recs) != 40) return 1;
+  if (strcmp(recs[39].endpoint, "tcp://127.0.0.1:20117") != 0 || recs[40].endpoint[0]) return 1;
+  const char *uncached[2] = {"many.000", "many.new"};
+  if (zcm_node_resolve_many(node, uncached, 2, recs) != -1) return 1;
+  zcm_node_free(node);
+
+  printf("zcm_node_resolve_many: falls back to INFO on older brokers\n");
+  void *rep = zmq_socket(zcm_context_zmq(ctx), ZMQ_REP);
+  if (!rep || zmq_bind(rep, broker_ep) != 0) return 1;
+  pthread_t th;
+  if (pthread_create(&th, NULL, legacy_broker_main, rep) != 0) return 1;
+  node = zcm_node_new(ctx, broker_ep);
+  if (!node) return 1;
+  const char *legacy[3] = {"legacy.a", "legacy.missing", "legacy.b"};
+  zcm_node_record_t legacy_recs[3];
+  int found = -1;
+  for (int k = 0; k < 20 && found < 0; k++) found = zcm_node_resolve_many(node, legacy, 3, legacy_recs);
+  if (found != 2) return 1;
+  if (strcmp(legacy_recs[2].endpoint, "tcp://127.0.0.1:7300") != 0 || legacy_recs[2].pid != 42) return 1;
+  if (legacy_recs[1].endpoint[0]) return 1;
+
+  void *quit = zmq_socket(zcm_context_zmq(ctx), ZMQ_REQ);
+  int timeout_ms = 1000;
+  char ack[8] = {0};
+  if (!quit || zmq_connect(quit, broker_ep) != 0) return 1;
+  zmq_setsockopt(quit, ZMQ_RCVTIMEO, &timeout_ms, sizeof(timeout_ms));
+  if (zmq_send(quit, "QUIT", 4, 0) < 0 || zmq_recv(quit, ack, sizeof(ack) - 1, 0) < 0) return 1;
+  pthread_join(th, NULL);
+
+  zmq_close(quit);
+  zmq_close(rep);
+  zcm_node_free(node);
+  zcm_context_free(ctx);
+  printf("zcm_node_resolve_many: PASS\n");
+  return 0;
+}
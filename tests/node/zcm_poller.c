@@ -0,0 +1,228 @@
+#include "zcm/zcm.h"
+#include "zcm/zcm_node.h"
+#include "zcm/zcm_poller.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define PAIRS 3
+#define MANY_TIMERS 1000
+
+static uint64_t now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000u + (uint64_t)(ts.tv_nsec / 1000000);
+}
+
+typedef struct {
+  int fired;
+  int stop_after;
+  uint64_t first_ms;
+} timer_tally_t;
+
+static void on_timer(zcm_poller_t *poller, int timer_id, void *user) {
+  timer_tally_t *t = (timer_tally_t *)user;
+  if (t->fired++ == 0) t->first_ms = now_ms();
+  if (t->stop_after > 0 && t->fired == t->stop_after) {
+    if (zcm_poller_cancel_timer(poller, timer_id) != 0) t->fired = -1000;
+  }
+}
+
+static void count_timer(zcm_poller_t *poller, int timer_id, void *user) {
+  (void)poller;
+  (void)timer_id;
+  (*(int *)user)++;
+}
+
+static int send_int(zcm_socket_t *sock, int v) {
+  zcm_msg_t *msg = zcm_msg_new();
+  if (!msg) return -1;
+  zcm_msg_set_type(msg, "Plain");
+  zcm_msg_put_int(msg, v);
+  int rc = zcm_socket_send_msg(sock, msg);
+  zcm_msg_free(msg);
+  return rc;
+}
+
+static int recv_int(zcm_socket_t *sock, int want) {
+  zcm_msg_t *msg = zcm_msg_new();
+  if (!msg) return -1;
+  int32_t v = -1;
+  int rc = (zcm_socket_recv_msg(sock, msg) == 0 && zcm_msg_get_int(msg, &v) == 0 && v == want)
+               ? 0
+               : -1;
+  zcm_msg_free(msg);
+  return rc;
+}
+
+/* Waits up to 1 s for `sock` alone to show up as readable. */
+static int expect_only(zcm_poller_t *poller, zcm_socket_t *sock, void *user) {
+  zcm_poll_event_t ev[PAIRS + 1];
+  int n = zcm_poller_wait(poller, ev, PAIRS + 1, 1000);
+  if (n != 1 || ev[0].sock != sock || ev[0].fd != -1) return -1;
+  if (ev[0].events != ZCM_POLL_IN || ev[0].user != user) return -1;
+  return 0;
+}
+
+int main(void) {
+  zcm_context_t *ctx = zcm_context_new();
+  zcm_poller_t *poller = zcm_poller_new();
+  if (!ctx || !poller) return 1;
+
+  printf("zcm_poller: connect inproc push/pull pairs\n");
+  zcm_socket_t *pull[PAIRS];
+  zcm_socket_t *push[PAIRS];
+  int tags[PAIRS];
+  for (int i = 0; i < PAIRS; i++) {
+    char ep[64];
+    snprintf(ep, sizeof(ep), "inproc://zcm-poller-%d", i);
+    pull[i] = zcm_socket_new(ctx, ZCM_SOCK_PULL);
+    push[i] = zcm_socket_new(ctx, ZCM_SOCK_PUSH);
+    if (!pull[i] || !push[i]) return 1;
+    if (zcm_socket_bind(pull[i], ep) != 0 || zcm_socket_connect(push[i], ep) != 0) return 1;
+    zcm_socket_set_timeouts(pull[i], 1000);
+    tags[i] = i;
+  }
+
+  printf("zcm_poller: argument checks\n");
+  zcm_poll_event_t ev[PAIRS + 1];
+  if (zcm_poller_add(NULL, pull[0], ZCM_POLL_IN, NULL) == 0) return 1;
+  if (zcm_poller_add(poller, NULL, ZCM_POLL_IN, NULL) == 0) return 1;
+  if (zcm_poller_add(poller, pull[0], 0, NULL) == 0) return 1;
+  if (zcm_poller_add_fd(poller, -1, ZCM_POLL_IN, NULL) == 0) return 1;
+  if (zcm_poller_remove(poller, pull[0]) == 0) return 1;
+  if (zcm_poller_add_timer(poller, -1, 0, on_timer, NULL) >= 0) return 1;
+  if (zcm_poller_add_timer(poller, 0, 0, NULL, NULL) >= 0) return 1;
+  if (zcm_poller_cancel_timer(poller, 1) == 0) return 1;
+  if (zcm_poller_wait(poller, ev, 0, 0) >= 0) return 1;
+  if (zcm_poller_size(NULL) != 0) return 1;
+  zcm_poller_free(NULL);
+
+  printf("zcm_poller: empty wait times out\n");
+  uint64_t t0 = now_ms();
+  if (zcm_poller_wait(poller, ev, PAIRS, 50) != 0) return 1;
+  if (now_ms() - t0 < 45) return 1;
+
+  printf("zcm_poller: readiness reported per socket with its user pointer\n");
+  for (int i = 0; i < PAIRS; i++) {
+    if (zcm_poller_add(poller, pull[i], ZCM_POLL_IN, &tags[i]) != 0) return 1;
+  }
+  if (zcm_poller_add(poller, pull[1], ZCM_POLL_IN, &tags[1]) != 0) return 1; /* update */
+  if (zcm_poller_size(poller) != PAIRS) return 1;
+  if (zcm_poller_wait(poller, ev, PAIRS, 0) != 0) return 1;
+  if (send_int(push[1], 11) != 0) return 1;
+  if (expect_only(poller, pull[1], &tags[1]) != 0) return 1;
+  if (recv_int(pull[1], 11) != 0) return 1;
+
+  printf("zcm_poller: short output array rotates through ready sockets\n");
+  for (int i = 0; i < PAIRS; i++) {
+    if (send_int(push[i], i) != 0) return 1;
+  }
+  int seen[PAIRS] = {0};
+  for (int round = 0; round < PAIRS; round++) {
+    if (zcm_poller_wait(poller, ev, 1, 1000) != 1) return 1;
+    int k = *(int *)ev[0].user;
+    if (seen[k]++) return 1;
+    if (recv_int(pull[k], k) != 0) return 1;
+  }
+
+  printf("zcm_poller: unread batch entries keep the socket readable\n");
+  zcm_msg_t *batch[3];
+  for (int i = 0; i < 3; i++) {
+    batch[i] = zcm_msg_new();
+    if (!batch[i]) return 1;
+    zcm_msg_set_type(batch[i], "Plain");
+    zcm_msg_put_int(batch[i], 20 + i);
+  }
+  if (zcm_socket_send_batch(push[2], (const zcm_msg_t *const *)batch, 3) != 0) return 1;
+  if (expect_only(poller, pull[2], &tags[2]) != 0) return 1;
+  if (recv_int(pull[2], 20) != 0) return 1;
+  /* ØMQ has nothing queued now; the two messages left sit in the socket. */
+  if (expect_only(poller, pull[2], &tags[2]) != 0) return 1;
+  if (recv_int(pull[2], 21) != 0 || recv_int(pull[2], 22) != 0) return 1;
+  if (zcm_poller_wait(poller, ev, PAIRS, 0) != 0) return 1;
+  for (int i = 0; i < 3; i++) zcm_msg_free(batch[i]);
+
+  printf("zcm_poller: plain descriptors and writability\n");
+  int fds[2];
+  if (pipe(fds) != 0) return 1;
+  int fd_tag = 99;
+  if (zcm_poller_add_fd(poller, fds[0], ZCM_POLL_IN, &fd_tag) != 0) return 1;
+  if (write(fds[1], "x", 1) != 1) return 1;
+  if (zcm_poller_wait(poller, ev, PAIRS + 1, 1000) != 1) return 1;
+  if (ev[0].sock || ev[0].fd != fds[0] || ev[0].user != &fd_tag) return 1;
+  if (!(ev[0].events & ZCM_POLL_IN)) return 1;
+  char c;
+  if (read(fds[0], &c, 1) != 1) return 1;
+  if (zcm_poller_remove_fd(poller, fds[0]) != 0 || zcm_poller_remove_fd(poller, fds[0]) == 0)
+    return 1;
+  if (zcm_poller_add(poller, push[0], ZCM_POLL_OUT, NULL) != 0) return 1;
+  if (zcm_poller_wait(poller, ev, PAIRS + 1, 1000) != 1) return 1;
+  if (ev[0].sock != push[0] || ev[0].events != ZCM_POLL_OUT) return 1;
+  if (zcm_poller_remove(poller, push[0]) != 0) return 1;
+
+  printf("zcm_poller: removed sockets are no longer reported\n");
+  if (zcm_poller_remove(poller, pull[0]) != 0 || zcm_poller_size(poller) != PAIRS - 1) return 1;
+  if (send_int(push[0], 5) != 0) return 1;
+  usleep(20 * 1000);
+  if (zcm_poller_wait(poller, ev, PAIRS, 0) != 0) return 1;
+  if (recv_int(pull[0], 5) != 0) return 1;
+
+  printf("zcm_poller: one-shot and repeating timers\n");
+  timer_tally_t once = {0, 0, 0};
+  timer_tally_t every = {0, 5, 0};
+  t0 = now_ms();
+  int once_id = zcm_poller_add_timer(poller, 30, 0, on_timer, &once);
+  int every_id = zcm_poller_add_timer(poller, 5, 10, on_timer, &every);
+  if (once_id <= 0 || every_id <= 0 || once_id == every_id) return 1;
+  uint64_t give_up = now_ms() + 2000;
+  while ((once.fired < 1 || every.fired < 5) && now_ms() < give_up) {
+    if (zcm_poller_wait(poller, ev, PAIRS, -1) != 0) return 1;
+  }
+  if (once.fired != 1 || every.fired != 5) return 1;
+  if (once.first_ms - t0 < 30 || every.first_ms - t0 < 5) return 1;
+  /* Both are gone: the one-shot after firing, the other cancelled itself. */
+  if (zcm_poller_cancel_timer(poller, once_id) == 0) return 1;
+  if (zcm_poller_cancel_timer(poller, every_id) == 0) return 1;
+  if (zcm_poller_wait(poller, ev, PAIRS, 50) != 0 || every.fired != 5) return 1;
+
+  printf("zcm_poller: cancelled timer never fires\n");
+  int cancelled = 0;
+  int id = zcm_poller_add_timer(poller, 10, 0, count_timer, &cancelled);
+  if (id <= 0 || zcm_poller_cancel_timer(poller, id) != 0) return 1;
+  if (zcm_poller_wait(poller, ev, PAIRS, 50) != 0 || cancelled != 0) return 1;
+
+  printf("zcm_poller: a message wakes the wait before a far timer\n");
+  int far = 0;
+  if (zcm_poller_add_timer(poller, 5000, 0, count_timer, &far) <= 0) return 1;
+  t0 = now_ms();
+  if (send_int(push[1], 7) != 0) return 1;
+  if (expect_only(poller, pull[1], &tags[1]) != 0) return 1;
+  if (now_ms() - t0 > 1000 || far != 0) return 1;
+  if (recv_int(pull[1], 7) != 0) return 1;
+
+  printf("zcm_poller: %d timers across several wheel rotations\n", MANY_TIMERS);
+  int many = 0;
+  for (int i = 0; i < MANY_TIMERS; i++) {
+    if (zcm_poller_add_timer(poller, (i * 37) % 1500, 0, count_timer, &many) <= 0) return 1;
+  }
+  give_up = now_ms() + 5000;
+  while (many < MANY_TIMERS && now_ms() < give_up) {
+    if (zcm_poller_wait(poller, ev, PAIRS, 100) < 0) return 1;
+  }
+  if (many != MANY_TIMERS || far != 0) return 1;
+
+  zcm_poller_free(poller);
+  close(fds[0]);
+  close(fds[1]);
+  for (int i = 0; i < PAIRS; i++) {
+    zcm_socket_free(push[i]);
+    zcm_socket_free(pull[i]);
+  }
+  zcm_context_free(ctx);
+  printf("zcm_poller: PASS\n");
+  return 0;
+}
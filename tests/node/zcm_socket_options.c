@@ -0,0 +1,153 @@
+#include "zcm/zcm.h"
+#include "zcm/zcm_node.h"
+#include "zcm/zcm_proc_runtime.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifndef ZCM_SOURCE_DIR
+#define ZCM_SOURCE_DIR "."
+#endif
+
+static int expect_option(zcm_socket_t *sock, zcm_socket_option_t opt, int64_t want) {
+  int64_t v = 0;
+  if (zcm_socket_get_option(sock, opt, &v) != 0) return -1;
+  return (v == want) ? 0 : -1;
+}
+
+static int write_text_file(const char *path, const char *text) {
+  FILE *f = fopen(path, "w");
+  if (!f) return -1;
+  int rc = (fputs(text, f) >= 0) ? 0 : -1;
+  if (fclose(f) != 0) rc = -1;
+  return rc;
+}
+
+static int load_xml(const char *path, const char *xml, zcm_proc_runtime_cfg_t *cfg) {
+  if (write_text_file(path, xml) != 0) return -2;
+  return zcm_proc_runtime_load_config(path, cfg);
+}
+
+int main(void) {
+  zcm_context_t *ctx = zcm_context_new();
+  if (!ctx) return 1;
+  zcm_socket_t *pull = zcm_socket_new(ctx, ZCM_SOCK_PULL);
+  zcm_socket_t *push = zcm_socket_new(ctx, ZCM_SOCK_PUSH);
+  zcm_socket_t *req = zcm_socket_new(ctx, ZCM_SOCK_REQ);
+  if (!pull || !push || !req) return 1;
+
+  printf("zcm_socket_options: argument and range checks\n");
+  int64_t v = 0;
+  if (zcm_socket_set_option(NULL, ZCM_SOCKOPT_SNDHWM, 1) == 0) return 1;
+  if (zcm_socket_set_option(push, (zcm_socket_option_t)0, 1) == 0) return 1;
+  if (zcm_socket_set_option(push, (zcm_socket_option_t)99, 1) == 0) return 1;
+  if (zcm_socket_set_option(push, ZCM_SOCKOPT_SNDHWM, -1) == 0) return 1;
+  if (zcm_socket_set_option(push, ZCM_SOCKOPT_SNDHWM, (int64_t)INT32_MAX + 1) == 0) return 1;
+  if (zcm_socket_set_option(push, ZCM_SOCKOPT_CONFLATE, 2) == 0) return 1;
+  if (zcm_socket_set_option(req, ZCM_SOCKOPT_CONFLATE, 1) == 0) return 1;
+  if (zcm_socket_set_option(push, ZCM_SOCKOPT_TCP_KEEPALIVE, 2) == 0) return 1;
+  if (zcm_socket_set_option(push, ZCM_SOCKOPT_MAXMSGSIZE, -2) == 0) return 1;
+  if (zcm_socket_get_option(push, ZCM_SOCKOPT_SNDHWM, NULL) == 0) return 1;
+  if (zcm_socket_get_option(push, (zcm_socket_option_t)99, &v) == 0) return 1;
+
+  printf("zcm_socket_options: values read back\n");
+  if (zcm_socket_set_option(push, ZCM_SOCKOPT_SNDHWM, 10) != 0) return 1;
+  if (zcm_socket_set_option(pull, ZCM_SOCKOPT_RCVHWM, 20) != 0) return 1;
+  if (zcm_socket_set_option(push, ZCM_SOCKOPT_SNDBUF, 65536) != 0) return 1;
+  if (zcm_socket_set_option(pull, ZCM_SOCKOPT_RCVBUF, 131072) != 0) return 1;
+  if (zcm_socket_set_option(push, ZCM_SOCKOPT_AFFINITY, 1) != 0) return 1;
+  if (zcm_socket_set_option(push, ZCM_SOCKOPT_TCP_KEEPALIVE, 1) != 0) return 1;
+  if (zcm_socket_set_option(pull, ZCM_SOCKOPT_MAXMSGSIZE, 4096) != 0) return 1;
+  if (expect_option(push, ZCM_SOCKOPT_SNDHWM, 10) != 0) return 1;
+  if (expect_option(pull, ZCM_SOCKOPT_RCVHWM, 20) != 0) return 1;
+  if (expect_option(push, ZCM_SOCKOPT_SNDBUF, 65536) != 0) return 1;
+  if (expect_option(pull, ZCM_SOCKOPT_RCVBUF, 131072) != 0) return 1;
+  if (expect_option(push, ZCM_SOCKOPT_AFFINITY, 1) != 0) return 1;
+  if (expect_option(push, ZCM_SOCKOPT_TCP_KEEPALIVE, 1) != 0) return 1;
+  if (expect_option(pull, ZCM_SOCKOPT_MAXMSGSIZE, 4096) != 0) return 1;
+
+  printf("zcm_socket_options: conflate keeps only the latest message\n");
+  /* inproc builds the pipe from the connecting side's options: set both ends. */
+  if (zcm_socket_set_option(pull, ZCM_SOCKOPT_CONFLATE, 1) != 0) return 1;
+  if (zcm_socket_set_option(push, ZCM_SOCKOPT_CONFLATE, 1) != 0) return 1;
+  if (expect_option(pull, ZCM_SOCKOPT_CONFLATE, 1) != 0) return 1;
+  if (zcm_socket_bind(pull, "inproc://zcm-options") != 0) return 1;
+  if (zcm_socket_connect(push, "inproc://zcm-options") != 0) return 1;
+  zcm_socket_set_timeouts(pull, 1000);
+  for (int i = 0; i < 5; i++) {
+    char text[16];
+    snprintf(text, sizeof(text), "v%d", i);
+    if (zcm_socket_send_bytes(push, text, strlen(text)) != 0) return 1;
+  }
+  usleep(50 * 1000);
+  char buf[16];
+  size_t n = 0;
+  if (zcm_socket_recv_bytes(pull, buf, sizeof(buf), &n) != 0) return 1;
+  if (n != 2 || memcmp(buf, "v4", 2) != 0) return 1;
+  zcm_socket_set_timeouts(pull, 50);
+  if (zcm_socket_recv_bytes(pull, buf, sizeof(buf), &n) == 0) return 1;
+
+  printf("zcm_socket_options: dataSocket attributes parsed from config\n");
+  setenv("ZCM_PROC_CONFIG_SCHEMA", ZCM_SOURCE_DIR "/config/schema/proc-config.xsd", 1);
+  char path[] = "/tmp/zcm_socket_options_XXXXXX";
+  int fd = mkstemp(path);
+  if (fd < 0) return 1;
+  close(fd);
+  static zcm_proc_runtime_cfg_t cfg;
+  int rc = load_xml(path,
+                    "<procConfig><process name=\"opts\">\n"
+                    "  <dataSocket type=\"PUB\" sndHwm=\"100\" sndBuf=\"262144\" affinity=\"2\"\n"
+                    "              tcpKeepalive=\"true\" conflate=\"1\"/>\n"
+                    "  <dataSocket type=\"SUB\" targets=\"a,b\" rcvHwm=\"0\" rcvBuf=\"65536\"\n"
+                    "              maxMsgSize=\"1048576\" tcpKeepalive=\"false\"/>\n"
+                    "  <dataSocket type=\"PULL\" target=\"c\"/>\n"
+                    "</process></procConfig>\n",
+                    &cfg);
+  if (rc != 0 || cfg.data_socket_count != 4) return 1;
+  const zcm_proc_data_socket_cfg_t *pub = &cfg.data_sockets[0];
+  if (pub->snd_hwm != 100 || pub->rcv_hwm != -1 || pub->snd_buf != 262144 ||
+      pub->rcv_buf != -1 || pub->affinity != 2 || pub->tcp_keepalive != 1 ||
+      pub->conflate != 1 || pub->max_msg_size != -1) {
+    return 1;
+  }
+  for (int i = 1; i <= 2; i++) {
+    const zcm_proc_data_socket_cfg_t *sub = &cfg.data_sockets[i];
+    if (sub->rcv_hwm != 0 || sub->snd_hwm != -1 || sub->rcv_buf != 65536 ||
+        sub->max_msg_size != 1048576 || sub->tcp_keepalive != 0 || sub->conflate != 0) {
+      return 1;
+    }
+  }
+  const zcm_proc_data_socket_cfg_t *plain = &cfg.data_sockets[3];
+  if (plain->snd_hwm != -1 || plain->rcv_hwm != -1 || plain->snd_buf != -1 ||
+      plain->rcv_buf != -1 || plain->conflate != 0 || plain->affinity != 0 ||
+      plain->tcp_keepalive != -1 || plain->max_msg_size != -1) {
+    return 1;
+  }
+
+  printf("zcm_socket_options: out-of-range attributes rejected\n");
+  if (load_xml(path,
+               "<procConfig><process name=\"opts\">\n"
+               "  <dataSocket type=\"PUB\" sndHwm=\"-5\"/>\n"
+               "</process></procConfig>\n",
+               &cfg) == 0) {
+    return 1;
+  }
+  if (load_xml(path,
+               "<procConfig><process name=\"opts\">\n"
+               "  <dataSocket type=\"PUB\" sndHwm=\"99999999999\"/>\n"
+               "</process></procConfig>\n",
+               &cfg) == 0) {
+    return 1;
+  }
+  unlink(path);
+
+  zcm_socket_free(req);
+  zcm_socket_free(push);
+  zcm_socket_free(pull);
+  zcm_context_free(ctx);
+  printf("zcm_socket_options: PASS\n");
+  return 0;
+}
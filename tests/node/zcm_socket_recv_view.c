@@ -0,0 +1,73 @@
+#include "zcm/zcm.h"
+#include "zcm/zcm_msg.h"
+#include "zcm/zcm_node.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+static int send_sample(zcm_socket_t *push, const char *text) {
+  zcm_msg_t *m = zcm_msg_new();
+  if (!m) return -1;
+  uint8_t blob[4096];
+  for (size_t i = 0; i < sizeof(blob); i++) blob[i] = (uint8_t)(i * 7u);
+  zcm_msg_set_type(m, "View");
+  zcm_msg_put_text(m, text);
+  zcm_msg_put_bytes(m, blob, (uint32_t)sizeof(blob));
+  int rc = zcm_socket_send_msg(push, m);
+  zcm_msg_free(m);
+  return rc;
+}
+
+int main(void) {
+  zcm_context_t *ctx = zcm_context_new();
+  if (!ctx) return 1;
+
+  printf("zcm_socket_recv_view: connect inproc push/pull\n");
+  zcm_socket_t *pull = zcm_socket_new(ctx, ZCM_SOCK_PULL);
+  zcm_socket_t *push = zcm_socket_new(ctx, ZCM_SOCK_PUSH);
+  if (!pull || !push) return 1;
+  if (zcm_socket_bind(pull, "inproc://zcm-recv-view") != 0) return 1;
+  if (zcm_socket_connect(push, "inproc://zcm-recv-view") != 0) return 1;
+  zcm_socket_set_timeouts(pull, 2000);
+
+  printf("zcm_socket_recv_view: receive borrowed view\n");
+  if (send_sample(push, "first") != 0) return 1;
+  zcm_msg_t *msg = zcm_msg_new();
+  if (!msg) return 1;
+  if (zcm_socket_recv_msg_view(pull, msg) != 0) return 1;
+  if (strcmp(zcm_msg_get_type(msg), "View") != 0) return 1;
+
+  const char *text = NULL;
+  uint32_t text_len = 0;
+  const void *bytes = NULL;
+  uint32_t bytes_len = 0;
+  if (zcm_msg_get_text(msg, &text, &text_len) != 0) return 1;
+  if (text_len != 5 || memcmp(text, "first", 5) != 0) return 1;
+  if (zcm_msg_get_bytes(msg, &bytes, &bytes_len) != 0) return 1;
+  if (bytes_len != 4096 || ((const uint8_t *)bytes)[4095] != (uint8_t)(4095u * 7u)) return 1;
+
+  printf("zcm_socket_recv_view: append copies view into owned storage\n");
+  if (zcm_msg_put_int(msg, 99) != 0) return 1;
+  zcm_msg_rewind(msg);
+  int32_t tail = 0;
+  if (zcm_msg_get_text(msg, &text, &text_len) != 0) return 1;
+  if (text_len != 5 || memcmp(text, "first", 5) != 0) return 1;
+  if (zcm_msg_get_bytes(msg, &bytes, &bytes_len) != 0 || bytes_len != 4096) return 1;
+  if (zcm_msg_get_int(msg, &tail) != 0 || tail != 99) return 1;
+
+  printf("zcm_socket_recv_view: reuse message for a second view\n");
+  if (send_sample(push, "second") != 0) return 1;
+  if (zcm_socket_recv_msg_view(pull, msg) != 0) return 1;
+  if (zcm_msg_get_text(msg, &text, &text_len) != 0) return 1;
+  if (text_len != 6 || memcmp(text, "second", 6) != 0) return 1;
+  zcm_msg_reset(msg);
+  if (zcm_msg_remaining(msg) != 0) return 1;
+
+  zcm_msg_free(msg);
+  zcm_socket_free(push);
+  zcm_socket_free(pull);
+  zcm_context_free(ctx);
+  printf("zcm_socket_recv_view: PASS\n");
+  return 0;
+}
@@ -0,0 +1,170 @@
+#include "zcm/zcm.h"
+#include "zcm/zcm_msg.h"
+#include "zcm/zcm_node.h"
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Linked with -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc (see CMakeLists.txt)
+ * to record the largest single allocation made by the library. */
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+static size_t g_largest = 0;
+
+void *__wrap_malloc(size_t size) {
+  if (size > g_largest) g_largest = size;
+  return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t n, size_t size) {
+  if (n * size > g_largest) g_largest = n * size;
+  return __real_calloc(n, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+  if (size > g_largest) g_largest = size;
+  return __real_realloc(ptr, size);
+}
+
+static atomic_int g_released;
+
+static void count_release(void *ctx) {
+  (void)ctx;
+  atomic_fetch_add(&g_released, 1);
+}
+
+/* Version-1 header announcing a payload of `plen` bytes with an empty type. */
+static void forged_header(uint8_t *h, uint32_t plen) {
+  const uint8_t magic[4] = {0x31, 0x4D, 0x43, 0x5A}; /* 'ZCM1' little-endian */
+  memcpy(h, magic, 4);
+  h[4] = 1;
+  h[5] = 0;
+  h[6] = 0;
+  h[7] = 0;
+  for (int i = 0; i < 4; i++) h[8 + i] = (uint8_t)(plen >> (8 * i));
+}
+
+static int check_payload(zcm_msg_t *m, const uint8_t *blob, size_t blob_len,
+                         const double *samples, uint32_t n) {
+  const char *text = NULL;
+  uint32_t text_len = 0;
+  const void *bytes = NULL;
+  uint32_t bytes_len = 0;
+  int32_t tail = 0;
+  zcm_msg_array_type_t t;
+  uint32_t elems = 0;
+  const void *arr = NULL;
+  if (strcmp(zcm_msg_get_type(m), "Acq") != 0) return -1;
+  if (zcm_msg_get_text(m, &text, &text_len) != 0 || text_len != 4) return -1;
+  if (zcm_msg_get_bytes(m, &bytes, &bytes_len) != 0 || bytes_len != blob_len) return -1;
+  if (memcmp(bytes, blob, blob_len) != 0) return -1;
+  if (zcm_msg_get_int(m, &tail) != 0 || tail != 77) return -1;
+  if (zcm_msg_get_array(m, &t, &elems, &arr) != 0) return -1;
+  if (t != ZCM_MSG_ARRAY_DOUBLE || elems != n || memcmp(arr, samples, n * sizeof(double)) != 0)
+    return -1;
+  if (zcm_msg_remaining(m) != 0) return -1;
+  return 0;
+}
+
+int main(void) {
+  static uint8_t blob[256 * 1024];
+  for (size_t i = 0; i < sizeof(blob); i++) blob[i] = (uint8_t)(i * 13u);
+  double samples[64];
+  for (int i = 0; i < 64; i++) samples[i] = i * 0.25;
+
+  zcm_context_t *ctx = zcm_context_new();
+  if (!ctx) return 1;
+
+  printf("zcm_socket_send_ref: connect inproc push/pull\n");
+  zcm_socket_t *pull = zcm_socket_new(ctx, ZCM_SOCK_PULL);
+  zcm_socket_t *push = zcm_socket_new(ctx, ZCM_SOCK_PUSH);
+  if (!pull || !push) return 1;
+  if (zcm_socket_bind(pull, "inproc://zcm-send-ref") != 0) return 1;
+  if (zcm_socket_connect(push, "inproc://zcm-send-ref") != 0) return 1;
+  zcm_socket_set_timeouts(pull, 2000);
+
+  zcm_msg_t *out = zcm_msg_new();
+  zcm_msg_t *in = zcm_msg_new();
+  if (!out || !in) return 1;
+  zcm_msg_set_type(out, "Acq");
+  if (zcm_msg_put_text(out, "scan") != 0) return 1;
+  if (zcm_msg_put_bytes_ref(out, blob, (uint32_t)sizeof(blob), count_release, NULL) != 0)
+    return 1;
+  if (zcm_msg_put_int(out, 77) != 0) return 1;
+  if (zcm_msg_put_array_ref(out, ZCM_MSG_ARRAY_DOUBLE, 64, samples, count_release, NULL) != 0)
+    return 1;
+
+  printf("zcm_socket_send_ref: multipart send is reassembled\n");
+  if (zcm_socket_send_msg(push, out) != 0) return 1;
+  if (zcm_socket_send_msg(push, out) != 0) return 1;
+  if (zcm_socket_recv_msg(pull, in) != 0) return 1;
+  if (check_payload(in, blob, sizeof(blob), samples, 64) != 0) return 1;
+  if (zcm_socket_recv_msg_view(pull, in) != 0) return 1;
+  if (check_payload(in, blob, sizeof(blob), samples, 64) != 0) return 1;
+
+  printf("zcm_socket_send_ref: plain message follows on the same socket\n");
+  zcm_msg_t *plain = zcm_msg_new();
+  if (!plain) return 1;
+  zcm_msg_set_type(plain, "Plain");
+  zcm_msg_put_int(plain, 5);
+  if (zcm_socket_send_msg(push, plain) != 0) return 1;
+  if (zcm_socket_recv_msg(pull, in) != 0 || strcmp(zcm_msg_get_type(in), "Plain") != 0) return 1;
+
+  printf("zcm_socket_send_ref: forged multipart header does not size the buffer\n");
+  uint8_t header[12];
+  forged_header(header, 0xFFFFFFF0u);
+  zcm_iov_t forged[2] = {
+    {header, sizeof(header), NULL, NULL},
+    {"tiny", 4, NULL, NULL},
+  };
+  g_largest = 0;
+  if (zcm_socket_send_frames(push, forged, 2, 0) != 0) return 1;
+  if (zcm_socket_recv_msg(pull, in) == 0) return 1;
+  if (zcm_socket_send_frames(push, forged, 2, 0) != 0) return 1;
+  if (zcm_socket_recv_msg_view(pull, in) == 0) return 1;
+  if (g_largest >= 1024 * 1024) return 1;
+  if (zcm_socket_send_msg(push, plain) != 0) return 1;
+  if (zcm_socket_recv_msg(pull, in) != 0 || strcmp(zcm_msg_get_type(in), "Plain") != 0) return 1;
+
+  printf("zcm_socket_send_ref: announced total above the socket limit is rejected\n");
+  if (zcm_socket_set_option(pull, ZCM_SOCKOPT_MAXMSGSIZE, 64 * 1024) != 0) return 1;
+  if (zcm_socket_send_msg(push, out) != 0) return 1;
+  if (zcm_socket_recv_msg(pull, in) == 0) return 1;
+  if (zcm_socket_set_option(pull, ZCM_SOCKOPT_MAXMSGSIZE, -1) != 0) return 1;
+  if (zcm_socket_send_msg(push, out) != 0) return 1;
+  if (zcm_socket_recv_msg(pull, in) != 0) return 1;
+  if (check_payload(in, blob, sizeof(blob), samples, 64) != 0) return 1;
+
+  printf("zcm_socket_send_ref: buffers are released once\n");
+  if (atomic_load(&g_released) != 0) return 1;
+  zcm_msg_reset(out);
+  if (atomic_load(&g_released) != 2) return 1;
+
+  printf("zcm_socket_send_ref: reading a referencing message copies it\n");
+  zcm_msg_set_type(out, "Acq");
+  zcm_msg_put_text(out, "scan");
+  zcm_msg_put_bytes_ref(out, blob, (uint32_t)sizeof(blob), count_release, NULL);
+  zcm_msg_put_int(out, 77);
+  zcm_msg_put_array_ref(out, ZCM_MSG_ARRAY_DOUBLE, 64, samples, count_release, NULL);
+  /* Plain validation is read-only and keeps the references in place. */
+  if (zcm_msg_validate(out) != 0) return 1;
+  if (zcm_msg_data(out, NULL) != NULL) return 1; /* not contiguous yet */
+  if (atomic_load(&g_released) != 2) return 1;
+  if (zcm_msg_validate_index(out) != 0) return 1;
+  if (atomic_load(&g_released) != 4) return 1;
+  if (check_payload(out, blob, sizeof(blob), samples, 64) != 0) return 1;
+
+  zcm_msg_free(plain);
+  zcm_msg_free(out);
+  zcm_msg_free(in);
+  zcm_socket_free(push);
+  zcm_socket_free(pull);
+  zcm_context_free(ctx);
+  printf("zcm_socket_send_ref: PASS\n");
+  return 0;
+}
@@ -0,0 +1,160 @@
+#include "zcm/zcm.h"
+#include "zcm/zcm_msg.h"
+#include "zcm/zcm_node.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+extern int zcm_msg__serialize_id(const zcm_msg_t *, const void **, size_t *, void **);
+
+static int send_typed(zcm_socket_t *push, const char *type, int32_t v) {
+  zcm_msg_t *m = zcm_msg_new();
+  if (!m) return -1;
+  zcm_msg_set_type(m, type);
+  zcm_msg_put_int(m, v);
+  int rc = zcm_socket_send_msg(push, m);
+  zcm_msg_free(m);
+  return rc;
+}
+
+typedef struct {
+  const void *env;
+  size_t env_len;
+  atomic_int *stop;
+  int bad;
+} reader_t;
+
+/* Decode a compact envelope in a loop while the main thread interns names. */
+static void *reader_main(void *arg) {
+  reader_t *r = (reader_t *)arg;
+  zcm_msg_t *m = zcm_msg_new();
+  if (!m) {
+    r->bad = 1;
+    return NULL;
+  }
+  do {
+    if (zcm_msg_from_bytes(m, r->env, r->env_len) != 0 ||
+        strcmp(zcm_msg_get_type(m), "SAMPLE") != 0) {
+      r->bad = 1;
+      break;
+    }
+  } while (!atomic_load(r->stop));
+  zcm_msg_free(m);
+  return NULL;
+}
+
+int main(void) {
+  printf("zcm_socket_type_ids: stable hash and interning\n");
+  uint32_t id = 0;
+  if (zcm_msg_type_id("ZCM_CMD") != 0x7b990e1eu) return 1;
+  if (zcm_msg_type_intern("SAMPLE", &id) != 0 || id != zcm_msg_type_id("SAMPLE")) return 1;
+  if (zcm_msg_type_intern("SAMPLE", NULL) != 0) return 1;
+  char name[64];
+  if (zcm_msg_type_name(id, name, sizeof(name)) != 0 || strcmp(name, "SAMPLE") != 0) return 1;
+  if (zcm_msg_type_name(zcm_msg_type_id("NEVER_INTERNED"), name, sizeof(name)) !=
+      ZCM_MSG_ERR_TYPE) return 1;
+
+  printf("zcm_socket_type_ids: compact envelope round trip\n");
+  zcm_msg_t *m = zcm_msg_new();
+  zcm_msg_t *in = zcm_msg_new();
+  if (!m || !in) return 1;
+  zcm_msg_set_type(m, "SAMPLE");
+  zcm_msg_put_int(m, 42);
+  if (zcm_msg_get_type_id(m) != id) return 1;
+  const void *data = NULL;
+  size_t len = 0;
+  void *owned = NULL;
+  if (zcm_msg__serialize_id(m, &data, &len, &owned) != 0) return 1;
+  if (len != 16 + 5) return 1;
+  if (zcm_msg_from_bytes(in, data, len) != 0) return 1;
+  free(owned);
+  if (strcmp(zcm_msg_get_type(in), "SAMPLE") != 0 || zcm_msg_get_type_id(in) != id) return 1;
+  int32_t v = 0;
+  if (zcm_msg_get_int(in, &v) != 0 || v != 42) return 1;
+
+  printf("zcm_socket_type_ids: socket sends compact envelopes\n");
+  zcm_context_t *ctx = zcm_context_new();
+  if (!ctx) return 1;
+  zcm_socket_t *pull = zcm_socket_new(ctx, ZCM_SOCK_PULL);
+  zcm_socket_t *push = zcm_socket_new(ctx, ZCM_SOCK_PUSH);
+  if (!pull || !push) return 1;
+  if (zcm_socket_bind(pull, "inproc://zcm-type-ids") != 0) return 1;
+  if (zcm_socket_connect(push, "inproc://zcm-type-ids") != 0) return 1;
+  zcm_socket_set_timeouts(pull, 2000);
+  if (zcm_socket_set_type_ids(push, 1) != 0) return 1;
+
+  if (send_typed(push, "SAMPLE", 7) != 0) return 1;
+  if (zcm_socket_recv_msg(pull, in) != 0) return 1;
+  if (strcmp(zcm_msg_get_type(in), "SAMPLE") != 0) return 1;
+  if (zcm_msg_get_int(in, &v) != 0 || v != 7) return 1;
+
+  printf("zcm_socket_type_ids: unknown IDs dispatch by number\n");
+  if (send_typed(push, "UNLISTED", 8) != 0) return 1;
+  if (zcm_socket_recv_msg_view(pull, in) != 0) return 1;
+  if (zcm_msg_get_type_id(in) != zcm_msg_type_id("UNLISTED")) return 1;
+  snprintf(name, sizeof(name), "#%08x", zcm_msg_type_id("UNLISTED"));
+  if (strcmp(zcm_msg_get_type(in), name) != 0) return 1;
+
+  printf("zcm_socket_type_ids: control messages match by ID\n");
+  zcm_msg_t *reply = zcm_msg_new();
+  if (!reply) return 1;
+  zcm_msg_reset(m);
+  zcm_msg_set_type(m, "ZCM_CMD");
+  zcm_msg_put_text(m, "PING");
+  if (zcm_socket_send_msg(push, m) != 0) return 1;
+  if (zcm_socket_recv_msg(pull, in) != 0) return 1;
+  int should_exit = 0;
+  if (zcm_node_handle_control_msg(in, reply, &should_exit) != 1) return 1;
+  const char *text = NULL;
+  uint32_t text_len = 0;
+  if (zcm_msg_get_text(reply, &text, &text_len) != 0 || memcmp(text, "PONG", 4) != 0) return 1;
+
+  printf("zcm_socket_type_ids: batches carry compact entries\n");
+  if (zcm_socket_set_coalesce(push, 1000, 1u << 20) != 0) return 1;
+  if (send_typed(push, "SAMPLE", 1) != 0 || send_typed(push, "SAMPLE", 2) != 0) return 1;
+  if (zcm_socket_flush(push) != 0) return 1;
+  for (int32_t want = 1; want <= 2; want++) {
+    if (zcm_socket_recv_msg(pull, in) != 0) return 1;
+    if (strcmp(zcm_msg_get_type(in), "SAMPLE") != 0) return 1;
+    if (zcm_msg_get_int(in, &v) != 0 || v != want) return 1;
+  }
+
+  printf("zcm_socket_type_ids: lookups race with table growth\n");
+  zcm_msg_reset(m);
+  zcm_msg_set_type(m, "SAMPLE");
+  zcm_msg_put_int(m, 1);
+  if (zcm_msg__serialize_id(m, &data, &len, &owned) != 0) return 1;
+  atomic_int stop = 0;
+  reader_t readers[4];
+  pthread_t threads[4];
+  for (int i = 0; i < 4; i++) {
+    readers[i] = (reader_t){data, len, &stop, 0};
+    if (pthread_create(&threads[i], NULL, reader_main, &readers[i]) != 0) return 1;
+  }
+  for (int i = 0; i < 2000; i++) {
+    char type[32];
+    snprintf(type, sizeof(type), "GROW_%d", i);
+    if (zcm_msg_type_intern(type, NULL) != 0) return 1;
+  }
+  atomic_store(&stop, 1);
+  for (int i = 0; i < 4; i++) {
+    pthread_join(threads[i], NULL);
+    if (readers[i].bad) return 1;
+  }
+  free(owned);
+  if (zcm_msg_type_name(zcm_msg_type_id("GROW_1999"), name, sizeof(name)) != 0 ||
+      strcmp(name, "GROW_1999") != 0) return 1;
+
+  zcm_msg_free(reply);
+  zcm_msg_free(in);
+  zcm_msg_free(m);
+  zcm_socket_free(push);
+  zcm_socket_free(pull);
+  zcm_context_free(ctx);
+  printf("zcm_socket_type_ids: PASS\n");
+  return 0;
+}
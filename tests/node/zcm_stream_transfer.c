@@ -0,0 +1,231 @@
+#include "zcm/zcm.h"
+#include "zcm/zcm_node.h"
+#include "zcm/zcm_stream.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define BYTES_TOTAL ((size_t)3 << 20)
+#define BYTES_CHUNK ((size_t)64 << 10)
+#define BYTES_WINDOW 4u
+#define ARRAY_ELEMS 200000u
+
+typedef struct {
+  zcm_socket_t *data;
+  zcm_socket_t *ack;
+  atomic_size_t written; /* bytes accepted by zcm_stream_write() so far */
+  int rc;
+} writer_job_t;
+
+static uint8_t pattern_at(uint64_t i) {
+  return (uint8_t)((i * 131u) ^ (i >> 9));
+}
+
+static void *bytes_writer(void *arg) {
+  writer_job_t *job = (writer_job_t *)arg;
+  zcm_stream_opts_t opts = {BYTES_CHUNK, BYTES_WINDOW};
+  zcm_stream_writer_t *w = zcm_stream_writer_new(job->data, job->ack, "frame",
+                                                 0, BYTES_TOTAL, &opts);
+  job->rc = -1;
+  if (!w) return NULL;
+  /* Odd-sized writes so chunks straddle write boundaries. */
+  uint8_t buf[40000];
+  size_t off = 0;
+  while (off < BYTES_TOTAL) {
+    size_t n = BYTES_TOTAL - off;
+    if (n > sizeof(buf)) n = sizeof(buf);
+    for (size_t i = 0; i < n; i++) buf[i] = pattern_at(off + i);
+    if (zcm_stream_write(w, buf, n) != 0) goto out;
+    off += n;
+    atomic_store(&job->written, off);
+  }
+  job->rc = zcm_stream_writer_finish(w);
+out:
+  zcm_stream_writer_free(w);
+  return NULL;
+}
+
+static void *array_writer(void *arg) {
+  writer_job_t *job = (writer_job_t *)arg;
+  zcm_stream_opts_t opts = {10000, 2};
+  zcm_stream_writer_t *w = zcm_stream_writer_new(job->data, NULL, "samples", ZCM_MSG_ARRAY_UINT32,
+                                                 ZCM_STREAM_SIZE_UNKNOWN, &opts);
+  job->rc = -1;
+  if (!w) return NULL;
+  uint32_t block[1000];
+  for (uint32_t base = 0; base < ARRAY_ELEMS; base += 1000) {
+    for (uint32_t i = 0; i < 1000; i++) block[i] = base + i;
+    if (zcm_stream_write(w, block, sizeof(block)) != 0) goto out;
+  }
+  if (zcm_stream_write(w, block, 3) == 0) goto out; /* partial element */
+  job->rc = zcm_stream_writer_finish(w);
+out:
+  zcm_stream_writer_free(w);
+  return NULL;
+}
+
+/* Hand-built protocol messages, as a misbehaving peer would send them. */
+static int send_open(zcm_socket_t *sock, int64_t total) {
+  zcm_msg_t *m = zcm_msg_new();
+  if (!m) return -1;
+  zcm_msg_set_type(m, "ZCM_STREAM_OPEN");
+  zcm_msg_put_long(m, 7);
+  zcm_msg_put_long(m, 0);
+  zcm_msg_put_long(m, total);
+  zcm_msg_put_char(m, 0);
+  zcm_msg_put_int(m, 16);
+  zcm_msg_put_int(m, 4);
+  zcm_msg_put_char(m, 0);
+  zcm_msg_put_text(m, "forged");
+  int rc = zcm_socket_send_msg(sock, m);
+  zcm_msg_free(m);
+  return rc;
+}
+
+static int send_chunk(zcm_socket_t *sock, int64_t seq, int64_t offset, size_t len, int last) {
+  uint8_t body[16] = {0};
+  zcm_msg_t *m = zcm_msg_new();
+  if (!m || len > sizeof(body)) return -1;
+  zcm_msg_set_type(m, "ZCM_STREAM");
+  zcm_msg_put_long(m, 7);
+  zcm_msg_put_long(m, seq);
+  zcm_msg_put_long(m, offset);
+  zcm_msg_put_char(m, last ? 1 : 0);
+  zcm_msg_put_bytes(m, body, (uint32_t)len);
+  int rc = zcm_socket_send_msg(sock, m);
+  zcm_msg_free(m);
+  return rc;
+}
+
+/* Sends a header declaring 10 bytes, one good 4-byte chunk, then `bad`. */
+static int expect_rejected(zcm_socket_t *push, zcm_socket_t *pull, int64_t bad_offset,
+                           size_t bad_len, int bad_last) {
+  if (send_open(push, 10) != 0 || send_chunk(push, 1, 0, 4, 0) != 0) return -1;
+  if (send_chunk(push, 2, bad_offset, bad_len, bad_last) != 0) return -1;
+  zcm_stream_reader_t *r = zcm_stream_reader_new(pull, NULL);
+  if (!r) return -1;
+  zcm_stream_chunk_t chunk;
+  int rc = -1;
+  if (zcm_stream_read_chunk(r, &chunk) == 1 && chunk.offset == 0 && chunk.len == 4 &&
+      zcm_stream_read_chunk(r, &chunk) == -1) {
+    rc = 0;
+  }
+  zcm_stream_reader_free(r);
+  return rc;
+}
+
+int main(void) {
+  zcm_context_t *ctx = zcm_context_new();
+  if (!ctx) return 1;
+
+  printf("zcm_stream_transfer: PUSH/PULL with acknowledgement window\n");
+  zcm_socket_t *pull = zcm_socket_new(ctx, ZCM_SOCK_PULL);
+  zcm_socket_t *push = zcm_socket_new(ctx, ZCM_SOCK_PUSH);
+  zcm_socket_t *ack_pull = zcm_socket_new(ctx, ZCM_SOCK_PULL);
+  zcm_socket_t *ack_push = zcm_socket_new(ctx, ZCM_SOCK_PUSH);
+  if (!pull || !push || !ack_pull || !ack_push) return 1;
+  if (zcm_socket_bind(pull, "inproc://zcm-stream-data") != 0) return 1;
+  if (zcm_socket_connect(push, "inproc://zcm-stream-data") != 0) return 1;
+  if (zcm_socket_bind(ack_pull, "inproc://zcm-stream-ack") != 0) return 1;
+  if (zcm_socket_connect(ack_push, "inproc://zcm-stream-ack") != 0) return 1;
+  zcm_socket_set_timeouts(pull, 5000);
+  zcm_socket_set_timeouts(ack_pull, 5000);
+
+  writer_job_t job = {push, ack_pull, 0, -1};
+  pthread_t th;
+  if (pthread_create(&th, NULL, bytes_writer, &job) != 0) return 1;
+
+  zcm_stream_reader_t *r = zcm_stream_reader_new(pull, ack_push);
+  if (!r) return 1;
+  zcm_stream_chunk_t chunk;
+  uint64_t expect = 0;
+  int rc = 0;
+  int ahead_ok = 1;
+  while ((rc = zcm_stream_read_chunk(r, &chunk)) == 1) {
+    if (chunk.offset != expect) return 1;
+    const uint8_t *p = (const uint8_t *)chunk.data;
+    for (size_t i = 0; i < chunk.len; i++) {
+      if (p[i] != pattern_at(expect + i)) return 1;
+    }
+    expect += chunk.len;
+    /* The writer may only run a window (plus its staging chunk) ahead. */
+    size_t written = atomic_load(&job.written);
+    if (written > expect + (BYTES_WINDOW + 2) * BYTES_CHUNK) ahead_ok = 0;
+    if ((expect / BYTES_CHUNK) % 8 == 0) usleep(2000);
+  }
+  pthread_join(th, NULL);
+  if (rc != 0 || job.rc != 0 || expect != BYTES_TOTAL || !ahead_ok) return 1;
+  const zcm_stream_info_t *info = zcm_stream_reader_info(r);
+  if (!info || strcmp(info->name, "frame") != 0 || info->total != BYTES_TOTAL) return 1;
+  if (info->chunk_size != BYTES_CHUNK || info->window != BYTES_WINDOW) return 1;
+  if (zcm_stream_read_chunk(r, &chunk) != 0) return 1;
+  zcm_stream_reader_free(r);
+
+  printf("zcm_stream_transfer: REQ/REP array stream into a file\n");
+  zcm_socket_t *rep = zcm_socket_new(ctx, ZCM_SOCK_REP);
+  zcm_socket_t *req = zcm_socket_new(ctx, ZCM_SOCK_REQ);
+  if (!rep || !req) return 1;
+  if (zcm_socket_bind(rep, "inproc://zcm-stream-rep") != 0) return 1;
+  if (zcm_socket_connect(req, "inproc://zcm-stream-rep") != 0) return 1;
+  zcm_socket_set_timeouts(rep, 5000);
+  zcm_socket_set_timeouts(req, 5000);
+  if (zcm_stream_writer_new(req, ack_pull, NULL, 0, 0, NULL) != NULL) return 1;
+
+  char path[] = "/tmp/zcm_stream_transferXXXXXX";
+  int fd = mkstemp(path);
+  if (fd < 0) return 1;
+  close(fd);
+
+  writer_job_t ajob = {req, NULL, 0, -1};
+  if (pthread_create(&th, NULL, array_writer, &ajob) != 0) return 1;
+  r = zcm_stream_reader_new(rep, NULL);
+  if (!r) return 1;
+  rc = zcm_stream_read_to_file(r, path);
+  pthread_join(th, NULL);
+  if (rc != 0 || ajob.rc != 0) return 1;
+  info = zcm_stream_reader_info(r);
+  if (!info || info->elem_type != ZCM_MSG_ARRAY_UINT32 || info->chunk_size != 10000) return 1;
+  if (info->total != ZCM_STREAM_SIZE_UNKNOWN) return 1;
+  zcm_stream_reader_free(r);
+
+  FILE *f = fopen(path, "rb");
+  if (!f) return 1;
+  uint32_t v = 0;
+  uint32_t n = 0;
+  while (fread(&v, sizeof(v), 1, f) == 1) {
+    if (v != n) return 1;
+    n++;
+  }
+  fclose(f);
+  unlink(path);
+  if (n != ARRAY_ELEMS) return 1;
+
+  printf("zcm_stream_transfer: out-of-place and oversized chunks are rejected\n");
+  zcm_socket_t *fpush = zcm_socket_new(ctx, ZCM_SOCK_PUSH);
+  zcm_socket_t *fpull = zcm_socket_new(ctx, ZCM_SOCK_PULL);
+  if (!fpush || !fpull) return 1;
+  if (zcm_socket_bind(fpull, "inproc://zcm-stream-forged") != 0) return 1;
+  if (zcm_socket_connect(fpush, "inproc://zcm-stream-forged") != 0) return 1;
+  zcm_socket_set_timeouts(fpull, 2000);
+  if (expect_rejected(fpush, fpull, 1 << 30, 4, 0) != 0) return 1; /* far offset */
+  if (expect_rejected(fpush, fpull, 0, 4, 0) != 0) return 1;       /* overlap */
+  if (expect_rejected(fpush, fpull, 4, 8, 1) != 0) return 1;       /* past total */
+  if (expect_rejected(fpush, fpull, 4, 2, 1) != 0) return 1;       /* short of total */
+  zcm_socket_free(fpush);
+  zcm_socket_free(fpull);
+
+  zcm_socket_free(req);
+  zcm_socket_free(rep);
+  zcm_socket_free(ack_push);
+  zcm_socket_free(ack_pull);
+  zcm_socket_free(push);
+  zcm_socket_free(pull);
+  zcm_context_free(ctx);
+  printf("zcm_stream_transfer: PASS\n");
+  return 0;
+}
@@ -26,6 +26,8 @@ static void usage(const char *prog) {
           "(-t TEXT | -d DOUBLE | -f FLOAT | -i INTEGER |\n"
           "                       -c CHAR | -s SHORT | -l LONG | -b BYTES | -a ARRAY_SPEC)+\n"
           "    ARRAY_SPEC: char:v1,v2 | short:v1,v2 | int:v1,v2 | float:v1,v2 | double:v1,v2\n"
+          "                | int64|uint8|uint16|uint32|uint64:v1,v2\n"
+          "                (integer types accept a +delta suffix, e.g. uint32+delta:v1,v2)\n"
           "  %s kill NAME\n"
           "  %s ping NAME\n"
           "  %s broker [ping|stop|list]\n",
@@ -219,27 +221,28 @@ static int query_proc_command_once(zcm_context_t *ctx, const char *endpoint,
   zcm_socket_set_timeouts(req, names_query_timeout_ms());
   if (zcm_socket_connect(req, endpoint) != 0) goto out;
 
-  zcm_msg_t *q = zcm_msg_new();
+  zcm_msg_pool_t *pool = zcm_msg_pool_thread();
+  zcm_msg_t *q = zcm_msg_pool_acquire(pool);
   if (!q) goto out;
   zcm_msg_set_type(q, "ZCM_CMD");
   if (zcm_msg_put_text(q, cmd) != 0) {
-    zcm_msg_free(q);
+    zcm_msg_pool_release(pool, q);
     goto out;
   }
   if (include_code_field && zcm_msg_put_int(q, 200) != 0) {
-    zcm_msg_free(q);
+    zcm_msg_pool_release(pool, q);
     goto out;
   }
   if (zcm_socket_send_msg(req, q) != 0) {
-    zcm_msg_free(q);
+    zcm_msg_pool_release(pool, q);
     goto out;
   }
-  zcm_msg_free(q);
+  zcm_msg_pool_release(pool, q);
 
-  zcm_msg_t *reply = zcm_msg_new();
+  zcm_msg_t *reply = zcm_msg_pool_acquire(pool);
   if (!reply) goto out;
-  if (zcm_socket_recv_msg(req, reply) != 0) {
-    zcm_msg_free(reply);
+  if (zcm_socket_recv_msg_view(req, reply) != 0) {
+    zcm_msg_pool_release(pool, reply);
     goto out;
   }
 
@@ -270,7 +273,7 @@ static int query_proc_command_once(zcm_context_t *ctx, const char *endpoint,
     }
   }
 
-  zcm_msg_free(reply);
+  zcm_msg_pool_release(pool, reply);
 
 out:
   zcm_socket_free(req);
@@ -1318,24 +1321,28 @@ static void names_rows_apply_subscriber_info_overrides(zcm_node_t *node,
                                                        zcm_node_entry_t *entries,
                                                        names_row_info_t *rows,
                                                        size_t count) {
-  if (!node || !entries || !rows) return;
-
+  if (!node || !entries || !rows || count == 0) return;
+
+  /* Resolve all candidates with one LOOKUP_MANY exchange. */
+  const char **names = (const char **)calloc(count, sizeof(*names));
+  size_t *name_rows = (size_t *)calloc(count, sizeof(*name_rows));
+  zcm_node_record_t *recs = (zcm_node_record_t *)calloc(count, sizeof(*recs));
+  size_t name_count = 0;
+  if (!names || !name_rows || !recs) goto out;
   for (size_t i = 0; i < count; i++) {
     if (!row_is_subscriber_candidate(&entries[i], &rows[i])) continue;
     if (!entries[i].name || !entries[i].name[0]) continue;
+    names[name_count] = entries[i].name;
+    name_rows[name_count++] = i;
+  }
+  if (name_count == 0 || zcm_node_resolve_many(node, names, name_count, recs) <= 0) goto out;
 
-    char info_ep[512] = {0};
-    char info_ctrl_ep[512] = {0};
-    char info_host[256] = {0};
-    int info_pid = 0;
-    if (zcm_node_info(node, entries[i].name,
-                      info_ep, sizeof(info_ep),
-                      info_ctrl_ep, sizeof(info_ctrl_ep),
-                      info_host, sizeof(info_host),
-                      &info_pid) != 0) {
-      continue;
-    }
-    (void)info_pid;
+  for (size_t r = 0; r < name_count; r++) {
+    size_t i = name_rows[r];
+    if (!recs[r].endpoint[0]) continue;
+    const char *info_ep = recs[r].endpoint;
+    const char *info_ctrl_ep = recs[r].ctrl_endpoint;
+    const char *info_host = recs[r].host;
 
     if (info_ep[0]) {
       snprintf(rows[i].ctrl_endpoint, sizeof(rows[i].ctrl_endpoint), "%s", info_ep);
@@ -1385,6 +1392,11 @@ static void names_rows_apply_subscriber_info_overrides(zcm_node_t *node,
       }
     }
   }
+
+out:
+  free(recs);
+  free(name_rows);
+  free(names);
 }
 
 static size_t role_collect_sub_variants(const char *role_display,
@@ -1968,6 +1980,18 @@ static int parse_int64_str(const char *text, int64_t *out) {
   return 0;
 }
 
+static int parse_uint64_str(const char *text, uint64_t max, uint64_t *out) {
+  if (!text || !out) return -1;
+  if (strchr(text, '-')) return -1;
+  char *end = NULL;
+  errno = 0;
+  unsigned long long v = strtoull(text, &end, 10);
+  if (!end || end == text || *end != '\0' || errno == ERANGE) return -1;
+  if (v > max) return -1;
+  *out = (uint64_t)v;
+  return 0;
+}
+
 static int parse_char_str(const char *text, char *out) {
   if (!text || !out) return -1;
   size_t n = strlen(text);
@@ -2012,27 +2036,36 @@ static void trim_ws_inplace(char *text) {
   }
 }
 
-static int parse_array_type(const char *text, zcm_msg_array_type_t *out) {
-  if (!text || !out) return -1;
-  if (strcasecmp(text, "char") == 0) {
-    *out = ZCM_MSG_ARRAY_CHAR;
-    return 0;
-  }
-  if (strcasecmp(text, "short") == 0) {
-    *out = ZCM_MSG_ARRAY_SHORT;
-    return 0;
-  }
-  if (strcasecmp(text, "int") == 0) {
-    *out = ZCM_MSG_ARRAY_INT;
-    return 0;
-  }
-  if (strcasecmp(text, "float") == 0) {
-    *out = ZCM_MSG_ARRAY_FLOAT;
-    return 0;
-  }
-  if (strcasecmp(text, "double") == 0) {
-    *out = ZCM_MSG_ARRAY_DOUBLE;
-    return 0;
+static int parse_array_type(const char *text, zcm_msg_array_type_t *out, int *delta) {
+  if (!text || !out || !delta) return -1;
+  static const struct {
+    const char *name;
+    zcm_msg_array_type_t type;
+  } k_types[] = {
+    {"char", ZCM_MSG_ARRAY_CHAR},     {"short", ZCM_MSG_ARRAY_SHORT},
+    {"int", ZCM_MSG_ARRAY_INT},       {"float", ZCM_MSG_ARRAY_FLOAT},
+    {"double", ZCM_MSG_ARRAY_DOUBLE}, {"int64", ZCM_MSG_ARRAY_INT64},
+    {"uint8", ZCM_MSG_ARRAY_UINT8},   {"uint16", ZCM_MSG_ARRAY_UINT16},
+    {"uint32", ZCM_MSG_ARRAY_UINT32}, {"uint64", ZCM_MSG_ARRAY_UINT64},
+  };
+
+  size_t n = strlen(text);
+  *delta = 0;
+  const char *plus = strchr(text, '+');
+  if (plus) {
+    if (strcasecmp(plus + 1, "delta") != 0) return -1;
+    *delta = 1;
+    n = (size_t)(plus - text);
+  }
+  for (size_t i = 0; i < sizeof(k_types) / sizeof(k_types[0]); i++) {
+    if (strlen(k_types[i].name) == n && strncasecmp(text, k_types[i].name, n) == 0) {
+      if (*delta && (k_types[i].type == ZCM_MSG_ARRAY_FLOAT ||
+                     k_types[i].type == ZCM_MSG_ARRAY_DOUBLE)) {
+        return -1;
+      }
+      *out = k_types[i].type;
+      return 0;
+    }
   }
   return -1;
 }
@@ -2044,6 +2077,11 @@ static size_t array_elem_size(zcm_msg_array_type_t type) {
     case ZCM_MSG_ARRAY_INT: return 4;
     case ZCM_MSG_ARRAY_FLOAT: return 4;
     case ZCM_MSG_ARRAY_DOUBLE: return 8;
+    case ZCM_MSG_ARRAY_INT64: return 8;
+    case ZCM_MSG_ARRAY_UINT8: return 1;
+    case ZCM_MSG_ARRAY_UINT16: return 2;
+    case ZCM_MSG_ARRAY_UINT32: return 4;
+    case ZCM_MSG_ARRAY_UINT64: return 8;
     default: return 0;
   }
 }
@@ -2074,12 +2112,15 @@ static int set_payload_array(zcm_msg_t *msg, const char *spec) {
   trim_ws_inplace(type_text);
 
   zcm_msg_array_type_t array_type;
-  if (parse_array_type(type_text, &array_type) != 0) return -1;
+  int delta = 0;
+  if (parse_array_type(type_text, &array_type, &delta) != 0) return -1;
+  int (*put)(zcm_msg_t *, zcm_msg_array_type_t, uint32_t, const void *) =
+      delta ? zcm_msg_put_array_delta : zcm_msg_put_array;
 
   const char *items_text = sep + 1;
   while (*items_text && isspace((unsigned char)*items_text)) items_text++;
   if (*items_text == '\0') {
-    return zcm_msg_put_array(msg, array_type, 0, NULL);
+    return put(msg, array_type, 0, NULL);
   }
 
   char *list = strdup(items_text);
@@ -2132,6 +2173,36 @@ static int set_payload_array(zcm_msg_t *msg, const char *spec) {
         ((double *)items)[count] = v;
         break;
       }
+      case ZCM_MSG_ARRAY_INT64: {
+        int64_t v = 0;
+        if (parse_int64_str(tok, &v) != 0) goto out;
+        ((int64_t *)items)[count] = v;
+        break;
+      }
+      case ZCM_MSG_ARRAY_UINT8: {
+        uint64_t v = 0;
+        if (parse_uint64_str(tok, UINT8_MAX, &v) != 0) goto out;
+        ((uint8_t *)items)[count] = (uint8_t)v;
+        break;
+      }
+      case ZCM_MSG_ARRAY_UINT16: {
+        uint64_t v = 0;
+        if (parse_uint64_str(tok, UINT16_MAX, &v) != 0) goto out;
+        ((uint16_t *)items)[count] = (uint16_t)v;
+        break;
+      }
+      case ZCM_MSG_ARRAY_UINT32: {
+        uint64_t v = 0;
+        if (parse_uint64_str(tok, UINT32_MAX, &v) != 0) goto out;
+        ((uint32_t *)items)[count] = (uint32_t)v;
+        break;
+      }
+      case ZCM_MSG_ARRAY_UINT64: {
+        uint64_t v = 0;
+        if (parse_uint64_str(tok, UINT64_MAX, &v) != 0) goto out;
+        ((uint64_t *)items)[count] = v;
+        break;
+      }
       default:
         goto out;
     }
@@ -2140,9 +2211,9 @@ static int set_payload_array(zcm_msg_t *msg, const char *spec) {
   }
 
   if (count == 0) {
-    rc = zcm_msg_put_array(msg, array_type, 0, NULL);
+    rc = put(msg, array_type, 0, NULL);
   } else {
-    rc = zcm_msg_put_array(msg, array_type, (uint32_t)count, items);
+    rc = put(msg, array_type, (uint32_t)count, items);
   }
 
 out:
@@ -2233,6 +2304,11 @@ static const char *array_type_name_from_u8(uint8_t t) {
     case ZCM_MSG_ARRAY_INT: return "int";
     case ZCM_MSG_ARRAY_FLOAT: return "float";
     case ZCM_MSG_ARRAY_DOUBLE: return "double";
+    case ZCM_MSG_ARRAY_INT64: return "int64";
+    case ZCM_MSG_ARRAY_UINT8: return "uint8";
+    case ZCM_MSG_ARRAY_UINT16: return "uint16";
+    case ZCM_MSG_ARRAY_UINT32: return "uint32";
+    case ZCM_MSG_ARRAY_UINT64: return "uint64";
     default: return "unknown";
   }
 }
@@ -2317,20 +2393,82 @@ static int print_reply_payload_generic(const zcm_msg_t *reply) {
       off += n;
       continue;
     }
+    if (item == ZCM_MSG_ITEM_VALUE) {
+      if (off + 1 > len) goto malformed;
+      uint8_t kind = buf[off++];
+      if (kind == ZCM_MSG_VALUE_TEXT) {
+        if (off + 4 > len) goto malformed;
+        uint32_t n = read_u32_le(buf + off);
+        off += 4;
+        if (off + n > len) goto malformed;
+        printf("value<text>=%.*s", (int)n, (const char *)(buf + off));
+        off += n;
+      } else if (kind == ZCM_MSG_VALUE_DOUBLE) {
+        if (off + 8 > len) goto malformed;
+        uint64_t bits = read_u64_le(buf + off);
+        off += 8;
+        double v = 0.0;
+        memcpy(&v, &bits, sizeof(v));
+        printf("value<double>=%f", v);
+      } else if (kind == ZCM_MSG_VALUE_FLOAT) {
+        if (off + 4 > len) goto malformed;
+        uint32_t bits = read_u32_le(buf + off);
+        off += 4;
+        float v = 0.0f;
+        memcpy(&v, &bits, sizeof(v));
+        printf("value<float>=%f", v);
+      } else if (kind == ZCM_MSG_VALUE_INT) {
+        if (off + 4 > len) goto malformed;
+        int32_t v = (int32_t)read_u32_le(buf + off);
+        off += 4;
+        printf("value<int>=%d", v);
+      } else {
+        goto malformed;
+      }
+      continue;
+    }
     if (item == ZCM_MSG_ITEM_ARRAY) {
       if (off + 1 + 4 > len) goto malformed;
       uint8_t arr_t = buf[off++];
       uint32_t elems = read_u32_le(buf + off);
       off += 4;
-      size_t elem_size = 0;
-      switch (arr_t) {
-        case ZCM_MSG_ARRAY_CHAR: elem_size = 1; break;
-        case ZCM_MSG_ARRAY_SHORT: elem_size = 2; break;
-        case ZCM_MSG_ARRAY_INT: elem_size = 4; break;
-        case ZCM_MSG_ARRAY_FLOAT: elem_size = 4; break;
-        case ZCM_MSG_ARRAY_DOUBLE: elem_size = 8; break;
-        default: goto malformed;
+      if (arr_t & 0x80u) {
+        /* delta + zigzag-varint coded integer array */
+        arr_t &= 0x7Fu;
+        if (array_elem_size((zcm_msg_array_type_t)arr_t) == 0) goto malformed;
+        if (off + 4 > len) goto malformed;
+        uint32_t coded = read_u32_le(buf + off);
+        off += 4;
+        if (off + coded > len) goto malformed;
+        printf("array<%s+delta>[%u]=[", array_type_name_from_u8(arr_t), elems);
+        size_t pos = 0;
+        int64_t prev = 0;
+        uint32_t show = elems < 8 ? elems : 8;
+        for (uint32_t i = 0; i < show; i++) {
+          uint64_t zz = 0;
+          unsigned shift = 0;
+          for (;;) {
+            if (pos >= coded || shift > 63) goto malformed;
+            uint8_t b = buf[off + pos++];
+            zz |= (uint64_t)(b & 0x7Fu) << shift;
+            if (!(b & 0x80u)) break;
+            shift += 7;
+          }
+          prev = (int64_t)((uint64_t)prev + ((zz >> 1) ^ (0 - (zz & 1u))));
+          if (i) printf(",");
+          if (arr_t == ZCM_MSG_ARRAY_UINT64) {
+            printf("%llu", (unsigned long long)(uint64_t)prev);
+          } else {
+            printf("%lld", (long long)prev);
+          }
+        }
+        if (elems > show) printf(",...");
+        printf("]");
+        off += coded;
+        continue;
       }
+      size_t elem_size = array_elem_size((zcm_msg_array_type_t)arr_t);
+      if (elem_size == 0) goto malformed;
       size_t total = elem_size * (size_t)elems;
       if (off + total > len) goto malformed;
       printf("array<%s>[%u]=", array_type_name_from_u8(arr_t), elems);
@@ -2356,6 +2494,16 @@ static int print_reply_payload_generic(const zcm_msg_t *reply) {
           double v = 0.0;
           memcpy(&v, &bits, sizeof(v));
           printf("%f", v);
+        } else if (arr_t == ZCM_MSG_ARRAY_INT64) {
+          printf("%lld", (long long)(int64_t)read_u64_le(q));
+        } else if (arr_t == ZCM_MSG_ARRAY_UINT8) {
+          printf("%u", (unsigned)q[0]);
+        } else if (arr_t == ZCM_MSG_ARRAY_UINT16) {
+          printf("%u", (unsigned)read_u16_le(q));
+        } else if (arr_t == ZCM_MSG_ARRAY_UINT32) {
+          printf("%u", read_u32_le(q));
+        } else if (arr_t == ZCM_MSG_ARRAY_UINT64) {
+          printf("%llu", (unsigned long long)read_u64_le(q));
         }
       }
       if (elems > show) printf(",...");
@@ -2380,8 +2528,9 @@ static int do_send(const char *endpoint, const char *name, const char *type,
   int rc = 1;
   zcm_context_t *ctx = zcm_context_new();
   zcm_node_t *node = NULL;
-  char ep[256] = {0};
-  char ctrl_ep[512] = {0};
+  zcm_node_record_t rec;
+  char ep[sizeof(rec.endpoint)] = {0};
+  char ctrl_ep[sizeof(rec.ctrl_endpoint)] = {0};
   const char *targets[2] = {NULL, NULL};
   int target_count = 0;
   int attempt;
@@ -2390,12 +2539,13 @@ static int do_send(const char *endpoint, const char *name, const char *type,
   node = zcm_node_new(ctx, endpoint);
   if (!node) goto out;
 
-  if (zcm_node_lookup(node, name, ep, sizeof(ep)) != 0) {
+  /* One INFO round trip yields both the data and the control endpoint. */
+  if (zcm_node_resolve(node, name, &rec) != 0 || !rec.endpoint[0]) {
     fprintf(stderr, "zcm: lookup failed for %s\n", name);
     goto out;
   }
-
-  (void)zcm_node_info(node, name, NULL, 0, ctrl_ep, sizeof(ctrl_ep), NULL, 0, NULL);
+  snprintf(ep, sizeof(ep), "%s", rec.endpoint);
+  snprintf(ctrl_ep, sizeof(ctrl_ep), "%s", rec.ctrl_endpoint);
   if (ctrl_ep[0] && strcmp(ctrl_ep, ep) != 0) {
     targets[target_count++] = ctrl_ep;
     targets[target_count++] = ep;